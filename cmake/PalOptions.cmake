@@ -152,6 +152,7 @@ macro(pal_options)
     # Paths to PAL's dependencies
     set(PAL_METROHASH_PATH ${PROJECT_SOURCE_DIR}/src/util/imported/metrohash CACHE PATH "Specify the path to the MetroHash project.")
     set(   PAL_CWPACK_PATH ${PROJECT_SOURCE_DIR}/src/util/imported/cwpack    CACHE PATH "Specify the path to the CWPack project.")
+    set(      PAL_LZ4_PATH ${PROJECT_SOURCE_DIR}/shared/gpuopen/third_party/lz4 CACHE PATH "Specify the path to the LZ4 project.")
     set(      PAL_VAM_PATH ${PROJECT_SOURCE_DIR}/src/core/imported/vam       CACHE PATH "Specify the path to the VAM project.")
     set(     PAL_ADDR_PATH ${PROJECT_SOURCE_DIR}/src/core/imported/addrlib   CACHE PATH "Specify the path to the ADDRLIB project.")
 
@@ -96,12 +96,27 @@ public:
 
     /// Check if a PipelineSymbolEntry exists and return it.
     ///
+    /// The generic symbols are indexed on the first call, so readers which only need the pipeline symbols never pay
+    /// for it.  This is safe to call from multiple threads at once and doesn't take any locks.
+    ///
     /// @param [in]  pName ELF name of the symbol to search for
     ///
     /// @returns The found symbol, or nullptr if it was not found.
     const Elf::SymbolTableEntry* GetGenericSymbol(const char* pName) const;
 
 private:
+    /// Progress of the lazily built generic symbol index
+    enum GenericSymbolsState : uint32
+    {
+        NotIndexed,  ///< GetGenericSymbol has not been called yet
+        Indexing,    ///< One thread is building m_genericSymbolsMap, other lookups scan the symbol tables
+        Indexed,     ///< m_genericSymbolsMap holds every generic symbol and is never modified again
+        IndexFailed, ///< Building the map failed, lookups scan the symbol tables instead
+    };
+
+    Result IndexGenericSymbols() const;
+    bool FindGenericSymbol(const char* pName, SymbolEntry* pSymbolEntry) const;
+
     IndirectAllocator m_allocator;
     ElfReader::Reader m_elfReader;
 
@@ -110,7 +125,10 @@ private:
     /// If the section index of the symbol is 0, it does not exist.
     SymbolEntry m_pipelineSymbols[static_cast<uint32>(PipelineSymbolType::Count)];
 
-    GenericSymbolMap m_genericSymbolsMap;
+    /// Generic symbols are only indexed once somebody looks one up.  The map may only be read once the state (one of
+    /// GenericSymbolsState) is Indexed.
+    mutable GenericSymbolMap m_genericSymbolsMap;
+    mutable volatile uint32  m_genericSymbolsState;
 };
 
 // =====================================================================================================================
@@ -119,7 +137,8 @@ PipelineAbiReader::PipelineAbiReader(Allocator* const pAllocator, const void* pD
     :
     m_allocator(pAllocator),
     m_elfReader(pData),
-    m_genericSymbolsMap(16u, &m_allocator)
+    m_genericSymbolsMap(16u, &m_allocator),
+    m_genericSymbolsState(NotIndexed)
 {
     PAL_ASSERT(pAllocator);
 
@@ -32,6 +32,7 @@
 #pragma once
 
 #include "palUtil.h"
+#include "palArchiveFileFmt.h"
 #include "palSysMemory.h"
 
 namespace Util
@@ -39,7 +40,6 @@ namespace Util
 
 class IArchiveFile;
 class IPlatformKey;
-struct ArchiveEntryHeader;
 
 constexpr size_t MaxPathLength      = 260; ///< Maximum absolute path location for an archive file
 constexpr size_t MaxFilenameLength  = 128; ///< Maximum archive filename length excluding folder path
@@ -67,6 +67,20 @@ struct ArchiveFileOpenInfo
     bool                allowAsyncFileIo;            ///< Allow use of OS specific asynchronous file routines
     bool                useBufferedReadMemory;       ///< Allow preloading/read-ahead of file into memory
     size_t              maxReadBufferMem;            ///< Maximum size allowed for read buffer
+    bool                useMemoryMappedReads;        ///< Map the archive read-only into the address space and serve
+                                                     ///  reads from the mapping rather than from the read buffer.
+                                                     ///  Falls back to direct file reads if the mapping fails.
+};
+
+/**
+***********************************************************************************************************************
+* @brief Options controlling how an archive file is rewritten by IArchiveFile::Compact()
+***********************************************************************************************************************
+*/
+struct ArchiveCompactInfo
+{
+    bool discardDuplicateKeys;  ///< Keep only the first entry written for each entryKey. Only set this when entryKey
+                                ///  uniquely identifies the entry data, as it does for archive backed cache layers.
 };
 
 /// Get the memory size needed for an archive file object
@@ -122,6 +136,20 @@ Result CreateArchiveFile(
 Result DeleteArchiveFile(
     const ArchiveFileOpenInfo* pOpenInfo);
 
+/// Compact an archive file on disc without the caller keeping it open
+///
+/// Opens the file with write access, calls IArchiveFile::Compact() and closes it again. No access order information
+/// is available so entries keep their relative order.
+///
+/// @param [in]     pOpenInfo       Information about which file to compact. Write access is implied.
+/// @param [in]     pCompactInfo    Options controlling which entries are kept
+///
+/// @returns Success if the archive was rewritten. Otherwise, any error returned by OpenArchiveFile() or
+///          IArchiveFile::Compact() may be returned.
+Result CompactArchiveFile(
+    const ArchiveFileOpenInfo* pOpenInfo,
+    const ArchiveCompactInfo*  pCompactInfo);
+
 /**
 ***********************************************************************************************************************
 * @brief Interface for reading and writing to a file adhering to the PAL Archive file format
@@ -214,6 +242,99 @@ public:
         ArchiveEntryHeader* pHeader,
         const void*         pData) = 0;
 
+    /// Write several entries out to the archive file
+    ///
+    /// Equivalent to calling Write() for each entry in order, but lets the archive append all of the entries and
+    /// update its footer in a single write. The default implementation simply calls Write() for each entry.
+    ///
+    /// @param [in/out] pHeaders    Array of count headers for the new entries, modified as by Write()
+    /// @param [in]     ppData      Array of count pointers to the data to be stored for each entry
+    /// @param [in]     count       Number of entries to write
+    ///
+    /// @return Success if every entry was written without error. Otherwise, one of the following may be returned and
+    ///         any number of the leading entries may have been written:
+    ///         + Unsupported if the file was not opened with write access
+    ///         + ErrorInvalidPointer if pHeaders, ppData or any of the data pointers is nullptr
+    ///         + ErrorUnknown if there is an internal error.
+    virtual Result WriteBatch(
+        ArchiveEntryHeader* pHeaders,
+        const void* const*  ppData,
+        uint32              count)
+    {
+        Result result = ((pHeaders == nullptr) || (ppData == nullptr)) ? Result::ErrorInvalidPointer : Result::Success;
+
+        for (uint32 i = 0; (i < count) && (result == Result::Success); ++i)
+        {
+            result = Write(&pHeaders[i], ppData[i]);
+        }
+
+        return result;
+    }
+
+    /// Find the first entry written with the given key
+    ///
+    /// Archives that store an entry index resolve this without reading every entry header. Index entries themselves
+    /// are never returned. Only entries this object already knows about are searched, so entries appended to the file
+    /// by another process are not found until Refresh() is called.
+    ///
+    /// When SupportsKeyLookup() returns true this may be called from multiple threads at once without external
+    /// synchronization, and concurrently with any other call into this interface except Compact().
+    ///
+    /// @param [in]  pEntryKey  Key to look for, sizeof(ArchiveEntryHeader::entryKey) bytes
+    /// @param [out] pHeader    Header of the entry found
+    ///
+    /// @return Success if an entry was found. Otherwise, one of the following may be returned:
+    ///         + NotFound if no entry has this key
+    ///         + Unsupported if key lookups are not implemented, see SupportsKeyLookup()
+    ///         + ErrorInvalidPointer if pEntryKey or pHeader is nullptr
+    ///         + ErrorUnknown if there is an internal error.
+    virtual Result FindEntryByKey(
+        const uint8*        pEntryKey,
+        ArchiveEntryHeader* pHeader) { return Result::Unsupported; }
+
+    /// Pick up any entries appended to the file since this object last looked at it
+    ///
+    /// @return Success if the file was checked for new entries. Otherwise, one of the following may be returned:
+    ///         + NotReady if the data requested is still being streamed in (requires Async File IO)
+    ///         + Unsupported if refreshing on request is not implemented
+    ///         + ErrorUnknown if there is an internal error.
+    virtual Result Refresh() { return Result::Unsupported; }
+
+    /// Query whether FindEntryByKey() is implemented.
+    ///
+    /// @return True if entries can be looked up by key.
+    virtual bool SupportsKeyLookup() const { return false; }
+
+    /// Query whether Read() may be called from multiple threads at once without external synchronization.
+    ///
+    /// When this returns true, Read() may also run concurrently with one other (externally synchronized) call into
+    /// this interface, provided the header passed to Read() was previously returned by this object.
+    ///
+    /// @return True if concurrent reads are supported.
+    virtual bool SupportsConcurrentReads() const { return false; }
+
+    /// Rewrite the archive so it only holds live entries stored back to back
+    ///
+    /// Entries are written in the order they were first read through this object, followed by any entries that were
+    /// never read in their original order. Entries whose data fails its checksum or lies outside the file are dropped,
+    /// as are entries with a duplicate key if requested. All entry headers are written as a single block so that the
+    /// next open reads them in one go. The new archive is written next to the old one and renamed over it, so the
+    /// original file is left untouched if compaction fails part way through.
+    ///
+    /// Ordinal ids and data positions change, so any header previously returned by this object is invalidated. This
+    /// call must be externally synchronized with every other call into this interface, including Read().
+    ///
+    /// @param [in] pCompactInfo    Options controlling which entries are kept
+    ///
+    /// @return Success if the archive was rewritten. Otherwise, one of the following may be returned:
+    ///         + Unsupported if the file was not opened with write access or compaction is not implemented
+    ///         + ErrorInvalidPointer if pCompactInfo is nullptr
+    ///         + ErrorOutOfMemory if a scratch buffer could not be allocated
+    ///         + ErrorUnavailable if the replacement file could not be created
+    ///         + ErrorUnknown if there is an internal error.
+    virtual Result Compact(
+        const ArchiveCompactInfo* pCompactInfo) { return Result::Unsupported; }
+
     /// Destroy the archive file interface. Closing the file if necessary.
     ///
     ///  If async file writes are allowed this function may block if there are pending writes to complete.
@@ -53,14 +53,31 @@ constexpr uint8 MagicArchiveMarker[16]  =                       ///< Identifies
      0x8b, 0xd1, 0x48, 0xf5, 0xd8, 0xf0, 0xb4, 0xa7};
 constexpr uint8 MagicFooterMarker[4]    = {'F','O','T','R'};    ///< Identifies the start of the ArchiveFileFooter
 constexpr uint8 MagicEntryMarker[4]     = {'N','T','R','Y'};    ///< Identifies the start of an ArchiveEntryHeader
+constexpr uint8 MagicIndexMarker[4]     = {'I','N','D','X'};    ///< Identifies an ArchiveIndexHeader or
+                                                                ///  ArchiveIndexLocator
 
 /**
 ***********************************************************************************************************************
 * @brief Version constants. Must be updated if this file is changed
 ***********************************************************************************************************************
 */
-constexpr uint32 CurrentMajorVersion    = 1;    ///< Version number denoting compatibility breaking changes
-constexpr uint32 CurrentMinorVersion    = 1;    ///< Version number denoting changes that should be backward compatible
+constexpr uint32 CurrentMajorVersion    = 2;    ///< Version number denoting compatibility breaking changes
+constexpr uint32 CurrentMinorVersion    = 0;    ///< Version number denoting changes that should be backward compatible
+
+/**
+***********************************************************************************************************************
+* @brief Version history
+*
+*   1.1: Initial release
+*   1.2: Optional entry indices. An index is stored as an ordinary entry, so readers that don't know about them just
+*        see one more entry and can ignore it.
+*   2.0: Entry data may be LZ4 compressed, which is flagged by ArchiveCompressedDataType. Readers of 1.x would hand
+*        compressed data out as is, so they must not open these files.
+***********************************************************************************************************************
+*/
+constexpr uint32 ArchiveIndexDataType      = 0x58444E49;   ///< ArchiveEntryHeader::dataType reserved for index entries
+constexpr uint32 ArchiveCompressedDataType = 0x43345A4C;   ///< ArchiveEntryHeader::dataType of entries whose data is
+                                                           ///  LZ4 compressed. metaValue holds the uncompressed size.
 
 /**
 ***********************************************************************************************************************
@@ -107,6 +124,57 @@ struct ArchiveEntryHeader
     uint8  entryKey[20];    ///< 160-bit (max) hash key for the entry
     uint32 metaValue;       ///< Optional meta-data value for use by consumer of data
 };
+
+/**
+***********************************************************************************************************************
+* @brief Header at the start of the data of an index entry
+*
+* An index describes a contiguous run of entries ending with the entry directly before the index entry itself. The
+* data of an index entry is laid out as:
+*
+*   ArchiveIndexHeader
+*   ArchiveEntryHeader  [entryCount]  Copies of the headers being indexed, in ordinal order
+*   ArchiveIndexKey     [keyCount]    Entry keys of the indexed entries sorted by entryKey then ordinalId. Other index
+*                                     entries are not included.
+*   ArchiveIndexLocator
+*
+* Indices chain back through prevIndexBlock until one with firstOrdinal of 0 is reached, so that the whole archive is
+* described by the chain ending at the most recently written index.
+***********************************************************************************************************************
+*/
+struct ArchiveIndexHeader
+{
+    uint8  indexMarker[4];  ///< Fixed marker to designate an index, must match MagicIndexMarker
+    uint32 firstOrdinal;    ///< Ordinal id of the first entry described by this index
+    uint32 entryCount;      ///< Number of entry headers stored in this index
+    uint32 keyCount;        ///< Number of entry keys stored in this index
+    uint32 prevIndexBlock;  ///< Byte offset of the ArchiveEntryHeader of the previous index, 0 if firstOrdinal is 0
+};
+
+/**
+***********************************************************************************************************************
+* @brief Sorted key table element of an index
+***********************************************************************************************************************
+*/
+struct ArchiveIndexKey
+{
+    uint8  entryKey[20];    ///< Matches ArchiveEntryHeader::entryKey
+    uint32 ordinalId;       ///< Ordinal id of the entry with this key
+};
+
+/**
+***********************************************************************************************************************
+* @brief Trailer at the end of the data of an index entry
+*
+* When the index entry is the last entry of the archive this sits directly in front of the ArchiveFileFooter, which
+* lets a reader find the index without walking the entry chain.
+***********************************************************************************************************************
+*/
+struct ArchiveIndexLocator
+{
+    uint8  indexMarker[4];  ///< Fixed marker to designate an index, must match MagicIndexMarker
+    uint32 indexBlock;      ///< Byte offset of the ArchiveEntryHeader of this index entry from start of archive
+};
 #pragma pack(pop)
 
 } // namespace Util
@@ -0,0 +1,162 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2020 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+/**
+ ***********************************************************************************************************************
+ * @file  palBufferedFileWriter.h
+ * @brief PAL utility collection BufferedFileWriter class declaration.
+ ***********************************************************************************************************************
+ */
+
+#pragma once
+
+#include "palConditionVariable.h"
+#include "palFile.h"
+#include "palMutex.h"
+#include "palSysMemory.h"
+#include "palThread.h"
+
+namespace Util
+{
+
+/**
+ ***********************************************************************************************************************
+ * @brief Writes a file through a chain of fixed-size staging buffers.
+ *
+ * Data is copied into the current buffer. When it fills, the buffer is written to the file, either immediately on the
+ * calling thread or by a background write thread. Buffers are never copied to grow, and once the file is open only a
+ * fixed number of them are kept, so writing a large file runs in constant memory. With a write thread the caller only
+ * waits on file I/O if every buffer is waiting to be written.
+ *
+ * Data may be added before the file is opened. It is kept in as many buffers as needed and is written once the file
+ * is opened.
+ *
+ * This class is not thread-safe, the write thread is internal and only one thread may add data at a time.
+ ***********************************************************************************************************************
+ */
+class BufferedFileWriter
+{
+public:
+    /// Constructor.
+    ///
+    /// @param [in] allocator  Allocator for the staging buffers.
+    /// @param [in] bufferSize The size of each staging buffer in bytes.
+    /// @param [in] maxBuffers How many staging buffers to keep once the file is open.
+    BufferedFileWriter(const IndirectAllocator& allocator, uint32 bufferSize, uint32 maxBuffers);
+
+    /// Writes any remaining data and closes the file if it is still open, then frees all staging buffers.
+    ~BufferedFileWriter();
+
+    /// Opens the file and writes any full buffers of data added before now.
+    ///
+    /// @param [in] pFilename       Name of file to open.
+    /// @param [in] accessFlags     Bitmask of FileAccessMode values indicating the usage of the file.
+    /// @param [in] backgroundWrite If full buffers should be written by a background thread.
+    ///
+    /// @returns Success if successful, otherwise an appropriate error.
+    Result Open(const char* pFilename, uint32 accessFlags, bool backgroundWrite);
+
+    /// Writes all remaining data, stops the write thread and closes the file.
+    ///
+    /// @returns Success if every write succeeded, otherwise the first error hit while writing the file.
+    Result Close();
+
+    /// Returns true if the file is currently open.
+    bool IsOpen() const { return m_file.IsOpen(); }
+
+    /// Returns the size of each staging buffer in bytes, which is the largest size that can be reserved.
+    uint32 BufferSize() const { return m_bufferSize; }
+
+    /// Adds data to the file, splitting it across staging buffers as needed.
+    ///
+    /// @param [in] pData Data to add.
+    /// @param [in] size  Size of the data in bytes.
+    ///
+    /// @returns Success if successful, or ErrorOutOfMemory if some of the data was lost because a buffer couldn't be
+    ///          allocated.
+    Result Write(const void* pData, size_t size);
+
+    /// Reserves contiguous space in the current staging buffer, moving on to a new buffer if the current one doesn't
+    /// have room. The caller may keep updating the space until RemainingSpace() returns less than it needs.
+    ///
+    /// @param [in] size Size of the space in bytes, no larger than BufferSize().
+    ///
+    /// @returns A pointer to the reserved space, or null if a buffer couldn't be allocated. There are no alignment
+    ///          guarantees.
+    void* Reserve(uint32 size);
+
+    /// Returns how many bytes can be reserved before moving on to a new staging buffer. Returns zero when there is no
+    /// current buffer, including right after Flush(), so space reserved before then must no longer be touched.
+    uint32 RemainingSpace() const { return (m_pCurBuffer != nullptr) ? (m_bufferSize - m_pCurBuffer->used) : 0; }
+
+    /// Writes all data added so far, including the partially filled current buffer, and flushes the file.
+    ///
+    /// @returns Success if every write succeeded, ErrorUnavailable if the file isn't open, otherwise the first error
+    ///          hit while writing the file.
+    Result Flush();
+
+private:
+    // A staging buffer, its data immediately follows this header in memory.
+    struct Buffer
+    {
+        Buffer* pNext;
+        uint32  used;  // How many bytes of the buffer are in use.
+
+        uint8* Data() { return reinterpret_cast<uint8*>(this + 1); }
+    };
+
+    void    NextBuffer();
+    Buffer* AcquireBuffer();
+    void    ReleaseBuffer(Buffer* pBuffer);
+    void    QueueBuffer(Buffer* pBuffer);
+    void    WriteQueuedBuffers();
+    void    FreeBufferList(Buffer* pList);
+
+    void        StopWriteThread();
+    void        RunWriteThread();
+    static void WriteThreadCallback(void* pParameter);
+
+    IndirectAllocator m_allocator;
+    const uint32      m_bufferSize;
+    const uint32      m_maxBuffers;
+    File              m_file;
+    Buffer*           m_pCurBuffer;      // Data is currently being added to this buffer.
+    Buffer*           m_pQueueHead;      // Full buffers that need to be written to the file, oldest first.
+    Buffer*           m_pQueueTail;
+    Buffer*           m_pFreeBuffers;    // Buffers that have been written and can be reused.
+    uint32            m_numBuffers;      // How many buffers are currently allocated.
+    Result            m_writeResult;     // The first error hit while writing the file.
+
+    // When the write thread is running, it owns m_file and the buffer lists are protected by m_bufferMutex.
+    Thread            m_writeThread;
+    Mutex             m_bufferMutex;
+    ConditionVariable m_bufferCondition; // Signaled when a buffer is queued or written.
+    bool              m_writing;         // The write thread is writing a buffer it removed from the queue.
+    bool              m_stopWriteThread;
+
+    PAL_DISALLOW_DEFAULT_CTOR(BufferedFileWriter);
+    PAL_DISALLOW_COPY_AND_ASSIGN(BufferedFileWriter);
+};
+
+} // Util
@@ -365,8 +365,12 @@ private:
 */
 struct CacheLayerBaseCreateInfo
 {
-    AllocCallbacks* pCallbacks; ///< Memory allocation callbacks to be used by the caching layer for all long term
-                                ///  storage. Allocation callbacks must be valid for the life of the cache layer
+    AllocCallbacks* pCallbacks;   ///< Memory allocation callbacks to be used by the caching layer for all long term
+                                  ///  storage. Allocation callbacks must be valid for the life of the cache layer
+    bool            compressData; ///< Store entries LZ4 compressed where that makes them smaller. Sizes reported by
+                                  ///  Query() are always uncompressed sizes and Load() always returns uncompressed
+                                  ///  data, but GetCacheData() is unsupported for compressed entries. Layers read
+                                  ///  compressed entries whether or not this is set.
 };
 
 /**
@@ -382,8 +386,16 @@ struct MemoryCacheCreateInfo
     bool                     evictOnFull;     ///< Whether or not the cache should evict entries based on LRU to
                                               ///  make room for new ones
     bool                     evictDuplicates; ///< Whether or not the cache should evict entries with a duplicate hash
+    uint32                   numShards;       ///< Number of independently locked shards the entries are split across,
+                                              ///  keyed by the low bits of the entry hash. Each shard has its own
+                                              ///  lookup table and LRU list while maxObjectCount and maxMemorySize
+                                              ///  remain a budget for the whole cache. Rounded up to a power of two
+                                              ///  and clamped to MaxMemoryCacheShards; 0 or 1 selects a single shard.
 };
 
+/// Maximum number of shards an in-memory cache layer may be split into
+constexpr uint32 MaxMemoryCacheShards = 64;
+
 /// Get the memory size for a in-memory cache layer
 ///
 /// @param [in]     pCreateInfo     Information about cache being created
@@ -445,6 +457,11 @@ struct ArchiveFileCacheCreateInfo
                                            ///  to be keyed to a specific driver/platform fingerprint.
     uint32                   dataTypeId;   ///< Optional 32-bit data type identifier, allows heterogenous data to be
                                            ///  stored within an archive file.
+    bool                     writeBehind;  ///< Queue stores and write them to the archive from a background thread,
+                                           ///  batching together whatever is queued by the time each write starts.
+                                           ///  Store() returns once the data has been copied. Queries for a queued
+                                           ///  entry wait for it to be written, and destroying the layer writes
+                                           ///  everything still queued.
 };
 
 /// Get the memory size for a archive file backed cache layer
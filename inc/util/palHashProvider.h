@@ -37,16 +37,20 @@ namespace Util
 
 class IHashContext;
 
-/// Ids for commonly supported hashing algorithms provided by the OS
+/// Ids for commonly supported hashing algorithms provided by the OS, plus a few that PAL implements itself
 enum class HashAlgorithm : uint32
 {
-    NoOp   = 0x00, ///< Null/Dummy algorithm
-    Md5    = 0x01, ///< Message Digest 5 (128-bit digest)
-    Sha1   = 0x10, ///< Secure Hash Algorithm 1 (160-bit digest)
-    Sha224 = 0x20, ///< Secure Hash Algorithm 2 (224-bit digest)
-    Sha256 = 0x21, ///< Secure Hash Algorithm 2 (256-bit digest)
-    Sha384 = 0x22, ///< Secure Hash Algorithm 2 (384-bit digest)
-    Sha512 = 0x23, ///< Secure Hash Algorithm 2 (512-bit digest)
+    NoOp          = 0x00, ///< Null/Dummy algorithm
+    Md5           = 0x01, ///< Message Digest 5 (128-bit digest)
+    Sha1          = 0x10, ///< Secure Hash Algorithm 1 (160-bit digest)
+    Sha224        = 0x20, ///< Secure Hash Algorithm 2 (224-bit digest)
+    Sha256        = 0x21, ///< Secure Hash Algorithm 2 (256-bit digest)
+    Sha384        = 0x22, ///< Secure Hash Algorithm 2 (384-bit digest)
+    Sha512        = 0x23, ///< Secure Hash Algorithm 2 (512-bit digest)
+    BuiltinSha1   = 0x80, ///< PAL's own Sha1. Same digest as Sha1, but needs no OS library and uses the CPU's SHA
+                          ///  extensions when they are present.
+    BuiltinSha256 = 0x81, ///< PAL's own Sha256. Same digest as Sha256, but needs no OS library and uses the CPU's
+                          ///  SHA extensions when they are present.
 };
 
 /// Minimum memory buffer sizes needed to hold data relating to hash algorithms
@@ -48,6 +48,8 @@ size_t GetPlatformKeySize(
 
 /// Create a platform key object
 ///
+/// HashAlgorithm::BuiltinSha1 and BuiltinSha256 produce the same keys as Sha1 and Sha256 without loading an OS library.
+///
 /// @param [in]     algorithm       Hashing algorithm to be used
 /// @param [in]     pInitialData    Optional pointer to initial data used to create the key, may be nullptr
 /// @param [in]     initialDataSize Size of initial data buffer. Must be greater than 0 if pInitialData is not nullptr
@@ -81,6 +81,9 @@ namespace DevDriver
             BlockId m_blockId;       // The id associated with this block
         };
 
+        // A callback that tells the owner of a buffer referenced by a server block that the block no longer needs it.
+        typedef void (*ReleaseBlockDataCb)(void* pUserData, const void* pData, size_t dataSize);
+
         // A server transfer block.
         // Only supports writes and must be closed before the data can be accessed.
         // Writes can only be performed on blocks that have not been closed.
@@ -92,14 +95,27 @@ namespace DevDriver
                 : TransferBlock(blockId)
                 , m_isClosed(false)
                 , m_chunks(allocCb)
+                , m_copiedDataSize(0)
+                , m_segments(allocCb)
                 , m_numPendingTransfers(0)
                 , m_transfersCompletedEvent(true)
                 , m_crc32(0)
                 {}
 
+            ~ServerBlock();
+
             // Writes numBytes bytes from pSrcBuffer into the block.
             void Write(const void* pSrcBuffer, size_t numBytes);
 
+            // Adds numBytes bytes from pSrcBuffer to the block without copying them.
+            // The buffer must stay valid and unchanged until pfnRelease is called with pUserData, which happens when
+            // the block is reset or destroyed. Blocks are kept alive by the transfers reading from them.
+            // pfnRelease may be null for buffers that outlive the block.
+            void WriteByReference(const void*        pSrcBuffer,
+                                  size_t             numBytes,
+                                  ReleaseBlockDataCb pfnRelease,
+                                  void*              pUserData);
+
             // Closes the block which exposes it to external clients and prevents further writes.
             void Close();
 
@@ -110,11 +126,22 @@ namespace DevDriver
             bool IsClosed() const { return m_isClosed; }
 
             // Returns a const pointer to the underlying data contained within the block, or null if it contains
-            // no data.
+            // no data or if its data isn't contiguous because it references external buffers.
             const uint8* GetBlockData() const {
-                return (m_blockDataSize > 0) ? reinterpret_cast<const uint8*>(m_chunks.Data()) : nullptr;
+                return ((m_blockDataSize > 0) && IsContiguous()) ? reinterpret_cast<const uint8*>(m_chunks.Data())
+                                                                 : nullptr;
             }
 
+            // Returns true if all of the block's data is stored in one piece.
+            bool IsContiguous() const { return m_segments.IsEmpty(); }
+
+            // Returns a pointer to the data at the given offset into the block and the number of bytes that can be
+            // read from it in one piece through pContiguousSize. Works whether or not the block is contiguous.
+            const uint8* GetBlockDataAt(size_t offset, size_t* pContiguousSize) const;
+
+            // Copies numBytes bytes starting at the given offset into the block into pDstBuffer.
+            void CopyBlockData(size_t offset, size_t numBytes, void* pDstBuffer) const;
+
             // Returns a boolean indicating whether the block has any transfers in progress.
             bool HasPendingTransfers();
 
@@ -137,8 +164,25 @@ namespace DevDriver
             // Notifies the block that an existing transfer has ended.
             void EndTransfer();
 
+            // Releases all referenced buffers and forgets the block's segments.
+            void ReleaseSegments();
+
+            // A range of the block's data that is either copied into the block's chunks or referenced.
+            // Segments are only tracked once the block references a buffer, until then all data lives in the chunks.
+            struct BlockSegment
+            {
+                size_t             blockOffset;  // Offset of the segment within the block's data
+                size_t             size;         // Size of the segment in bytes
+                const uint8*       pData;        // The referenced buffer, or null if the data is in the chunks
+                size_t             copiedOffset; // Offset of the data within the chunks if it was copied
+                ReleaseBlockDataCb pfnRelease;   // Called when a referenced buffer is no longer needed
+                void*              pUserData;    // Passed to pfnRelease
+            };
+
             bool                  m_isClosed;                // A bool that indicates if the block is closed
             Vector<TransferChunk> m_chunks;                  // A list of transfer chunks used to store data
+            size_t                m_copiedDataSize;          // Number of bytes stored in m_chunks
+            Vector<BlockSegment>  m_segments;                // The block's data in order, if it references buffers
             Platform::Mutex       m_pendingTransfersMutex;   // A mutex used to control access to the pending transfers counter
             uint32                m_numPendingTransfers;     // A counter used to track the number of pending transfers
             Platform::Event       m_transfersCompletedEvent; // An event that is signaled when all pendings transfers are completed
@@ -72,6 +72,11 @@ public:
 
 private:
     static Result WriteBytes(void* pUserData, const void* pBytes, size_t numBytes);
+    static Result WriteBytesByReference(void*          pUserData,
+                                        const void*    pBytes,
+                                        size_t         numBytes,
+                                        ReleaseBytesCb pfnRelease,
+                                        void*          pReleaseUserData);
 
     PostDataInfo  m_postInfo;
     char*         m_pRequestArguments;
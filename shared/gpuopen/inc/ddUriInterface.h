@@ -52,6 +52,10 @@ namespace DevDriver
         Count
     };
 
+    // A callback that tells the owner of a buffer passed to IByteWriter::WriteBytesByReference that the writer no
+    // longer references it.
+    typedef void (*ReleaseBytesCb)(void* pUserData, const void* pBytes, size_t length);
+
     // An interface to write bytes.
     class IByteWriter
     {
@@ -65,6 +69,25 @@ namespace DevDriver
         // Write exactly `length` bytes.
         virtual void WriteBytes(const void* pBytes, size_t length) = 0;
 
+        // Write exactly `length` bytes without copying them, if the writer supports it.
+        // The bytes must stay valid and unchanged until `pfnRelease` is called with `pUserData`. This can happen long
+        // after End() returns, since the bytes may be referenced until they have been sent to a remote client.
+        // `pfnRelease` is called exactly once, even if writing fails. It may be `nullptr` for buffers that outlive
+        // the writer.
+        // Writers that can't reference external buffers copy the bytes and release them right away.
+        virtual void WriteBytesByReference(const void*    pBytes,
+                                           size_t         length,
+                                           ReleaseBytesCb pfnRelease,
+                                           void*          pUserData)
+        {
+            WriteBytes(pBytes, length);
+
+            if (pfnRelease != nullptr)
+            {
+                pfnRelease(pUserData, pBytes, length);
+            }
+        }
+
         // Write a value as a byte array.
         // N.B.: Be mindful of your struct's implicit padding!
         template <typename T>
@@ -29,7 +29,7 @@
 
 #define GPUOPEN_INTERFACE_MAJOR_VERSION 42
 
-#define GPUOPEN_INTERFACE_MINOR_VERSION 0
+#define GPUOPEN_INTERFACE_MINOR_VERSION 1
 
 #define GPUOPEN_INTERFACE_VERSION ((GPUOPEN_INTERFACE_MAJOR_VERSION << 16) | GPUOPEN_INTERFACE_MINOR_VERSION)
 
@@ -50,6 +50,7 @@
 ***********************************************************************************************************************
 *| Version | Change Description                                                                                       |
 *| ------- | ---------------------------------------------------------------------------------------------------------|
+*| 42.1    | Added ISession::GetStatistics to query the transfer statistics of a session.                             |
 *| 42.0    | Updates RGP Protocol to support SPM counters and SE masking.                                             |
 *| 41.0    | Updates DriverControlProtocol to allow user to query device clock frequencies for a given                |
 *|         | clock mode without changing the clock mode.                                                              |
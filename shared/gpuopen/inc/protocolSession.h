@@ -129,6 +129,22 @@ namespace DevDriver
         Server
     };
 
+    // Transfer statistics of a session. The counters cover the lifetime of the session.
+    struct SessionStatistics
+    {
+        uint64 sessionTimeInMs;         // Time since the session was created
+        uint64 messagesSent;            // Messages sent for the first time
+        uint64 bytesSent;               // Payload bytes of the messages sent for the first time
+        uint64 messagesReceived;        // Messages received for the first time
+        uint64 bytesReceived;           // Payload bytes of the messages received for the first time
+        uint64 messagesRetransmitted;   // Messages sent again because they were lost or acknowledged too late
+        uint64 duplicatesReceived;      // Messages received again after they had already arrived
+        uint32 retransmitTimeouts;      // Times unacknowledged messages timed out and were retransmitted
+        uint32 fastRetransmits;         // Times duplicate acknowledgements caused lost messages to be retransmitted
+        uint32 congestionWindowSize;    // Number of unacknowledged messages currently allowed in flight
+        float  roundTripTimeInMs;       // Moving average of the time it takes for a message to be acknowledged
+    };
+
     class ISession
     {
     public:
@@ -147,6 +163,9 @@ namespace DevDriver
         virtual Version GetVersion() const = 0;
         virtual Protocol GetProtocol() const = 0;
 
+        // Returns a snapshot of the session's transfer statistics.
+        virtual void GetStatistics(SessionStatistics* pStatistics) = 0;
+
         // Helper functions for working with SizedPayloadContainers and managing back-compat.
         Result SendPayload(const SizedPayloadContainer& payload, uint32 timeoutInMs)
         {
@@ -45,6 +45,54 @@ namespace EventProtocol
 
 class EventServer;
 
+// Encodes the payload of an event written with BaseEventProvider::WriteEncodedEvent
+// The timestamp is the one the event is written with. Every encoded event of a provider is written into the same
+// stream, so a provider can use it to encode its own timing information relative to the previous encoded event. The
+// first event of each stream is always given a full timestamp. The payload must be written into pBuffer, which has
+// room for bufferSize bytes, and its size returned in pEventDataSize.
+// If the payload doesn't fit, the function must return InsufficientMemory with the size it needs in pEventDataSize.
+// It is then called again with the same timestamp and a buffer of at least that size.
+typedef Result (*EncodeEventDataFunc)(void*                 pUserdata,
+                                      const EventTimestamp& timestamp,
+                                      void*                 pBuffer,
+                                      size_t                bufferSize,
+                                      size_t*               pEventDataSize);
+
+// Size of the scratch buffer encoded payloads are first written into
+// This is large enough for nearly every payload, including RMT userdata tokens carrying a full length string, so
+// payloads are only encoded into a heap allocation in rare cases.
+DD_STATIC_CONST size_t kEncodedEventScratchSize = 2048;
+
+// Holds the payload produced by an EncodeEventDataFunc
+// The payload is encoded into a scratch buffer inside this object, or into a heap allocation if it doesn't fit there.
+class EncodedEventData
+{
+public:
+    explicit EncodedEventData(const AllocCb& allocCb)
+        : m_allocCb(allocCb)
+        , m_pHeapData(nullptr)
+        , m_dataSize(0)
+    {
+    }
+
+    ~EncodedEventData();
+
+    // Runs pfnEncode, retrying with a larger buffer if the payload doesn't fit in the scratch buffer
+    Result Encode(EncodeEventDataFunc pfnEncode, void* pUserdata, const EventTimestamp& timestamp);
+
+    void*       Data()       { return (m_pHeapData != nullptr) ? m_pHeapData : m_scratch; }
+    const void* Data() const { return (m_pHeapData != nullptr) ? m_pHeapData : m_scratch; }
+    size_t      Size() const { return m_dataSize; }
+
+private:
+    const AllocCb& m_allocCb;
+    void*          m_pHeapData;
+    size_t         m_dataSize;
+    uint8          m_scratch[kEncodedEventScratchSize];
+
+    DD_DISALLOW_COPY_AND_ASSIGN(EncodedEventData);
+};
+
 class BaseEventProvider
 {
     friend class EventServer;
@@ -89,6 +137,11 @@ protected:
         return WriteEventWithHeader(eventId, nullptr, 0, pEventData, eventDataSize);
     }
 
+    // Like WriteEvent, but the payload is produced by pfnEncode once the timestamp of the event is known
+    // This is useful for providers whose event payloads contain their own timing information. These events don't use
+    // the per-thread streams: they all go through a single stream so the timeline in their payloads never goes back.
+    Result WriteEncodedEvent(uint32 eventId, EncodeEventDataFunc pfnEncode, void* pUserdata);
+
     // Returns the header associated with this provider
     ProviderDescriptionHeader GetHeader() const;
 
@@ -98,16 +151,63 @@ protected:
     virtual void OnDisable() {}
 
 private:
+    // A stream of event chunks that is written by a single thread at a time
+    // Every thread that writes events gets a stream of its own so writers don't have to wait for each other. Streams
+    // are flushed to the server as a whole and each one begins with its own provider token, so the server can order
+    // them by the time they were started.
+    struct EventStream
+    {
+        Platform::AtomicLock lock;           // Held while writing to or flushing the stream
+        volatile uint32      ownerThreadId;  // Id of the thread the stream belongs to, zero if it's unused
+        EventTimer           eventTimer;
+        uint64               startTimestamp; // Timestamp of the stream's provider token
+        uint64               nextFlushTime;
+        Vector<EventChunk*>  eventChunks;
+
+        explicit EventStream(const AllocCb& allocCb)
+            : ownerThreadId(0)
+            , startTimestamp(0)
+            , nextFlushTime(0)
+            , eventChunks(allocCb)
+        {
+        }
+    };
+
+    // Maximum number of threads that can write into a stream of their own at the same time
+    // Any threads past this share a single stream.
+    DD_STATIC_CONST uint32 kMaxThreadEventStreams = 16;
+
+    // The thread streams followed by the shared stream and the encoded event stream
+    DD_STATIC_CONST uint32 kNumEventStreams = (kMaxThreadEventStreams + 2);
+
     void EnableEvent(uint32 eventId) { m_eventState.SetBit(eventId); }
     void DisableEvent(uint32 eventId) { m_eventState.ResetBit(eventId); }
 
     void Update();
 
-    // This function must only be called while the chunk mutex is held!
-    void UpdateFlushTimer();
+    // Returns the calling thread's event stream with its lock held
+    EventStream* AcquireEventStream();
+
+    // Returns the stream at streamIndex, which is less than kNumEventStreams. May return nullptr.
+    EventStream* GetEventStream(uint32 streamIndex);
+
+    // Flushes the event chunks of every stream to the server
+    void FlushEventStreams();
 
-    // This function must only be called while the chunk mutex is held!
-    void Flush();
+    // Writes an event into the calling thread's stream
+    // The payload is either the header followed by the event data, or the output of pfnEncode if it's provided. Encoded
+    // events are written into the encoded event stream instead.
+    Result WriteEventInternal(uint32              eventId,
+                              const void*         pHeaderData,
+                              size_t              headerSize,
+                              const void*         pEventData,
+                              size_t              eventDataSize,
+                              EncodeEventDataFunc pfnEncode,
+                              void*               pUserdata);
+
+    // These functions must only be called while the stream's lock is held!
+    void UpdateFlushTimer(EventStream* pStream);
+    void Flush(EventStream* pStream);
 
     void Enable()
     {
@@ -123,9 +223,7 @@ private:
         if (m_isEnabled)
         {
             // We want to flush any remaining queued events when disabling the provider.
-            m_chunkMutex.Lock();
-            Flush();
-            m_chunkMutex.Unlock();
+            FlushEventStreams();
 
             m_isEnabled = false;
             OnDisable();
@@ -137,31 +235,31 @@ private:
         m_eventState.UpdateBitData(pEventData, eventDataSize);
     }
 
-    Result AcquireEventChunks(size_t numBytesRequired, Vector<EventChunk*>* pChunks);
-
     void Register(EventServer* pServer);
     void Unregister();
 
-    Result AllocateEventChunk(EventChunk** ppChunk);
-    void   FreeEventChunk(EventChunk* pChunk);
-    Result BeginEventStream(EventChunk** ppChunk);
-    Result WriteStreamPreamble(EventChunk* pChunk);
+    // These functions must only be called while the stream's lock is held!
+    Result AcquireEventChunks(EventStream* pStream, size_t numBytesRequired, Vector<EventChunk*>* pChunks);
+    Result AllocateEventChunk(EventStream* pStream, EventChunk** ppChunk);
+    void   FreeEventChunk(EventStream* pStream, EventChunk* pChunk);
+    Result BeginEventStream(EventStream* pStream);
+    Result WriteStreamPreamble(EventStream* pStream, EventChunk* pChunk);
 
-    // This function generates a small delta time value for use in other event tokens.
+    // This function generates a small delta time value for use in other event tokens from the timestamp of an event.
     // It requires a pointer to the chunk that's being written to because it may need to write
     // a separate timestamp token as a side effect of generating the small delta value.
-    Result GenerateEventTimestamp(EventChunkBufferView* pBufferView, uint8* pSmallDelta);
+    Result WriteEventTimestamp(EventChunkBufferView* pBufferView, const EventTimestamp& timestamp, uint8* pSmallDelta);
 
     AllocCb              m_allocCb;
     EventServer*         m_pServer;
     DynamicBitSet<>      m_eventState;
     bool                 m_isEnabled;
-    EventTimer           m_eventTimer;
     uint32               m_flushFrequencyInMs;
-    uint32               m_eventDataIndex;
-    Platform::AtomicLock m_chunkMutex;
-    uint64               m_nextFlushTime;
-    Vector<EventChunk*>  m_eventChunks;
+    Platform::Atomic     m_eventDataIndex;
+    Platform::AtomicLock m_streamMutex;    // Serializes threads claiming unused streams
+    EventStream*         m_pThreadStreams[kMaxThreadEventStreams];
+    EventStream          m_sharedStream;   // Used by any threads that don't have a stream of their own
+    EventStream          m_encodedStream;  // Used by every encoded event so their payloads share a single timer
 };
 
 } // namespace EventProtocol
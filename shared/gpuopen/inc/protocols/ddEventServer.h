@@ -65,9 +65,17 @@ public:
     Result UnregisterProvider(BaseEventProvider* pProvider);
 
 private:
+    // A chunk waiting to be sent, along with the start time of the provider stream it belongs to
+    struct QueuedEventChunk
+    {
+        EventChunk* pChunk;
+        uint64      streamTimestamp;
+        bool        isStreamStart;    // True for the first chunk of a stream
+    };
+
     Result AllocateEventChunk(EventChunk** ppChunk);
     void FreeEventChunk(EventChunk* pChunk);
-    void EnqueueEventChunks(size_t numChunks, EventChunk** ppChunks);
+    void EnqueueEventChunks(size_t numChunks, EventChunk** ppChunks, uint64 streamTimestamp);
     EventChunk* DequeueEventChunk();
     Result BuildQueryProvidersResponse(BlockId* pBlockId);
     Result ApplyProviderUpdate(const ProviderUpdateHeader* pUpdate);
@@ -79,7 +87,7 @@ private:
     Platform::AtomicLock                              m_eventPoolMutex;
     Vector<EventChunk*>                               m_eventChunkPool;
     Platform::AtomicLock                              m_eventQueueMutex;
-    Vector<EventChunk*>                               m_eventChunkQueue;
+    Vector<QueuedEventChunk>                          m_eventChunkQueue;
     EventServerSession*                               m_pActiveSession;
     uint64                                            m_nextTrimTime;
 };
@@ -172,6 +172,14 @@ public:
     // This function should only be called during the GetPipelineCodeObjects() callback.
     void AddPipeline(const PipelineRecord& pipeline);
 
+    // Drivers call this function to add code objects to the list being sent to the consumer without copying them.
+    // This is preferable for large code objects that the Driver keeps around anyway, like the ones in a pipeline cache.
+    // The code object must stay valid and unchanged until `pfnRelease` is called with `pUserData`. This happens once
+    // the consumer has received it, so it's usually after the GetPipelineCodeObjects() callback returns and it may be
+    // on another thread. `pfnRelease` is called exactly once and may be `nullptr`.
+    // This function should only be called during the GetPipelineCodeObjects() callback.
+    void AddPipelineByReference(const PipelineRecord& pipeline, ReleaseBytesCb pfnRelease, void* pUserData);
+
     // Overview:
     //      Clients provide an implementation of this function if they wish to support queries for
     //      an index of available pipelines.
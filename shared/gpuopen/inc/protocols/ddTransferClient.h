@@ -81,6 +81,16 @@ namespace DevDriver
         private:
             void ResetState() override;
 
+            // Tries to map the shared buffer offered by a TransferBulkHeader and tells the server whether it can be
+            // used. Returns Unavailable if the server must fall back to a regular transfer.
+            Result AcceptBulkTransfer(const TransferBulkHeader& header);
+
+            // Reads data from the mapped buffer of a bulk pull transfer.
+            Result ReadBulkTransferData(uint8* pDstBuffer, size_t bufferSize, size_t* pBytesRead);
+
+            // Unmaps the buffer of a bulk pull transfer if there is one.
+            void ReleaseBulkTransfer();
+
             // Helper method to send a payload, handling backwards compatibility and retrying.
             Result SendTransferPayload(const SizedPayloadContainer& container,
                                        uint32                       timeoutInMs = kDefaultCommunicationTimeoutInMs,
@@ -111,6 +121,11 @@ namespace DevDriver
                 size_t dataChunkSizeInBytes;
                 size_t dataChunkBytesTransfered;
                 SizedPayloadContainer scratchPayload;
+
+                // Only used by bulk pull transfers, pBulkData is the client's mapping of the server's buffer.
+                const uint8* pBulkData;
+                size_t       bulkDataSize;
+                size_t       bulkBytesRead;
             };
 
             ClientTransferContext m_transferContext;
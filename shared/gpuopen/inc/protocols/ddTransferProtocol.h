@@ -40,7 +40,7 @@
 ***********************************************************************************************************************
 */
 
-#define TRANSFER_PROTOCOL_VERSION 2
+#define TRANSFER_PROTOCOL_VERSION 3
 
 #define TRANSFER_PROTOCOL_MINIMUM_VERSION 1
 
@@ -48,11 +48,13 @@
 ***********************************************************************************************************************
 *| Version | Change Description                                                                                       |
 *| ------- | ---------------------------------------------------------------------------------------------------------|
+*|  3.0    | Add bulk pull transfers through a shared memory buffer for clients on the same machine                      |
 *|  2.0    | Refactor for variably sized messages + push transfers                                                    |
 *|  1.0    | Initial version                                                                                          |
 ***********************************************************************************************************************
 */
 
+#define TRANSFER_BULK_VERSION 3
 #define TRANSFER_REFACTOR_VERSION 2
 #define TRANSFER_INITIAL_VERSION 1
 
@@ -70,6 +72,7 @@ namespace DevDriver
             TransferDataChunk,
             TransferDataSentinel,
             TransferStatus,
+            TransferBulkHeader,
             Count,
         };
 
@@ -84,6 +87,18 @@ namespace DevDriver
         //        The compiler pads out TransferMessage to 4 bytes when it's included in the payload struct.
         DD_STATIC_CONST size_t kMaxTransferDataChunkSize = (kMaxPayloadSizeInBytes - sizeof(uint32));
 
+        // Pull transfers of at least this many bytes are offered as a bulk transfer on sessions that support it.
+        // Smaller blocks only take a handful of chunks, so they aren't worth the extra round trip.
+        DD_STATIC_CONST size_t kMinBulkTransferSizeInBytes = (64 * 1024);
+
+        // Pull transfers larger than this always use the chunked path. The server copies the whole block into the
+        // shared buffer on the session thread, which briefly doubles the memory held for the block, so the copy is
+        // kept to a size that neither stalls the session nor puts much pressure on shared memory.
+        DD_STATIC_CONST size_t kMaxBulkTransferSizeInBytes = (32 * 1024 * 1024);
+
+        // Maximum length of the name of a bulk transfer buffer, including the null terminator.
+        DD_STATIC_CONST size_t kMaxBulkTransferNameSize = 64;
+
         ///////////////////////
         // Transfer Types
         typedef uint32 BlockId;
@@ -198,5 +213,26 @@ namespace DevDriver
         };
 
         DD_CHECK_SIZE(TransferStatus, 8);
+
+        // Sent by the server instead of a TransferDataHeaderV2 when it has placed the block's data in a named shared
+        // buffer. The client replies with a TransferStatus: Success once it has mapped and verified the buffer, in
+        // which case the transfer is complete, or any other result to fall back to a regular chunked transfer.
+        DD_NETWORK_STRUCT(TransferBulkHeader, 4)
+        {
+            TransferMessage command;
+            uint32          sizeInBytes;
+            uint32          crc32;
+            char            name[kMaxBulkTransferNameSize];
+
+            TransferBulkHeader(uint32 size, uint32 crc, const char* pName)
+                : command(TransferMessage::TransferBulkHeader)
+                , sizeInBytes(size)
+                , crc32(crc)
+            {
+                Platform::Strncpy(name, pName);
+            }
+        };
+
+        DD_CHECK_SIZE(TransferBulkHeader, 76);
     }
 }
@@ -70,12 +70,14 @@ namespace DevDriver
         };
 
         typedef uint8 SessionVersion;
+        // Session protocol 3 lets acks carry a SelectiveAckPayload describing messages received out of order
+        DD_STATIC_CONST SessionVersion kSessionProtocolSelectiveAckVersion = 3;
         // Session protocol 2 lets session servers return session version as part of the synack
         DD_STATIC_CONST SessionVersion kSessionProtocolVersionSynAckVersion = 2;
         // Session protocol 1 lets session clients specify a max range supported as part of the syn
         DD_STATIC_CONST SessionVersion kSessionProtocolRangeVersion = 1;
-        // current version is 2
-        DD_STATIC_CONST SessionVersion kSessionProtocolVersion = kSessionProtocolVersionSynAckVersion;
+        // current version is 3
+        DD_STATIC_CONST SessionVersion kSessionProtocolVersion = kSessionProtocolSelectiveAckVersion;
         // not mentioned is session version 0. It only supported min version in SynAck, servers reporting it cannot
         // cleanly terminate in response to a Fin packet.
 
@@ -123,6 +125,15 @@ namespace DevDriver
         };
 
         DD_CHECK_SIZE(SynAckPayload, 16);
+
+        // Optional payload of an Ack message. Bit N is set if the receiver already holds the message that follows the
+        // acknowledged sequence number by N + 2, so the sender only needs to retransmit the messages that are missing.
+        DD_NETWORK_STRUCT(SelectiveAckPayload, 8)
+        {
+            uint64 receivedMask;
+        };
+
+        DD_CHECK_SIZE(SelectiveAckPayload, 8);
     }
 
     namespace ClientManagementProtocol
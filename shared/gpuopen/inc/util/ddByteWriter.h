@@ -47,18 +47,29 @@ namespace DevDriver
         // `pUserData` may be `nullptr`.
         typedef Result(*WriteBytesCb)(void* pUserData, const void* pBytes, size_t numBytes);
 
+        // A Callback to reference bytes without copying them, see `IByteWriter::WriteBytesByReference()`.
+        // The callback takes over the responsibility of calling `pfnRelease`, even when it fails.
+        typedef Result(*WriteBytesByReferenceCb)(void*          pUserData,
+                                                 const void*    pBytes,
+                                                 size_t         numBytes,
+                                                 ReleaseBytesCb pfnRelease,
+                                                 void*          pReleaseUserData);
+
         // Write bytes into a Vector<uint8>
         explicit ByteWriter(Vector<uint8>* pBuff)
             : m_pUserData(pBuff),
               m_pfnWriter(WriteBytesViaVectorCb),
+              m_pfnReferenceWriter(nullptr),
               m_lastResult(Result::Success)
         {}
 
         // Constructs a `ByteWriter` with a callback and its expected user data pointer.
         // `pUserData` may be `nullptr`, if your callback doesn't use it.
-        explicit ByteWriter(void* pUserData, WriteBytesCb callback)
+        // `referenceCallback` is optional. Without it, bytes written by reference are copied through `callback`.
+        explicit ByteWriter(void* pUserData, WriteBytesCb callback, WriteBytesByReferenceCb referenceCallback = nullptr)
             : m_pUserData(pUserData),
               m_pfnWriter(callback),
+              m_pfnReferenceWriter(referenceCallback),
               m_lastResult(Result::Success)
         {}
 
@@ -96,6 +107,22 @@ namespace DevDriver
             }
         }
 
+        // Write bytes without copying them, if the writer was given a callback for it
+        void WriteBytesByReference(const void*    pBytes,
+                                   size_t         numBytes,
+                                   ReleaseBytesCb pfnRelease,
+                                   void*          pReleaseUserData) override
+        {
+            if ((m_pfnReferenceWriter != nullptr) && CanWrite() && (pBytes != nullptr))
+            {
+                m_lastResult = (m_pfnReferenceWriter)(m_pUserData, pBytes, numBytes, pfnRelease, pReleaseUserData);
+            }
+            else
+            {
+                IByteWriter::WriteBytesByReference(pBytes, numBytes, pfnRelease, pReleaseUserData);
+            }
+        }
+
     private:
         // If the writer's callback returns an error, it saves that error and predicates all of its write functions.
         // This is called before every invocation of the callback.
@@ -110,6 +137,9 @@ namespace DevDriver
         // The callback to write bytes. This is never changed after initialization.
         WriteBytesCb const m_pfnWriter;
 
+        // The optional callback to reference bytes. This is never changed after initialization.
+        WriteBytesByReferenceCb const m_pfnReferenceWriter;
+
         // The last result generated.
         Result m_lastResult;
 
@@ -67,21 +67,23 @@ typedef struct RmtFileHeader
 /// An enumeration of all chunk types used in the file format.
 typedef enum RmtFileChunkType
 {
-    RMT_FILE_CHUNK_TYPE_ASIC_INFO     = 0,  ///< A chunk that encodes info about the ASIC on which the RMT file
-                                            ///  was generated
-    RMT_FILE_CHUNK_TYPE_API_INFO      = 1,  ///< A chunk that encodes info about hte API that the application
-                                            ///  generating the RMT file was using.
-    RMT_FILE_CHUNK_TYPE_SYSTEM_INFO   = 2,  ///< A chunk containing the description of the system on which the trace
-                                            ///  was made.
-    RMT_FILE_CHUNK_TYPE_RMT_DATA      = 3,  ///< A chunk containing the RMT data.
-    RMT_FILE_CHUNK_TYPE_SEGMENT_INFO  = 4,  ///< A chunk containing segment information for the main process.
-    RMT_FILE_CHUNK_TYPE_PROCESS_INFO  = 5,  ///< A chunk containing process state information at the start of the
-                                            ///  RMT trace.
-    RMT_FILE_CHUNK_TYPE_SNAPSHOT_INFO = 6,  ///< A chunk containing information about a snapshot.
-    RMT_FILE_CHUNK_TYPE_ADAPTER_INFO  = 7,  ///< A chunk containing information about the adapter.
+    RMT_FILE_CHUNK_TYPE_ASIC_INFO       = 0,  ///< A chunk that encodes info about the ASIC on which the RMT file
+                                              ///  was generated
+    RMT_FILE_CHUNK_TYPE_API_INFO        = 1,  ///< A chunk that encodes info about hte API that the application
+                                              ///  generating the RMT file was using.
+    RMT_FILE_CHUNK_TYPE_SYSTEM_INFO     = 2,  ///< A chunk containing the description of the system on which the trace
+                                              ///  was made.
+    RMT_FILE_CHUNK_TYPE_RMT_DATA        = 3,  ///< A chunk containing the RMT data.
+    RMT_FILE_CHUNK_TYPE_SEGMENT_INFO    = 4,  ///< A chunk containing segment information for the main process.
+    RMT_FILE_CHUNK_TYPE_PROCESS_INFO    = 5,  ///< A chunk containing process state information at the start of the
+                                              ///  RMT trace.
+    RMT_FILE_CHUNK_TYPE_SNAPSHOT_INFO   = 6,  ///< A chunk containing information about a snapshot.
+    RMT_FILE_CHUNK_TYPE_ADAPTER_INFO    = 7,  ///< A chunk containing information about the adapter.
+    RMT_FILE_CHUNK_TYPE_RMT_DATA_PACKED = 8,  ///< A chunk containing RMT data in the packed encoding from
+                                              ///  rmtTokenPacker.h. It has the same layout as an RMT_DATA chunk.
 
     // NOTE: Add new chunks above this.
-    RMT_FILE_CHUNK_TYPE_COUNT               ///< The number of different chunk types.
+    RMT_FILE_CHUNK_TYPE_COUNT                 ///< The number of different chunk types.
 } RmtFileChunkType;
 
 /// An enumeration of flags about the file header.
@@ -0,0 +1,120 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2020 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+/**
+***********************************************************************************************************************
+* @file  rmtTokenPacker.h
+* @brief Compact encoding for RMT token data
+***********************************************************************************************************************
+*/
+
+#pragma once
+
+#include <ddPlatform.h>
+#include <util/vector.h>
+
+namespace DevDriver
+{
+
+// Packed RMT data is a stream of records, each of which expands back into the exact bytes it was packed from:
+//  - TIMESTAMP and TIME_DELTA tokens are stored as is.
+//  - Tokens that carry virtual addresses or resource ids are stored as their header byte followed by varints. Addresses
+//    and resource ids are stored as the difference from the previous one in the stream and every other field of the
+//    token is combined into a single value.
+//  - Anything else, like resource descriptions, is stored as a literal. Literals have their zero bytes removed and
+//    small literals are kept in a dictionary so repeated ones can be stored as a reference to the earlier copy.
+// Literals and references start with a token header that uses a reserved RMT token type, so records can always be told
+// apart by their first byte.
+//
+// Packing is stateful, so a packed stream has to be expanded from the start of the stream it was packed in.
+
+// Number of literals that are remembered for deduplication
+DD_STATIC_CONST uint32 kRmtPackedDictionarySize = 64;
+
+// Range of literal sizes that are remembered for deduplication
+DD_STATIC_CONST size_t kRmtPackedMinDictionaryEntrySize = 8;
+DD_STATIC_CONST size_t kRmtPackedMaxDictionaryEntrySize = 64;
+
+// State shared by the packer and the expander. Both sides update it identically as records go by.
+class RmtPackedStreamState
+{
+public:
+    RmtPackedStreamState() { Reset(); }
+
+    void Reset();
+
+protected:
+    struct DictionaryEntry
+    {
+        uint32 hash;
+        uint32 size;
+        uint8  data[kRmtPackedMaxDictionaryEntrySize];
+    };
+
+    // Returns true if a literal of this size is remembered in the dictionary
+    static bool IsDictionarySize(size_t size)
+    {
+        return ((size >= kRmtPackedMinDictionaryEntrySize) && (size <= kRmtPackedMaxDictionaryEntrySize));
+    }
+
+    static uint32 HashLiteral(const uint8* pData, size_t size);
+
+    void AddDictionaryEntry(const uint8* pData, size_t size);
+
+    uint64          m_lastVirtualAddress;
+    uint64          m_lastResourceId;
+    uint32          m_nextDictionaryEntry;
+    DictionaryEntry m_dictionary[kRmtPackedDictionarySize];
+};
+
+// Packs RMT token data
+class RmtTokenPacker : public RmtPackedStreamState
+{
+public:
+    // Returns the largest number of bytes Pack can produce for dataSize bytes of token data
+    static size_t CalculateMaxPackedSize(size_t dataSize) { return (2 * dataSize) + 16; }
+
+    // Packs a block of token data into pOutput, which must have room for CalculateMaxPackedSize(dataSize) bytes.
+    // The block should begin at a token boundary. Returns the number of bytes written.
+    size_t Pack(const void* pData, size_t dataSize, void* pOutput);
+
+private:
+    size_t PackLiteral(const uint8* pData, size_t size, uint8* pOutput);
+};
+
+// Expands packed RMT token data back into standard RMT token data
+class RmtTokenExpander : public RmtPackedStreamState
+{
+public:
+    // Expands a block of packed data and appends it to pOutput
+    // Returns Error if the packed data is malformed.
+    Result Expand(const void* pPackedData, size_t packedDataSize, Vector<uint8>* pOutput);
+};
+
+// Converts RMT data containing packed data chunks into standard RMT data that tools can load
+// The input can either be a complete RMT file or a sequence of chunks like the ones returned by the PAL event service.
+// Packed data chunks are expanded into RMT_FILE_CHUNK_TYPE_RMT_DATA chunks and all other chunks are copied as is.
+Result ExpandPackedRmtData(const void* pData, size_t dataSize, Vector<uint8>* pOutput);
+
+} // namespace DevDriver
@@ -32,10 +32,12 @@
 #pragma once
 
 #include <ddPlatform.h>
+#include <ddUriInterface.h>
 #include <util/vector.h>
 
 #include <util/ddEventTimer.h>
 #include <util/rmtFileFormat.h>
+#include <util/rmtTokenPacker.h>
 #include <util/rmtTokens.h>
 
 namespace DevDriver
@@ -50,6 +52,17 @@ public:
     // Initializes the RMT file writer.
     void Init();
 
+    // Initializes the RMT file writer in streaming mode.
+    // Rather than keeping the whole file in memory until it's finalized, the writer hands its data to pStreamWriter
+    // whenever more than flushThreshold bytes are buffered. The active data chunk is closed and continued in a new
+    // chunk with the next chunk index, so data that has been streamed never needs to be revisited. The caller owns
+    // pStreamWriter and is responsible for ending it once the writer is finalized.
+    void InitStreaming(IByteWriter* pStreamWriter, size_t flushThreshold);
+
+    // Packs the token data of data chunks started after this call. Packed data chunks are written as
+    // RMT_FILE_CHUNK_TYPE_RMT_DATA_PACKED and must be converted with ExpandPackedRmtData before tools can load them.
+    void EnablePacking();
+
     // Resets the internal state of the RMT file writer
     void Reset();
 
@@ -79,6 +92,7 @@ public:
     void WriteTokenData(const RMT_TOKEN_DATA& tokenData);
     // Calculates the 4-bit delta for an RMT token, adding TIMESTAMP or TIME_DELTA tokens to the active data
     // chunk as required
+    // In streaming mode, this is also where the buffered data is flushed since it's the start of a new event.
     uint8 CalculateDelta();
     void EndDataChunk();
 
@@ -94,12 +108,20 @@ public:
 
     void Finalize();
 
+    // In streaming mode, these only cover data that hasn't been handed to the stream writer yet, which is nothing
+    // once the writer is finalized.
     const void* GetRmtData() const { return m_rmtFileData.IsEmpty() ? nullptr : m_rmtFileData.Data(); }
     size_t GetRmtDataSize() const { return m_rmtFileData.Size(); }
 
+    bool IsStreaming() const { return (m_pStreamWriter != nullptr); }
+    bool IsPacking() const { return m_isPacking; }
+
 private:
     void WriteBytes(const void* pData, size_t dataSize);
 
+    // Closes the active data chunk, hands all buffered data to the stream writer and begins the next data chunk
+    void StreamDataChunk();
+
     enum RmtWriterState
     {
         Uninitialized,
@@ -111,8 +133,15 @@ private:
     const AllocCb&  m_allocCb;
     RmtWriterState  m_state;
     size_t          m_dataChunkHeaderOffset;
+    uint64          m_dataChunkProcessId;
+    uint64          m_dataChunkThreadId;
+    uint32          m_dataChunkIndex;
     EventTimer      m_eventTimer;
     Vector<uint8>   m_rmtFileData;
+    IByteWriter*    m_pStreamWriter;
+    size_t          m_streamFlushThreshold;
+    bool            m_isPacking;
+    RmtTokenPacker  m_tokenPacker;
 
 };
 
@@ -213,6 +213,12 @@ namespace DevDriver
             *ppBlock = nullptr;
         }
 
+        // ============================================================================================================
+        ServerBlock::~ServerBlock()
+        {
+            ReleaseSegments();
+        }
+
         // ============================================================================================================
         void ServerBlock::Write(const void* pSrcBuffer, size_t numBytes)
         {
@@ -223,7 +229,7 @@ namespace DevDriver
             {
                 // Calculate how many bytes we have available.
                 const size_t blockCapacityInBytes = (m_chunks.Size() * kTransferChunkSizeInBytes);
-                const size_t bytesAvailable = (blockCapacityInBytes - m_blockDataSize);
+                const size_t bytesAvailable = (blockCapacityInBytes - m_copiedDataSize);
 
                 // Allocate more chunks if necessary.
                 if (bytesAvailable < numBytes)
@@ -235,13 +241,154 @@ namespace DevDriver
                 }
 
                 // Copy the new data into the block
-                uint8* pData = (reinterpret_cast<uint8*>(m_chunks.Data()) + m_blockDataSize);
+                uint8* pData = (reinterpret_cast<uint8*>(m_chunks.Data()) + m_copiedDataSize);
                 memcpy(pData, pSrcBuffer, numBytes);
                 m_crc32 = CRC32(pData, numBytes, m_crc32);
+
+                // Once the block references buffers, copied data has to be tracked as segments too. Consecutive writes
+                // extend the same segment.
+                if (m_segments.IsEmpty() == false)
+                {
+                    BlockSegment& lastSegment = m_segments[m_segments.Size() - 1];
+                    if (lastSegment.pData == nullptr)
+                    {
+                        lastSegment.size += numBytes;
+                    }
+                    else
+                    {
+                        const BlockSegment segment =
+                            { m_blockDataSize, numBytes, nullptr, m_copiedDataSize, nullptr, nullptr };
+                        m_segments.PushBack(segment);
+                    }
+                }
+
+                m_copiedDataSize += numBytes;
                 m_blockDataSize += numBytes;
             }
         }
 
+        // ============================================================================================================
+        void ServerBlock::WriteByReference(
+            const void*        pSrcBuffer,
+            size_t             numBytes,
+            ReleaseBlockDataCb pfnRelease,
+            void*              pUserData)
+        {
+            // Writes can only be performed on blocks that are not closed.
+            DD_ASSERT(m_isClosed == false);
+
+            bool isReferenced = false;
+
+            if (numBytes > 0)
+            {
+                // Everything written so far becomes the first segment
+                bool result = true;
+                if (m_segments.IsEmpty() && (m_blockDataSize > 0))
+                {
+                    const BlockSegment segment = { 0, m_copiedDataSize, nullptr, 0, nullptr, nullptr };
+                    result = m_segments.PushBack(segment);
+                }
+
+                const BlockSegment segment =
+                    { m_blockDataSize, numBytes, static_cast<const uint8*>(pSrcBuffer), 0, pfnRelease, pUserData };
+                if (result && m_segments.PushBack(segment))
+                {
+                    m_crc32 = CRC32(pSrcBuffer, numBytes, m_crc32);
+                    m_blockDataSize += numBytes;
+                    isReferenced = true;
+                }
+                else
+                {
+                    // Fall back to copying the data if we can't keep track of the buffer
+                    Write(pSrcBuffer, numBytes);
+                }
+            }
+
+            if ((isReferenced == false) && (pfnRelease != nullptr))
+            {
+                pfnRelease(pUserData, pSrcBuffer, numBytes);
+            }
+        }
+
+        // ============================================================================================================
+        const uint8* ServerBlock::GetBlockDataAt(size_t offset, size_t* pContiguousSize) const
+        {
+            DD_ASSERT(offset < m_blockDataSize);
+            DD_ASSERT(pContiguousSize != nullptr);
+
+            const uint8* pChunkData = reinterpret_cast<const uint8*>(m_chunks.Data());
+            const uint8* pData      = nullptr;
+
+            if (IsContiguous())
+            {
+                pData            = (pChunkData + offset);
+                *pContiguousSize = (m_blockDataSize - offset);
+            }
+            else
+            {
+                // Find the last segment that starts at or before the offset
+                size_t first = 0;
+                size_t last  = (m_segments.Size() - 1);
+                while (first < last)
+                {
+                    const size_t middle = (first + ((last - first + 1) / 2));
+                    if (m_segments[middle].blockOffset <= offset)
+                    {
+                        first = middle;
+                    }
+                    else
+                    {
+                        last = (middle - 1);
+                    }
+                }
+
+                const BlockSegment& segment     = m_segments[first];
+                const size_t        innerOffset = (offset - segment.blockOffset);
+                DD_ASSERT(innerOffset < segment.size);
+
+                pData            = ((segment.pData != nullptr) ? segment.pData : (pChunkData + segment.copiedOffset)) +
+                                   innerOffset;
+                *pContiguousSize = (segment.size - innerOffset);
+            }
+
+            return pData;
+        }
+
+        // ============================================================================================================
+        void ServerBlock::CopyBlockData(size_t offset, size_t numBytes, void* pDstBuffer) const
+        {
+            DD_ASSERT((offset + numBytes) <= m_blockDataSize);
+
+            uint8* pDst = static_cast<uint8*>(pDstBuffer);
+            while (numBytes > 0)
+            {
+                size_t contiguousSize = 0;
+                const uint8* pSrc = GetBlockDataAt(offset, &contiguousSize);
+
+                const size_t bytesToCopy = Platform::Min(contiguousSize, numBytes);
+                memcpy(pDst, pSrc, bytesToCopy);
+
+                pDst     += bytesToCopy;
+                offset   += bytesToCopy;
+                numBytes -= bytesToCopy;
+            }
+        }
+
+        // ============================================================================================================
+        void ServerBlock::ReleaseSegments()
+        {
+            for (size_t segmentIndex = 0; segmentIndex < m_segments.Size(); ++segmentIndex)
+            {
+                const BlockSegment& segment = m_segments[segmentIndex];
+                if ((segment.pData != nullptr) && (segment.pfnRelease != nullptr))
+                {
+                    segment.pfnRelease(segment.pUserData, segment.pData, segment.size);
+                }
+            }
+
+            m_segments.Reset();
+        }
+
         // ============================================================================================================
         void ServerBlock::Close()
         {
@@ -253,8 +400,11 @@ namespace DevDriver
         // ============================================================================================================
         void ServerBlock::Reset()
         {
+            ReleaseSegments();
+
             m_isClosed = false;
             m_blockDataSize = 0;
+            m_copiedDataSize = 0;
             m_crc32 = 0;
         }
 
@@ -63,11 +63,30 @@ Result URIRequestContext::WriteBytes(void* pUserData, const void* pBytes, size_t
     return result;
 }
 
+// ========================================================================================================
+// ByteWriter Callback for bytes that the response block references instead of copying
+Result URIRequestContext::WriteBytesByReference(
+    void*          pUserData,
+    const void*    pBytes,
+    size_t         numBytes,
+    ReleaseBytesCb pfnRelease,
+    void*          pReleaseUserData)
+{
+    DD_ASSERT(pUserData != nullptr);
+    URIRequestContext& context = *static_cast<URIRequestContext*>(pUserData);
+
+    // The block owns the buffer from here on. It is released once the block is gone, which is after the client
+    // has finished pulling the response.
+    context.GetBlock()->WriteByReference(pBytes, numBytes, pfnRelease, pReleaseUserData);
+
+    return Result::Success;
+}
+
 // ========================================================================================================
 URIRequestContext::URIRequestContext()
     : m_postInfo(),
       m_contextState(ContextState::WriterSelection),
-      m_byteWriter(this, URIRequestContext::WriteBytes),
+      m_byteWriter(this, URIRequestContext::WriteBytes, URIRequestContext::WriteBytesByReference),
       m_textWriter(this, URIRequestContext::WriteBytes)
     , m_jsonWriter(this, URIRequestContext::WriteBytes)
 {
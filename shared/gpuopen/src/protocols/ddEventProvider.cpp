@@ -52,6 +52,56 @@ size_t CalculateWorstCaseSize(size_t eventDataSize)
     return bytesRequired;
 }
 
+// Returns a small non-zero id that's unique to the calling thread
+// This is only used to match threads up with their event streams.
+static uint32 GetThreadStreamId()
+{
+    static Platform::Atomic s_nextThreadStreamId = 0;
+    static thread_local uint32 t_threadStreamId  = 0;
+
+    if (t_threadStreamId == 0)
+    {
+        t_threadStreamId = static_cast<uint32>(Platform::AtomicIncrement(&s_nextThreadStreamId));
+    }
+
+    return t_threadStreamId;
+}
+
+EncodedEventData::~EncodedEventData()
+{
+    if (m_pHeapData != nullptr)
+    {
+        DD_FREE(m_pHeapData, m_allocCb);
+    }
+}
+
+Result EncodedEventData::Encode(EncodeEventDataFunc pfnEncode, void* pUserdata, const EventTimestamp& timestamp)
+{
+    DD_ASSERT((pfnEncode != nullptr) && (m_pHeapData == nullptr));
+
+    size_t requiredSize = 0;
+    Result result       = pfnEncode(pUserdata, timestamp, m_scratch, sizeof(m_scratch), &requiredSize);
+
+    // The payload didn't fit, so encode it again into a buffer of the size that was asked for
+    if ((result == Result::InsufficientMemory) && (requiredSize > sizeof(m_scratch)))
+    {
+        m_pHeapData = DD_MALLOC(requiredSize, alignof(uint64), m_allocCb);
+
+        if (m_pHeapData != nullptr)
+        {
+            const size_t bufferSize = requiredSize;
+
+            result = pfnEncode(pUserdata, timestamp, m_pHeapData, bufferSize, &requiredSize);
+
+            DD_ASSERT((result != Result::Success) || (requiredSize <= bufferSize));
+        }
+    }
+
+    m_dataSize = (result == Result::Success) ? requiredSize : 0;
+
+    return result;
+}
+
 BaseEventProvider::BaseEventProvider(const AllocCb& allocCb, uint32 numEvents, uint32 flushFrequencyInMs)
     : m_allocCb(allocCb)
     , m_pServer(nullptr)
@@ -59,14 +109,30 @@ BaseEventProvider::BaseEventProvider(const AllocCb& allocCb, uint32 numEvents, u
     , m_isEnabled(false)
     , m_flushFrequencyInMs(flushFrequencyInMs)
     , m_eventDataIndex(0)
-    , m_nextFlushTime(0)
-    , m_eventChunks(allocCb)
+    , m_sharedStream(allocCb)
+    , m_encodedStream(allocCb)
 {
     DD_UNHANDLED_RESULT(m_eventState.Resize(numEvents));
+
+    // Thread streams that fail to allocate are skipped, their threads fall back to the shared stream instead.
+    for (uint32 streamIndex = 0; streamIndex < kMaxThreadEventStreams; ++streamIndex)
+    {
+        m_pThreadStreams[streamIndex] = DD_NEW(EventStream, m_allocCb)(m_allocCb);
+    }
 }
 
 BaseEventProvider::~BaseEventProvider()
 {
+    for (uint32 streamIndex = 0; streamIndex < kMaxThreadEventStreams; ++streamIndex)
+    {
+        if (m_pThreadStreams[streamIndex] != nullptr)
+        {
+            // Any remaining chunks should have been flushed when the provider was unregistered
+            DD_ASSERT(m_pThreadStreams[streamIndex]->eventChunks.IsEmpty());
+
+            DD_DELETE(m_pThreadStreams[streamIndex], m_allocCb);
+        }
+    }
 }
 
 Result BaseEventProvider::QueryEventWriteStatus(uint32 eventId) const
@@ -84,12 +150,69 @@ Result BaseEventProvider::QueryEventWriteStatus(uint32 eventId) const
 }
 
 Result BaseEventProvider::WriteEventWithHeader(uint32 eventId, const void* pHeaderData, size_t headerSize, const void* pEventData, size_t eventDataSize)
+{
+    return WriteEventInternal(eventId, pHeaderData, headerSize, pEventData, eventDataSize, nullptr, nullptr);
+}
+
+Result BaseEventProvider::WriteEncodedEvent(uint32 eventId, EncodeEventDataFunc pfnEncode, void* pUserdata)
+{
+    DD_ASSERT(pfnEncode != nullptr);
+
+    return WriteEventInternal(eventId, nullptr, 0, nullptr, 0, pfnEncode, pUserdata);
+}
+
+Result BaseEventProvider::WriteEventInternal(
+    uint32              eventId,
+    const void*         pHeaderData,
+    size_t              headerSize,
+    const void*         pEventData,
+    size_t              eventDataSize,
+    EncodeEventDataFunc pfnEncode,
+    void*               pUserdata)
 {
     Result result = QueryEventWriteStatus(eventId);
 
     if (result == Result::Success)
     {
-        m_chunkMutex.Lock();
+        EventStream* pStream = nullptr;
+
+        if (pfnEncode != nullptr)
+        {
+            pStream = &m_encodedStream;
+            pStream->lock.Lock();
+        }
+        else
+        {
+            pStream = AcquireEventStream();
+        }
+
+        // The stream's provider token has to come before the event's timestamp since it restarts the stream's timer
+        if (pStream->eventChunks.IsEmpty())
+        {
+            result = BeginEventStream(pStream);
+
+            // An encoded payload only sees its own timestamp, so the first one in a stream needs a full timestamp
+            // rather than a delta from the provider token that it knows nothing about.
+            if (pfnEncode != nullptr)
+            {
+                pStream->eventTimer.Reset();
+            }
+        }
+
+        EventTimestamp timestamp = {};
+        if (result == Result::Success)
+        {
+            timestamp = pStream->eventTimer.CreateTimestamp();
+        }
+
+        // Encoded events are written into a temporary buffer first since we don't know their size up front
+        EncodedEventData encodedData(m_allocCb);
+        if ((result == Result::Success) && (pfnEncode != nullptr))
+        {
+            result        = encodedData.Encode(pfnEncode, pUserdata, timestamp);
+            pEventData    = encodedData.Data();
+            eventDataSize = encodedData.Size();
+        }
 
         const size_t totalEventSize = (headerSize + eventDataSize);
 
@@ -97,7 +220,14 @@ Result BaseEventProvider::WriteEventWithHeader(uint32 eventId, const void* pHead
 
         // Attempt to allocate as many event chunks as we require from the server and write the data into them
         Vector<EventChunk*> chunks(m_allocCb);
-        result = AcquireEventChunks(requiredSize, &chunks);
+        if (result == Result::Success)
+        {
+            result = AcquireEventChunks(pStream, requiredSize, &chunks);
+        }
+
+        // Increment the event data index value every time we attempt to write a new event.
+        // This value should be incremented even if we fail to write the event data to a chunk.
+        const uint32 eventDataIndex = static_cast<uint32>(Platform::AtomicIncrement(&m_eventDataIndex) - 1);
 
         if (result == Result::Success)
         {
@@ -107,7 +237,7 @@ Result BaseEventProvider::WriteEventWithHeader(uint32 eventId, const void* pHead
             uint8 smallDelta = 0;
             if (result == Result::Success)
             {
-                result = GenerateEventTimestamp(&bufferView, &smallDelta);
+                result = WriteEventTimestamp(&bufferView, timestamp, &smallDelta);
             }
 
             if (result == Result::Success)
@@ -115,7 +245,7 @@ Result BaseEventProvider::WriteEventWithHeader(uint32 eventId, const void* pHead
                 result = bufferView.WriteEventDataToken(
                     smallDelta,
                     eventId,
-                    m_eventDataIndex,
+                    eventDataIndex,
                     totalEventSize);
             }
 
@@ -136,14 +266,16 @@ Result BaseEventProvider::WriteEventWithHeader(uint32 eventId, const void* pHead
         // under heavy event writing pressure.
         if (result == Result::Success)
         {
-            UpdateFlushTimer();
+            UpdateFlushTimer(pStream);
+        }
+        else if (timestamp.type != EventTimestampType::SmallDelta)
+        {
+            // The timer has moved past a timestamp that never made it into the stream. Force the next event to write
+            // a full timestamp so the stream's timing stays consistent.
+            pStream->eventTimer.Reset();
         }
 
-        // Increment the event data index value every time we attempt to write a new event.
-        // This value should be incremented even if we fail to write the event data to a chunk.
-        ++m_eventDataIndex;
-
-        m_chunkMutex.Unlock();
+        pStream->lock.Unlock();
 
         if (result != Result::Success)
         {
@@ -152,7 +284,7 @@ Result BaseEventProvider::WriteEventWithHeader(uint32 eventId, const void* pHead
                 GetId(),
                 ResultToString(result),
                 eventId,
-                static_cast<uint32>(eventDataSize));
+                static_cast<uint32>(totalEventSize));
         }
     }
 
@@ -167,48 +299,166 @@ ProviderDescriptionHeader BaseEventProvider::GetHeader() const
                                      m_isEnabled);
 }
 
+BaseEventProvider::EventStream* BaseEventProvider::AcquireEventStream()
+{
+    const uint32 threadId = GetThreadStreamId();
+
+    EventStream* pStream = nullptr;
+
+    // Look for a stream this thread already owns, starting at the slot it would have preferred
+    for (uint32 slotOffset = 0; slotOffset < kMaxThreadEventStreams; ++slotOffset)
+    {
+        EventStream* pThreadStream = m_pThreadStreams[(threadId + slotOffset) % kMaxThreadEventStreams];
+
+        if ((pThreadStream != nullptr) && (pThreadStream->ownerThreadId == threadId))
+        {
+            pStream = pThreadStream;
+            break;
+        }
+    }
+
+    if (pStream != nullptr)
+    {
+        pStream->lock.Lock();
+
+        // Update may have released the stream while it was idle before we locked it
+        if (pStream->ownerThreadId != threadId)
+        {
+            pStream->lock.Unlock();
+            pStream = nullptr;
+        }
+    }
+
+    if (pStream == nullptr)
+    {
+        // Claim an unused stream. Ownership only ever changes from unused to used while the stream mutex is held.
+        m_streamMutex.Lock();
+
+        for (uint32 slotOffset = 0; slotOffset < kMaxThreadEventStreams; ++slotOffset)
+        {
+            EventStream* pThreadStream = m_pThreadStreams[(threadId + slotOffset) % kMaxThreadEventStreams];
+
+            if ((pThreadStream != nullptr) && (pThreadStream->ownerThreadId == 0))
+            {
+                pThreadStream->lock.Lock();
+                pThreadStream->ownerThreadId = threadId;
+
+                pStream = pThreadStream;
+                break;
+            }
+        }
+
+        m_streamMutex.Unlock();
+    }
+
+    if (pStream == nullptr)
+    {
+        // Every thread stream is in use so this thread will have to share
+        pStream = &m_sharedStream;
+        pStream->lock.Lock();
+    }
+
+    return pStream;
+}
+
+BaseEventProvider::EventStream* BaseEventProvider::GetEventStream(uint32 streamIndex)
+{
+    DD_ASSERT(streamIndex < kNumEventStreams);
+
+    EventStream* pStream = nullptr;
+
+    if (streamIndex < kMaxThreadEventStreams)
+    {
+        pStream = m_pThreadStreams[streamIndex];
+    }
+    else if (streamIndex == kMaxThreadEventStreams)
+    {
+        pStream = &m_sharedStream;
+    }
+    else
+    {
+        pStream = &m_encodedStream;
+    }
+
+    return pStream;
+}
+
 void BaseEventProvider::Update()
 {
-    // Attempt to lock our chunk mutex so we can update the flush timer
+    // Attempt to lock each stream so we can update its flush timer
     // Under heavy event logging pressure, we may be unable to do this, but that's fine because the event logging
     // path has built-in flush logic so the data will get flushed eventually by the thread who refuses to give up
-    // the chunk lock.
-    if (m_chunkMutex.TryLock())
+    // the stream's lock.
+    for (uint32 streamIndex = 0; streamIndex < kNumEventStreams; ++streamIndex)
+    {
+        EventStream* pStream = GetEventStream(streamIndex);
+
+        if ((pStream != nullptr) && pStream->lock.TryLock())
+        {
+            // Threads that haven't written anything since the last flush give up their stream so it can be reused
+            const bool isIdle = pStream->eventChunks.IsEmpty();
+
+            UpdateFlushTimer(pStream);
+
+            if (isIdle)
+            {
+                pStream->ownerThreadId = 0;
+            }
+
+            pStream->lock.Unlock();
+        }
+    }
+}
+
+void BaseEventProvider::FlushEventStreams()
+{
+    for (uint32 streamIndex = 0; streamIndex < kNumEventStreams; ++streamIndex)
     {
-        UpdateFlushTimer();
+        EventStream* pStream = GetEventStream(streamIndex);
 
-        m_chunkMutex.Unlock();
+        if (pStream != nullptr)
+        {
+            pStream->lock.Lock();
+            Flush(pStream);
+            pStream->lock.Unlock();
+        }
     }
 }
 
-// This function must only be called while the chunk mutex is held!
-void BaseEventProvider::UpdateFlushTimer()
+// This function must only be called while the stream's lock is held!
+void BaseEventProvider::UpdateFlushTimer(EventStream* pStream)
 {
     const uint64 currentTime = Platform::GetCurrentTimeInMs();
 
     if (m_flushFrequencyInMs > 0)
     {
-        if (currentTime >= m_nextFlushTime)
+        if (currentTime >= pStream->nextFlushTime)
         {
-            m_nextFlushTime = currentTime + m_flushFrequencyInMs;
+            pStream->nextFlushTime = currentTime + m_flushFrequencyInMs;
 
-            Flush();
+            Flush(pStream);
         }
     }
 }
 
-// This function must only be called while the chunk mutex is held!
-void BaseEventProvider::Flush()
+// This function must only be called while the stream's lock is held!
+void BaseEventProvider::Flush(EventStream* pStream)
 {
-    if (m_eventChunks.IsEmpty() == false)
+    if (pStream->eventChunks.IsEmpty() == false)
     {
-        // Flush all chunks in our current stream into the event server's queue
-        m_pServer->EnqueueEventChunks(m_eventChunks.Size(), m_eventChunks.Data());
-        m_eventChunks.Reset();
+        // Flush all chunks in the stream into the event server's queue
+        // The server uses the stream's start time to order it against the streams of other threads.
+        m_pServer->EnqueueEventChunks(pStream->eventChunks.Size(),
+                                      pStream->eventChunks.Data(),
+                                      pStream->startTimestamp);
+        pStream->eventChunks.Reset();
     }
 }
 
-Result BaseEventProvider::AcquireEventChunks(size_t numBytesRequired, Vector<EventChunk*>* pChunks)
+Result BaseEventProvider::AcquireEventChunks(
+    EventStream*         pStream,
+    size_t               numBytesRequired,
+    Vector<EventChunk*>* pChunks)
 {
     // We should always start with a valid, empty vector.
     DD_ASSERT(pChunks != nullptr);
@@ -218,25 +468,18 @@ Result BaseEventProvider::AcquireEventChunks(size_t numBytesRequired, Vector<Eve
 
     Result result = Result::Success;
 
-    bool hasExistingData = false;
-    EventChunk* pChunk = nullptr;
-
     // Acquire the current chunk
     // We may have to start a new stream if we have none in our internal buffer.
-    if (m_eventChunks.IsEmpty() == false)
-    {
-        // We have existing chunks, attempt to acquire the most recently used chunk.
-        pChunk = m_eventChunks[m_eventChunks.Size() - 1];
-        hasExistingData = true;
-    }
-    else
+    if (pStream->eventChunks.IsEmpty())
     {
-        // We have no existing chunks, begin a new stream
-        result = BeginEventStream(&pChunk);
+        result = BeginEventStream(pStream);
     }
 
+    EventChunk* pChunk = nullptr;
     if (result == Result::Success)
     {
+        // Acquire the most recently used chunk.
+        pChunk = pStream->eventChunks[pStream->eventChunks.Size() - 1];
         result = BoolToResult(chunks.PushBack(pChunk));
     }
 
@@ -247,7 +490,7 @@ Result BaseEventProvider::AcquireEventChunks(size_t numBytesRequired, Vector<Eve
         size_t bytesAllocated = pChunk->CalculateBytesRemaining();
         while (bytesAllocated < numBytesRequired)
         {
-            result = AllocateEventChunk(&pChunk);
+            result = AllocateEventChunk(pStream, &pChunk);
             if (result == Result::Success)
             {
                 result = BoolToResult(chunks.PushBack(pChunk));
@@ -258,7 +501,7 @@ Result BaseEventProvider::AcquireEventChunks(size_t numBytesRequired, Vector<Eve
                 else
                 {
                     // Free the event chunk if we fail to add it to our list
-                    FreeEventChunk(pChunk);
+                    FreeEventChunk(pStream, pChunk);
                 }
             }
 
@@ -266,12 +509,11 @@ Result BaseEventProvider::AcquireEventChunks(size_t numBytesRequired, Vector<Eve
             if (result != Result::Success)
             {
                 // Free all the chunks we allocated if we fail.
-                // In some cases, the first chunk may contained unrelated event data so we need to ensure that we don't
-                // free it in those cases.
-                const size_t firstAllocatedChunkIndex = (hasExistingData ? 1 : 0);
-                for (size_t chunkIndex = firstAllocatedChunkIndex; chunkIndex < chunks.Size(); ++chunkIndex)
+                // The first chunk always belongs to the stream and may contain unrelated event data, so we need to
+                // ensure that we don't free it.
+                for (size_t chunkIndex = 1; chunkIndex < chunks.Size(); ++chunkIndex)
                 {
-                    FreeEventChunk(chunks[chunkIndex]);
+                    FreeEventChunk(pStream, chunks[chunkIndex]);
                 }
                 chunks.Clear();
 
@@ -294,20 +536,18 @@ void BaseEventProvider::Register(EventServer* pServer)
 void BaseEventProvider::Unregister()
 {
     // Flush any remaining chunks before the provider is unregistered
-    m_chunkMutex.Lock();
-    Flush();
-    m_chunkMutex.Unlock();
+    FlushEventStreams();
 
     m_pServer = nullptr;
 }
 
-Result BaseEventProvider::AllocateEventChunk(EventChunk** ppChunk)
+Result BaseEventProvider::AllocateEventChunk(EventStream* pStream, EventChunk** ppChunk)
 {
     EventChunk* pChunk = nullptr;
     Result result = m_pServer->AllocateEventChunk(&pChunk);
     if (result == Result::Success)
     {
-        if (m_eventChunks.PushBack(pChunk) == false)
+        if (pStream->eventChunks.PushBack(pChunk) == false)
         {
             result = Result::InsufficientMemory;
             m_pServer->FreeEventChunk(pChunk);
@@ -321,64 +561,61 @@ Result BaseEventProvider::AllocateEventChunk(EventChunk** ppChunk)
     return result;
 }
 
-void BaseEventProvider::FreeEventChunk(EventChunk* pChunk)
+void BaseEventProvider::FreeEventChunk(EventStream* pStream, EventChunk* pChunk)
 {
-    m_eventChunks.Remove(pChunk);
+    pStream->eventChunks.Remove(pChunk);
     m_pServer->FreeEventChunk(pChunk);
 }
 
-Result BaseEventProvider::BeginEventStream(EventChunk** ppChunk)
+Result BaseEventProvider::BeginEventStream(EventStream* pStream)
 {
     // We should always have an empty chunk list if a new stream is being started
-    DD_ASSERT(m_eventChunks.IsEmpty());
+    DD_ASSERT(pStream->eventChunks.IsEmpty());
 
     EventChunk* pChunk = nullptr;
-    Result result = AllocateEventChunk(&pChunk);
+    Result result = AllocateEventChunk(pStream, &pChunk);
     if (result == Result::Success)
     {
-        result = WriteStreamPreamble(pChunk);
+        result = WriteStreamPreamble(pStream, pChunk);
 
         if (result != Result::Success)
         {
-            FreeEventChunk(pChunk);
-            pChunk = nullptr;
+            FreeEventChunk(pStream, pChunk);
         }
     }
 
-    if (result == Result::Success)
-    {
-        *ppChunk = pChunk;
-    }
-
     return result;
 }
 
-Result BaseEventProvider::WriteStreamPreamble(EventChunk* pChunk)
+Result BaseEventProvider::WriteStreamPreamble(EventStream* pStream, EventChunk* pChunk)
 {
     // Write the stream preamble data
     // This only needs to be included once per provider event stream
 
     // Reset the timer since we're starting a new stream and generate a timestamp.
-    m_eventTimer.Reset();
-    const EventTimestamp timestamp = m_eventTimer.CreateTimestamp();
+    pStream->eventTimer.Reset();
+    const EventTimestamp timestamp = pStream->eventTimer.CreateTimestamp();
 
     // We should always get a full timestamp since we just reset the event timer above.
     DD_ASSERT(timestamp.type == EventTimestampType::Full);
 
+    pStream->startTimestamp = timestamp.full.timestamp;
+
     // Write the provider token
     EventChunkBufferView bufferView(&pChunk);
     return bufferView.WriteEventProviderToken(GetId(), timestamp.full.frequency, timestamp.full.timestamp);
 }
 
-Result BaseEventProvider::GenerateEventTimestamp(EventChunkBufferView* pBufferView, uint8* pSmallDelta)
+Result BaseEventProvider::WriteEventTimestamp(
+    EventChunkBufferView* pBufferView,
+    const EventTimestamp& timestamp,
+    uint8*                pSmallDelta)
 {
     DD_ASSERT(pBufferView != nullptr);
     DD_ASSERT(pSmallDelta != nullptr);
 
     Result result = Result::Success;
 
-    const EventTimestamp timestamp = m_eventTimer.CreateTimestamp();
-
     uint8 smallDelta = 0;
 
     if (timestamp.type == EventTimestampType::Full)
@@ -254,7 +254,7 @@ void EventServer::FreeEventChunk(EventChunk* pChunk)
     }
 }
 
-void EventServer::EnqueueEventChunks(size_t numChunks, EventChunk** ppChunks)
+void EventServer::EnqueueEventChunks(size_t numChunks, EventChunk** ppChunks, uint64 streamTimestamp)
 {
     DD_ASSERT(ppChunks != nullptr);
 
@@ -262,6 +262,25 @@ void EventServer::EnqueueEventChunks(size_t numChunks, EventChunk** ppChunks)
 
     Result result = Result::Success;
 
+    // Each provider thread flushes its own stream, so streams can arrive slightly out of order. Streams are kept
+    // whole and ordered by their start time by inserting the new stream in front of any queued streams that started
+    // after it. Only whole streams are moved since the session may already be partway through sending the oldest one.
+    size_t insertIndex = m_eventChunkQueue.Size();
+    for (size_t queueIndex = m_eventChunkQueue.Size(); queueIndex > 0; --queueIndex)
+    {
+        const QueuedEventChunk& queuedChunk = m_eventChunkQueue[queueIndex - 1];
+        if (queuedChunk.streamTimestamp <= streamTimestamp)
+        {
+            break;
+        }
+        else if (queuedChunk.isStreamStart)
+        {
+            insertIndex = (queueIndex - 1);
+        }
+    }
+
+    bool isStreamStart = true;
+
     for (size_t chunkIndex = 0; chunkIndex < numChunks; ++chunkIndex)
     {
         EventChunk* pChunk = ppChunks[chunkIndex];
@@ -271,7 +290,21 @@ void EventServer::EnqueueEventChunks(size_t numChunks, EventChunk** ppChunks)
         // we know they don't contain any useful data.
         if (pChunk->IsEmpty() == false)
         {
-            result = (m_eventChunkQueue.PushBack(pChunk) ? Result::Success : Result::InsufficientMemory);
+            const QueuedEventChunk queuedChunk = { pChunk, streamTimestamp, isStreamStart };
+            result = (m_eventChunkQueue.PushBack(queuedChunk) ? Result::Success : Result::InsufficientMemory);
+
+            if (result == Result::Success)
+            {
+                // Shift the chunk back into place behind the rest of its stream
+                for (size_t queueIndex = (m_eventChunkQueue.Size() - 1); queueIndex > insertIndex; --queueIndex)
+                {
+                    m_eventChunkQueue[queueIndex] = m_eventChunkQueue[queueIndex - 1];
+                }
+                m_eventChunkQueue[insertIndex] = queuedChunk;
+
+                ++insertIndex;
+                isStreamStart = false;
+            }
         }
         else
         {
@@ -292,13 +325,13 @@ EventChunk* EventServer::DequeueEventChunk()
 {
     Platform::LockGuard<Platform::AtomicLock> queueLock(m_eventQueueMutex);
 
-    EventChunk* pChunk = nullptr;
+    QueuedEventChunk queuedChunk = {};
 
     // Attempt to pop the next chunk from the queue.
     // It's okay if this fails since it just means we don't have any chunks available and we should return nullptr.
-    m_eventChunkQueue.PopFront(&pChunk);
+    m_eventChunkQueue.PopFront(&queuedChunk);
 
-    return pChunk;
+    return queuedChunk.pChunk;
 }
 
 Result EventServer::BuildQueryProvidersResponse(BlockId* pBlockId)
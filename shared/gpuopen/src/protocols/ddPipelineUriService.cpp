@@ -355,4 +355,29 @@ void PipelineUriService::AddPipeline(const PipelineRecord& record)
     }
 }
 
+void PipelineUriService::AddPipelineByReference(
+    const PipelineRecord& record,
+    ReleaseBytesCb        pfnRelease,
+    void*                 pUserData)
+{
+    DD_ASSERT(m_pWriter != nullptr);
+    m_pWriter->Write(record.header);
+    if ((record.header.size > 0) && (record.pBinary != nullptr))
+    {
+        if (record.header.size >= UINT32_MAX) {
+            // The protocol does not support sizes this large.
+            DD_ASSERT_ALWAYS();
+        }
+        m_pWriter->WriteBytesByReference(record.pBinary,
+                                         static_cast<uint32>(record.header.size),
+                                         pfnRelease,
+                                         pUserData);
+    }
+    else if (pfnRelease != nullptr)
+    {
+        // There's nothing to reference, but the caller still expects its buffer to be released
+        pfnRelease(pUserData, record.pBinary, 0);
+    }
+}
+
 } // DevDriver
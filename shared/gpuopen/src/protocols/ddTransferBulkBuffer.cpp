@@ -0,0 +1,188 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2019-2020 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+/**
+***********************************************************************************************************************
+* @file  ddTransferBulkBuffer.cpp
+* @brief Helpers for the named shared buffers used by bulk pull transfers
+***********************************************************************************************************************
+*/
+
+#include "ddTransferBulkBuffer.h"
+
+#if defined(DD_PLATFORM_LINUX_UM)
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+
+namespace DevDriver
+{
+    namespace TransferProtocol
+    {
+        // Used to keep buffer names unique when the same block is transferred to several clients at once.
+        static Platform::Atomic s_bulkBufferCount = 0;
+
+        // =============================================================================================================
+        Result CreateBulkTransferBuffer(
+            const ServerBlock& block,
+            char               (&name)[kMaxBulkTransferNameSize])
+        {
+            Result result = Result::Error;
+
+            const size_t sizeInBytes = block.GetBlockDataSize();
+
+            Platform::Snprintf(name,
+                               sizeof(name),
+                               "/dd-xfer-%u-%u-%u",
+                               static_cast<uint32>(Platform::GetProcessId()),
+                               block.GetBlockId(),
+                               static_cast<uint32>(Platform::AtomicIncrement(&s_bulkBufferCount)));
+
+            // The buffer is only readable by processes of the same user, like the local transports.
+            const int fd = shm_open(name, (O_RDWR | O_CREAT | O_EXCL), 0600);
+            if (fd != -1)
+            {
+                // Writing through a mapping of a file that tmpfs can't back raises SIGBUS, so the pages are
+                // allocated up front. If shared memory is full this fails and the caller uses a chunked transfer.
+                if (posix_fallocate(fd, 0, static_cast<off_t>(sizeInBytes)) == 0)
+                {
+                    void* pMemory = mmap(nullptr, sizeInBytes, PROT_WRITE, MAP_SHARED, fd, 0);
+                    if (pMemory != MAP_FAILED)
+                    {
+                        block.CopyBlockData(0, sizeInBytes, pMemory);
+                        munmap(pMemory, sizeInBytes);
+                        result = Result::Success;
+                    }
+                }
+
+                close(fd);
+
+                if (result != Result::Success)
+                {
+                    shm_unlink(name);
+                }
+            }
+
+            return result;
+        }
+
+        // =============================================================================================================
+        void DestroyBulkTransferBuffer(const char* pName)
+        {
+            shm_unlink(pName);
+        }
+
+        // =============================================================================================================
+        Result OpenBulkTransferBuffer(const char* pName, size_t sizeInBytes, BulkTransferMapping* pMapping)
+        {
+            DD_ASSERT(pMapping != nullptr);
+
+            Result result = Result::Unavailable;
+
+            // Bulk buffer names always start with a slash, anything else didn't come from CreateBulkTransferBuffer.
+            if ((pName[0] == '/') && (sizeInBytes > 0))
+            {
+                const int fd = shm_open(pName, O_RDONLY, 0);
+                if (fd != -1)
+                {
+                    struct stat fileInfo = {};
+                    if ((fstat(fd, &fileInfo) == 0) && (static_cast<size_t>(fileInfo.st_size) == sizeInBytes))
+                    {
+                        void* pMemory = mmap(nullptr, sizeInBytes, PROT_READ, MAP_SHARED, fd, 0);
+                        if (pMemory != MAP_FAILED)
+                        {
+                            pMapping->pData       = static_cast<const uint8*>(pMemory);
+                            pMapping->sizeInBytes = sizeInBytes;
+                            result                = Result::Success;
+                        }
+                    }
+
+                    close(fd);
+                }
+            }
+
+            return result;
+        }
+
+        // =============================================================================================================
+        void CloseBulkTransferBuffer(BulkTransferMapping* pMapping)
+        {
+            DD_ASSERT(pMapping != nullptr);
+
+            if (pMapping->pData != nullptr)
+            {
+                munmap(const_cast<uint8*>(pMapping->pData), pMapping->sizeInBytes);
+                pMapping->pData       = nullptr;
+                pMapping->sizeInBytes = 0;
+            }
+        }
+    }
+} // DevDriver
+
+#else
+
+namespace DevDriver
+{
+    namespace TransferProtocol
+    {
+        // =============================================================================================================
+        Result CreateBulkTransferBuffer(
+            const ServerBlock& block,
+            char               (&name)[kMaxBulkTransferNameSize])
+        {
+            DD_UNUSED(block);
+            name[0] = '\0';
+
+            return Result::Unavailable;
+        }
+
+        // =============================================================================================================
+        void DestroyBulkTransferBuffer(const char* pName)
+        {
+            DD_UNUSED(pName);
+        }
+
+        // =============================================================================================================
+        Result OpenBulkTransferBuffer(const char* pName, size_t sizeInBytes, BulkTransferMapping* pMapping)
+        {
+            DD_UNUSED(pName);
+            DD_UNUSED(sizeInBytes);
+            DD_UNUSED(pMapping);
+
+            return Result::Unavailable;
+        }
+
+        // =============================================================================================================
+        void CloseBulkTransferBuffer(BulkTransferMapping* pMapping)
+        {
+            DD_UNUSED(pMapping);
+        }
+    }
+} // DevDriver
+
+#endif
@@ -0,0 +1,65 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2019-2020 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+/**
+***********************************************************************************************************************
+* @file  ddTransferBulkBuffer.h
+* @brief Helpers for the named shared buffers used by bulk pull transfers
+***********************************************************************************************************************
+*/
+
+#pragma once
+
+#include "protocols/ddTransferProtocol.h"
+#include "ddTransferManager.h"
+
+namespace DevDriver
+{
+    namespace TransferProtocol
+    {
+        // A read only view of a bulk transfer buffer opened by the client.
+        struct BulkTransferMapping
+        {
+            const uint8* pData;
+            size_t       sizeInBytes;
+        };
+
+        // Creates a new named buffer holding a copy of the block's data and writes its name into pName. The buffer
+        // stays alive until DestroyBulkTransferBuffer is called with its name, even though nothing keeps it mapped.
+        // Returns Unavailable on platforms that don't support bulk transfers and Error if the buffer can't be fully
+        // allocated, e.g. because shared memory is full.
+        Result CreateBulkTransferBuffer(const ServerBlock& block,
+                                        char               (&name)[kMaxBulkTransferNameSize]);
+
+        // Removes the name of a buffer created with CreateBulkTransferBuffer. Existing mappings remain valid.
+        void DestroyBulkTransferBuffer(const char* pName);
+
+        // Maps an existing buffer into this process. This fails if the buffer doesn't exist, which is always the case
+        // when the server is on another machine, or if its size doesn't match the expected size.
+        Result OpenBulkTransferBuffer(const char* pName, size_t sizeInBytes, BulkTransferMapping* pMapping);
+
+        // Unmaps a buffer opened with OpenBulkTransferBuffer.
+        void CloseBulkTransferBuffer(BulkTransferMapping* pMapping);
+    }
+} // DevDriver
@@ -24,9 +24,10 @@
  **********************************************************************************************************************/
 
 #include "protocols/ddTransferClient.h"
+#include "ddTransferBulkBuffer.h"
 
 #define TRANSFER_CLIENT_MIN_VERSION 1
-#define TRANSFER_CLIENT_MAX_VERSION 2
+#define TRANSFER_CLIENT_MAX_VERSION 3
 
 namespace DevDriver
 {
@@ -45,6 +46,7 @@ namespace DevDriver
         // ============================================================================================================
         TransferClient::~TransferClient()
         {
+            ReleaseBulkTransfer();
         }
 
         // ============================================================================================================
@@ -60,8 +62,28 @@ namespace DevDriver
 
                 result = TransactTransferPayload(&container);
 
+                bool isBulkTransfer = false;
                 if ((result == Result::Success) &&
-                    (container.GetPayload<TransferHeader>().command == TransferMessage::TransferDataHeader))
+                    (container.GetPayload<TransferHeader>().command == TransferMessage::TransferBulkHeader))
+                {
+                    result = AcceptBulkTransfer(container.GetPayload<TransferBulkHeader>());
+                    if (result == Result::Success)
+                    {
+                        isBulkTransfer = true;
+                    }
+                    else if (result == Result::Unavailable)
+                    {
+                        // The server follows up with a regular transfer data header.
+                        result = ReceiveTransferPayload(&container);
+                    }
+                }
+
+                if (isBulkTransfer)
+                {
+                    *pTransferSizeInBytes = m_transferContext.bulkDataSize;
+                }
+                else if ((result == Result::Success) &&
+                         (container.GetPayload<TransferHeader>().command == TransferMessage::TransferDataHeader))
                 {
                     // We've successfully received the transfer data header. Check if the transfer request was successful.
                     if (m_pSession->GetVersion() >= TRANSFER_REFACTOR_VERSION)
@@ -118,8 +140,12 @@ namespace DevDriver
             {
                 result = Result::Success;
 
+                if (m_transferContext.pBulkData != nullptr)
+                {
+                    result = ReadBulkTransferData(pDstBuffer, bufferSize, pBytesRead);
+                }
                 // There is no remaining data to read
-                if ((m_transferContext.totalBytes == 0) &&
+                else if ((m_transferContext.totalBytes == 0) &&
                     (m_transferContext.dataChunkSizeInBytes == m_transferContext.dataChunkBytesTransfered))
                 {
                     result = Result::EndOfStream;
@@ -342,7 +368,16 @@ namespace DevDriver
             Result result = Result::Error;
 
             if ((m_transferContext.state == TransferState::TransferInProgress) &&
-                (m_transferContext.type == TransferType::Pull))
+                (m_transferContext.type == TransferType::Pull) &&
+                (m_transferContext.pBulkData != nullptr))
+            {
+                // The server finished with a bulk transfer as soon as we accepted it, there's nothing to abort there.
+                ReleaseBulkTransfer();
+                m_transferContext.state = TransferState::Idle;
+                result = Result::Success;
+            }
+            else if ((m_transferContext.state == TransferState::TransferInProgress) &&
+                     (m_transferContext.type == TransferType::Pull))
             {
                 SizedPayloadContainer container = {};
 
@@ -385,9 +420,100 @@ namespace DevDriver
         // ============================================================================================================
         void TransferClient::ResetState()
         {
+            ReleaseBulkTransfer();
             memset(&m_transferContext, 0, sizeof(m_transferContext));
         }
 
+        // ============================================================================================================
+        Result TransferClient::AcceptBulkTransfer(const TransferBulkHeader& header)
+        {
+            // Copy the name out first, the header may live in a container that gets reused below.
+            char name[kMaxBulkTransferNameSize];
+            Platform::Strncpy(name, header.name);
+
+            const uint32 sizeInBytes = header.sizeInBytes;
+            const uint32 crc32       = header.crc32;
+
+            BulkTransferMapping mapping = {};
+            Result result = OpenBulkTransferBuffer(name, sizeInBytes, &mapping);
+
+            // The buffer name is only unique per server machine, so make sure the data is what the server offered
+            // before accepting it.
+            if ((result == Result::Success) && (CRC32(mapping.pData, mapping.sizeInBytes, 0) != crc32))
+            {
+                CloseBulkTransferBuffer(&mapping);
+                result = Result::Unavailable;
+            }
+
+            SizedPayloadContainer container = {};
+            container.CreatePayload<TransferStatus>((result == Result::Success) ? Result::Success : Result::Unavailable);
+
+            if (SendTransferPayload(container) == Result::Success)
+            {
+                if (result == Result::Success)
+                {
+                    m_transferContext.state = TransferState::TransferInProgress;
+                    m_transferContext.type = TransferType::Pull;
+                    m_transferContext.totalBytes = 0;
+                    m_transferContext.crc32 = crc32;
+                    m_transferContext.dataChunkSizeInBytes = 0;
+                    m_transferContext.dataChunkBytesTransfered = 0;
+                    m_transferContext.pBulkData = mapping.pData;
+                    m_transferContext.bulkDataSize = mapping.sizeInBytes;
+                    m_transferContext.bulkBytesRead = 0;
+                }
+            }
+            else
+            {
+                CloseBulkTransferBuffer(&mapping);
+                result = Result::Error;
+            }
+
+            return result;
+        }
+
+        // ============================================================================================================
+        Result TransferClient::ReadBulkTransferData(uint8* pDstBuffer, size_t bufferSize, size_t* pBytesRead)
+        {
+            DD_ASSERT(m_transferContext.pBulkData != nullptr);
+
+            Result result = Result::Success;
+
+            const size_t bytesRemaining = (m_transferContext.bulkDataSize - m_transferContext.bulkBytesRead);
+            const size_t bytesToRead    = Platform::Min(bufferSize, bytesRemaining);
+            if (bytesToRead > 0)
+            {
+                memcpy(pDstBuffer, (m_transferContext.pBulkData + m_transferContext.bulkBytesRead), bytesToRead);
+                m_transferContext.bulkBytesRead += bytesToRead;
+            }
+
+            *pBytesRead = bytesToRead;
+
+            // Like chunked transfers, return end of stream along with the last of the data.
+            if (m_transferContext.bulkBytesRead == m_transferContext.bulkDataSize)
+            {
+                ReleaseBulkTransfer();
+                m_transferContext.state = TransferState::Idle;
+                result = Result::EndOfStream;
+            }
+
+            return result;
+        }
+
+        // ============================================================================================================
+        void TransferClient::ReleaseBulkTransfer()
+        {
+            if (m_transferContext.pBulkData != nullptr)
+            {
+                BulkTransferMapping mapping = { m_transferContext.pBulkData, m_transferContext.bulkDataSize };
+                CloseBulkTransferBuffer(&mapping);
+
+                m_transferContext.pBulkData = nullptr;
+                m_transferContext.bulkDataSize = 0;
+                m_transferContext.bulkBytesRead = 0;
+            }
+        }
+
         // ============================================================================================================
         // Helper method to send a payload, handling backwards compatibility and retrying.
         Result TransferClient::SendTransferPayload(
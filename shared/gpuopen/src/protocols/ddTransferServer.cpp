@@ -25,10 +25,11 @@
 
 #include "protocols/ddTransferServer.h"
 #include "ddTransferManager.h"
+#include "ddTransferBulkBuffer.h"
 #include "msgChannel.h"
 
 #define TRANSFER_SERVER_MIN_VERSION 1
-#define TRANSFER_SERVER_MAX_VERSION 2
+#define TRANSFER_SERVER_MAX_VERSION 3
 
 namespace DevDriver
 {
@@ -40,6 +41,8 @@ namespace DevDriver
             SendPayload,
             StartPullTransfer,
             ProcessPullTransfer,
+            StartBulkPullTransfer,
+            WaitForBulkPullReply,
             StartPushTransfer,
             ReceivePushTransferData,
         };
@@ -57,7 +60,9 @@ namespace DevDriver
                 , m_bytesTransferred(0)
                 , m_crc32(0)
                 , m_state(SessionState::Idle)
+                , m_hasBulkBuffer(false)
             {
+                m_bulkName[0] = '\0';
             }
 
             // ========================================================================================================
@@ -69,6 +74,9 @@ namespace DevDriver
                 {
                     m_pBlock->EndTransfer();
                 }
+
+                // The client never answered a bulk transfer header, don't leave the buffer behind.
+                DestroyBulkBuffer();
             }
 
             // Helper functions for working with SizedPayloadContainers and managing back-compat.
@@ -125,19 +133,36 @@ namespace DevDriver
                             m_totalBytes = pBlock->GetBlockDataSize();
                             m_bytesTransferred = 0;
                             m_crc32 = pBlock->GetCrc32();
-                            m_state = SessionState::StartPullTransfer;
 
                             const uint32 blockSizeInBytes = static_cast<uint32>(m_pBlock->GetBlockDataSize());
-                            if (m_pSession->GetVersion() >= TRANSFER_REFACTOR_VERSION)
+                            if ((m_pSession->GetVersion() >= TRANSFER_BULK_VERSION) &&
+                                (m_totalBytes >= kMinBulkTransferSizeInBytes) &&
+                                (m_totalBytes <= kMaxBulkTransferSizeInBytes) &&
+                                (CreateBulkTransferBuffer(*m_pBlock, m_bulkName) == Result::Success))
                             {
-                                m_scratchPayload.CreatePayload<TransferDataHeaderV2>(blockSizeInBytes);
+                                // Offer the data through a shared buffer. Clients on another machine can't open it
+                                // and will ask for a regular transfer instead.
+                                m_hasBulkBuffer = true;
+                                m_state = SessionState::StartBulkPullTransfer;
+                                m_scratchPayload.CreatePayload<TransferBulkHeader>(blockSizeInBytes,
+                                                                                   m_crc32,
+                                                                                   m_bulkName);
+                                SendBulkPullHeader();
                             }
                             else
                             {
-                                m_scratchPayload.CreatePayload<TransferDataHeader>(Result::Success, blockSizeInBytes);
+                                m_state = SessionState::StartPullTransfer;
+                                if (m_pSession->GetVersion() >= TRANSFER_REFACTOR_VERSION)
+                                {
+                                    m_scratchPayload.CreatePayload<TransferDataHeaderV2>(blockSizeInBytes);
+                                }
+                                else
+                                {
+                                    m_scratchPayload.CreatePayload<TransferDataHeader>(Result::Success, blockSizeInBytes);
+                                }
+
+                                SendPullTransferHeader();
                             }
-
-                            SendPullTransferHeader();
                         }
                         else
                         {
@@ -259,9 +284,10 @@ namespace DevDriver
                 {
                     while (m_bytesTransferred < m_totalBytes)
                     {
-                        const uint8* pData = (m_pBlock->GetBlockData() + m_bytesTransferred);
-                        const size_t bytesRemaining = (m_totalBytes - m_bytesTransferred);
-                        const size_t bytesToSend = Platform::Min(kMaxTransferDataChunkSize, bytesRemaining);
+                        // Blocks can reference several buffers, so only send what's contiguous
+                        size_t contiguousSize = 0;
+                        const uint8* pData = m_pBlock->GetBlockDataAt(m_bytesTransferred, &contiguousSize);
+                        const size_t bytesToSend = Platform::Min(kMaxTransferDataChunkSize, contiguousSize);
 
                         TransferDataChunk::WritePayload(pData, bytesToSend, &m_scratchPayload);
 
@@ -314,6 +340,62 @@ namespace DevDriver
                 }
             }
 
+            // ========================================================================================================
+            void SendBulkPullHeader()
+            {
+                DD_ASSERT(m_state == SessionState::StartBulkPullTransfer);
+                if (SendPayload(m_scratchPayload, kNoWait) == Result::Success)
+                {
+                    m_state = SessionState::WaitForBulkPullReply;
+                }
+            }
+
+            // ========================================================================================================
+            void ReceiveBulkPullReply()
+            {
+                DD_ASSERT(m_state == SessionState::WaitForBulkPullReply);
+
+                const Result result = ReceivePayload(&m_scratchPayload, kNoWait);
+                if (result == Result::Success)
+                {
+                    // Either way the client is done with the name, it keeps its own mapping if it opened the buffer.
+                    DestroyBulkBuffer();
+
+                    if (m_scratchPayload.GetPayload<TransferHeader>().command == TransferMessage::TransferStatus)
+                    {
+                        if (m_scratchPayload.GetPayload<TransferStatus>().result == Result::Success)
+                        {
+                            // The client has all of the data, so the transfer is complete and there's no sentinel.
+                            m_pBlock->EndTransfer();
+                            m_pBlock.Clear();
+                            m_state = SessionState::Idle;
+                        }
+                        else
+                        {
+                            // The client couldn't use the buffer, fall back to sending the data in chunks.
+                            m_scratchPayload.CreatePayload<TransferDataHeaderV2>(static_cast<uint32>(m_totalBytes));
+                            m_state = SessionState::StartPullTransfer;
+                            SendPullTransferHeader();
+                        }
+                    }
+                    else
+                    {
+                        SendSentinel(Result::Error);
+                        DD_WARN_REASON("Invalid response received");
+                    }
+                }
+            }
+
+            // ========================================================================================================
+            void DestroyBulkBuffer()
+            {
+                if (m_hasBulkBuffer)
+                {
+                    DestroyBulkTransferBuffer(m_bulkName);
+                    m_hasBulkBuffer = false;
+                }
+            }
+
             // ========================================================================================================
             void StartPushTransferSession()
             {
@@ -427,6 +509,18 @@ namespace DevDriver
                     break;
                 }
 
+                case SessionState::StartBulkPullTransfer:
+                {
+                    SendBulkPullHeader();
+                    break;
+                }
+
+                case SessionState::WaitForBulkPullReply:
+                {
+                    ReceiveBulkPullReply();
+                    break;
+                }
+
                 case SessionState::StartPushTransfer:
                 {
                     StartPushTransferSession();
@@ -462,6 +556,8 @@ namespace DevDriver
             size_t                     m_bytesTransferred;
             uint32                     m_crc32;
             SessionState               m_state;
+            bool                       m_hasBulkBuffer;
+            char                       m_bulkName[kMaxBulkTransferNameSize];
         };
 
         // =====================================================================================================================
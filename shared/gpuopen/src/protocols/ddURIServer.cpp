@@ -279,6 +279,14 @@ namespace DevDriver
 
                             if (result == Result::Success)
                             {
+                                // Let go of the previous response before starting a new one. The client has already
+                                // started pulling it by now and the transfer keeps the block alive until it's done.
+                                // Buffers the block references are released along with it.
+                                if (!m_pResponseBlock.IsNull())
+                                {
+                                    m_pTransferManager->CloseServerBlock(m_pResponseBlock);
+                                }
+
                                 m_pResponseBlock = m_pTransferManager->OpenServerBlock();
 
                                 if (m_pResponseBlock.IsNull())
@@ -65,6 +65,7 @@ namespace DevDriver
     DD_STATIC_CONST float kMinRetransmitDelay = 100.0f;
     DD_STATIC_CONST float kMaxRetransmitDelay = 2000.0f;
     DD_STATIC_CONST uint32 kMaxUnacknowledgedThreshold = 5;
+    DD_STATIC_CONST float kMinCongestionWindowSize = 2.0f;
 
     Session::Session(IMsgChannel* pMsgChannel, SessionType type, Protocol protocol) :
         m_pMsgChannel(pMsgChannel),
@@ -80,7 +81,9 @@ namespace DevDriver
         m_protocolVersion(0),
         m_minClientProtocolVersion(0),
         m_sessionVersion(kSessionProtocolVersion),
-        m_connectionEvent(false)
+        m_connectionEvent(false),
+        m_createTimeInMs(Platform::GetCurrentTimeInMs()),
+        m_statistics()
     {
     }
 
@@ -103,8 +106,13 @@ namespace DevDriver
         return result;
     }
 
-    bool Session::SendControlMessage(SessionMessage command, Sequence sequenceNumber)
+    bool Session::SendControlMessage(SessionMessage command,
+                                     Sequence       sequenceNumber,
+                                     uint32         payloadSizeInBytes,
+                                     const void*    pPayload)
     {
+        DD_ASSERT(payloadSizeInBytes <= kMaxPayloadSizeInBytes);
+
         MessageBuffer messageBuffer = {};
         messageBuffer.header.dstClientId = m_remoteClientId;
         messageBuffer.header.srcClientId = m_clientId;
@@ -112,9 +120,14 @@ namespace DevDriver
         messageBuffer.header.messageId = static_cast<MessageCode>(command);
         messageBuffer.header.sessionId = m_sessionId;
         messageBuffer.header.sequence = sequenceNumber;
-        messageBuffer.header.payloadSize = 0;
+        messageBuffer.header.payloadSize = payloadSizeInBytes;
         messageBuffer.header.windowSize = m_receiveWindow.currentAvailableSize;
 
+        if (payloadSizeInBytes > 0)
+        {
+            memcpy(&messageBuffer.payload[0], pPayload, payloadSizeInBytes);
+        }
+
         return SendOrClose(messageBuffer);
     }
 
@@ -128,7 +141,19 @@ namespace DevDriver
 
         DD_PRINT(LogLevel::Debug, "Acking sequence number %u", ackSequence);
 
-        return SendControlMessage(SessionMessage::Ack, ackSequence);
+        // Let the sender know about any messages we received past a missing one. The payload is left off if there
+        // aren't any.
+        SelectiveAckPayload payload = {};
+        if (m_sessionVersion >= kSessionProtocolSelectiveAckVersion)
+        {
+            payload.receivedMask = CalculateSelectiveAckMask();
+        }
+        const uint32 payloadSize = (payload.receivedMask != 0) ? sizeof(payload) : 0;
+
+        m_receiveWindow.selectiveAckGap = (payload.receivedMask != 0) ? seq : 0;
+        m_receiveWindow.unreportedCount = 0;
+
+        return SendControlMessage(SessionMessage::Ack, ackSequence, payloadSize, &payload);
     }
 
     Result Session::MarkMessagesAsAcknowledged(Sequence maxSequenceNumber)
@@ -153,11 +178,28 @@ namespace DevDriver
             m_sendWindow.valid[index] = false;
 
             // if we aren't in the middle of retransmit, feel free to use this as part of the round trip time
-            if (m_sendWindow.retransmitCount == 0)
+            // Messages that were selectively acknowledged earlier have been waiting on others, so they're skipped too.
+            if ((m_sendWindow.retransmitCount == 0) && (m_sendWindow.selectivelyAcked[index] == false))
             {
                 const uint64 elapsedTimeInMs = currentTime - m_sendWindow.initialTransmitTimeInMs[index];
                 currentAverage = (kAlpha * elapsedTimeInMs) + ((1.0f - kAlpha) * currentAverage);
             }
+            if (m_sendWindow.selectivelyAcked[index])
+            {
+                m_sendWindow.selectivelyAcked[index] = false;
+                m_sendWindow.selectivelyAckedCount--;
+            }
+
+            // Grow the congestion window by a message per acknowledged message during slow start, which doubles it
+            // every round trip, and by about one message per round trip after that.
+            if (m_sendWindow.congestionWindow < m_sendWindow.slowStartThreshold)
+            {
+                m_sendWindow.congestionWindow += 1.0f;
+            }
+            else
+            {
+                m_sendWindow.congestionWindow += (1.0f / m_sendWindow.congestionWindow);
+            }
 
             DD_ASSERT((m_sendWindow.nextSequence - seq) <= m_sendWindow.GetWindowSize());
 
@@ -176,7 +218,8 @@ namespace DevDriver
             m_sendWindow.retransmitCount = 0;
             m_sendWindow.nextUnacknowledgedSequence = seq;
             m_sendWindow.lastAckCount = 0;
-
+            m_sendWindow.congestionWindow = Min(m_sendWindow.congestionWindow,
+                                                static_cast<float>(m_sendWindow.GetWindowSize()));
         }
         else if (m_sendWindow.nextUnacknowledgedSequence == seq)
         {
@@ -188,7 +231,38 @@ namespace DevDriver
             // if we've passed the fast retransmit threshold we need to automatically start retransmitting data
             // we start at the first unacknowledged packet, and retransmit one additional packet for every duplicate we
             // receive
-            if (m_sendWindow.lastAckCount >= kFastRetransmitThreshold)
+            if ((m_sessionVersion < kSessionProtocolSelectiveAckVersion) &&
+                (m_sendWindow.lastAckCount == kFastRetransmitThreshold) &&
+                (m_sendWindow.nextUnacknowledgedSequence <= m_sendWindow.lastSentSequence))
+            {
+                // A message was lost, most likely because we're sending faster than the link can handle.
+                m_statistics.fastRetransmits++;
+                ReduceCongestionWindow(false);
+            }
+
+            if (m_sessionVersion >= kSessionProtocolSelectiveAckVersion)
+            {
+                // The receiver coalesces its acks while a message is missing, so the messages it reports past the gap
+                // count towards the fast retransmit threshold as well as the duplicate acks.
+                const bool lossDetected = (m_sendWindow.lastAckCount >= kFastRetransmitThreshold) ||
+                                          (m_sendWindow.selectivelyAckedCount >= kFastRetransmitThreshold);
+
+                // The receiver tells us exactly which messages it is missing, so each of them is retransmitted once
+                // instead of one message for every further duplicate ack. If a retransmitted message gets lost again,
+                // the regular retransmit timeout takes care of it.
+                if (lossDetected)
+                {
+                    // Nothing has been fast retransmitted for this gap yet, so this is a new loss.
+                    if (m_sendWindow.lastFastRetransmit < m_sendWindow.nextUnacknowledgedSequence)
+                    {
+                        m_statistics.fastRetransmits++;
+                        ReduceCongestionWindow(false);
+                    }
+
+                    RetransmitMissingMessages();
+                }
+            }
+            else if (m_sendWindow.lastAckCount >= kFastRetransmitThreshold)
             {
                 // calculate the nextSequence number for the packet to retransmit
                 const Sequence retransSeq = m_sendWindow.nextUnacknowledgedSequence +
@@ -207,12 +281,108 @@ namespace DevDriver
                     // If we successfully transmitted this we want to reset the transmit count so that regular
                     // retransmit doesn't take affect
                     m_sendWindow.retransmitCount = 0;
+                    m_statistics.messagesRetransmitted++;
                 }
             }
         }
         return result;
     }
 
+    // Records the messages the receiver reported in the selective ack payload of an ack message. These are not
+    // retransmitted anymore, but stay in the send window until the receiver acknowledges everything before them.
+    void Session::MarkMessagesAsSelectivelyAcknowledged(Sequence ackSequenceNumber, uint64 receivedMask)
+    {
+        LockGuard<AtomicLock> lock(m_sendWindow.lock);
+
+        for (uint32 bit = 0; (bit < 64) && ((receivedMask >> bit) != 0); ++bit)
+        {
+            const Sequence seq = (ackSequenceNumber + 2 + bit);
+            if (seq > m_sendWindow.lastSentSequence)
+            {
+                break;
+            }
+
+            const Sequence index = seq % m_sendWindow.GetWindowSize();
+            if (((receivedMask >> bit) & 1) &&
+                (seq >= m_sendWindow.nextUnacknowledgedSequence) &&
+                m_sendWindow.valid[index] &&
+                (m_sendWindow.sequence[index] == seq))
+            {
+                if (m_sendWindow.selectivelyAcked[index] == false)
+                {
+                    m_sendWindow.selectivelyAcked[index] = true;
+                    m_sendWindow.selectivelyAckedCount++;
+                }
+                m_sendWindow.highestSelectiveAck = Max(m_sendWindow.highestSelectiveAck, seq);
+            }
+        }
+    }
+
+    // Retransmits the unacknowledged messages the receiver doesn't have, which are the ones before the last message
+    // it selectively acknowledged. Without any selective acks this is only the first unacknowledged message. Messages
+    // that were already fast retransmitted are skipped, unless the receiver has since selectively acknowledged a
+    // message that was sent after them. Messages arrive in order, so that means the retransmitted ones were lost too.
+    // The send window lock must be held.
+    void Session::RetransmitMissingMessages()
+    {
+        const bool retransmitLost = (m_sendWindow.lastFastRetransmit >= m_sendWindow.nextUnacknowledgedSequence) &&
+                                    (m_sendWindow.highestSelectiveAck > m_sendWindow.fastRetransmitMark);
+
+        const Sequence firstMissingSequence = retransmitLost ? m_sendWindow.nextUnacknowledgedSequence
+                                                             : Max(m_sendWindow.nextUnacknowledgedSequence,
+                                                                   (m_sendWindow.lastFastRetransmit + 1));
+        const Sequence lastMissingSequence  = Min(Max(m_sendWindow.highestSelectiveAck,
+                                                      m_sendWindow.nextUnacknowledgedSequence),
+                                                  m_sendWindow.lastSentSequence);
+        const uint64 currentTime = Platform::GetCurrentTimeInMs();
+
+        Sequence seq = firstMissingSequence;
+        for (; seq <= lastMissingSequence; seq++)
+        {
+            const Sequence index = seq % m_sendWindow.GetWindowSize();
+            if (m_sendWindow.selectivelyAcked[index] == false)
+            {
+                DD_PRINT(LogLevel::Debug, "FAST RETRANS session %u seq %u", m_sessionId, seq);
+
+                m_sendWindow.messages[index].header.windowSize = m_receiveWindow.currentAvailableSize;
+                if (SendOrClose(m_sendWindow.messages[index]) == false)
+                {
+                    break;
+                }
+
+                // Restart the retransmit timer so the regular retransmit doesn't send it yet again right away.
+                m_sendWindow.initialTransmitTimeInMs[index] = currentTime;
+                m_statistics.messagesRetransmitted++;
+            }
+        }
+
+        if (seq > firstMissingSequence)
+        {
+            m_sendWindow.lastFastRetransmit = (seq - 1);
+            m_sendWindow.fastRetransmitMark = m_sendWindow.lastSentSequence;
+            m_sendWindow.retransmitCount = 0;
+        }
+    }
+
+    // Shrinks the congestion window after a message was lost. Losses among the messages that were already in flight
+    // when the window was last reduced belong to the same congestion event and don't reduce it again, but a timeout
+    // always drops it to the minimum. The send window lock must be held.
+    void Session::ReduceCongestionWindow(bool isTimeout)
+    {
+        if (isTimeout || (m_sendWindow.nextUnacknowledgedSequence > m_sendWindow.recoverySequence))
+        {
+            m_sendWindow.slowStartThreshold = Max(m_sendWindow.congestionWindow * 0.5f, kMinCongestionWindowSize);
+            m_sendWindow.congestionWindow =
+                isTimeout ? kMinCongestionWindowSize : m_sendWindow.slowStartThreshold;
+            m_sendWindow.recoverySequence = m_sendWindow.lastSentSequence;
+
+            DD_PRINT(LogLevel::Debug,
+                     "Session %u reduced congestion window to %0.2f",
+                     m_sessionId,
+                     m_sendWindow.congestionWindow);
+        }
+    }
+
     Result Session::WriteMessageIntoReceiveWindow(const MessageBuffer& messageBuffer)
     {
         DD_PRINT(LogLevel::Debug,
@@ -247,6 +417,16 @@ namespace DevDriver
 
                     // DD_ASSERT(m_receiveWindow.valid[index] == false);
 
+                    if (m_receiveWindow.valid[index] && (m_receiveWindow.sequence[index] == messageBuffer.header.sequence))
+                    {
+                        m_statistics.duplicatesReceived++;
+                    }
+                    else
+                    {
+                        m_statistics.messagesReceived++;
+                        m_statistics.bytesReceived += messageBuffer.header.payloadSize;
+                    }
+
                     // copy data + set associated state
                     memcpy(&m_receiveWindow.messages[index],
                         &messageBuffer,
@@ -274,11 +454,26 @@ namespace DevDriver
 
                     m_receiveWindow.nextExpectedSequence = nextSequence;
 
+                    if ((m_sessionVersion >= kSessionProtocolSelectiveAckVersion) &&
+                        (messageBuffer.header.sequence >= nextSequence))
+                    {
+                        // This message arrived while an earlier one is still missing. The first one past a new gap
+                        // is acked right away so the sender finds out about the loss as soon as possible. Later ones
+                        // are coalesced like in order messages, and any left over are acked by the next update.
+                        m_receiveWindow.unreportedCount++;
+
+                        if ((m_receiveWindow.selectiveAckGap != nextSequence) ||
+                            (m_receiveWindow.unreportedCount >= kMaxUnacknowledgedThreshold))
+                        {
+                            DD_PRINT(LogLevel::Debug, "Selective ack seq %u", messageBuffer.header.sequence);
+                            SendAckMessage();
+                        }
+                    }
                     // if we already have data waiting we want to ack in two conditions
                     //  1) if too many packets have not been acknowledged
                     //  2) if we have waited more than half of the a round trip time
                     // This is to prevent situations where a client retransmits a bunch of data unnecessarily
-                    if (pendingAck)
+                    else if (pendingAck)
                     {
                         const uint64 unackDistance = (nextSequence - m_receiveWindow.lastUnacknowledgedSequence);
                         if (unackDistance >= kMaxUnacknowledgedThreshold)
@@ -302,6 +497,7 @@ namespace DevDriver
                 {
                     DD_PRINT(LogLevel::Debug, "Reack seq %u", (nextSequence - 1));
                 }
+                m_statistics.duplicatesReceived++;
                 SendAckMessage();
                 result = Result::Success;
             }
@@ -672,6 +868,14 @@ namespace DevDriver
         case SessionState::FinWait1: // Session has requested a disconnect
         case SessionState::FinWait2: // Session sent Fin and is waiting on ack
         case SessionState::Closing: // Session has received a Fin packet and sending data
+            // Selective acks have to be recorded first so a fast retransmit skips the messages that arrived.
+            if ((m_sessionVersion >= kSessionProtocolSelectiveAckVersion) &&
+                (messageBuffer.header.payloadSize >= sizeof(SelectiveAckPayload)))
+            {
+                const SelectiveAckPayload* DD_RESTRICT pPayload =
+                    reinterpret_cast<const SelectiveAckPayload*>(&messageBuffer.payload[0]);
+                MarkMessagesAsSelectivelyAcknowledged(messageBuffer.header.sequence, pPayload->receivedMask);
+            }
             MarkMessagesAsAcknowledged(messageBuffer.header.sequence);
             break;
         default:
@@ -799,7 +1003,7 @@ namespace DevDriver
         LockGuard<AtomicLock> lock(m_receiveWindow.lock);
         {
             const Sequence& seq = m_receiveWindow.nextExpectedSequence;
-            if (seq > m_receiveWindow.lastUnacknowledgedSequence)
+            if ((seq > m_receiveWindow.lastUnacknowledgedSequence) || (m_receiveWindow.unreportedCount > 0))
             {
                 // if there is unacknowledged data in the receive window we need to acknowledge it
                 DD_PRINT(LogLevel::Debug, "Acknowledging packets %u-%u", m_receiveWindow.lastUnacknowledgedSequence, (seq - 1));
@@ -834,6 +1038,13 @@ namespace DevDriver
                      seq++)
                 {
                     const Sequence index = seq % m_sendWindow.GetWindowSize();
+
+                    // the receiver already has the messages it selectively acknowledged
+                    if (m_sendWindow.selectivelyAcked[index])
+                    {
+                        continue;
+                    }
+
                     const uint64 currentDifference = (currentTime - m_sendWindow.initialTransmitTimeInMs[index]);
 
                     // if it hasn't timed out yet we abort
@@ -862,6 +1073,10 @@ namespace DevDriver
                 {
                     DD_PRINT(LogLevel::Debug, "RETRANSMIT: retransmitted %u packets on session %u of type %u", count, m_sessionId, m_sessionType);
                     m_sendWindow.retransmitCount += 1;
+
+                    m_statistics.retransmitTimeouts++;
+                    m_statistics.messagesRetransmitted += count;
+                    ReduceCongestionWindow(true);
                 }
             }
             else
@@ -873,8 +1088,15 @@ namespace DevDriver
         // proceed to transmit any data we haven't sent yet
         const WindowSize& windowSize = m_sendWindow.GetWindowSize();
 
+        // the congestion window limits how many messages can be in flight on top of the receiver's window. Messages
+        // that were selectively acknowledged have left the network, so they don't count.
+        const Sequence congestionWindowSize = GetCongestionWindowSize();
+
         Sequence seq = m_sendWindow.lastSentSequence + 1;
-        while ((seq < m_sendWindow.nextSequence) & (m_sendWindow.lastAvailableSize > 0))
+        while ((seq < m_sendWindow.nextSequence) &
+               (m_sendWindow.lastAvailableSize > 0) &
+               ((seq - m_sendWindow.nextUnacknowledgedSequence - m_sendWindow.selectivelyAckedCount) <
+                congestionWindowSize))
         {
             const uint32 index = seq % windowSize;
             if (m_sendWindow.valid[index] & (seq == m_sendWindow.sequence[index]))
@@ -889,6 +1111,9 @@ namespace DevDriver
                     m_sendWindow.initialTransmitTimeInMs[index] = currentTime;
                     m_sendWindow.lastSentSequence = messageBuffer.header.sequence;
                     m_sendWindow.lastAvailableSize -= 1;
+
+                    m_statistics.messagesSent++;
+                    m_statistics.bytesSent += messageBuffer.header.payloadSize;
                 }
                 else
                 {
@@ -1069,6 +1294,69 @@ namespace DevDriver
         return result;
     }
 
+    void Session::GetStatistics(SessionStatistics* pStatistics)
+    {
+        DD_ASSERT(pStatistics != nullptr);
+
+        {
+            LockGuard<AtomicLock> lock(m_sendWindow.lock);
+
+            pStatistics->messagesSent          = m_statistics.messagesSent;
+            pStatistics->bytesSent             = m_statistics.bytesSent;
+            pStatistics->messagesRetransmitted = m_statistics.messagesRetransmitted;
+            pStatistics->retransmitTimeouts    = m_statistics.retransmitTimeouts;
+            pStatistics->fastRetransmits       = m_statistics.fastRetransmits;
+            pStatistics->congestionWindowSize  = static_cast<uint32>(GetCongestionWindowSize());
+            pStatistics->roundTripTimeInMs     = m_sendWindow.roundTripTime;
+        }
+
+        {
+            LockGuard<AtomicLock> lock(m_receiveWindow.lock);
+
+            pStatistics->messagesReceived   = m_statistics.messagesReceived;
+            pStatistics->bytesReceived      = m_statistics.bytesReceived;
+            pStatistics->duplicatesReceived = m_statistics.duplicatesReceived;
+        }
+
+        pStatistics->sessionTimeInMs = (Platform::GetCurrentTimeInMs() - m_createTimeInMs);
+    }
+
+    // Returns the number of messages that may currently be in flight. Older receivers only ack out of order messages
+    // once the sender retransmits, which is too late to adapt the window to, so their sessions use the whole window.
+    // The send window lock must be held.
+    Sequence Session::GetCongestionWindowSize() const
+    {
+        return (m_sessionVersion >= kSessionProtocolSelectiveAckVersion)
+            ? static_cast<Sequence>(m_sendWindow.congestionWindow)
+            : m_sendWindow.GetWindowSize();
+    }
+
+    // Computes the selective ack mask for the messages received past the next expected one. The receive window lock
+    // must be held.
+    uint64 Session::CalculateSelectiveAckMask()
+    {
+        uint64 receivedMask = 0;
+
+        // The message at nextExpectedSequence is missing by definition, so the mask starts with the one after it.
+        const Sequence firstSequence = (m_receiveWindow.nextExpectedSequence + 1);
+        for (uint32 bit = 0; bit < 64; ++bit)
+        {
+            const Sequence seq = (firstSequence + bit);
+            if ((seq - m_receiveWindow.nextUnreadSequence) >= m_receiveWindow.GetWindowSize())
+            {
+                break;
+            }
+
+            const Sequence index = seq % m_receiveWindow.GetWindowSize();
+            if (m_receiveWindow.valid[index] && (m_receiveWindow.sequence[index] == seq))
+            {
+                receivedMask |= (1ull << bit);
+            }
+        }
+
+        return receivedMask;
+    }
+
     inline void DevDriver::Session::SetState(SessionState newState)
     {
         if (m_sessionState != newState)
@@ -156,13 +156,21 @@ namespace DevDriver
             return m_protocol;
         }
 
+        void GetStatistics(SessionStatistics* pStatistics) override final;
+
     private:
         Result MarkMessagesAsAcknowledged(Sequence maxSequenceNumber);
+        void MarkMessagesAsSelectivelyAcknowledged(Sequence ackSequenceNumber, uint64 receivedMask);
+        void RetransmitMissingMessages();
+        void ReduceCongestionWindow(bool isTimeout);
         Result WriteMessageIntoReceiveWindow(const MessageBuffer& messageBuffer);
         Result WriteMessageIntoSendWindow(SessionProtocol::SessionMessage message, uint32 payloadSizeInBytes, const void* pPayload, uint32 timeoutInMs);
 
         bool SendOrClose(const MessageBuffer& messageBuffer);
-        bool SendControlMessage(SessionProtocol::SessionMessage command, Sequence sequenceNumber);
+        bool SendControlMessage(SessionProtocol::SessionMessage command,
+                                Sequence                        sequenceNumber,
+                                uint32                          payloadSizeInBytes = 0,
+                                const void*                     pPayload = nullptr);
         bool SendAckMessage();
 
         void HandleSynMessage(const MessageBuffer& messageBuffer);
@@ -177,6 +185,8 @@ namespace DevDriver
         void UpdateTimeout();
 
         WindowSize CalculateCurrentWindowSize();
+        Sequence GetCongestionWindowSize() const;
+        uint64 CalculateSelectiveAckMask();
         bool IsSendWindowEmpty();
         void UpdateSendWindowSize(const MessageBuffer& messageBuffer);
 
@@ -189,6 +199,7 @@ namespace DevDriver
             Sequence                sequence[size];
             uint64                  initialTransmitTimeInMs[size];
             volatile bool           valid[size];
+            bool                    selectivelyAcked[size];
 
             Platform::AtomicLock    lock;
             Platform::Semaphore     semaphore;
@@ -202,6 +213,17 @@ namespace DevDriver
 
             WindowSize              lastAvailableSize;
 
+            // Congestion control: the number of messages in flight is limited to congestionWindow. It starts out at the
+            // whole window and is cut down when messages are lost. After that it grows by one message per acknowledged
+            // message until it reaches slowStartThreshold and by one message per round trip once it has.
+            float                   congestionWindow;
+            float                   slowStartThreshold;
+            Sequence                recoverySequence;        // Last message sent when the window was last reduced
+            Sequence                highestSelectiveAck;     // Highest sequence the receiver has selectively acked
+            uint32                  selectivelyAckedCount;   // Number of messages in the window that were selectively acked
+            Sequence                lastFastRetransmit;      // Highest sequence covered by a fast retransmit
+            Sequence                fastRetransmitMark;      // Last message sent when the last fast retransmit happened
+
             constexpr WindowSize GetWindowSize() const { return size; };
 
             TransmitWindow() :
@@ -209,6 +231,7 @@ namespace DevDriver
                 sequence(),
                 initialTransmitTimeInMs(),
                 valid(),
+                selectivelyAcked(),
                 lock(),
                 semaphore(size, size),
                 nextSequence(1),
@@ -217,7 +240,14 @@ namespace DevDriver
                 lastAckCount(),
                 roundTripTime(kInitialRoundTripTimeInMs),
                 retransmitCount(0),
-                lastAvailableSize(1)
+                lastAvailableSize(1),
+                congestionWindow(size),
+                slowStartThreshold(size),
+                recoverySequence(0),
+                highestSelectiveAck(0),
+                selectivelyAckedCount(0),
+                lastFastRetransmit(0),
+                fastRetransmitMark(0)
             {
 
             };
@@ -237,6 +267,8 @@ namespace DevDriver
             Sequence                nextExpectedSequence;
             Sequence                lastUnacknowledgedSequence;
             WindowSize              currentAvailableSize;
+            Sequence                selectiveAckGap;     // Missing sequence the last selective ack reported, or zero
+            uint32                  unreportedCount;     // Messages received past a gap since the last ack
 
             constexpr WindowSize MaxAdvertizedSize() const { return size - (size >> 1); };
             constexpr WindowSize GetWindowSize() const { return size; };
@@ -250,7 +282,9 @@ namespace DevDriver
                 nextUnreadSequence(1),
                 nextExpectedSequence(1),
                 lastUnacknowledgedSequence(1),
-                currentAvailableSize(size - (size >> 1))
+                currentAvailableSize(size - (size >> 1)),
+                selectiveAckGap(0),
+                unreportedCount(0)
             {
             }
         };
@@ -271,5 +305,8 @@ namespace DevDriver
         Version                             m_minClientProtocolVersion;
         SessionProtocol::SessionVersion     m_sessionVersion;
         Platform::Event                     m_connectionEvent;
+        const uint64                        m_createTimeInMs;
+        SessionStatistics                   m_statistics;       // Sending and receiving counters are protected by
+                                                                // the send and receive window locks respectively
     };
 } // DevDriver
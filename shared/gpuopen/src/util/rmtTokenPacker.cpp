@@ -0,0 +1,643 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2020 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+
+#include <util/rmtTokenPacker.h>
+#include <util/rmtFileFormat.h>
+#include <util/rmtTokens.h>
+
+namespace DevDriver
+{
+
+// The reserved token type used to mark literals and dictionary references
+DD_STATIC_CONST uint8 kEscapeTokenType = RMT_TOKEN_RESERVED_0;
+
+// Subtypes stored in the delta bits of an escape token
+DD_STATIC_CONST uint8 kEscapeLiteral   = 0;
+DD_STATIC_CONST uint8 kEscapeReference = 1;
+
+// The state a packed token field is stored relative to
+enum class PackedFieldContext : uint8
+{
+    VirtualAddress,
+    ResourceId
+};
+
+// A token field that's stored as the difference from the previous value of the same kind
+struct PackedField
+{
+    uint8              startBit;
+    uint8              endBit;
+    PackedFieldContext context;
+};
+
+// Describes how a token type is packed. Token types with a size of zero are never packed.
+// All bits of the token that aren't covered by the header or the fields are combined into a single value, which must
+// fit into 64 bits.
+struct PackedTokenLayout
+{
+    uint8       sizeInBytes;
+    uint8       numFields;
+    PackedField fields[2];
+};
+
+static const PackedTokenLayout kPackedTokenLayouts[] =
+{
+    { },                                                                // RMT_TOKEN_TIMESTAMP
+    { },                                                                // RMT_TOKEN_RESERVED_0
+    { },                                                                // RMT_TOKEN_RESERVED_1
+    { },                                                                // RMT_TOKEN_PAGE_TABLE_UPDATE
+    { },                                                                // RMT_TOKEN_USERDATA
+    { },                                                                // RMT_TOKEN_MISC
+    { 8,  1, { { 9,  56,  PackedFieldContext::VirtualAddress } } },     // RMT_TOKEN_RESOURCE_REFERENCE
+    { 17, 2, { { 8,  55,  PackedFieldContext::VirtualAddress },
+               { 104, 135, PackedFieldContext::ResourceId } } },        // RMT_TOKEN_RESOURCE_BIND
+    { },                                                                // RMT_TOKEN_PROCESS_EVENT
+    { },                                                                // RMT_TOKEN_PAGE_REFERENCE
+    { 8,  1, { { 8,  55,  PackedFieldContext::VirtualAddress } } },     // RMT_TOKEN_CPU_MAP
+    { 7,  1, { { 8,  55,  PackedFieldContext::VirtualAddress } } },     // RMT_TOKEN_FREE_VIRTUAL
+    { 12, 1, { { 34, 81,  PackedFieldContext::VirtualAddress } } },     // RMT_TOKEN_VIRTUAL_ALLOCATE
+    { 7,  1, { { 8,  39,  PackedFieldContext::ResourceId } } },         // RMT_TOKEN_RESOURCE_CREATE
+    { },                                                                // RMT_TOKEN_TIME_DELTA
+    { 5,  1, { { 8,  39,  PackedFieldContext::ResourceId } } },         // RMT_TOKEN_RESOURCE_DESTROY
+};
+
+static_assert((sizeof(kPackedTokenLayouts) / sizeof(kPackedTokenLayouts[0])) == 16,
+              "A packed token layout is required for every RMT token type");
+
+// =====================================================================================================================
+// Returns the size of a timing token from its header byte, or zero if it isn't a timing token
+static size_t GetTimingTokenSize(uint8 header)
+{
+    size_t size = 0;
+
+    const uint8 tokenType = (header & 0xF);
+    if (tokenType == RMT_TOKEN_TIMESTAMP)
+    {
+        size = RMT_MSG_TIMESTAMP_TOKEN_BYTES_SIZE;
+    }
+    else if (tokenType == RMT_TOKEN_TIME_DELTA)
+    {
+        // DELTA_BYTES [6:4]
+        size = 1 + ((header >> 4) & 0x7);
+    }
+
+    return size;
+}
+
+// =====================================================================================================================
+static uint64 ReadBits(const uint8* pData, uint32 startBit, uint32 endBit)
+{
+    uint64 value = 0;
+    for (uint32 bit = endBit + 1; bit > startBit; --bit)
+    {
+        value = (value << 1) | ((pData[(bit - 1) / 8] >> ((bit - 1) % 8)) & 1);
+    }
+
+    return value;
+}
+
+// =====================================================================================================================
+// The destination bits must be zero
+static void WriteBits(uint8* pData, uint32 startBit, uint32 endBit, uint64 value)
+{
+    for (uint32 bit = startBit; bit <= endBit; ++bit)
+    {
+        pData[bit / 8] |= static_cast<uint8>((value & 1) << (bit % 8));
+        value >>= 1;
+    }
+}
+
+// =====================================================================================================================
+// Returns true if the bit is part of one of the layout's fields
+static bool IsFieldBit(const PackedTokenLayout& layout, uint32 bit)
+{
+    bool isFieldBit = false;
+    for (uint32 fieldIndex = 0; fieldIndex < layout.numFields; ++fieldIndex)
+    {
+        isFieldBit |= ((bit >= layout.fields[fieldIndex].startBit) && (bit <= layout.fields[fieldIndex].endBit));
+    }
+
+    return isFieldBit;
+}
+
+// =====================================================================================================================
+static size_t WriteVarint(uint64 value, uint8* pOutput)
+{
+    size_t size = 0;
+    while (value >= 0x80)
+    {
+        pOutput[size++] = static_cast<uint8>(value | 0x80);
+        value >>= 7;
+    }
+    pOutput[size++] = static_cast<uint8>(value);
+
+    return size;
+}
+
+// =====================================================================================================================
+// Returns false if the varint runs past the end of the data
+static bool ReadVarint(const uint8* pData, size_t dataSize, size_t* pOffset, uint64* pValue)
+{
+    uint64 value = 0;
+    bool   done  = false;
+
+    for (uint32 shift = 0; (shift < 64) && (*pOffset < dataSize) && (done == false); shift += 7)
+    {
+        const uint8 byte = pData[(*pOffset)++];
+
+        value |= (static_cast<uint64>(byte & 0x7F) << shift);
+        done   = ((byte & 0x80) == 0);
+    }
+
+    *pValue = value;
+
+    return done;
+}
+
+// =====================================================================================================================
+static uint64 ZigZagEncode(int64 value)
+{
+    return (static_cast<uint64>(value) << 1) ^ static_cast<uint64>(value >> 63);
+}
+
+// =====================================================================================================================
+static int64 ZigZagDecode(uint64 value)
+{
+    return static_cast<int64>(value >> 1) ^ -static_cast<int64>(value & 1);
+}
+
+// =====================================================================================================================
+void RmtPackedStreamState::Reset()
+{
+    m_lastVirtualAddress  = 0;
+    m_lastResourceId      = 0;
+    m_nextDictionaryEntry = 0;
+
+    for (uint32 entryIndex = 0; entryIndex < kRmtPackedDictionarySize; ++entryIndex)
+    {
+        m_dictionary[entryIndex].size = 0;
+    }
+}
+
+// =====================================================================================================================
+uint32 RmtPackedStreamState::HashLiteral(const uint8* pData, size_t size)
+{
+    // FNV-1a
+    uint32 hash = 2166136261u;
+    for (size_t byteIndex = 0; byteIndex < size; ++byteIndex)
+    {
+        hash = (hash ^ pData[byteIndex]) * 16777619u;
+    }
+
+    return hash;
+}
+
+// =====================================================================================================================
+// Replaces the oldest dictionary entry
+void RmtPackedStreamState::AddDictionaryEntry(const uint8* pData, size_t size)
+{
+    DD_ASSERT(IsDictionarySize(size));
+
+    DictionaryEntry* pEntry = &m_dictionary[m_nextDictionaryEntry];
+    pEntry->hash = HashLiteral(pData, size);
+    pEntry->size = static_cast<uint32>(size);
+    memcpy(pEntry->data, pData, size);
+
+    m_nextDictionaryEntry = ((m_nextDictionaryEntry + 1) % kRmtPackedDictionarySize);
+}
+
+// =====================================================================================================================
+size_t RmtTokenPacker::Pack(
+    const void* pData,
+    size_t      dataSize,
+    void*       pOutput)
+{
+    DD_ASSERT((pData != nullptr) || (dataSize == 0));
+    DD_ASSERT(pOutput != nullptr);
+
+    const uint8* pInput     = static_cast<const uint8*>(pData);
+    uint8*       pPacked    = static_cast<uint8*>(pOutput);
+    size_t       offset     = 0;
+    size_t       packedSize = 0;
+
+    while (offset < dataSize)
+    {
+        const uint8  header          = pInput[offset];
+        const size_t bytesRemaining  = (dataSize - offset);
+        const size_t timingTokenSize = GetTimingTokenSize(header);
+
+        const PackedTokenLayout& layout = kPackedTokenLayouts[header & 0xF];
+
+        if ((timingTokenSize != 0) && (timingTokenSize <= bytesRemaining))
+        {
+            // Timing tokens are rare enough that they're not worth packing
+            memcpy(pPacked + packedSize, pInput + offset, timingTokenSize);
+            packedSize += timingTokenSize;
+            offset     += timingTokenSize;
+        }
+        else if ((layout.sizeInBytes != 0) && (layout.sizeInBytes <= bytesRemaining))
+        {
+            const uint8* pToken = (pInput + offset);
+
+            pPacked[packedSize++] = header;
+
+            for (uint32 fieldIndex = 0; fieldIndex < layout.numFields; ++fieldIndex)
+            {
+                const PackedField& field = layout.fields[fieldIndex];
+
+                uint64* pLastValue = (field.context == PackedFieldContext::VirtualAddress) ? &m_lastVirtualAddress
+                                                                                           : &m_lastResourceId;
+
+                const uint64 value = ReadBits(pToken, field.startBit, field.endBit);
+                packedSize += WriteVarint(ZigZagEncode(static_cast<int64>(value - *pLastValue)), pPacked + packedSize);
+
+                *pLastValue = value;
+            }
+
+            // Gather up the rest of the token's bits, if it has any
+            uint64 remainingBits    = 0;
+            uint32 numRemainingBits = 0;
+            for (uint32 bit = 8; bit < (layout.sizeInBytes * 8u); ++bit)
+            {
+                if (IsFieldBit(layout, bit) == false)
+                {
+                    remainingBits |= (ReadBits(pToken, bit, bit) << numRemainingBits);
+                    ++numRemainingBits;
+                }
+            }
+            DD_ASSERT(numRemainingBits <= 64);
+
+            if (numRemainingBits > 0)
+            {
+                packedSize += WriteVarint(remainingBits, pPacked + packedSize);
+            }
+
+            offset += layout.sizeInBytes;
+        }
+        else
+        {
+            // Whatever is left isn't a token we know how to pack, most likely a resource description
+            packedSize += PackLiteral(pInput + offset, bytesRemaining, pPacked + packedSize);
+            offset      = dataSize;
+        }
+    }
+
+    DD_ASSERT(packedSize <= CalculateMaxPackedSize(dataSize));
+
+    return packedSize;
+}
+
+// =====================================================================================================================
+size_t RmtTokenPacker::PackLiteral(
+    const uint8* pData,
+    size_t       size,
+    uint8*       pOutput)
+{
+    size_t packedSize = 0;
+
+    // Look for an earlier copy of the literal
+    int32 entryIndex = -1;
+    if (IsDictionarySize(size))
+    {
+        const uint32 hash = HashLiteral(pData, size);
+        for (uint32 i = 0; i < kRmtPackedDictionarySize; ++i)
+        {
+            const DictionaryEntry& entry = m_dictionary[i];
+            if ((entry.hash == hash) && (entry.size == size) && (memcmp(entry.data, pData, size) == 0))
+            {
+                entryIndex = static_cast<int32>(i);
+                break;
+            }
+        }
+    }
+
+    if (entryIndex >= 0)
+    {
+        pOutput[packedSize++] = static_cast<uint8>(kEscapeTokenType | (kEscapeReference << 4));
+        packedSize += WriteVarint(static_cast<uint64>(entryIndex), pOutput + packedSize);
+    }
+    else
+    {
+        pOutput[packedSize++] = static_cast<uint8>(kEscapeTokenType | (kEscapeLiteral << 4));
+        packedSize += WriteVarint(size, pOutput + packedSize);
+
+        // Each group of eight bytes is stored as a mask of its non-zero bytes followed by those bytes
+        for (size_t groupOffset = 0; groupOffset < size; groupOffset += 8)
+        {
+            uint8& mask = pOutput[packedSize++];
+            mask = 0;
+
+            for (size_t byteIndex = groupOffset; (byteIndex < size) && (byteIndex < (groupOffset + 8)); ++byteIndex)
+            {
+                if (pData[byteIndex] != 0)
+                {
+                    mask |= static_cast<uint8>(1 << (byteIndex - groupOffset));
+                    pOutput[packedSize++] = pData[byteIndex];
+                }
+            }
+        }
+
+        if (IsDictionarySize(size))
+        {
+            AddDictionaryEntry(pData, size);
+        }
+    }
+
+    return packedSize;
+}
+
+// =====================================================================================================================
+Result RmtTokenExpander::Expand(
+    const void*    pPackedData,
+    size_t         packedDataSize,
+    Vector<uint8>* pOutput)
+{
+    DD_ASSERT((pPackedData != nullptr) || (packedDataSize == 0));
+    DD_ASSERT(pOutput != nullptr);
+
+    const uint8* pPacked = static_cast<const uint8*>(pPackedData);
+    size_t       offset  = 0;
+    Result       result  = Result::Success;
+
+    while ((offset < packedDataSize) && (result == Result::Success))
+    {
+        const uint8  header          = pPacked[offset];
+        const uint8  tokenType       = (header & 0xF);
+        const size_t timingTokenSize = GetTimingTokenSize(header);
+
+        const PackedTokenLayout& layout = kPackedTokenLayouts[tokenType];
+
+        if (timingTokenSize != 0)
+        {
+            if (timingTokenSize <= (packedDataSize - offset))
+            {
+                const size_t outputOffset = pOutput->Grow(timingTokenSize);
+                memcpy(pOutput->Data() + outputOffset, pPacked + offset, timingTokenSize);
+                offset += timingTokenSize;
+            }
+            else
+            {
+                result = Result::Error;
+            }
+        }
+        else if (layout.sizeInBytes != 0)
+        {
+            uint8 token[32] = {};
+            DD_ASSERT(layout.sizeInBytes <= sizeof(token));
+
+            token[0] = header;
+            ++offset;
+
+            for (uint32 fieldIndex = 0; (fieldIndex < layout.numFields) && (result == Result::Success); ++fieldIndex)
+            {
+                const PackedField& field = layout.fields[fieldIndex];
+
+                uint64* pLastValue = (field.context == PackedFieldContext::VirtualAddress) ? &m_lastVirtualAddress
+                                                                                           : &m_lastResourceId;
+
+                uint64 delta = 0;
+                if (ReadVarint(pPacked, packedDataSize, &offset, &delta))
+                {
+                    const uint64 value = (*pLastValue + static_cast<uint64>(ZigZagDecode(delta)));
+                    WriteBits(token, field.startBit, field.endBit, value);
+
+                    *pLastValue = value;
+                }
+                else
+                {
+                    result = Result::Error;
+                }
+            }
+
+            // Tokens where the fields cover every bit after the header don't store the remaining bits at all
+            uint32 numRemainingBits = 0;
+            for (uint32 bit = 8; bit < (layout.sizeInBytes * 8u); ++bit)
+            {
+                numRemainingBits += (IsFieldBit(layout, bit) ? 0 : 1);
+            }
+
+            uint64 remainingBits = 0;
+            if ((result == Result::Success) &&
+                (numRemainingBits > 0)      &&
+                (ReadVarint(pPacked, packedDataSize, &offset, &remainingBits) == false))
+            {
+                result = Result::Error;
+            }
+
+            if (result == Result::Success)
+            {
+                for (uint32 bit = 8; bit < (layout.sizeInBytes * 8u); ++bit)
+                {
+                    if (IsFieldBit(layout, bit) == false)
+                    {
+                        WriteBits(token, bit, bit, remainingBits & 1);
+                        remainingBits >>= 1;
+                    }
+                }
+
+                const size_t outputOffset = pOutput->Grow(layout.sizeInBytes);
+                memcpy(pOutput->Data() + outputOffset, token, layout.sizeInBytes);
+            }
+        }
+        else if (tokenType == kEscapeTokenType)
+        {
+            const uint8 escapeType = (header >> 4);
+            ++offset;
+
+            uint64 value = 0;
+            if (ReadVarint(pPacked, packedDataSize, &offset, &value) == false)
+            {
+                result = Result::Error;
+            }
+            else if (escapeType == kEscapeReference)
+            {
+                if ((value < kRmtPackedDictionarySize) && (m_dictionary[value].size != 0))
+                {
+                    const DictionaryEntry& entry = m_dictionary[value];
+
+                    const size_t outputOffset = pOutput->Grow(entry.size);
+                    memcpy(pOutput->Data() + outputOffset, entry.data, entry.size);
+                }
+                else
+                {
+                    result = Result::Error;
+                }
+            }
+            else if ((escapeType == kEscapeLiteral) &&
+                     (((value / 8) + (((value % 8) != 0) ? 1 : 0)) > (packedDataSize - offset)))
+            {
+                // Every group of 8 literal bytes needs at least its mask byte, so a length the remaining input can't
+                // cover is corrupt. This has to be caught before the output grows by an untrusted amount.
+                result = Result::Error;
+            }
+            else if (escapeType == kEscapeLiteral)
+            {
+                const size_t literalSize  = static_cast<size_t>(value);
+                const size_t outputOffset = pOutput->Grow(literalSize);
+                uint8*       pLiteral     = (pOutput->Data() + outputOffset);
+
+                for (size_t groupOffset = 0;
+                     (groupOffset < literalSize) && (result == Result::Success);
+                     groupOffset += 8)
+                {
+                    if (offset < packedDataSize)
+                    {
+                        const uint8 mask = pPacked[offset++];
+
+                        for (size_t byteIndex = groupOffset;
+                             (byteIndex < literalSize) && (byteIndex < (groupOffset + 8));
+                             ++byteIndex)
+                        {
+                            if ((mask & (1 << (byteIndex - groupOffset))) == 0)
+                            {
+                                pLiteral[byteIndex] = 0;
+                            }
+                            else if (offset < packedDataSize)
+                            {
+                                pLiteral[byteIndex] = pPacked[offset++];
+                            }
+                            else
+                            {
+                                result = Result::Error;
+                                break;
+                            }
+                        }
+                    }
+                    else
+                    {
+                        result = Result::Error;
+                    }
+                }
+
+                if ((result == Result::Success) && IsDictionarySize(literalSize))
+                {
+                    AddDictionaryEntry(pLiteral, literalSize);
+                }
+            }
+            else
+            {
+                result = Result::Error;
+            }
+        }
+        else
+        {
+            // The packer never writes any other kind of record
+            result = Result::Error;
+        }
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+Result ExpandPackedRmtData(
+    const void*    pData,
+    size_t         dataSize,
+    Vector<uint8>* pOutput)
+{
+    DD_ASSERT((pData != nullptr) || (dataSize == 0));
+    DD_ASSERT(pOutput != nullptr);
+
+    const uint8* pInput = static_cast<const uint8*>(pData);
+    size_t       offset = 0;
+    Result       result = Result::Success;
+
+    // Copy the file header if this is a complete file
+    if (dataSize >= sizeof(RmtFileHeader))
+    {
+        RmtFileHeader fileHeader = {};
+        memcpy(&fileHeader, pInput, sizeof(fileHeader));
+
+        if (fileHeader.magicNumber == RMT_FILE_MAGIC_NUMBER)
+        {
+            if ((fileHeader.chunkOffset >= static_cast<int32>(sizeof(fileHeader))) &&
+                (static_cast<size_t>(fileHeader.chunkOffset) <= dataSize))
+            {
+                offset = static_cast<size_t>(fileHeader.chunkOffset);
+
+                const size_t outputOffset = pOutput->Grow(offset);
+                memcpy(pOutput->Data() + outputOffset, pInput, offset);
+            }
+            else
+            {
+                result = Result::Error;
+            }
+        }
+    }
+
+    while ((offset < dataSize) && (result == Result::Success))
+    {
+        RmtFileChunkHeader chunkHeader = {};
+        if (sizeof(chunkHeader) <= (dataSize - offset))
+        {
+            memcpy(&chunkHeader, pInput + offset, sizeof(chunkHeader));
+        }
+
+        const size_t chunkSize = (chunkHeader.sizeInBytes > 0) ? static_cast<size_t>(chunkHeader.sizeInBytes) : 0;
+
+        if ((chunkSize < sizeof(chunkHeader)) || (chunkSize > (dataSize - offset)))
+        {
+            result = Result::Error;
+        }
+        else if (chunkHeader.chunkIdentifier.chunkType == RMT_FILE_CHUNK_TYPE_RMT_DATA_PACKED)
+        {
+            if (chunkSize >= sizeof(RmtFileChunkRmtData))
+            {
+                RmtFileChunkRmtData dataChunkHeader = {};
+                memcpy(&dataChunkHeader, pInput + offset, sizeof(dataChunkHeader));
+
+                const size_t headerOffset = pOutput->Grow(sizeof(dataChunkHeader));
+
+                // Each packed chunk is packed on its own
+                RmtTokenExpander expander;
+                result = expander.Expand(pInput + offset + sizeof(dataChunkHeader),
+                                         chunkSize - sizeof(dataChunkHeader),
+                                         pOutput);
+
+                if (result == Result::Success)
+                {
+                    dataChunkHeader.header.chunkIdentifier.chunkType = RMT_FILE_CHUNK_TYPE_RMT_DATA;
+                    dataChunkHeader.header.sizeInBytes = static_cast<int32>(pOutput->Size() - headerOffset);
+                    memcpy(pOutput->Data() + headerOffset, &dataChunkHeader, sizeof(dataChunkHeader));
+                }
+            }
+            else
+            {
+                result = Result::Error;
+            }
+        }
+        else
+        {
+            const size_t outputOffset = pOutput->Grow(chunkSize);
+            memcpy(pOutput->Data() + outputOffset, pInput + offset, chunkSize);
+        }
+
+        offset += chunkSize;
+    }
+
+    return result;
+}
+
+} // namespace DevDriver
@@ -36,7 +36,13 @@ RmtWriter::RmtWriter(
     : m_allocCb(allocCb)
     , m_state(RmtWriterState::Uninitialized)
     , m_dataChunkHeaderOffset(0)
+    , m_dataChunkProcessId(0)
+    , m_dataChunkThreadId(0)
+    , m_dataChunkIndex(0)
     , m_rmtFileData(m_allocCb)
+    , m_pStreamWriter(nullptr)
+    , m_streamFlushThreshold(0)
+    , m_isPacking(false)
 {
 }
 
@@ -54,10 +60,34 @@ void RmtWriter::Init()
     m_dataChunkHeaderOffset = 0;
     m_rmtFileData.Resize(0);
     m_eventTimer.Reset();
+    m_pStreamWriter        = nullptr;
+    m_streamFlushThreshold = 0;
+    m_isPacking            = false;
 
     m_state = RmtWriterState::Initialized;
 }
 
+//=====================================================================================================================
+void RmtWriter::InitStreaming(
+    IByteWriter* pStreamWriter,
+    size_t       flushThreshold)
+{
+    DD_ASSERT(pStreamWriter != nullptr);
+
+    Init();
+
+    m_pStreamWriter        = pStreamWriter;
+    m_streamFlushThreshold = flushThreshold;
+}
+
+//=====================================================================================================================
+void RmtWriter::EnablePacking()
+{
+    DD_ASSERT(m_state == RmtWriterState::Initialized);
+
+    m_isPacking = true;
+}
+
 //=====================================================================================================================
 void RmtWriter::Reset()
 {
@@ -206,8 +236,14 @@ void RmtWriter::BeginDataChunk(
     // bytes of token data has been written.
     m_dataChunkHeaderOffset = m_rmtFileData.Size();
 
+    // Save the chunk's identity as well, streaming may have to continue it in another chunk
+    m_dataChunkProcessId = processId;
+    m_dataChunkThreadId  = threadId;
+    m_dataChunkIndex     = 0;
+
     // Create the chunk header with a zero byte size and add it to the stream
-    WriteDataChunkHeader(processId, threadId, 0, 0);
+    WriteDataChunkHeader(processId, threadId, 0, m_dataChunkIndex);
+    m_tokenPacker.Reset();
 
     m_state = RmtWriterState::WritingDataChunk;
 }
@@ -218,7 +254,19 @@ void RmtWriter::WriteTokenData(
 {
     DD_ASSERT(m_state == RmtWriterState::WritingDataChunk);
 
-    WriteBytes(tokenData.Data(), tokenData.Size());
+    if (m_isPacking)
+    {
+        // Pack straight into the file buffer and give back whatever the worst case didn't need
+        const size_t byteOffset = m_rmtFileData.Grow(RmtTokenPacker::CalculateMaxPackedSize(tokenData.Size()));
+        const size_t packedSize =
+            m_tokenPacker.Pack(tokenData.Data(), tokenData.Size(), VoidPtrInc(m_rmtFileData.Data(), byteOffset));
+
+        m_rmtFileData.Resize(byteOffset + packedSize);
+    }
+    else
+    {
+        WriteBytes(tokenData.Data(), tokenData.Size());
+    }
 }
 
 //=====================================================================================================================
@@ -228,6 +276,12 @@ uint8 RmtWriter::CalculateDelta()
 {
     DD_ASSERT(m_state == RmtWriterState::WritingDataChunk);
 
+    // Hand off the buffered data before the timestamp is generated since the next chunk has to start with a full one
+    if (IsStreaming() && (m_rmtFileData.Size() >= m_streamFlushThreshold))
+    {
+        StreamDataChunk();
+    }
+
     const EventTimestamp eventTimestamp = m_eventTimer.CreateTimestamp();
 
     uint8 delta = 0;
@@ -283,6 +337,11 @@ void RmtWriter::EndDataChunk()
         static_cast<RmtFileChunkRmtData*>(VoidPtrInc(m_rmtFileData.Data(), m_dataChunkHeaderOffset));
     pHeader->header.sizeInBytes = rmtDataChunkSize;
 
+    if (m_isPacking)
+    {
+        pHeader->header.chunkIdentifier.chunkType = RMT_FILE_CHUNK_TYPE_RMT_DATA_PACKED;
+    }
+
     // Update our state
     m_state = RmtWriterState::Initialized;
     m_dataChunkHeaderOffset = 0;
@@ -320,9 +379,39 @@ void RmtWriter::Finalize()
 {
     DD_ASSERT(m_state == RmtWriterState::Initialized);
 
+    // Hand off whatever is left, the stream writer then holds the complete file
+    if (IsStreaming() && (m_rmtFileData.IsEmpty() == false))
+    {
+        m_pStreamWriter->WriteBytes(m_rmtFileData.Data(), m_rmtFileData.Size());
+        m_rmtFileData.Resize(0);
+    }
+
     m_state = RmtWriterState::Finalized;
 }
 
+//=====================================================================================================================
+// Closes the active data chunk, hands all buffered data to the stream writer and begins the next data chunk
+void RmtWriter::StreamDataChunk()
+{
+    DD_ASSERT(IsStreaming());
+    DD_ASSERT(m_state == RmtWriterState::WritingDataChunk);
+
+    EndDataChunk();
+
+    m_pStreamWriter->WriteBytes(m_rmtFileData.Data(), m_rmtFileData.Size());
+
+    // The buffer keeps its capacity, so memory use stays bounded by the flush threshold plus a single event
+    m_rmtFileData.Resize(0);
+
+    // Continue in a new chunk, starting over with a full timestamp so it can be parsed on its own
+    ++m_dataChunkIndex;
+    WriteDataChunkHeader(m_dataChunkProcessId, m_dataChunkThreadId, 0, m_dataChunkIndex);
+    m_tokenPacker.Reset();
+    m_eventTimer.Reset();
+
+    m_state = RmtWriterState::WritingDataChunk;
+}
+
 //=====================================================================================================================
 // Writes to the RMT file stream
 void RmtWriter::WriteBytes(
@@ -26,7 +26,9 @@
 #include "core/devDriverEventService.h"
 #include "core/devDriverEventServiceConv.h"
 #include "core/eventDefs.h"
+#include "core/device.h"
 #include "core/gpuMemory.h"
+#include "core/platform.h"
 
 #include "palSysUtil.h"
 
@@ -38,8 +40,43 @@ using namespace DevDriver;
 namespace Pal
 {
 // =====================================================================================================================
-EventService::EventService(const AllocCb& allocCb)
-    : m_rmtWriter(allocCb)
+DevDriver::Result TraceFileWriter::Open(
+    const char* pFilePath)
+{
+    m_result = (m_file.Open(pFilePath, Util::FileAccessWrite | Util::FileAccessBinary) == Util::Result::Success)
+                   ? DevDriver::Result::Success
+                   : DevDriver::Result::FileIoError;
+
+    return m_result;
+}
+
+// =====================================================================================================================
+DevDriver::Result TraceFileWriter::End()
+{
+    m_file.Close();
+
+    return m_result;
+}
+
+// =====================================================================================================================
+void TraceFileWriter::WriteBytes(
+    const void* pBytes,
+    size_t      length)
+{
+    // Stop writing after the first failure, the rest of the trace would be unusable anyway
+    if ((m_result == DevDriver::Result::Success) && (m_file.Write(pBytes, length) != Util::Result::Success))
+    {
+        m_result = DevDriver::Result::FileIoError;
+    }
+}
+
+// =====================================================================================================================
+EventService::EventService(
+    Platform*      pPlatform,
+    const AllocCb& allocCb)
+    : m_pPlatform(pPlatform)
+    , m_allocCb(allocCb)
+    , m_rmtWriter(allocCb)
     , m_isMemoryProfilingEnabled(false)
     , m_isInitialized(false)
 {
@@ -50,6 +87,88 @@ EventService::~EventService()
 {
 }
 
+// =====================================================================================================================
+// Opens the file a streamed trace is written into. The name comes from a remote request, so only a plain file name is
+// accepted and the file is always created in the event log directory. Opening it truncates any existing file, so a
+// full path would let a request overwrite anything the process is allowed to write.
+DevDriver::Result EventService::OpenTraceFile(
+    const char* pFileName)
+{
+    DevDriver::Result result = DevDriver::Result::UriInvalidParameters;
+
+    const bool isPlainName = (strpbrk(pFileName, "/\\:") == nullptr) &&
+                             (strcmp(pFileName, ".") != 0)           &&
+                             (strcmp(pFileName, "..") != 0);
+
+    if (isPlainName)
+    {
+        const char* pLogDir = &m_pPlatform->PlatformSettings().eventLogDirectory[0];
+
+        char filePath[MaxPathStrLen] = {};
+        const int length = Util::Snprintf(&filePath[0], sizeof(filePath), "%s/%s", pLogDir, pFileName);
+
+        if ((length > 0) && (static_cast<size_t>(length) < sizeof(filePath)))
+        {
+            // Create the directory. We don't care if it fails (existing is fine, failure is caught when opening the
+            // file).
+            Util::MkDirRecursively(pLogDir);
+
+            result = m_traceFileWriter.Open(&filePath[0]);
+        }
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Writes the RMT file header along with the system and adapter info chunks that tools expect ahead of the data chunks.
+// Nothing in these needs to be fixed up later: the header only records the offset of the first chunk and each chunk
+// carries its own size.
+void EventService::WriteTraceFileHeader()
+{
+    m_rmtWriter.WriteFileHeader();
+
+    // The chunk is still written if the query fails, the timestamp frequency is what tools need most
+    Util::SystemInfo systemInfo = {};
+    Util::QuerySystemInfo(&systemInfo);
+
+    RmtFileChunkSystemInfo systemChunk = {};
+    Util::Strncpy(systemChunk.vendorId, systemInfo.cpuVendorString, sizeof(systemChunk.vendorId));
+    Util::Strncpy(systemChunk.processorBrand, systemInfo.cpuBrandString, sizeof(systemChunk.processorBrand));
+    systemChunk.timestampFrequency = DevDriver::Platform::QueryTimestampFrequency();
+    systemChunk.clockSpeed         = systemInfo.cpuFrequency;
+    systemChunk.logicCores         = static_cast<int32>(systemInfo.cpuLogicalCoreCount);
+    systemChunk.physicalCores      = static_cast<int32>(systemInfo.cpuPhysicalCoreCount);
+    systemChunk.systemRamInMB      = static_cast<int32>(systemInfo.totalSysMemSize);
+
+    m_rmtWriter.WriteSystemInfo(systemChunk);
+
+    // The RMT format describes a single adapter, so the trace is attributed to the first device
+    const Device* pDevice = (m_pPlatform->GetDeviceCount() > 0) ? m_pPlatform->GetDevice(0) : nullptr;
+
+    DeviceProperties properties = {};
+    if ((pDevice != nullptr) && (pDevice->GetProperties(&properties) == Result::Success))
+    {
+        const auto& memProps = properties.gpuMemoryProperties;
+        const uint32 memType = static_cast<uint32>(memProps.localMemoryType);
+
+        RmtFileChunkAdapterInfo adapterChunk = {};
+        Util::Strncpy(adapterChunk.name, properties.gpuName, sizeof(adapterChunk.name));
+        adapterChunk.familyId          = pDevice->ChipProperties().familyId;
+        adapterChunk.revisionId        = properties.revisionId;
+        adapterChunk.deviceId          = properties.deviceId;
+        adapterChunk.maxEngineClock    = static_cast<uint32>(properties.gfxipProperties.performance.maxGpuClock);
+        adapterChunk.maxMemoryClock    = static_cast<uint32>(memProps.performance.maxMemClock);
+        adapterChunk.memoryType        = (memType < RMT_MEMORY_TYPE_COUNT) ? memType : uint32(RMT_MEMORY_TYPE_UNKNOWN);
+        adapterChunk.memoryOpsPerClock = memProps.performance.memOpsPerClock;
+        adapterChunk.memoryBusWidth    = memProps.performance.vramBusBitWidth;
+        adapterChunk.memoryBandwidth   = (adapterChunk.maxMemoryClock * adapterChunk.memoryBusWidth / 8) *
+                                         adapterChunk.memoryOpsPerClock;
+
+        m_rmtWriter.WriteAdapterInfo(adapterChunk);
+    }
+}
+
 // =====================================================================================================================
 DevDriver::Result EventService::HandleRequest(
     IURIRequestContext* pContext)
@@ -57,7 +176,7 @@ DevDriver::Result EventService::HandleRequest(
     DD_ASSERT(pContext != nullptr);
 
     // Make sure we aren't logging while we handle a network request
-    Platform::LockGuard<Platform::Mutex> lock(m_mutex);
+    DevDriver::Platform::LockGuard<DevDriver::Platform::Mutex> lock(m_mutex);
 
     DevDriver::Result result = DevDriver::Result::Unavailable;
 
@@ -65,18 +184,49 @@ DevDriver::Result EventService::HandleRequest(
     char* pStrtokContext = nullptr;
 
     // Safety note: Strtok handles nullptr by returning nullptr. We handle that below.
-    char* pCmdName = Platform::Strtok(pContext->GetRequestArguments(), pArgDelim, &pStrtokContext);
-    char* pCmdArg1 = Platform::Strtok(nullptr, pArgDelim, &pStrtokContext);
+    char* pCmdName = DevDriver::Platform::Strtok(pContext->GetRequestArguments(), pArgDelim, &pStrtokContext);
+    char* pCmdArg1 = DevDriver::Platform::Strtok(nullptr, pArgDelim, &pStrtokContext);
 
     if (strcmp(pCmdName, "enableMemoryProfiling") == 0)
     {
         if (m_isMemoryProfilingEnabled == false)
         {
-            m_isMemoryProfilingEnabled = true;
-            result = DevDriver::Result::Success;
+            // An optional "packed" argument packs the trace's token data, which makes it considerably smaller. Packed
+            // traces have to be expanded with DevDriver::ExpandPackedRmtData before tools can load them.
+            const bool packTokenData = (pCmdArg1 != nullptr) && (strcmp(pCmdArg1, "packed") == 0);
+            if (packTokenData)
+            {
+                pCmdArg1 = DevDriver::Platform::Strtok(nullptr, pArgDelim, &pStrtokContext);
+            }
 
-            m_rmtWriter.Init();
-            m_rmtWriter.BeginDataChunk(Util::GetIdOfCurrentProcess(), 0);
+            // An optional file name argument streams the trace into that file instead of keeping it in memory
+            // until profiling is disabled. This keeps memory use bounded for long traces.
+            if (pCmdArg1 != nullptr)
+            {
+                result = OpenTraceFile(pCmdArg1);
+                if (result == DevDriver::Result::Success)
+                {
+                    // The file is never sent back through the service, so it has to be a complete RMT file
+                    m_rmtWriter.InitStreaming(&m_traceFileWriter, kTraceStreamFlushThreshold);
+                    WriteTraceFileHeader();
+                }
+            }
+            else
+            {
+                result = DevDriver::Result::Success;
+                m_rmtWriter.Init();
+            }
+
+            if (result == DevDriver::Result::Success)
+            {
+                if (packTokenData)
+                {
+                    m_rmtWriter.EnablePacking();
+                }
+
+                m_isMemoryProfilingEnabled = true;
+                m_rmtWriter.BeginDataChunk(Util::GetIdOfCurrentProcess(), 0);
+            }
         }
     }
     else if (strcmp(pCmdName, "disableMemoryProfiling") == 0)
@@ -89,6 +239,12 @@ DevDriver::Result EventService::HandleRequest(
             m_rmtWriter.EndDataChunk();
             m_rmtWriter.Finalize();
 
+            // A streamed trace is already complete in its file, so there's nothing to send back
+            if (m_rmtWriter.IsStreaming())
+            {
+                result = m_traceFileWriter.End();
+            }
+
             const size_t rmtDataSize = m_rmtWriter.GetRmtDataSize();
             if (rmtDataSize > 0)
             {
@@ -107,13 +263,31 @@ DevDriver::Result EventService::HandleRequest(
     return result;
 }
 
-void EventService::WriteTokenData(const DevDriver::RMT_TOKEN_DATA& token)
+void EventService::WriteEncodedTokens(
+    EventProtocol::EncodeEventDataFunc pfnEncode,
+    void*                              pUserdata)
 {
-    // Make sure we aren't logging while we handle a network request
-    Platform::LockGuard<Platform::Mutex> lock(m_mutex);
+    // Skip the lock entirely when memory profiling is off, the state is checked again once it's held
     if (IsMemoryProfilingEnabled())
     {
-        m_rmtWriter.WriteTokenData(token);
+        // Make sure we aren't logging while we handle a network request
+        DevDriver::Platform::LockGuard<DevDriver::Platform::Mutex> lock(m_mutex);
+        if (IsMemoryProfilingEnabled())
+        {
+            // The writer tracks its own timing, any timestamp tokens it needs are written ahead of the event's tokens
+            EventTimestamp timestamp   = {};
+            timestamp.type             = EventTimestampType::SmallDelta;
+            timestamp.smallDelta.delta = m_rmtWriter.CalculateDelta();
+
+            EventProtocol::EncodedEventData tokenData(m_allocCb);
+            const DevDriver::Result result = tokenData.Encode(pfnEncode, pUserdata, timestamp);
+
+            if (result == DevDriver::Result::Success)
+            {
+                const RMT_TOKEN_DATA tokens = { static_cast<uint8*>(tokenData.Data()), tokenData.Size() };
+                m_rmtWriter.WriteTokenData(tokens);
+            }
+        }
     }
 }
 
@@ -27,19 +27,47 @@
 
 #include "ddUriInterface.h"
 #include "palEventDefs.h"
+#include "palFile.h"
+#include "protocols/ddEventProvider.h"
 #include "util/rmtWriter.h"
 
 namespace Pal
 {
+    class Platform;
+
     // String used to identify the service
     DD_STATIC_CONST char kEventServiceName[] = "event";
 
-    DD_STATIC_CONST DevDriver::Version kEventServiceVersion = 1;
+    // Version 2 allows enableMemoryProfiling to stream the trace into a file
+    // Version 3 allows enableMemoryProfiling to pack the trace's token data
+    // Version 4 only accepts a file name for the streamed trace, the file is created in the event log directory
+    DD_STATIC_CONST DevDriver::Version kEventServiceVersion = 4;
+
+    // Amount of trace data that's kept in memory before it gets written out when streaming into a file
+    DD_STATIC_CONST size_t kTraceStreamFlushThreshold = 1024 * 1024;
+
+    // Writes a streamed memory trace into a file
+    class TraceFileWriter : public DevDriver::IByteWriter
+    {
+    public:
+        TraceFileWriter() : m_result(DevDriver::Result::Success) {}
+        ~TraceFileWriter() {}
+
+        DevDriver::Result Open(const char* pFilePath);
+
+        // Closes the file and returns the first error encountered while writing to it
+        DevDriver::Result End() override;
+        void WriteBytes(const void* pBytes, size_t length) override;
+
+    private:
+        Util::File        m_file;
+        DevDriver::Result m_result;
+    };
 
     class EventService : public DevDriver::IService
     {
     public:
-        EventService(const DevDriver::AllocCb& allocCb);
+        EventService(Platform* pPlatform, const DevDriver::AllocCb& allocCb);
         ~EventService();
 
         // Returns the name of the service
@@ -57,11 +85,21 @@ namespace Pal
             return m_rmtWriter.CalculateDelta();
         }
 
-        void WriteTokenData(const DevDriver::RMT_TOKEN_DATA& token);
+        // Writes the RMT tokens produced by pfnEncode into the trace if memory profiling is enabled
+        void WriteEncodedTokens(DevDriver::EventProtocol::EncodeEventDataFunc pfnEncode, void* pUserdata);
 
     private:
+        // Opens the named file in the event log directory for a streamed trace
+        DevDriver::Result OpenTraceFile(const char* pFileName);
+
+        // Writes the RMT file header along with the system and adapter info chunks
+        void WriteTraceFileHeader();
+
+        Platform*                  m_pPlatform;
+        DevDriver::AllocCb         m_allocCb;
         DevDriver::Platform::Mutex m_mutex;
         DevDriver::RmtWriter       m_rmtWriter;
+        TraceFileWriter            m_traceFileWriter;
         bool                       m_isMemoryProfilingEnabled;
         bool                       m_isInitialized;
 };
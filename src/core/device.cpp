@@ -214,6 +214,7 @@ Device::Device(
     :
     m_pPlatform(pPlatform),
     m_memMgr(this),
+    m_pipelineBinaryStore(pPlatform),
     m_connectedPrivateScreens(0),
     m_emulatedPrivateScreens(0),
     m_emulatedTargetId(UINT_MAX),
@@ -462,6 +463,11 @@ Result Device::EarlyInit(
         result = m_referencedGpuMem.Init();
     }
 
+    if (result == Result::Success)
+    {
+        result = m_pipelineBinaryStore.Init();
+    }
+
     if (result == Result::Success)
     {
         result = m_queueLock.Init();
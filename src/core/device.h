@@ -32,6 +32,7 @@
 #include "core/hw/ossip/ossDevice.h"
 #include "core/addrMgr/addrMgr.h"
 #include "core/dmaUploadRing.h"
+#include "core/pipelineBinaryStore.h"
 #include "palCmdAllocator.h"
 #include "palDevice.h"
 #include "palDeque.h"
@@ -1657,6 +1658,8 @@ public:
 
     InternalMemMgr* MemMgr() { return &m_memMgr; }
 
+    PipelineBinaryStore* GetPipelineBinaryStore() { return &m_pipelineBinaryStore; }
+
     // Returns the internal tracked command allocator except for engines that do not support tracking.
     CmdAllocator* InternalCmdAllocator(EngineType engineType) const
         { return m_pTrackedCmdAllocator; }
@@ -1990,8 +1993,9 @@ protected:
     uint32 GetDeviceIndex() const
         { return m_deviceIndex; }
 
-    Platform*      m_pPlatform;
-    InternalMemMgr m_memMgr;
+    Platform*           m_pPlatform;
+    InternalMemMgr      m_memMgr;
+    PipelineBinaryStore m_pipelineBinaryStore;  // ELF binaries shared by this device's pipelines and shader libraries
 
     // An array stores enumerated private screens info and only m_connectedPrivateScreens out of them are valid.
     PrivateScreenCreateInfo m_privateScreenInfo[MaxPrivateScreens];
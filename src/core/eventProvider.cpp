@@ -50,6 +50,53 @@ namespace Pal
 
 static constexpr uint32 kEventFlushTimeoutInMs = 10;
 
+// =====================================================================================================================
+// A fixed size buffer that a PalEvent's RMT tokens are written into before being handed off as a single block.
+class RmtTokenBuffer
+{
+public:
+    RmtTokenBuffer(void* pBuffer, size_t bufferSize)
+        :
+        m_pBuffer(static_cast<uint8*>(pBuffer)),
+        m_bufferSize(bufferSize),
+        m_dataSize(0),
+        m_overflowed(false)
+        {}
+
+    // Tokens that don't fit are still counted so that the size of the buffer they need can be reported.
+    void WriteTokenData(const RMT_TOKEN_DATA& token)
+    {
+        if ((m_dataSize + token.Size()) <= m_bufferSize)
+        {
+            memcpy(m_pBuffer + m_dataSize, token.Data(), token.Size());
+        }
+        else
+        {
+            m_overflowed = true;
+        }
+
+        m_dataSize += token.Size();
+    }
+
+    // Returns the size of every token written so far, including any that overflowed the buffer.
+    size_t DataSize() const { return m_dataSize; }
+    bool Overflowed() const { return m_overflowed; }
+
+private:
+    uint8*const  m_pBuffer;
+    const size_t m_bufferSize;
+    size_t       m_dataSize;
+    bool         m_overflowed;
+};
+
+// The data needed to encode a PalEvent once its timestamp is known.
+struct RmtEventInfo
+{
+    PalEvent    eventId;
+    const void* pEventData;
+    size_t      eventDataSize;
+};
+
 static const char kEventDescription[] = "All available events are RmtTokens directly embedded.";
 
 const void* EventProvider::GetEventDescriptionData() const
@@ -70,8 +117,7 @@ EventProvider::EventProvider(Platform* pPlatform)
             kEventFlushTimeoutInMs
         ),
         m_pPlatform(pPlatform),
-        m_eventService({ pPlatform, DevDriverAlloc, DevDriverFree }),
-        m_eventTimer()
+        m_eventService(pPlatform, { pPlatform, DevDriverAlloc, DevDriverFree })
         {}
 
 // =====================================================================================================================
@@ -392,209 +438,241 @@ void EventProvider::LogEvent(
     if (ShouldLog(eventId))
     {
         // The RMT format requires that certain tokens strictly follow each other (e.g. resource create + description),
-        // so we need to lock to ensure another event isn't inserted into the stream while writing dependent tokens.
-        DevDriver::Platform::LockGuard<DevDriver::Platform::Mutex> providerLock(m_providerLock);
+        // so all of an event's tokens are encoded into one block. The event protocol writes every encoded event into
+        // one stream and times it against that stream's timer, so the RMT timeline stays in order across threads.
+        RmtEventInfo eventInfo = { eventId, pEventData, eventDataSize };
 
-        const EventTimestamp timestamp = m_eventTimer.CreateTimestamp();
-        uint8 delta = 0;
+        WriteEncodedEvent(static_cast<uint32>(PalEvent::RmtToken), &EncodeRmtTokens, &eventInfo);
+        m_eventService.WriteEncodedTokens(&EncodeRmtTokens, &eventInfo);
+    }
+}
 
-        if (timestamp.type == EventTimestampType::Full)
-        {
-            RMT_MSG_TIMESTAMP tsToken(timestamp.full.timestamp, timestamp.full.frequency);
-            WriteTokenData(tsToken);
-        }
-        else if (timestamp.type == EventTimestampType::LargeDelta)
+// =====================================================================================================================
+DevDriver::Result EventProvider::EncodeRmtTokens(
+    void*                 pUserdata,
+    const EventTimestamp& timestamp,
+    void*                 pBuffer,
+    size_t                bufferSize,
+    size_t*               pEventDataSize)
+{
+    const auto* pEventInfo = static_cast<const RmtEventInfo*>(pUserdata);
+
+    RmtTokenBuffer tokens(pBuffer, bufferSize);
+    EncodeEvent(pEventInfo->eventId, pEventInfo->pEventData, pEventInfo->eventDataSize, timestamp, &tokens);
+
+    // If the tokens overflowed, this is the buffer size needed to encode them all on the next attempt.
+    *pEventDataSize = tokens.DataSize();
+
+    return tokens.Overflowed() ? DevDriver::Result::InsufficientMemory : DevDriver::Result::Success;
+}
+
+// =====================================================================================================================
+void EventProvider::EncodeEvent(
+    PalEvent              eventId,
+    const void*           pEventData,
+    size_t                eventDataSize,
+    const EventTimestamp& timestamp,
+    RmtTokenBuffer*       pTokens)
+{
+    uint8 delta = 0;
+
+    if (timestamp.type == EventTimestampType::Full)
+    {
+        RMT_MSG_TIMESTAMP tsToken(timestamp.full.timestamp, timestamp.full.frequency);
+        pTokens->WriteTokenData(tsToken);
+    }
+    else if (timestamp.type == EventTimestampType::LargeDelta)
+    {
+        RMT_MSG_TIME_DELTA tdToken(timestamp.largeDelta.delta, timestamp.largeDelta.numBytes);
+        pTokens->WriteTokenData(tdToken);
+    }
+    else
+    {
+        delta = timestamp.smallDelta.delta;
+    }
+
+    switch (eventId)
+    {
+        case PalEvent::Count:
+        case PalEvent::Invalid:
         {
-            RMT_MSG_TIME_DELTA tdToken(timestamp.largeDelta.delta, timestamp.largeDelta.numBytes);
-            WriteTokenData(tdToken);
+            PAL_ASSERT_ALWAYS();
+            break;
         }
-        else
+        case PalEvent::RmtToken:
         {
-            delta = timestamp.smallDelta.delta;
+            // RmtTokens should not be logged throug this function
+            PAL_ASSERT_ALWAYS();
+            break;
         }
-
-        switch (eventId)
+        case PalEvent::CreateGpuMemory:
         {
-            case PalEvent::Count:
-            case PalEvent::Invalid:
-            {
-                PAL_ASSERT_ALWAYS();
-                break;
-            }
-            case PalEvent::RmtToken:
-            {
-                // RmtTokens should not be logged throug this function
-                PAL_ASSERT_ALWAYS();
-                break;
-            }
-            case PalEvent::CreateGpuMemory:
-            {
-                PAL_ASSERT(sizeof(CreateGpuMemoryData) == eventDataSize);
+            PAL_ASSERT(sizeof(CreateGpuMemoryData) == eventDataSize);
 
-                const CreateGpuMemoryData* pData = reinterpret_cast<const CreateGpuMemoryData*>(pEventData);
+            const CreateGpuMemoryData* pData = reinterpret_cast<const CreateGpuMemoryData*>(pEventData);
 
-                RMT_MSG_VIRTUAL_ALLOCATE eventToken(
-                    delta,
-                    pData->size,
-                    pData->isInternal ? RMT_OWNER_CLIENT_DRIVER : RMT_OWNER_APP, // For now we only distinguish between driver
-                                                                                 // app ownership
-                    pData->gpuVirtualAddr,
-                    PalToRmtHeapType(pData->preferredHeap),
-                    RMT_HEAP_TYPE_LOCAL,
-                    RMT_HEAP_TYPE_LOCAL,
-                    RMT_HEAP_TYPE_LOCAL);
+            RMT_MSG_VIRTUAL_ALLOCATE eventToken(
+                delta,
+                pData->size,
+                pData->isInternal ? RMT_OWNER_CLIENT_DRIVER : RMT_OWNER_APP, // For now we only distinguish between driver
+                                                                             // app ownership
+                pData->gpuVirtualAddr,
+                PalToRmtHeapType(pData->preferredHeap),
+                RMT_HEAP_TYPE_LOCAL,
+                RMT_HEAP_TYPE_LOCAL,
+                RMT_HEAP_TYPE_LOCAL);
 
-                WriteTokenData(eventToken);
+            pTokens->WriteTokenData(eventToken);
 
-                break;
-            }
-            case PalEvent::DestroyGpuMemory:
-            {
-                PAL_ASSERT(sizeof(DestroyGpuMemoryData) == eventDataSize);
+            break;
+        }
+        case PalEvent::DestroyGpuMemory:
+        {
+            PAL_ASSERT(sizeof(DestroyGpuMemoryData) == eventDataSize);
 
-                const DestroyGpuMemoryData* pData = reinterpret_cast<const DestroyGpuMemoryData*>(pEventData);
+            const DestroyGpuMemoryData* pData = reinterpret_cast<const DestroyGpuMemoryData*>(pEventData);
 
-                RMT_MSG_FREE_VIRTUAL eventToken(delta, pData->gpuVirtualAddr);
+            RMT_MSG_FREE_VIRTUAL eventToken(delta, pData->gpuVirtualAddr);
 
-                WriteTokenData(eventToken);
+            pTokens->WriteTokenData(eventToken);
 
-                break;
-            }
-            case PalEvent::GpuMemoryResourceCreate:
-            {
-                LogResourceCreateEvent(delta, pEventData, eventDataSize);
-                break;
-            }
-            case PalEvent::GpuMemoryResourceDestroy:
-            {
-                PAL_ASSERT(sizeof(GpuMemoryResourceDestroyData) == eventDataSize);
-                const GpuMemoryResourceDestroyData* pData = reinterpret_cast<const GpuMemoryResourceDestroyData*>(pEventData);
+            break;
+        }
+        case PalEvent::GpuMemoryResourceCreate:
+        {
+            EncodeResourceCreateEvent(delta, pEventData, eventDataSize, pTokens);
+            break;
+        }
+        case PalEvent::GpuMemoryResourceDestroy:
+        {
+            PAL_ASSERT(sizeof(GpuMemoryResourceDestroyData) == eventDataSize);
+            const GpuMemoryResourceDestroyData* pData = reinterpret_cast<const GpuMemoryResourceDestroyData*>(pEventData);
 
-                RMT_MSG_RESOURCE_DESTROY eventToken(delta, static_cast<uint32>(pData->handle));
+            RMT_MSG_RESOURCE_DESTROY eventToken(delta, static_cast<uint32>(pData->handle));
 
-                WriteTokenData(eventToken);
+            pTokens->WriteTokenData(eventToken);
 
-                break;
-            }
-            case PalEvent::GpuMemoryMisc:
-            {
-                PAL_ASSERT(sizeof(GpuMemoryMiscData) == eventDataSize);
-                const GpuMemoryMiscData* pData = reinterpret_cast<const GpuMemoryMiscData*>(pEventData);
+            break;
+        }
+        case PalEvent::GpuMemoryMisc:
+        {
+            PAL_ASSERT(sizeof(GpuMemoryMiscData) == eventDataSize);
+            const GpuMemoryMiscData* pData = reinterpret_cast<const GpuMemoryMiscData*>(pEventData);
 
-                RMT_MSG_MISC eventToken(delta, PalToRmtMiscEventType(pData->type));
+            RMT_MSG_MISC eventToken(delta, PalToRmtMiscEventType(pData->type));
 
-                WriteTokenData(eventToken);
-                break;
-            }
-            case PalEvent::GpuMemorySnapshot:
-            {
-                PAL_ASSERT(sizeof(GpuMemorySnapshotData) == eventDataSize);
-                const GpuMemorySnapshotData* pData = reinterpret_cast<const GpuMemorySnapshotData*>(pEventData);
+            pTokens->WriteTokenData(eventToken);
+            break;
+        }
+        case PalEvent::GpuMemorySnapshot:
+        {
+            PAL_ASSERT(sizeof(GpuMemorySnapshotData) == eventDataSize);
+            const GpuMemorySnapshotData* pData = reinterpret_cast<const GpuMemorySnapshotData*>(pEventData);
 
-                RMT_MSG_USERDATA_EMBEDDED_STRING eventToken(
-                    delta,
-                    RMT_USERDATA_EVENT_TYPE_SNAPSHOT,
-                    pData->pSnapshotName);
+            RMT_MSG_USERDATA_EMBEDDED_STRING eventToken(
+                delta,
+                RMT_USERDATA_EVENT_TYPE_SNAPSHOT,
+                pData->pSnapshotName);
 
-                WriteTokenData(eventToken);
-                break;
-            }
-            case PalEvent::DebugName:
-            {
-                PAL_ASSERT(sizeof(DebugNameData) == eventDataSize);
-                const DebugNameData* pData = reinterpret_cast<const DebugNameData*>(pEventData);
+            pTokens->WriteTokenData(eventToken);
+            break;
+        }
+        case PalEvent::DebugName:
+        {
+            PAL_ASSERT(sizeof(DebugNameData) == eventDataSize);
+            const DebugNameData* pData = reinterpret_cast<const DebugNameData*>(pEventData);
 
-                RMT_MSG_USERDATA_DEBUG_NAME eventToken(
-                    delta,
-                    pData->pDebugName,
-                    static_cast<uint32>(pData->handle));
+            RMT_MSG_USERDATA_DEBUG_NAME eventToken(
+                delta,
+                pData->pDebugName,
+                static_cast<uint32>(pData->handle));
 
-                WriteTokenData(eventToken);
-                break;
-            }
-            case PalEvent::GpuMemoryResourceBind:
-            {
-                PAL_ASSERT(sizeof(GpuMemoryResourceBindData) == eventDataSize);
-                const GpuMemoryResourceBindData* pData =
-                    reinterpret_cast<const GpuMemoryResourceBindData*>(pEventData);
+            pTokens->WriteTokenData(eventToken);
+            break;
+        }
+        case PalEvent::GpuMemoryResourceBind:
+        {
+            PAL_ASSERT(sizeof(GpuMemoryResourceBindData) == eventDataSize);
+            const GpuMemoryResourceBindData* pData =
+                reinterpret_cast<const GpuMemoryResourceBindData*>(pEventData);
 
-                RMT_MSG_RESOURCE_BIND eventToken(
-                    delta,
-                    pData->gpuVirtualAddr + pData->offset,
-                    pData->requiredSize,
-                    static_cast<uint32>(pData->resourceHandle),
-                    pData->isSystemMemory);
+            RMT_MSG_RESOURCE_BIND eventToken(
+                delta,
+                pData->gpuVirtualAddr + pData->offset,
+                pData->requiredSize,
+                static_cast<uint32>(pData->resourceHandle),
+                pData->isSystemMemory);
 
-                WriteTokenData(eventToken);
+            pTokens->WriteTokenData(eventToken);
 
-                GpuMemory* pGpuMemory = reinterpret_cast<GpuMemory*>(pData->handle);
-                if (pGpuMemory != nullptr)
+            GpuMemory* pGpuMemory = reinterpret_cast<GpuMemory*>(pData->handle);
+            if (pGpuMemory != nullptr)
+            {
+                if (pData->requiredSize > pGpuMemory->Desc().size)
                 {
-                    if (pData->requiredSize > pGpuMemory->Desc().size)
-                    {
-                        // GPU memory smaller than resource size
-                        DD_ASSERT_ALWAYS();
-                    }
+                    // GPU memory smaller than resource size
+                    DD_ASSERT_ALWAYS();
                 }
-                break;
             }
-            case PalEvent::GpuMemoryCpuMap:
-            {
-                PAL_ASSERT(sizeof(GpuMemoryCpuMapData) == eventDataSize);
-                const GpuMemoryCpuMapData* pData = reinterpret_cast<const GpuMemoryCpuMapData*>(pEventData);
+            break;
+        }
+        case PalEvent::GpuMemoryCpuMap:
+        {
+            PAL_ASSERT(sizeof(GpuMemoryCpuMapData) == eventDataSize);
+            const GpuMemoryCpuMapData* pData = reinterpret_cast<const GpuMemoryCpuMapData*>(pEventData);
 
-                RMT_MSG_CPU_MAP eventToken(delta, pData->gpuVirtualAddr, false);
+            RMT_MSG_CPU_MAP eventToken(delta, pData->gpuVirtualAddr, false);
 
-                WriteTokenData(eventToken);
-                break;
-            }
-            case PalEvent::GpuMemoryCpuUnmap:
-            {
-                PAL_ASSERT(sizeof(GpuMemoryCpuUnmapData) == eventDataSize);
-                const GpuMemoryCpuUnmapData* pData = reinterpret_cast<const GpuMemoryCpuUnmapData*>(pEventData);
+            pTokens->WriteTokenData(eventToken);
+            break;
+        }
+        case PalEvent::GpuMemoryCpuUnmap:
+        {
+            PAL_ASSERT(sizeof(GpuMemoryCpuUnmapData) == eventDataSize);
+            const GpuMemoryCpuUnmapData* pData = reinterpret_cast<const GpuMemoryCpuUnmapData*>(pEventData);
 
-                RMT_MSG_CPU_MAP eventToken(delta, pData->gpuVirtualAddr, true);
+            RMT_MSG_CPU_MAP eventToken(delta, pData->gpuVirtualAddr, true);
 
-                WriteTokenData(eventToken);
-                break;
-            }
-            case PalEvent::GpuMemoryAddReference:
-            {
-                PAL_ASSERT(sizeof(GpuMemoryAddReferenceData) == eventDataSize);
-                const GpuMemoryAddReferenceData* pData = reinterpret_cast<const GpuMemoryAddReferenceData*>(pEventData);
+            pTokens->WriteTokenData(eventToken);
+            break;
+        }
+        case PalEvent::GpuMemoryAddReference:
+        {
+            PAL_ASSERT(sizeof(GpuMemoryAddReferenceData) == eventDataSize);
+            const GpuMemoryAddReferenceData* pData = reinterpret_cast<const GpuMemoryAddReferenceData*>(pEventData);
 
-                RMT_MSG_RESOURCE_REFERENCE eventToken(
-                    delta,
-                    false,   // isRemove
-                    pData->gpuVirtualAddr,
-                    static_cast<uint8>(pData->queueHandle));
+            RMT_MSG_RESOURCE_REFERENCE eventToken(
+                delta,
+                false,   // isRemove
+                pData->gpuVirtualAddr,
+                static_cast<uint8>(pData->queueHandle));
 
-                WriteTokenData(eventToken);
-                break;
-            }
-            case PalEvent::GpuMemoryRemoveReference:
-            {
-                PAL_ASSERT(sizeof(GpuMemoryRemoveReferenceData) == eventDataSize);
-                const GpuMemoryRemoveReferenceData* pData = reinterpret_cast<const GpuMemoryRemoveReferenceData*>(pEventData);
+            pTokens->WriteTokenData(eventToken);
+            break;
+        }
+        case PalEvent::GpuMemoryRemoveReference:
+        {
+            PAL_ASSERT(sizeof(GpuMemoryRemoveReferenceData) == eventDataSize);
+            const GpuMemoryRemoveReferenceData* pData = reinterpret_cast<const GpuMemoryRemoveReferenceData*>(pEventData);
 
-                RMT_MSG_RESOURCE_REFERENCE eventToken(
-                    delta,
-                    true,   // isRemove
-                    pData->gpuVirtualAddr,
-                    static_cast<uint8>(pData->queueHandle));
+            RMT_MSG_RESOURCE_REFERENCE eventToken(
+                delta,
+                true,   // isRemove
+                pData->gpuVirtualAddr,
+                static_cast<uint8>(pData->queueHandle));
 
-                WriteTokenData(eventToken);
-                break;
-            }
+            pTokens->WriteTokenData(eventToken);
+            break;
         }
     }
 }
 
 // =====================================================================================================================
-void EventProvider::LogResourceCreateEvent(
-    uint8       delta,
-    const void* pEventData,
-    size_t      eventDataSize)
+void EventProvider::EncodeResourceCreateEvent(
+    uint8           delta,
+    const void*     pEventData,
+    size_t          eventDataSize,
+    RmtTokenBuffer* pTokens)
 {
     PAL_ASSERT(eventDataSize == sizeof(GpuMemoryResourceCreateData));
     const auto* pRsrcCreateData = reinterpret_cast<const GpuMemoryResourceCreateData*>(pEventData);
@@ -606,7 +684,7 @@ void EventProvider::LogResourceCreateEvent(
         0,
         RMT_COMMIT_TYPE_COMMITTED,
         PalToRmtResourceType(pRsrcCreateData->type));
-    WriteTokenData(rsrcCreateToken);
+    pTokens->WriteTokenData(rsrcCreateToken);
 
     switch (pRsrcCreateData->type)
     {
@@ -643,7 +721,7 @@ void EventProvider::LogResourceCreateEvent(
 
         RMT_RESOURCE_TYPE_IMAGE_TOKEN imgDesc(imgCreateInfo);
 
-        WriteTokenData(imgDesc);
+        pTokens->WriteTokenData(imgDesc);
         break;
     }
 
@@ -658,7 +736,7 @@ void EventProvider::LogResourceCreateEvent(
             static_cast<uint16>(pBufferData->usageFlags),
             pBufferData->size);
 
-        WriteTokenData(bufferDesc);
+        pTokens->WriteTokenData(bufferDesc);
         break;
     }
 
@@ -690,7 +768,7 @@ void EventProvider::LogResourceCreateEvent(
 
         RMT_RESOURCE_TYPE_PIPELINE_TOKEN pipelineDesc(flags, hash, stages, false);
 
-        WriteTokenData(pipelineDesc);
+        pTokens->WriteTokenData(pipelineDesc);
         break;
     }
 
@@ -741,7 +819,7 @@ void EventProvider::LogResourceCreateEvent(
             RMT_PAGE_SIZE_4KB,  //< @TODO - we don't currently have this info, so just set to 4KB
             static_cast<uint8>(pHeapData->preferredGpuHeap));
 
-        WriteTokenData(heapDesc);
+        pTokens->WriteTokenData(heapDesc);
         break;
     }
 
@@ -753,7 +831,7 @@ void EventProvider::LogResourceCreateEvent(
         const bool isGpuOnly = (pGpuEventData->pCreateInfo->flags.gpuAccessOnly == 1);
         RMT_RESOURCE_TYPE_GPU_EVENT_TOKEN gpuEventDesc(isGpuOnly);
 
-        WriteTokenData(gpuEventDesc);
+        pTokens->WriteTokenData(gpuEventDesc);
         break;
     }
 
@@ -764,7 +842,7 @@ void EventProvider::LogResourceCreateEvent(
 
         RMT_RESOURCE_TYPE_BORDER_COLOR_PALETTE_TOKEN bcpDesc(static_cast<uint8>(pBcpData->pCreateInfo->paletteSize));
 
-        WriteTokenData(bcpDesc);
+        pTokens->WriteTokenData(bcpDesc);
         break;
     }
 
@@ -779,7 +857,7 @@ void EventProvider::LogResourceCreateEvent(
             static_cast<uint32>(pPerfExperimentData->sqttSize),
             static_cast<uint32>(pPerfExperimentData->perfCounterSize));
 
-        WriteTokenData(perfExperimentDesc);
+        pTokens->WriteTokenData(perfExperimentDesc);
         break;
     }
 
@@ -792,7 +870,7 @@ void EventProvider::LogResourceCreateEvent(
             PalToRmtQueryHeapType(pQueryPoolData->pCreateInfo->queryPoolType),
             (pQueryPoolData->pCreateInfo->flags.enableCpuAccess == 1));
 
-        WriteTokenData(queryHeapDesc);
+        pTokens->WriteTokenData(queryHeapDesc);
         break;
     }
 
@@ -818,7 +896,7 @@ void EventProvider::LogResourceCreateEvent(
             static_cast<uint8>(pDescriptorHeapData->nodeMask),
             static_cast<uint16>(pDescriptorHeapData->numDescriptors));
 
-        WriteTokenData(descriptorHeapDesc);
+        pTokens->WriteTokenData(descriptorHeapDesc);
         break;
     }
 
@@ -832,7 +910,7 @@ void EventProvider::LogResourceCreateEvent(
             static_cast<uint16>(pDescriptorPoolData->maxSets),
             static_cast<uint8>(pDescriptorPoolData->numPoolSize));
 
-        WriteTokenData(poolSizeDesc);
+        pTokens->WriteTokenData(poolSizeDesc);
 
         // Then loop through writing RMT_POOL_SIZE_DESCs
         for (uint32 i = 0; i < pDescriptorPoolData->numPoolSize; ++i)
@@ -841,7 +919,7 @@ void EventProvider::LogResourceCreateEvent(
                 PalToRmtDescriptorType(pDescriptorPoolData->pPoolSizes[i].type),
                 static_cast<uint16>(pDescriptorPoolData->pPoolSizes[i].numDescriptors));
 
-            WriteTokenData(poolSize);
+            pTokens->WriteTokenData(poolSize);
         }
         break;
     }
@@ -864,7 +942,7 @@ void EventProvider::LogResourceCreateEvent(
             pCmdAllocatorData->pCreateInfo->allocInfo[CmdAllocType::GpuScratchMemAlloc].allocSize,
             pCmdAllocatorData->pCreateInfo->allocInfo[CmdAllocType::GpuScratchMemAlloc].suballocSize);
 
-        WriteTokenData(cmdAllocatorDesc);
+        pTokens->WriteTokenData(cmdAllocatorDesc);
         break;
     }
 
@@ -876,7 +954,7 @@ void EventProvider::LogResourceCreateEvent(
 
         RMT_RESOURCE_TYPE_MISC_INTERNAL_TOKEN miscInternalDesc(PalToRmtMiscInternalType(pMiscInternalData->type));
 
-        WriteTokenData(miscInternalDesc);
+        pTokens->WriteTokenData(miscInternalDesc);
         break;
     }
 
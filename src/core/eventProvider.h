@@ -46,6 +46,7 @@ class Device;
 class GpuMemory;
 class Platform;
 class Queue;
+class RmtTokenBuffer;
 
 // =====================================================================================================================
 // The PalEventProvider class is a class derived from DevDriver EventProvider that is be responsible for logging
@@ -118,27 +119,34 @@ public:
 private:
     bool ShouldLog(PalEvent eventId) const;
 
-    // Logs a PalEvent by translating it into one or more RMT Tokens and passing it into WriteTokenData
+    // Logs a PalEvent by translating it into one or more RMT Tokens and writing them to both the service and the event
+    // protocol
     void LogEvent(PalEvent eventId, const void* pEventData, size_t eventDataSize);
 
-    // Hepler method for LogEvent
-    void LogResourceCreateEvent(uint8 delta, const void* pEventData, size_t eventDataSize);
-
-    // Write an RMT token to both the service and event protocol
-    void WriteTokenData(const DevDriver::RMT_TOKEN_DATA& token)
-    {
-        WriteEvent(
-            static_cast<uint32>(PalEvent::RmtToken),
-            token.Data(),
-            token.Size()
-        );
-        m_eventService.WriteTokenData(token);
-    }
+    // Translates a PalEvent into RMT tokens, timed by the provided timestamp. This is the encode callback LogEvent
+    // passes to both the event protocol and the service, since each of them tracks event timing on its own.
+    static DevDriver::Result EncodeRmtTokens(
+        void*                            pUserdata,
+        const DevDriver::EventTimestamp& timestamp,
+        void*                            pBuffer,
+        size_t                           bufferSize,
+        size_t*                          pEventDataSize);
+
+    // Hepler methods for EncodeRmtTokens
+    static void EncodeEvent(
+        PalEvent                         eventId,
+        const void*                      pEventData,
+        size_t                           eventDataSize,
+        const DevDriver::EventTimestamp& timestamp,
+        RmtTokenBuffer*                  pTokens);
+    static void EncodeResourceCreateEvent(
+        uint8           delta,
+        const void*     pEventData,
+        size_t          eventDataSize,
+        RmtTokenBuffer* pTokens);
 
     Platform*                  m_pPlatform;
     EventService               m_eventService;
-    DevDriver::EventTimer      m_eventTimer;
-    DevDriver::Platform::Mutex m_providerLock;
 
     PAL_DISALLOW_COPY_AND_ASSIGN(EventProvider);
 };
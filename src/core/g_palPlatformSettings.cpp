@@ -134,8 +134,10 @@ void PlatformSettingsLoader::SetupDefaults()
     m_settings.gpuProfilerConfig.frameCount = 0;
     m_settings.gpuProfilerConfig.recordPipelineStats = false;
     m_settings.gpuProfilerConfig.breakSubmitBatches = false;
+    m_settings.gpuProfilerConfig.replayThreadCount = 0;
     m_settings.gpuProfilerConfig.ignoreNonDrawDispatchCmdBufs = false;
     m_settings.gpuProfilerConfig.useFullPipelineHash = false;
+    m_settings.gpuProfilerConfig.binaryTraceOutput = false;
     m_settings.gpuProfilerConfig.traceModeMask = 0x0;
     m_settings.gpuProfilerConfig.granularity = GpuProfilerGranularityDraw;
     memset(m_settings.gpuProfilerPerfCounterConfig.globalPerfCounterConfigFile, 0, 256);
@@ -194,6 +196,10 @@ void PlatformSettingsLoader::SetupDefaults()
     strncpy(m_settings.interfaceLoggerConfig.logDirectory, "amdpal/", 512);
 #endif
     m_settings.interfaceLoggerConfig.multithreaded = false;
+    m_settings.interfaceLoggerConfig.mergeThreadLogs = false;
+    m_settings.interfaceLoggerConfig.streamOutput = false;
+    m_settings.interfaceLoggerConfig.backgroundWrite = false;
+    m_settings.interfaceLoggerConfig.binaryOutput = false;
     m_settings.interfaceLoggerConfig.basePreset = 0x7;
     m_settings.interfaceLoggerConfig.elevatedPreset = 0x1f;
 
@@ -432,6 +438,11 @@ void PlatformSettingsLoader::ReadSettings(Pal::Device* pDevice)
                            &m_settings.gpuProfilerConfig.breakSubmitBatches,
                            InternalSettingScope::PrivatePalKey);
 
+    pDevice->ReadSetting(pGpuProfilerConfig_ReplayThreadCountStr,
+                           Util::ValueType::Uint,
+                           &m_settings.gpuProfilerConfig.replayThreadCount,
+                           InternalSettingScope::PrivatePalKey);
+
     pDevice->ReadSetting(pGpuProfilerConfig_IgnoreNonDrawDispatchCmdBufsStr,
                            Util::ValueType::Boolean,
                            &m_settings.gpuProfilerConfig.ignoreNonDrawDispatchCmdBufs,
@@ -442,6 +453,11 @@ void PlatformSettingsLoader::ReadSettings(Pal::Device* pDevice)
                            &m_settings.gpuProfilerConfig.useFullPipelineHash,
                            InternalSettingScope::PrivatePalKey);
 
+    pDevice->ReadSetting(pGpuProfilerConfig_BinaryTraceOutputStr,
+                           Util::ValueType::Boolean,
+                           &m_settings.gpuProfilerConfig.binaryTraceOutput,
+                           InternalSettingScope::PrivatePalKey);
+
     pDevice->ReadSetting(pGpuProfilerConfig_TraceModeMaskStr,
                            Util::ValueType::Uint,
                            &m_settings.gpuProfilerConfig.traceModeMask,
@@ -662,6 +678,26 @@ void PlatformSettingsLoader::ReadSettings(Pal::Device* pDevice)
                            &m_settings.interfaceLoggerConfig.multithreaded,
                            InternalSettingScope::PrivatePalKey);
 
+    pDevice->ReadSetting(pInterfaceLoggerConfig_MergeThreadLogsStr,
+                           Util::ValueType::Boolean,
+                           &m_settings.interfaceLoggerConfig.mergeThreadLogs,
+                           InternalSettingScope::PrivatePalKey);
+
+    pDevice->ReadSetting(pInterfaceLoggerConfig_StreamOutputStr,
+                           Util::ValueType::Boolean,
+                           &m_settings.interfaceLoggerConfig.streamOutput,
+                           InternalSettingScope::PrivatePalKey);
+
+    pDevice->ReadSetting(pInterfaceLoggerConfig_BackgroundWriteStr,
+                           Util::ValueType::Boolean,
+                           &m_settings.interfaceLoggerConfig.backgroundWrite,
+                           InternalSettingScope::PrivatePalKey);
+
+    pDevice->ReadSetting(pInterfaceLoggerConfig_BinaryOutputStr,
+                           Util::ValueType::Boolean,
+                           &m_settings.interfaceLoggerConfig.binaryOutput,
+                           InternalSettingScope::PrivatePalKey);
+
     pDevice->ReadSetting(pInterfaceLoggerConfig_BasePresetStr,
                            Util::ValueType::Uint,
                            &m_settings.interfaceLoggerConfig.basePreset,
@@ -913,6 +949,11 @@ void PlatformSettingsLoader::InitSettingsInfo()
     info.valueSize = sizeof(m_settings.gpuProfilerConfig.breakSubmitBatches);
     m_settingsInfoMap.Insert(2743656777, info);
 
+    info.type      = SettingType::Uint;
+    info.pValuePtr = &m_settings.gpuProfilerConfig.replayThreadCount;
+    info.valueSize = sizeof(m_settings.gpuProfilerConfig.replayThreadCount);
+    m_settingsInfoMap.Insert(1606231994, info);
+
     info.type      = SettingType::Boolean;
     info.pValuePtr = &m_settings.gpuProfilerConfig.ignoreNonDrawDispatchCmdBufs;
     info.valueSize = sizeof(m_settings.gpuProfilerConfig.ignoreNonDrawDispatchCmdBufs);
@@ -923,6 +964,11 @@ void PlatformSettingsLoader::InitSettingsInfo()
     info.valueSize = sizeof(m_settings.gpuProfilerConfig.useFullPipelineHash);
     m_settingsInfoMap.Insert(3204367348, info);
 
+    info.type      = SettingType::Boolean;
+    info.pValuePtr = &m_settings.gpuProfilerConfig.binaryTraceOutput;
+    info.valueSize = sizeof(m_settings.gpuProfilerConfig.binaryTraceOutput);
+    m_settingsInfoMap.Insert(1515964323, info);
+
     info.type      = SettingType::Uint;
     info.pValuePtr = &m_settings.gpuProfilerConfig.traceModeMask;
     info.valueSize = sizeof(m_settings.gpuProfilerConfig.traceModeMask);
@@ -1138,6 +1184,26 @@ void PlatformSettingsLoader::InitSettingsInfo()
     info.valueSize = sizeof(m_settings.interfaceLoggerConfig.multithreaded);
     m_settingsInfoMap.Insert(4177532476, info);
 
+    info.type      = SettingType::Boolean;
+    info.pValuePtr = &m_settings.interfaceLoggerConfig.mergeThreadLogs;
+    info.valueSize = sizeof(m_settings.interfaceLoggerConfig.mergeThreadLogs);
+    m_settingsInfoMap.Insert(4029121867, info);
+
+    info.type      = SettingType::Boolean;
+    info.pValuePtr = &m_settings.interfaceLoggerConfig.streamOutput;
+    info.valueSize = sizeof(m_settings.interfaceLoggerConfig.streamOutput);
+    m_settingsInfoMap.Insert(3605666353, info);
+
+    info.type      = SettingType::Boolean;
+    info.pValuePtr = &m_settings.interfaceLoggerConfig.backgroundWrite;
+    info.valueSize = sizeof(m_settings.interfaceLoggerConfig.backgroundWrite);
+    m_settingsInfoMap.Insert(2357663407, info);
+
+    info.type      = SettingType::Boolean;
+    info.pValuePtr = &m_settings.interfaceLoggerConfig.binaryOutput;
+    info.valueSize = sizeof(m_settings.interfaceLoggerConfig.binaryOutput);
+    m_settingsInfoMap.Insert(1770086808, info);
+
     info.type      = SettingType::Uint;
     info.pValuePtr = &m_settings.interfaceLoggerConfig.basePreset;
     info.valueSize = sizeof(m_settings.interfaceLoggerConfig.basePreset);
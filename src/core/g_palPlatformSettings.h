@@ -156,8 +156,10 @@ struct PalPlatformSettings : public Pal::DriverSettings
         uint32                                      frameCount;
         bool                                        recordPipelineStats;
         bool                                        breakSubmitBatches;
+        uint32                                      replayThreadCount;
         bool                                        ignoreNonDrawDispatchCmdBufs;
         bool                                        useFullPipelineHash;
+        bool                                        binaryTraceOutput;
         uint32                                      traceModeMask;
         GpuProfilerGranularity                      granularity;
     } gpuProfilerConfig;
@@ -213,6 +215,10 @@ struct PalPlatformSettings : public Pal::DriverSettings
     struct {
         char                                        logDirectory[MaxPathStrLen];
         bool                                        multithreaded;
+        bool                                        mergeThreadLogs;
+        bool                                        streamOutput;
+        bool                                        backgroundWrite;
+        bool                                        binaryOutput;
         uint32                                      basePreset;
         uint32                                      elevatedPreset;
     } interfaceLoggerConfig;
@@ -283,8 +289,10 @@ static const char* pGpuProfilerConfig_StartFrameStr = "#17496565";
 static const char* pGpuProfilerConfig_FrameCountStr = "#3630548216";
 static const char* pGpuProfilerConfig_RecordPipelineStatsStr = "#1092484338";
 static const char* pGpuProfilerConfig_BreakSubmitBatchesStr = "#2743656777";
+static const char* pGpuProfilerConfig_ReplayThreadCountStr = "#1606231994";
 static const char* pGpuProfilerConfig_IgnoreNonDrawDispatchCmdBufsStr = "#2163321285";
 static const char* pGpuProfilerConfig_UseFullPipelineHashStr = "#3204367348";
+static const char* pGpuProfilerConfig_BinaryTraceOutputStr = "#1515964323";
 static const char* pGpuProfilerConfig_TraceModeMaskStr = "#2717664970";
 static const char* pGpuProfilerConfig_GranularityStr = "#1675329864";
 static const char* pGpuProfilerPerfCounterConfig_GlobalPerfCounterConfigFileStr = "#1666123781";
@@ -328,6 +336,10 @@ static const char* pPm4InstrumentorConfig_DumpIntervalStr = "#1471065745";
 static const char* pInterfaceLoggerEnabledStr = "#2678054117";
 static const char* pInterfaceLoggerConfig_LogDirectoryStr = "#3997041373";
 static const char* pInterfaceLoggerConfig_MultithreadedStr = "#4177532476";
+static const char* pInterfaceLoggerConfig_MergeThreadLogsStr = "#4029121867";
+static const char* pInterfaceLoggerConfig_StreamOutputStr = "#3605666353";
+static const char* pInterfaceLoggerConfig_BackgroundWriteStr = "#2357663407";
+static const char* pInterfaceLoggerConfig_BinaryOutputStr = "#1770086808";
 static const char* pInterfaceLoggerConfig_BasePresetStr = "#3886684530";
 static const char* pInterfaceLoggerConfig_ElevatedPresetStr = "#3991423149";
 
@@ -399,8 +411,10 @@ static const SettingNameHash g_palPlatformSettingHashList[] = {
 3630548216,
 1092484338,
 2743656777,
+1606231994,
 2163321285,
 3204367348,
+1515964323,
 2717664970,
 1675329864,
 1666123781,
@@ -444,6 +458,10 @@ static const SettingNameHash g_palPlatformSettingHashList[] = {
 2678054117,
 3997041373,
 4177532476,
+4029121867,
+3605666353,
+2357663407,
+1770086808,
 3886684530,
 3991423149,
 
@@ -57,15 +57,9 @@ Result ComputePipeline::Init(
     if ((createInfo.pPipelineBinary != nullptr) && (createInfo.pipelineBinarySize != 0))
     {
         m_pipelineBinaryLen = createInfo.pipelineBinarySize;
-        m_pPipelineBinary   = PAL_MALLOC(m_pipelineBinaryLen, m_pDevice->GetPlatform(), AllocInternal);
-        if (m_pPipelineBinary == nullptr)
-        {
-            result = Result::ErrorOutOfMemory;
-        }
-        else
-        {
-            memcpy(m_pPipelineBinary, createInfo.pPipelineBinary, m_pipelineBinaryLen);
-        }
+        result              = m_pDevice->GetPipelineBinaryStore()->Acquire(createInfo.pPipelineBinary,
+                                                                           m_pipelineBinaryLen,
+                                                                           &m_pPipelineBinary);
     }
     else
     {
@@ -105,45 +99,37 @@ Result ComputePipeline::InitFromPipelineBinary(
 {
     PAL_ASSERT((m_pPipelineBinary != nullptr) && (m_pipelineBinaryLen != 0));
 
-    AbiReader abiReader(m_pDevice->GetPlatform(), m_pPipelineBinary);
-    Result result = abiReader.Init();
+    // The binary was parsed when it entered the device's binary store, so there is no need to re-walk the ELF here.
+    const ParsedPipelineBinary& parsed         = PipelineBinaryStore::GetParsedBinary(m_pPipelineBinary);
+    const AbiReader&            abiReader      = parsed.GetAbiReader();
+    const CodeObjectMetadata&   metadata       = parsed.GetMetadata();
+    MsgPackReader               metadataReader = parsed.GetMetadataReader();
 
-    MsgPackReader      metadataReader;
-    CodeObjectMetadata metadata;
+    ExtractPipelineInfo(metadata, ShaderType::Compute, ShaderType::Compute);
 
-    if (result == Result::Success)
-    {
-        result = abiReader.GetMetadata(&metadataReader, &metadata);
-    }
+    DumpPipelineElf("PipelineCs",
+                    ((metadata.pipeline.hasEntry.name != 0) ? &metadata.pipeline.name[0] : nullptr));
 
-    if (result == Result::Success)
+    const Elf::SymbolTableEntry* pSymbol = abiReader.GetPipelineSymbol(Abi::PipelineSymbolType::CsDisassembly);
+    if (pSymbol != nullptr)
     {
-        ExtractPipelineInfo(metadata, ShaderType::Compute, ShaderType::Compute);
-
-        DumpPipelineElf("PipelineCs",
-                        ((metadata.pipeline.hasEntry.name != 0) ? &metadata.pipeline.name[0] : nullptr));
-
-        const Elf::SymbolTableEntry* pSymbol = abiReader.GetPipelineSymbol(Abi::PipelineSymbolType::CsDisassembly);
-        if (pSymbol != nullptr)
-        {
-            m_stageInfo.disassemblyLength = static_cast<size_t>(pSymbol->st_size);
-        }
+        m_stageInfo.disassemblyLength = static_cast<size_t>(pSymbol->st_size);
+    }
 
 #if PAL_CLIENT_INTERFACE_MAJOR_VERSION >= 580
-        m_maxFunctionCallDepth = createInfo.maxFunctionCallDepth;
+    m_maxFunctionCallDepth = createInfo.maxFunctionCallDepth;
 #endif
-        const auto& csStageMetadata = metadata.pipeline.hardwareStage[static_cast<uint32>(Abi::HardwareStage::Cs)];
-        if (csStageMetadata.hasEntry.scratchMemorySize != 0)
-        {
-            m_stackSizeInBytes = csStageMetadata.scratchMemorySize;
-        }
-
-        result = HwlInit(createInfo,
-                         abiReader,
-                         metadata,
-                         &metadataReader);
+    const auto& csStageMetadata = metadata.pipeline.hardwareStage[static_cast<uint32>(Abi::HardwareStage::Cs)];
+    if (csStageMetadata.hasEntry.scratchMemorySize != 0)
+    {
+        m_stackSizeInBytes = csStageMetadata.scratchMemorySize;
     }
 
+    const Result result = HwlInit(createInfo,
+                                  abiReader,
+                                  metadata,
+                                  &metadataReader);
+
     return result;
 }
 
@@ -923,24 +923,19 @@ Result Device::CreateGraphicsPipeline(
 {
     PAL_ASSERT(createInfo.pPipelineBinary != nullptr);
     PAL_ASSERT(pPlacementAddr != nullptr);
-    AbiReader abiReader(GetPlatform(), createInfo.pPipelineBinary);
-    Result result = abiReader.Init();
 
-    PAL_PLACEMENT_NEW(pPlacementAddr) GraphicsPipeline(this, isInternal);
+    auto* pPipeline = PAL_PLACEMENT_NEW(pPlacementAddr) GraphicsPipeline(this, isInternal);
 
-    if (result == Result::Success)
-    {
-        auto* pPipeline = static_cast<GraphicsPipeline*>(pPlacementAddr);
-        result = pPipeline->Init(createInfo, internalInfo, abiReader);
+    // The pipeline parses its binary through the device's binary store, which reuses the parse for identical binaries.
+    Result result = pPipeline->Init(createInfo, internalInfo);
 
-        if (result != Result::Success)
-        {
-            pPipeline->Destroy();
-        }
-        else
-        {
-            *ppPipeline = pPipeline;
-        }
+    if (result != Result::Success)
+    {
+        pPipeline->Destroy();
+    }
+    else
+    {
+        *ppPipeline = pPipeline;
     }
 
     return result;
@@ -214,21 +214,15 @@ Result ShaderLibrary::GetShaderFunctionCode(
     void*        pBuffer
     ) const
 {
-    // To extract the shader code, we can re-parse the saved ELF binary and lookup the shader's program
-    // instructions by examining the symbol table entry for that shader's entrypoint.
-    AbiReader abiReader(m_pDevice->GetPlatform(), m_pCodeObjectBinary);
-    Result result = abiReader.Init();
-    if (result == Result::Success)
+    // To extract the shader code, we can lookup the shader's program instructions by examining the symbol table entry
+    // for that shader's entrypoint.  The saved ELF binary was already parsed by the device's binary store.
+    const AbiReader& abiReader = PipelineBinaryStore::GetParsedBinary(m_pCodeObjectBinary).GetAbiReader();
+    Result           result    = Result::ErrorUnavailable;
+
+    const Elf::SymbolTableEntry* pSymbol = abiReader.GetGenericSymbol(pShaderExportName);
+    if (pSymbol != nullptr)
     {
-        const Elf::SymbolTableEntry* pSymbol = abiReader.GetGenericSymbol(pShaderExportName);
-        if (pSymbol != nullptr)
-        {
-            result = abiReader.GetElfReader().CopySymbol(*pSymbol, pSize, pBuffer);
-        }
-        else
-        {
-            result = Result::ErrorUnavailable;
-        }
+        result = abiReader.GetElfReader().CopySymbol(*pSymbol, pSize, pBuffer);
     }
 
     return result;
@@ -256,24 +250,17 @@ Result ShaderLibrary::GetShaderFunctionStats(
     pShaderStats->common.ldsSizePerThreadGroup = chipProps.gfxip.ldsSizePerThreadGroup;
     pShaderStats->common.flags.isWave32        = m_hwInfo.flags.isWave32;
 
-    // We can re-parse the saved pipeline ELF binary to extract shader statistics.
-    AbiReader abiReader(m_pDevice->GetPlatform(), m_pCodeObjectBinary);
-    result = abiReader.Init();
-    if (result == Result::Success)
-    {
-        const Elf::SymbolTableEntry* pSymbol = abiReader.GetGenericSymbol(pShaderExportName);
-        if (pSymbol != nullptr)
-        {
-            pShaderStats->isaSizeInBytes = static_cast<size_t>(pSymbol->st_size);
-        }
-    }
-
-    MsgPackReader      metadataReader;
-    CodeObjectMetadata metadata;
+    // The saved ELF binary was already parsed by the device's binary store, so we can read the shader statistics
+    // straight out of it.
+    const auto&               parsed         = PipelineBinaryStore::GetParsedBinary(m_pCodeObjectBinary);
+    const AbiReader&          abiReader      = parsed.GetAbiReader();
+    const CodeObjectMetadata& metadata       = parsed.GetMetadata();
+    MsgPackReader             metadataReader = parsed.GetMetadataReader();
 
-    if (result == Result::Success)
+    const Elf::SymbolTableEntry* pSymbol = abiReader.GetGenericSymbol(pShaderExportName);
+    if (pSymbol != nullptr)
     {
-        result = abiReader.GetMetadata(&metadataReader, &metadata);
+        pShaderStats->isaSizeInBytes = static_cast<size_t>(pSymbol->st_size);
     }
 
     if (result == Result::Success)
@@ -58,23 +58,16 @@ GraphicsPipeline::GraphicsPipeline(
 // Initialize this graphics pipeline based on the provided creation info.
 Result GraphicsPipeline::Init(
     const GraphicsPipelineCreateInfo&         createInfo,
-    const GraphicsPipelineInternalCreateInfo& internalInfo,
-    const AbiReader&                          abiReader)
+    const GraphicsPipelineInternalCreateInfo& internalInfo)
 {
     Result result = Result::Success;
 
     if ((createInfo.pPipelineBinary != nullptr) && (createInfo.pipelineBinarySize != 0))
     {
         m_pipelineBinaryLen = createInfo.pipelineBinarySize;
-        m_pPipelineBinary   = PAL_MALLOC(m_pipelineBinaryLen, m_pDevice->GetPlatform(), AllocInternal);
-        if (m_pPipelineBinary == nullptr)
-        {
-            result = Result::ErrorOutOfMemory;
-        }
-        else
-        {
-            memcpy(m_pPipelineBinary, createInfo.pPipelineBinary, m_pipelineBinaryLen);
-        }
+        result              = m_pDevice->GetPipelineBinaryStore()->Acquire(createInfo.pPipelineBinary,
+                                                                           m_pipelineBinaryLen,
+                                                                           &m_pPipelineBinary);
     }
     else
     {
@@ -84,7 +77,7 @@ Result GraphicsPipeline::Init(
     if (result == Result::Success)
     {
         PAL_ASSERT(m_pPipelineBinary != nullptr);
-        result = InitFromPipelineBinary(createInfo, internalInfo, abiReader);
+        result = InitFromPipelineBinary(createInfo, internalInfo);
     }
 
     return result;
@@ -95,8 +88,7 @@ Result GraphicsPipeline::Init(
 // info.
 Result GraphicsPipeline::InitFromPipelineBinary(
     const GraphicsPipelineCreateInfo&         createInfo,
-    const GraphicsPipelineInternalCreateInfo& internalInfo,
-    const AbiReader&                          abiReader)
+    const GraphicsPipelineInternalCreateInfo& internalInfo)
 {
     // Store the ROP code this pipeline was created with
     m_logicOp = createInfo.cbState.logicOp;
@@ -127,39 +119,38 @@ Result GraphicsPipeline::InitFromPipelineBinary(
     m_viewInstancingDesc                   = createInfo.viewInstancingDesc;
     m_viewInstancingDesc.viewInstanceCount = Max(m_viewInstancingDesc.viewInstanceCount, 1u);
 
-    MsgPackReader      metadataReader;
-    CodeObjectMetadata metadata;
-    Result result = abiReader.GetMetadata(&metadataReader, &metadata);
+    // The binary was parsed when it entered the device's binary store, so there is no need to re-walk the ELF here.
+    const ParsedPipelineBinary& parsed         = PipelineBinaryStore::GetParsedBinary(m_pPipelineBinary);
+    const AbiReader&            abiReader      = parsed.GetAbiReader();
+    const CodeObjectMetadata&   metadata       = parsed.GetMetadata();
+    MsgPackReader               metadataReader = parsed.GetMetadataReader();
 
-    if (result == Result::Success)
-    {
-        ExtractPipelineInfo(metadata, ShaderType::Vertex, ShaderType::Pixel);
+    ExtractPipelineInfo(metadata, ShaderType::Vertex, ShaderType::Pixel);
 
-        DumpPipelineElf("PipelineGfx",
-                        ((metadata.pipeline.hasEntry.name != 0) ? &metadata.pipeline.name[0] : nullptr));
+    DumpPipelineElf("PipelineGfx",
+                    ((metadata.pipeline.hasEntry.name != 0) ? &metadata.pipeline.name[0] : nullptr));
 
-        if (ShaderHashIsNonzero(m_info.shader[static_cast<uint32>(ShaderType::Geometry)].hash))
-        {
-            m_flags.gsEnabled = 1;
-        }
-        if (ShaderHashIsNonzero(m_info.shader[static_cast<uint32>(ShaderType::Hull)].hash) &&
-            ShaderHashIsNonzero(m_info.shader[static_cast<uint32>(ShaderType::Domain)].hash))
-        {
-            m_flags.tessEnabled = 1;
-        }
+    if (ShaderHashIsNonzero(m_info.shader[static_cast<uint32>(ShaderType::Geometry)].hash))
+    {
+        m_flags.gsEnabled = 1;
+    }
+    if (ShaderHashIsNonzero(m_info.shader[static_cast<uint32>(ShaderType::Hull)].hash) &&
+        ShaderHashIsNonzero(m_info.shader[static_cast<uint32>(ShaderType::Domain)].hash))
+    {
+        m_flags.tessEnabled = 1;
+    }
 
-        m_flags.vportArrayIdx = (metadata.pipeline.flags.usesViewportArrayIndex != 0);
+    m_flags.vportArrayIdx = (metadata.pipeline.flags.usesViewportArrayIndex != 0);
 
-        const auto& psStageMetadata = metadata.pipeline.hardwareStage[static_cast<uint32>(Abi::HardwareStage::Ps)];
+    const auto& psStageMetadata = metadata.pipeline.hardwareStage[static_cast<uint32>(Abi::HardwareStage::Ps)];
 
-        m_flags.psUsesUavs          = (psStageMetadata.flags.usesUavs          != 0);
-        m_flags.psUsesRovs          = (psStageMetadata.flags.usesRovs          != 0);
-        m_flags.psWritesUavs        = (psStageMetadata.flags.writesUavs        != 0);
-        m_flags.psWritesDepth       = (psStageMetadata.flags.writesDepth       != 0);
-        m_flags.psUsesAppendConsume = (psStageMetadata.flags.usesAppendConsume != 0);
+    m_flags.psUsesUavs          = (psStageMetadata.flags.usesUavs          != 0);
+    m_flags.psUsesRovs          = (psStageMetadata.flags.usesRovs          != 0);
+    m_flags.psWritesUavs        = (psStageMetadata.flags.writesUavs        != 0);
+    m_flags.psWritesDepth       = (psStageMetadata.flags.writesDepth       != 0);
+    m_flags.psUsesAppendConsume = (psStageMetadata.flags.usesAppendConsume != 0);
 
-        result = HwlInit(createInfo, abiReader, metadata, &metadataReader);
-    }
+    const Result result = HwlInit(createInfo, abiReader, metadata, &metadataReader);
 
     return result;
 }
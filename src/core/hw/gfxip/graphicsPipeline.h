@@ -40,8 +40,7 @@ public:
 
     virtual Result Init(
         const GraphicsPipelineCreateInfo&         createInfo,
-        const GraphicsPipelineInternalCreateInfo& internalInfo,
-        const AbiReader&                          abiReader);
+        const GraphicsPipelineInternalCreateInfo& internalInfo);
 
     bool IsGsEnabled() const { return m_flags.gsEnabled; }
     bool IsGsOnChip() const { return m_flags.isGsOnchip; }
@@ -88,8 +87,7 @@ protected:
 private:
     Result InitFromPipelineBinary(
         const GraphicsPipelineCreateInfo&         createInfo,
-        const GraphicsPipelineInternalCreateInfo& internalInfo,
-        const AbiReader&                          abiReader);
+        const GraphicsPipelineInternalCreateInfo& internalInfo);
 
     union
     {
@@ -102,7 +102,7 @@ Pipeline::~Pipeline()
     data.pObj = this;
     m_pDevice->GetPlatform()->GetEventProvider()->LogGpuMemoryResourceDestroyEvent(data);
 
-    PAL_SAFE_FREE(m_pPipelineBinary, m_pDevice->GetPlatform());
+    m_pDevice->GetPipelineBinaryStore()->Release(m_pPipelineBinary);
 }
 
 // =====================================================================================================================
@@ -317,22 +317,16 @@ Result Pipeline::GetShaderCode(
     const ShaderStageInfo*const pInfo = GetShaderStageInfo(shaderType);
     PAL_ASSERT(pInfo->codeLength != 0); // How did we get here if there's no shader code?!
 
-    // To extract the shader code, we can re-parse the saved ELF binary and lookup the shader's program
-    // instructions by examining the symbol table entry for that shader's entrypoint.
-    AbiReader abiReader(m_pDevice->GetPlatform(), m_pPipelineBinary);
-    Result result = abiReader.Init();
-    if (result == Result::Success)
+    // To extract the shader code, we can lookup the shader's program instructions by examining the symbol table entry
+    // for that shader's entrypoint.  The saved ELF binary was already parsed by the device's binary store.
+    const AbiReader& abiReader = PipelineBinaryStore::GetParsedBinary(m_pPipelineBinary).GetAbiReader();
+    Result           result    = Result::ErrorUnavailable;
+
+    const Elf::SymbolTableEntry* pSymbol = abiReader.GetPipelineSymbol(
+            Abi::GetSymbolForStage(Abi::PipelineSymbolType::ShaderMainEntry, pInfo->stageId));
+    if (pSymbol != nullptr)
     {
-        const Elf::SymbolTableEntry* pSymbol = abiReader.GetPipelineSymbol(
-                Abi::GetSymbolForStage(Abi::PipelineSymbolType::ShaderMainEntry, pInfo->stageId));
-        if (pSymbol != nullptr)
-        {
-            result = abiReader.GetElfReader().CopySymbol(*pSymbol, pSize, pBuffer);
-        }
-        else
-        {
-            result = Result::ErrorUnavailable;
-        }
+        result = abiReader.GetElfReader().CopySymbol(*pSymbol, pSize, pBuffer);
     }
 
     return result;
@@ -411,73 +405,61 @@ Result Pipeline::GetShaderStatsForStage(
     PAL_ASSERT(pStats != nullptr);
     memset(pStats, 0, sizeof(ShaderStats));
 
-    // We can re-parse the saved pipeline ELF binary to extract shader statistics.
-    AbiReader abiReader(m_pDevice->GetPlatform(), m_pPipelineBinary);
-    Result result = abiReader.Init();
+    // The saved pipeline ELF binary's metadata was decoded when it entered the device's binary store.
+    const CodeObjectMetadata& metadata = PipelineBinaryStore::GetParsedBinary(m_pPipelineBinary).GetMetadata();
 
-    MsgPackReader      metadataReader;
-    CodeObjectMetadata metadata;
+    const auto&  gpuInfo       = m_pDevice->ChipProperties();
+    const auto&  stageMetadata = metadata.pipeline.hardwareStage[static_cast<uint32>(stageInfo.stageId)];
 
-    if (result == Result::Success)
-    {
-        result = abiReader.GetMetadata(&metadataReader, &metadata);
-    }
-
-    if (result == Result::Success)
-    {
-        const auto&  gpuInfo       = m_pDevice->ChipProperties();
-        const auto&  stageMetadata = metadata.pipeline.hardwareStage[static_cast<uint32>(stageInfo.stageId)];
-
-        pStats->common.numUsedSgprs = stageMetadata.sgprCount;
-        pStats->common.numUsedVgprs = stageMetadata.vgprCount;
+    pStats->common.numUsedSgprs = stageMetadata.sgprCount;
+    pStats->common.numUsedVgprs = stageMetadata.vgprCount;
 
 #if PAL_BUILD_GFX6
-        if (gpuInfo.gfxLevel < GfxIpLevel::GfxIp9)
-        {
-            pStats->numAvailableSgprs = (stageMetadata.hasEntry.sgprLimit != 0) ? stageMetadata.sgprLimit
-                                                                                : gpuInfo.gfx6.numShaderVisibleSgprs;
-        }
+    if (gpuInfo.gfxLevel < GfxIpLevel::GfxIp9)
+    {
+        pStats->numAvailableSgprs = (stageMetadata.hasEntry.sgprLimit != 0) ? stageMetadata.sgprLimit
+                                                                            : gpuInfo.gfx6.numShaderVisibleSgprs;
+    }
 #endif
 
-        if (gpuInfo.gfxLevel >= GfxIpLevel::GfxIp9)
-        {
-            pStats->numAvailableSgprs = (stageMetadata.hasEntry.sgprLimit != 0) ? stageMetadata.sgprLimit
-                                                                                : gpuInfo.gfx9.numShaderVisibleSgprs;
-        }
-        pStats->numAvailableVgprs = (stageMetadata.hasEntry.vgprLimit != 0) ? stageMetadata.vgprLimit
-                                                                            : MaxVgprPerShader;
+    if (gpuInfo.gfxLevel >= GfxIpLevel::GfxIp9)
+    {
+        pStats->numAvailableSgprs = (stageMetadata.hasEntry.sgprLimit != 0) ? stageMetadata.sgprLimit
+                                                                            : gpuInfo.gfx9.numShaderVisibleSgprs;
+    }
+    pStats->numAvailableVgprs = (stageMetadata.hasEntry.vgprLimit != 0) ? stageMetadata.vgprLimit
+                                                                        : MaxVgprPerShader;
 
-        pStats->common.ldsUsageSizeInBytes    =
-            (stageMetadata.hasEntry.ldsSize           != 0) ? stageMetadata.ldsSize           : 0;
-        pStats->common.scratchMemUsageInBytes =
-            (stageMetadata.hasEntry.scratchMemorySize != 0) ? stageMetadata.scratchMemorySize : 0;
+    pStats->common.ldsUsageSizeInBytes    =
+        (stageMetadata.hasEntry.ldsSize           != 0) ? stageMetadata.ldsSize           : 0;
+    pStats->common.scratchMemUsageInBytes =
+        (stageMetadata.hasEntry.scratchMemorySize != 0) ? stageMetadata.scratchMemorySize : 0;
 
-        pStats->common.flags.isWave32 =
-            ((stageMetadata.hasEntry.wavefrontSize != 0) && (stageMetadata.wavefrontSize == 32));
+    pStats->common.flags.isWave32 =
+        ((stageMetadata.hasEntry.wavefrontSize != 0) && (stageMetadata.wavefrontSize == 32));
 
-        pStats->isaSizeInBytes = stageInfo.disassemblyLength;
+    pStats->isaSizeInBytes = stageInfo.disassemblyLength;
 
-        if (pStageInfoCopy != nullptr)
-        {
-            const auto& copyStageMetadata =
-                metadata.pipeline.hardwareStage[static_cast<uint32>(pStageInfoCopy->stageId)];
+    if (pStageInfoCopy != nullptr)
+    {
+        const auto& copyStageMetadata =
+            metadata.pipeline.hardwareStage[static_cast<uint32>(pStageInfoCopy->stageId)];
 
-            pStats->flags.copyShaderPresent = 1;
+        pStats->flags.copyShaderPresent = 1;
 
-            pStats->copyShader.numUsedSgprs = copyStageMetadata.sgprCount;
-            pStats->copyShader.numUsedVgprs = copyStageMetadata.vgprCount;
+        pStats->copyShader.numUsedSgprs = copyStageMetadata.sgprCount;
+        pStats->copyShader.numUsedVgprs = copyStageMetadata.vgprCount;
 
-            pStats->copyShader.ldsUsageSizeInBytes    =
-                (copyStageMetadata.hasEntry.ldsSize           != 0) ? copyStageMetadata.ldsSize           : 0;
-            pStats->copyShader.scratchMemUsageInBytes =
-                (copyStageMetadata.hasEntry.scratchMemorySize != 0) ? copyStageMetadata.scratchMemorySize : 0;
+        pStats->copyShader.ldsUsageSizeInBytes    =
+            (copyStageMetadata.hasEntry.ldsSize           != 0) ? copyStageMetadata.ldsSize           : 0;
+        pStats->copyShader.scratchMemUsageInBytes =
+            (copyStageMetadata.hasEntry.scratchMemorySize != 0) ? copyStageMetadata.scratchMemorySize : 0;
 
-            pStats->copyShader.flags.isWave32 =
-                (copyStageMetadata.hasEntry.wavefrontSize != 0) && (copyStageMetadata.wavefrontSize == 32);
-        }
+        pStats->copyShader.flags.isWave32 =
+            (copyStageMetadata.hasEntry.wavefrontSize != 0) && (copyStageMetadata.wavefrontSize == 32);
     }
 
-    return result;
+    return Result::Success;
 }
 
 // =====================================================================================================================
@@ -197,8 +197,9 @@ protected:
     BoundGpuMemory  m_gpuMem;
     gpusize         m_gpuMemSize;
 
-    void*   m_pPipelineBinary;      // Buffer containing the pipeline binary data (Pipeline ELF ABI).
-    size_t  m_pipelineBinaryLen;    // Size of the pipeline binary data, in bytes.
+    const void* m_pPipelineBinary;      // Pipeline binary data (Pipeline ELF ABI), shared through the device's
+                                        // PipelineBinaryStore.
+    size_t      m_pipelineBinaryLen;    // Size of the pipeline binary data, in bytes.
 
     PerfDataInfo m_perfDataInfo[static_cast<size_t>(Util::Abi::HardwareStage::Count)];
     Util::Abi::ApiHwShaderMapping m_apiHwMapping;
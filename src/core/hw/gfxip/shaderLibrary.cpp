@@ -65,16 +65,9 @@ Result ShaderLibrary::Initialize(
     if((createInfo.pCodeObject != nullptr) && (createInfo.codeObjectSize != 0))
     {
         m_codeObjectBinaryLen = createInfo.codeObjectSize;
-        m_pCodeObjectBinary   = PAL_MALLOC(m_codeObjectBinaryLen, m_pDevice->GetPlatform(), AllocInternal);
-
-        if (m_pCodeObjectBinary == nullptr)
-        {
-            result = Result::ErrorOutOfMemory;
-        }
-        else
-        {
-            memcpy(m_pCodeObjectBinary, createInfo.pCodeObject, m_codeObjectBinaryLen);
-        }
+        result                = m_pDevice->GetPipelineBinaryStore()->Acquire(createInfo.pCodeObject,
+                                                                             m_codeObjectBinaryLen,
+                                                                             &m_pCodeObjectBinary);
     }
     else
     {
@@ -97,34 +90,26 @@ Result ShaderLibrary::InitFromCodeObjectBinary(
 {
     PAL_ASSERT((m_pCodeObjectBinary != nullptr) && (m_codeObjectBinaryLen != 0));
 
-    AbiReader abiReader(m_pDevice->GetPlatform(), m_pCodeObjectBinary);
-    Result result = abiReader.Init();
+    // The binary was parsed when it entered the device's binary store, so there is no need to re-walk the ELF here.
+    const ParsedPipelineBinary& parsed         = PipelineBinaryStore::GetParsedBinary(m_pCodeObjectBinary);
+    const AbiReader&            abiReader      = parsed.GetAbiReader();
+    const CodeObjectMetadata&   metadata       = parsed.GetMetadata();
+    MsgPackReader               metadataReader = parsed.GetMetadataReader();
 
-    MsgPackReader      metadataReader;
-    CodeObjectMetadata metadata;
+    ExtractLibraryInfo(metadata);
 
-    if (result == Result::Success)
-    {
-        result = abiReader.GetMetadata(&metadataReader, &metadata);
-    }
+    Result result = metadataReader.Seek(metadata.pipeline.shaderFunctions);
 
     if (result == Result::Success)
     {
-        ExtractLibraryInfo(metadata);
-
-        result = metadataReader.Seek(metadata.pipeline.shaderFunctions);
-
-        if (result == Result::Success)
-        {
-            result = ExtractShaderFunctions(&metadataReader);
-        }
-
-        result = HwlInit(createInfo,
-                abiReader,
-                metadata,
-                &metadataReader);
+        result = ExtractShaderFunctions(&metadataReader);
     }
 
+    result = HwlInit(createInfo,
+            abiReader,
+            metadata,
+            &metadataReader);
+
     return result;
 }
 
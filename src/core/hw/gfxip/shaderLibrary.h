@@ -99,7 +99,7 @@ protected:
     // internal Destructor.
     virtual ~ShaderLibrary()
     {
-        PAL_SAFE_FREE(m_pCodeObjectBinary, m_pDevice->GetPlatform());
+        m_pDevice->GetPipelineBinaryStore()->Release(m_pCodeObjectBinary);
     }
 
     virtual Result HwlInit(
@@ -122,7 +122,8 @@ protected:
     Device*const    m_pDevice;
 
     LibraryInfo     m_info;                  // Public info structure available to the client.
-    void*           m_pCodeObjectBinary;    // Buffer containing the code object binary data (Pipeline ELF ABI).
+    const void*     m_pCodeObjectBinary;    // Code object binary data (Pipeline ELF ABI), shared through the device's
+                                            // PipelineBinaryStore.
     size_t          m_codeObjectBinaryLen;  // Size of code object binary data, in bytes.
 
     BoundGpuMemory  m_gpuMem;
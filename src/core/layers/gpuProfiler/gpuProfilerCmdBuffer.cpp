@@ -53,9 +53,9 @@ CmdBuffer::CmdBuffer(
     m_pDevice(pDevice),
     m_queueType(createInfo.queueType),
     m_engineType(createInfo.engineType),
-    m_pTokenStream(nullptr),
-    m_tokenStreamSize(m_pDevice->GetPlatform()->PlatformSettings().gpuProfilerTokenAllocatorSize),
-    m_tokenWriteOffset(0),
+    m_pFirstTokenChunk(nullptr),
+    m_pWriteTokenChunk(nullptr),
+    m_pReadTokenChunk(nullptr),
     m_tokenReadOffset(0),
     m_tokenStreamResult(Result::Success),
     m_disableDataGathering(false),
@@ -91,7 +91,7 @@ CmdBuffer::CmdBuffer(
 // =====================================================================================================================
 CmdBuffer::~CmdBuffer()
 {
-    PAL_FREE(m_pTokenStream, m_pDevice->GetPlatform());
+    m_pDevice->ReleaseTokenChunks(m_pFirstTokenChunk);
 }
 
 // =====================================================================================================================
@@ -99,74 +99,84 @@ void* CmdBuffer::AllocTokenSpace(
     size_t numBytes,
     size_t alignment)
 {
-    void*        pTokenSpace        = nullptr;
-    const size_t alignedWriteOffset = Pow2Align(m_tokenWriteOffset, alignment);
-    const size_t nextWriteOffset    = alignedWriteOffset + numBytes;
+    void*       pTokenSpace = nullptr;
+    TokenChunk* pChunk      = m_pWriteTokenChunk;
+    size_t      writeOffset = 0;
 
-    if (nextWriteOffset > m_tokenStreamSize)
+    // Tokens never straddle two chunks, so we start a new chunk if this token doesn't fit in the rest of the current
+    // one. Skip all of this if we've previously encountered an error.
+    if (m_tokenStreamResult == Result::Success)
     {
-        // Double the size of the token stream until we have enough space.
-        size_t newStreamSize = m_tokenStreamSize * 2;
-
-        while (nextWriteOffset > newStreamSize)
+        if (pChunk != nullptr)
         {
-            newStreamSize *= 2;
+            writeOffset = Pow2Align(pChunk->used, alignment);
         }
 
-        // Allocate the new buffer and copy the current tokens over.
-        void* pNewStream = PAL_MALLOC(newStreamSize, m_pDevice->GetPlatform(), AllocInternal);
-
-        if (pNewStream != nullptr)
+        if ((pChunk == nullptr) || (writeOffset + numBytes > pChunk->size))
         {
-            memcpy(pNewStream, m_pTokenStream, m_tokenWriteOffset);
-            PAL_FREE(m_pTokenStream, m_pDevice->GetPlatform());
+            TokenChunk*const pNewChunk = m_pDevice->AcquireTokenChunk(numBytes);
 
-            m_pTokenStream    = pNewStream;
-            m_tokenStreamSize = newStreamSize;
-        }
-        else
-        {
-            // We've run out of memory, this stream is now invalid.
-            m_tokenStreamResult = Result::ErrorOutOfMemory;
+            if (pNewChunk == nullptr)
+            {
+                // We've run out of memory, this stream is now invalid.
+                m_tokenStreamResult = Result::ErrorOutOfMemory;
+            }
+            else
+            {
+                if (pChunk == nullptr)
+                {
+                    m_pFirstTokenChunk = pNewChunk;
+                }
+                else
+                {
+                    pChunk->pNext = pNewChunk;
+                }
+
+                m_pWriteTokenChunk = pNewChunk;
+                pChunk             = pNewChunk;
+                writeOffset        = 0;
+            }
         }
     }
 
-    // Return null if we've previously encountered an error or just failed to reallocate the token stream. Otherwise,
-    // return a properly aligned write pointer and update the write offset to point at the end of the allocated space.
+    // Return null if we've previously encountered an error or just failed to allocate a chunk. Otherwise, return a
+    // properly aligned write pointer and mark the space as used.
     if (m_tokenStreamResult == Result::Success)
     {
-        // Malloc is required to give us memory that is aligned high enough for any variable, but let's double check.
-        PAL_ASSERT(IsPow2Aligned(reinterpret_cast<uint64>(m_pTokenStream), alignment));
+        pTokenSpace  = VoidPtrInc(pChunk->Data(), writeOffset);
+        pChunk->used = writeOffset + numBytes;
 
-        pTokenSpace        = VoidPtrInc(m_pTokenStream, alignedWriteOffset);
-        m_tokenWriteOffset = nextWriteOffset;
+        // Chunk data is aligned high enough for any variable, but let's double check.
+        PAL_ASSERT(IsPow2Aligned(reinterpret_cast<uint64>(pTokenSpace), alignment));
     }
 
     return pTokenSpace;
 }
 
 // =====================================================================================================================
-Result CmdBuffer::Begin(
-    const CmdBufferBuildInfo& info)
+// Returns all of our token chunks to the device so that other command buffers can reuse them.
+void CmdBuffer::ResetTokenStream()
 {
-    m_flags.containsPresent = 0;
+    m_pDevice->ReleaseTokenChunks(m_pFirstTokenChunk);
 
-    // Reset the token stream state so that we can reuse our old token stream buffer.
-    m_tokenWriteOffset  = 0;
+    m_pFirstTokenChunk  = nullptr;
+    m_pWriteTokenChunk  = nullptr;
+    m_pReadTokenChunk   = nullptr;
     m_tokenReadOffset   = 0;
     m_tokenStreamResult = Result::Success;
+}
 
-    // We lazy allocate the first token stream during the first Begin() call to avoid allocating a lot of extra
-    // memory if the client creates a ton of command buffers but doesn't use them.
-    if (m_pTokenStream == nullptr)
-    {
-        m_pTokenStream = PAL_MALLOC(m_tokenStreamSize, m_pDevice->GetPlatform(), AllocInternal);
+// =====================================================================================================================
+Result CmdBuffer::Begin(
+    const CmdBufferBuildInfo& info)
+{
+    m_flags.containsPresent = 0;
+    m_flags.executesNested  = 0;
+    m_flags.forcesLogging   = 0;
 
-        if (m_pTokenStream == nullptr)
-        {
-            m_tokenStreamResult = Result::ErrorOutOfMemory;
-        }
-    }
+    // Recycle any tokens from a previous recording. Chunks are taken from the device's pool as we record tokens, so
+    // command buffers that the client creates but never uses don't hold any token memory.
+    ResetTokenStream();
 
     InsertToken(CmdBufCallId::Begin);
     InsertToken(info);
@@ -213,8 +223,9 @@ void CmdBuffer::ReplayBegin(
     // We must remove the client's external allocator because PAL can only use it during command building from the
     // client's perspective. By batching and replaying command building later on we're breaking that rule. The good news
     // is that we can replace it with our queue's command buffer replay allocator because replaying is thread-safe with
-    // respect to each queue.
-    info.pMemAllocator = pQueue->ReplayAllocator();
+    // respect to each queue. When the queue replays in parallel each worker thread provides its own allocator instead.
+    info.pMemAllocator = (pTgtCmdBuffer->ReplayAllocator() != nullptr) ? pTgtCmdBuffer->ReplayAllocator()
+                                                                       : pQueue->ReplayAllocator();
 
     pTgtCmdBuffer->Begin(NextCmdBufferBuildInfo(info));
 
@@ -222,8 +233,8 @@ void CmdBuffer::ReplayBegin(
     memset(&m_cpState,  0, sizeof(m_cpState));
     memset(&m_gfxpState, 0, sizeof(m_gfxpState));
 
-    if (m_pDevice->LoggingEnabled(GpuProfilerGranularityDraw) ||
-        m_pDevice->LoggingEnabled(GpuProfilerGranularityCmdBuf))
+    if (LoggingEnabled(pTgtCmdBuffer, GpuProfilerGranularityDraw) ||
+        LoggingEnabled(pTgtCmdBuffer, GpuProfilerGranularityCmdBuf))
     {
         memset(&m_cmdBufLogItem, 0, sizeof(m_cmdBufLogItem));
         m_cmdBufLogItem.type                   = CmdBufferCall;
@@ -239,7 +250,7 @@ void CmdBuffer::ReplayBegin(
             bool enablePerfExp   = false;
             bool enablePipeStats = false;
 
-            if (m_pDevice->LoggingEnabled(GpuProfilerGranularityCmdBuf))
+            if (LoggingEnabled(pTgtCmdBuffer, GpuProfilerGranularityCmdBuf))
             {
                 enablePerfExp    = (m_pDevice->NumGlobalPerfCounters() > 0)    ||
                                    (m_pDevice->NumStreamingPerfCounters() > 0) ||
@@ -259,8 +270,7 @@ void CmdBuffer::ReplayBegin(
     }
     else
     {
-        m_sampleFlags.sqThreadTraceActive =
-            m_pDevice->LoggingEnabled(GpuProfilerGranularity::GpuProfilerGranularityFrame);
+        m_sampleFlags.sqThreadTraceActive = LoggingEnabled(pTgtCmdBuffer, GpuProfilerGranularityFrame);
     }
 }
 
@@ -289,8 +299,8 @@ void CmdBuffer::ReplayEnd(
 {
     m_sampleFlags.sqThreadTraceActive = false;
 
-    if (m_pDevice->LoggingEnabled(GpuProfilerGranularityDraw) ||
-        m_pDevice->LoggingEnabled(GpuProfilerGranularityCmdBuf))
+    if (LoggingEnabled(pTgtCmdBuffer, GpuProfilerGranularityDraw) ||
+        LoggingEnabled(pTgtCmdBuffer, GpuProfilerGranularityCmdBuf))
     {
         if (m_flags.nested == false)
         {
@@ -314,6 +324,8 @@ Result CmdBuffer::Reset(
     ICmdAllocator* pCmdAllocator,
     bool           returnGpuMemory)
 {
+    ResetTokenStream();
+
     return NextLayer()->Reset(NextCmdAllocator(pCmdAllocator), returnGpuMemory);
 }
 
@@ -364,7 +376,7 @@ void CmdBuffer::ReplayCmdBindPipeline(
 
     pTgtCmdBuffer->CmdBindPipeline(params);
 
-    if (m_pDevice->LoggingEnabled(GpuProfilerGranularity::GpuProfilerGranularityFrame))
+    if (LoggingEnabled(pTgtCmdBuffer, GpuProfilerGranularityFrame))
     {
         GpuUtil::GpaSession* pGpaSession = pQueue->GetPerFrameGpaSession();
 
@@ -2843,6 +2855,8 @@ void CmdBuffer::CmdExecuteNestedCmdBuffers(
 {
     InsertToken(CmdBufCallId::CmdExecuteNestedCmdBuffers);
     InsertTokenArray(ppCmdBuffers, cmdBufferCount);
+
+    m_flags.executesNested = 1;
 }
 
 // =====================================================================================================================
@@ -2853,7 +2867,7 @@ void CmdBuffer::ReplayCmdExecuteNestedCmdBuffers(
     Queue*           pQueue,
     TargetCmdBuffer* pTgtCmdBuffer)
 {
-    if (m_pDevice->LoggingEnabled(GpuProfilerGranularityDraw))
+    if (LoggingEnabled(pTgtCmdBuffer, GpuProfilerGranularityDraw))
     {
         LogItem logItem = { };
         logItem.type              = CmdBufferCall;
@@ -3261,7 +3275,7 @@ void CmdBuffer::ReplayCmdCommentString(
     const char* pComment = nullptr;
     uint32 commentLength = ReadTokenArray(&pComment);
 
-    if (m_pDevice->LoggingEnabled(GpuProfilerGranularityDraw))
+    if (LoggingEnabled(pTgtCmdBuffer, GpuProfilerGranularityDraw))
     {
         LogItem logItem = { };
         logItem.type                     = CmdBufferCall;
@@ -3393,6 +3407,8 @@ void CmdBuffer::ReplayCmdSetClipRects(
 void CmdBuffer::CmdStartGpuProfilerLogging()
 {
     InsertToken(CmdBufCallId::CmdStartGpuProfilerLogging);
+
+    m_flags.forcesLogging = 1;
 }
 
 // =====================================================================================================================
@@ -3568,6 +3584,7 @@ Result CmdBuffer::Replay(
     if (m_tokenStreamResult == Result::Success)
     {
         // Start reading from the beginning of the token stream.
+        m_pReadTokenChunk = m_pFirstTokenChunk;
         m_tokenReadOffset = 0;
 
         CmdBufCallId callId;
@@ -3587,6 +3604,18 @@ Result CmdBuffer::Replay(
     return result;
 }
 
+// =====================================================================================================================
+// Returns true if replaying into the given target command buffer should log at the given granularity. The queue only
+// replays in parallel when logging was disabled as the submit began, but the logging window can move while the jobs
+// run, so replays on a parallel job never log regardless of what the device currently reports.
+bool CmdBuffer::LoggingEnabled(
+    const TargetCmdBuffer* pTgtCmdBuffer,
+    GpuProfilerGranularity granularity
+    ) const
+{
+    return (pTgtCmdBuffer->ReplayAllocator() == nullptr) && m_pDevice->LoggingEnabled(granularity);
+}
+
 // =====================================================================================================================
 // Perform initial setup of a log item and insert pre-call events into the target command buffer (i.e., begin queries,
 // issue pre-call timestamp, etc.). Adds this log item to the queue for processing if LogPostTimedCall will not be
@@ -3597,7 +3626,7 @@ void CmdBuffer::LogPreTimedCall(
     LogItem*          pLogItem,
     CmdBufCallId      callId)
 {
-    if (m_pDevice->LoggingEnabled(GpuProfilerGranularityDraw) || m_forceDrawGranularityLogging)
+    if (LoggingEnabled(pTgtCmdBuffer, GpuProfilerGranularityDraw) || m_forceDrawGranularityLogging)
     {
         pLogItem->type                   = CmdBufferCall;
         pLogItem->frameId                = m_curLogFrame;
@@ -3679,7 +3708,7 @@ void CmdBuffer::LogPostTimedCall(
     TargetCmdBuffer* pTgtCmdBuffer,
     LogItem*         pLogItem)
 {
-    if (m_pDevice->LoggingEnabled(GpuProfilerGranularityDraw) || m_forceDrawGranularityLogging)
+    if (LoggingEnabled(pTgtCmdBuffer, GpuProfilerGranularityDraw) || m_forceDrawGranularityLogging)
     {
         pTgtCmdBuffer->EndSample(pQueue, pLogItem);
 
@@ -3765,6 +3794,7 @@ TargetCmdBuffer::TargetCmdBuffer(
     m_engineType(createInfo.engineType),
     m_supportTimestamps(false),
     m_pGpaSession(nullptr),
+    m_pReplayAllocator(nullptr),
     m_result(Result::Success),
     m_subQueueIdx(subQueueIdx)
 {
@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include "core/g_palPlatformSettings.h"
 #include "core/layers/functionIds.h"
 #include "core/layers/gpuProfiler/gpuProfilerQueue.h"
 #include "palLinearAllocator.h"
@@ -43,6 +44,17 @@ namespace GpuProfiler
 class Device;
 class TargetCmdBuffer;
 
+// A block of a command buffer's token stream. The token data immediately follows this header in memory. Chunks are
+// pooled by the device and recycled when their command buffer is reset.
+struct alignas(16) TokenChunk
+{
+    TokenChunk* pNext;
+    size_t      size; // The size of this chunk's token data in bytes.
+    size_t      used; // How many bytes of token data have been written.
+
+    void* Data() { return (this + 1); }
+};
+
 // Used to track currently-bound compute/graphics pipeline/shader state during replay.
 struct PipelineState
 {
@@ -72,6 +84,11 @@ public:
 
     bool ContainsPresent() const { return m_flags.containsPresent; }
 
+    // Replaying a present, nested command buffers or forced draw logging touches queue state which must be updated in
+    // submission order, so command buffers which record those calls must be replayed serially.
+    bool CanReplayInParallel() const
+        { return (m_flags.containsPresent == 0) && (m_flags.executesNested == 0) && (m_flags.forcesLogging == 0); }
+
     ICmdBuffer* NextLayer() { return GetNextLayer(); }
     const ICmdBuffer* NextLayer() const { return GetNextLayer(); }
 
@@ -544,6 +561,27 @@ private:
         uint32      zDim);
 
     void* AllocTokenSpace(size_t numBytes, size_t alignment);
+    void  ResetTokenStream();
+
+    // Returns a pointer to the next token of the given size then advances the read pointer. Tokens never straddle two
+    // chunks, so if this token doesn't fit in the rest of the current chunk AllocTokenSpace must have put it at the
+    // start of the next one.
+    void* ReadTokenSpace(size_t numBytes, size_t alignment)
+    {
+        PAL_ASSERT(m_tokenStreamResult == Result::Success);
+        m_tokenReadOffset = Util::Pow2Align(m_tokenReadOffset, alignment);
+
+        if (m_tokenReadOffset + numBytes > m_pReadTokenChunk->used)
+        {
+            m_pReadTokenChunk = m_pReadTokenChunk->pNext;
+            m_tokenReadOffset = 0;
+        }
+
+        void*const pTokenSpace = Util::VoidPtrInc(m_pReadTokenChunk->Data(), m_tokenReadOffset);
+        m_tokenReadOffset += numBytes;
+
+        return pTokenSpace;
+    }
 
     // Insert a copy of the specified value into the token stream.
     template <typename T> void InsertToken(const T& token)
@@ -573,11 +611,7 @@ private:
     // InsertToken().
     template <typename T> const T& ReadTokenVal()
     {
-        PAL_ASSERT(m_tokenStreamResult == Result::Success);
-        m_tokenReadOffset = Util::Pow2Align(m_tokenReadOffset, __alignof(T));
-        const T& val = *static_cast<T*>(Util::VoidPtrInc(m_pTokenStream, m_tokenReadOffset));
-        m_tokenReadOffset += sizeof(T);
-        return val;
+        return *static_cast<const T*>(ReadTokenSpace(sizeof(T), __alignof(T)));
     }
 
     // Retrieves a pointer to the next array of value(s) in the token stream then advances the read pointer.  Returns
@@ -587,9 +621,7 @@ private:
         uint32 count = ReadTokenVal<uint32>();
         if (count != 0)
         {
-            m_tokenReadOffset = Util::Pow2Align(m_tokenReadOffset, __alignof(T));
-            *ppToken = static_cast<T*>(Util::VoidPtrInc(m_pTokenStream, m_tokenReadOffset));
-            m_tokenReadOffset += sizeof(T) * count;
+            *ppToken = static_cast<T*>(ReadTokenSpace(sizeof(T) * count, __alignof(T)));
         }
         else
         {
@@ -719,15 +751,17 @@ private:
 
     void LogPostTimedCall(Queue* pQueue, TargetCmdBuffer* pTgtCmdBuffer, LogItem* pLogItem);
 
+    bool LoggingEnabled(const TargetCmdBuffer* pTgtCmdBuffer, GpuProfilerGranularity granularity) const;
+
     Device*const     m_pDevice;
     const QueueType  m_queueType;
     const EngineType m_engineType;
 
-    // The token stream is a single block of memory that doubles in size each time it runs out of space.
-    void*            m_pTokenStream;      // Storage for tokenized commands. Rewind here on command buffer reset.
-    size_t           m_tokenStreamSize;   // The size of the token stream buffer in bytes.
-    size_t           m_tokenWriteOffset;  // Write the next token at this offset within the token stream.
-    size_t           m_tokenReadOffset;   // Read the next token at this offset within the token stream.
+    // The token stream is a list of chunks from the device's pool, which grows one chunk at a time as tokens are added.
+    TokenChunk*      m_pFirstTokenChunk;  // The first chunk in the token stream. Replay starts reading here.
+    TokenChunk*      m_pWriteTokenChunk;  // Write the next token after the used space in this chunk.
+    TokenChunk*      m_pReadTokenChunk;   // Read the next token from this chunk.
+    size_t           m_tokenReadOffset;   // Read the next token at this offset within the read chunk.
     Result           m_tokenStreamResult; // This must be Success unless an error occured during AllocTokenSpace.
 
     struct
@@ -736,7 +770,9 @@ private:
         uint32 enableSqThreadTrace :  1;  // Thread traces should be collected based on specified data granularity.
         uint32 containsPresent     :  1;  // A CmdPresent() call is made in this command buffer.
         uint32 nested              :  1;  // This is a nested command buffer.
-        uint32 reserved            : 28;
+        uint32 executesNested      :  1;  // A CmdExecuteNestedCmdBuffers() call is made in this command buffer.
+        uint32 forcesLogging       :  1;  // A CmdStartGpuProfilerLogging() call is made in this command buffer.
+        uint32 reserved            : 26;
     } m_flags;
 
     union
@@ -809,6 +845,11 @@ public:
     bool IsFromMasterSubQue() const { return m_subQueueIdx == 0; }
     uint32 GetSubQueueIdx() const { return m_subQueueIdx; }
 
+    // Parallel replay gives this command buffer a worker's allocator to use in place of the queue's replay allocator.
+    // A non-null replay allocator also tells CmdBuffer::Replay that it's running on a parallel job and must not log.
+    void SetReplayAllocator(Util::VirtualLinearAllocator* pAllocator) { m_pReplayAllocator = pAllocator; }
+    Util::VirtualLinearAllocator* ReplayAllocator() const { return m_pReplayAllocator; }
+
 protected:
     virtual ~TargetCmdBuffer() {}
 
@@ -826,6 +867,9 @@ private:
 
     GpuUtil::GpaSession*         m_pGpaSession;
 
+    // If non-null, replays into this command buffer use this allocator instead of the queue's replay allocator.
+    Util::VirtualLinearAllocator* m_pReplayAllocator;
+
     Result                       m_result; // Result from attempted operations.
 
     // The subQueue to which this tgtCmdBuf belongs. This won't change onced the tgtCmdBuf is created.
@@ -65,6 +65,10 @@ Device::Device(
     m_stallMode(GpuProfilerStallAlways),
     m_startFrame(0),
     m_endFrame(0),
+    m_tokenChunkSize(0),
+    m_pFreeTokenChunks(nullptr),
+    m_numFreeTokenChunks(0),
+    m_maxFreeTokenChunks(0),
     m_pGlobalPerfCounters(nullptr),
     m_numGlobalPerfCounters(0),
     m_pStreamingPerfCounters(nullptr),
@@ -83,6 +87,13 @@ Device::Device(
 // =====================================================================================================================
 Device::~Device()
 {
+    while (m_pFreeTokenChunks != nullptr)
+    {
+        TokenChunk*const pNext = m_pFreeTokenChunks->pNext;
+        PAL_FREE(m_pFreeTokenChunks, GetPlatform());
+        m_pFreeTokenChunks = pNext;
+    }
+
     PAL_SAFE_DELETE_ARRAY(m_pGlobalPerfCounters, GetPlatform());
 
     if (m_pStreamingPerfCounters != nullptr)
@@ -105,6 +116,75 @@ bool Device::LoggingEnabled(
              ((platform.FrameId() >= m_startFrame) && (platform.FrameId() < m_endFrame))));
 }
 
+// =====================================================================================================================
+TokenChunk* Device::AcquireTokenChunk(
+    size_t minSize)
+{
+    TokenChunk* pChunk = nullptr;
+
+    if (minSize <= m_tokenChunkSize)
+    {
+        MutexAuto lock(&m_tokenChunkLock);
+
+        pChunk = m_pFreeTokenChunks;
+
+        if (pChunk != nullptr)
+        {
+            m_pFreeTokenChunks = pChunk->pNext;
+            m_numFreeTokenChunks--;
+        }
+    }
+
+    if (pChunk == nullptr)
+    {
+        // Tokens larger than the normal chunk size get a chunk of their own which isn't returned to the pool.
+        const size_t size = Max(minSize, m_tokenChunkSize);
+        void*const   pMem = PAL_MALLOC(sizeof(TokenChunk) + size, GetPlatform(), AllocInternal);
+
+        if (pMem != nullptr)
+        {
+            pChunk       = PAL_PLACEMENT_NEW(pMem) TokenChunk;
+            pChunk->size = size;
+        }
+    }
+
+    if (pChunk != nullptr)
+    {
+        pChunk->pNext = nullptr;
+        pChunk->used  = 0;
+    }
+
+    return pChunk;
+}
+
+// =====================================================================================================================
+void Device::ReleaseTokenChunks(
+    TokenChunk* pChunkList)
+{
+    if (pChunkList != nullptr)
+    {
+        MutexAuto lock(&m_tokenChunkLock);
+
+        while (pChunkList != nullptr)
+        {
+            TokenChunk*const pNext = pChunkList->pNext;
+
+            if ((pChunkList->size == m_tokenChunkSize) && (m_numFreeTokenChunks < m_maxFreeTokenChunks))
+            {
+                pChunkList->pNext  = m_pFreeTokenChunks;
+                m_pFreeTokenChunks = pChunkList;
+                m_numFreeTokenChunks++;
+            }
+            else
+            {
+                PAL_FREE(pChunkList, GetPlatform());
+            }
+
+            pChunkList = pNext;
+        }
+    }
+}
+
 // =====================================================================================================================
 Result Device::CommitSettingsAndInit()
 {
@@ -141,6 +221,8 @@ Result Device::CommitSettingsAndInit()
         m_logPipeStats         = settings.gpuProfilerConfig.recordPipelineStats;
         m_sqttCompilerHash     = settings.gpuProfilerSqttConfig.pipelineHash;
         m_seMask               = settings.gpuProfilerSqttConfig.seMask & maxSeMask;
+        m_tokenChunkSize       = settings.gpuProfilerTokenAllocatorSize;
+        m_maxFreeTokenChunks   = (m_tokenChunkSize > 0) ? Max<size_t>(MaxFreeTokenChunkBytes / m_tokenChunkSize, 1) : 0;
 
         m_stallMode           = settings.gpuProfilerSqttConfig.stallBehavior;
         m_sqttVsHash.upper = settings.gpuProfilerSqttConfig.vsHashHi;
@@ -179,6 +261,11 @@ Result Device::CommitSettingsAndInit()
         }
     }
 
+    if (result == Result::Success)
+    {
+        result = m_tokenChunkLock.Init();
+    }
+
     if (result == Result::Success)
     {
         // Create directory for log files.
@@ -43,6 +43,7 @@ namespace GpuProfiler
 // Forward decl's.
 class TargetCmdBuffer;
 struct PipelineState;
+struct TokenChunk;
 
 // Maximum config field widths is characters
 constexpr uint32 ConfigBlockNameSize    = 32;
@@ -96,6 +97,12 @@ public:
 
     bool SqttEnabledForPipeline(const PipelineState& state, PipelineBindPoint bindPoint) const;
 
+    // Command buffers record their token streams into chunks from a pool shared by the whole device. A chunk will have
+    // room for at least minSize bytes of tokens. Released chunks are returned to the pool unless they were oversized or
+    // the pool is already full.
+    TokenChunk* AcquireTokenChunk(size_t minSize);
+    void        ReleaseTokenChunks(TokenChunk* pChunkList);
+
     // Public IDevice interface methods:
     virtual Result CommitSettingsAndInit() override;
     virtual size_t GetQueueSize(
@@ -209,6 +216,16 @@ private:
     uint32                 m_endFrame;
     uint32                 m_minTimestampAlignment[EngineTypeCount];
     uint32                 m_seMask;
+    size_t                 m_tokenChunkSize;
+
+    // The free token chunk list may hold at most this many bytes of chunks. Anything beyond that is freed on release
+    // so one huge command buffer doesn't pin its peak memory for the lifetime of the device.
+    static constexpr size_t MaxFreeTokenChunkBytes = 64 * 1024 * 1024;
+
+    Util::Mutex            m_tokenChunkLock;       // Serializes access to the free token chunk list.
+    TokenChunk*            m_pFreeTokenChunks;     // A list of token chunks ready for reuse.
+    size_t                 m_numFreeTokenChunks;   // The length of m_pFreeTokenChunks.
+    size_t                 m_maxFreeTokenChunks;   // The longest m_pFreeTokenChunks may grow.
 
     // Track array of which performance counters the user has requested to capture.
     PerfCounter*           m_pGlobalPerfCounters;
@@ -30,6 +30,7 @@
 #include "palAutoBuffer.h"
 #include "palDequeImpl.h"
 #include "palSysUtil.h"
+#include <stdlib.h>
 
 using namespace Util;
 
@@ -52,6 +53,13 @@ Queue::Queue(
     m_shaderEngineCount(0),
     m_pCmdAllocator(nullptr),
     m_replayAllocator(64 * 1024),
+    m_pReplayWorkers(nullptr),
+    m_replayWorkerCount(0),
+    m_pReplayJobs(nullptr),
+    m_replayJobCount(0),
+    m_nextReplayJob(0),
+    m_replayFrameId(0),
+    m_stopReplayWorkers(false),
     m_availableGpaSessions(static_cast<Platform*>(pDevice->GetPlatform())),
     m_busyGpaSessions(static_cast<Platform*>(pDevice->GetPlatform())),
     m_availPerfExpMem(static_cast<Platform*>(pDevice->GetPlatform())),
@@ -60,6 +68,9 @@ Queue::Queue(
     m_pendingSubmits(static_cast<Platform*>(pDevice->GetPlatform())),
     m_profilingModeEnabled(false),
     m_logItems(static_cast<Platform*>(pDevice->GetPlatform())),
+    m_traceWriter(static_cast<Platform*>(pDevice->GetPlatform())),
+    m_binaryTrace(false),
+    m_traceFailed(false),
     m_curLogFrame(0),
     m_curLogCmdBufIdx(0),
     m_curLogSqttIdx(0)
@@ -91,6 +102,14 @@ Queue::~Queue()
     ProcessIdleSubmits();
     m_logFile.Close();
 
+    if (m_traceWriter.IsOpen())
+    {
+        const Result result = m_traceWriter.Close();
+        PAL_ASSERT(result == Result::Success);
+    }
+
+    DestroyReplayWorkers();
+
     Platform* pPlatform = static_cast<Platform*>(m_pDevice->GetPlatform());
     if (m_nextSubmitInfo.pCmdBufCount != nullptr)
     {
@@ -240,9 +259,15 @@ Result Queue::Init(
         result = m_replayAllocator.Init();
     }
 
+    if (result == Result::Success)
+    {
+        result = InitReplayWorkers(pPlatform->PlatformSettings().gpuProfilerConfig.replayThreadCount);
+    }
+
     if (result == Result::Success)
     {
         CmdAllocatorCreateInfo createInfo = { };
+        createInfo.flags.threadSafe                           = (m_replayWorkerCount > 0) ? 1 : 0;
         createInfo.flags.autoMemoryReuse                      = 1;
         createInfo.allocInfo[CommandDataAlloc].allocHeap      = GpuHeapGartUswc;
         createInfo.allocInfo[CommandDataAlloc].allocSize      = 2 * 1024 * 1024;
@@ -290,6 +315,20 @@ Result Queue::Init(
         m_numReportedPerfCounters = numGlobalPerfCounters;
     }
 
+    // The binary trace only holds timing data so anything else must still be logged to .csv files.
+    const auto& profilerConfig = pPlatform->PlatformSettings().gpuProfilerConfig;
+
+    m_binaryTrace = profilerConfig.binaryTraceOutput                 &&
+                    (profilerConfig.recordPipelineStats == false)    &&
+                    (numGlobalPerfCounters == 0)                     &&
+                    (m_pDevice->NumStreamingPerfCounters() == 0)     &&
+                    (m_pDevice->IsThreadTraceEnabled() == false);
+
+    if ((result == Result::Success) && m_binaryTrace)
+    {
+        result = m_traceWriter.Init();
+    }
+
     return result;
 }
 
@@ -463,6 +502,14 @@ Result Queue::Submit(
 
     bool breakBatches = m_pDevice->GetPlatform()->PlatformSettings().gpuProfilerConfig.breakSubmitBatches;
 
+    // Each batch must be replayed before it's submitted so breaking batches forces us to replay serially.
+    const bool parallelReplay = (breakBatches == false) && CanReplayInParallel(submitInfo);
+
+    const uint32 maxReplayJobs  = parallelReplay ? cmdBufferCount : 0;
+    uint32       replayJobCount = 0;
+
+    AutoBuffer<ReplayJob, 64, PlatformDecorator> replayJobs(Max(maxReplayJobs, 1u), pPlatform);
+
     AutoBuffer<GpuMemoryRef, 32, PlatformDecorator> nextGpuMemoryRefs(submitInfo.gpuMemRefCount, pPlatform);
     AutoBuffer<DoppRef,      32, PlatformDecorator> nextDoppRefs(submitInfo.doppRefCount, pPlatform);
 #if PAL_CLIENT_INTERFACE_MAJOR_VERSION >= 568
@@ -471,6 +518,7 @@ Result Queue::Submit(
 
     if ((nextCmdBuffers.Capacity()     < cmdBufferCount)          ||
         (nextCmdBufInfoList.Capacity() < cmdBufferCount)          ||
+        (replayJobs.Capacity()         < maxReplayJobs)           ||
         (nextDoppRefs.Capacity()       < submitInfo.doppRefCount) ||
         (nextGpuMemoryRefs.Capacity()  < submitInfo.gpuMemRefCount)
 #if PAL_CLIENT_INTERFACE_MAJOR_VERSION >= 568
@@ -594,10 +642,22 @@ Result Queue::Submit(
                     nextCmdBuffers[globalCmdBufIdx + localCmdBufIdx] = NextCmdBuffer(pTargetCmdBuffer);
                     localCmdBufIdx++;
 
-                    // Replay the client-specified command buffer commands into the queue-owned command buffer.
-                    result = pRecordedCmdBuffer->Replay(this,
-                                                        pTargetCmdBuffer,
-                                                        static_cast<Platform*>(m_pDevice->GetPlatform())->FrameId());
+                    // Replay the client-specified command buffer commands into the queue-owned command buffer.  In
+                    // parallel mode we only queue up the replay here and run all of them once the loop is done.
+                    if (parallelReplay)
+                    {
+                        replayJobs[replayJobCount].pRecordedCmdBuffer = pRecordedCmdBuffer;
+                        replayJobs[replayJobCount].pTargetCmdBuffer   = pTargetCmdBuffer;
+                        replayJobs[replayJobCount].result             = Result::Success;
+                        replayJobCount++;
+                    }
+                    else
+                    {
+                        result = pRecordedCmdBuffer->Replay(
+                            this,
+                            pTargetCmdBuffer,
+                            static_cast<Platform*>(m_pDevice->GetPlatform())->FrameId());
+                    }
 
                     nextPerSubQueueInfosBreakBatch[subQueueIdx].cmdBufferCount = needPresent ? 2 : 1;
                     nextPerSubQueueInfosBreakBatch[subQueueIdx].ppCmdBuffers = &nextCmdBuffers[
@@ -662,6 +722,13 @@ Result Queue::Submit(
             nextPerSubQueueInfosBreakBatch[subQueueIdx].pCmdBufInfoList = nullptr;
         } // end of traversing each perSubQueueInfo
 
+        if ((result == Result::Success) && parallelReplay)
+        {
+            result = ParallelReplay(&replayJobs[0],
+                                    replayJobCount,
+                                    static_cast<Platform*>(m_pDevice->GetPlatform())->FrameId());
+        }
+
         if ((result == Result::Success) && (breakBatches == false))
         {
             // Make sure we didn't overflow the next arrays.
@@ -695,6 +762,226 @@ Result Queue::Submit(
     return result;
 }
 
+// =====================================================================================================================
+// Starts the worker threads which help the submitting thread replay command buffers. No workers are started if
+// workerCount is zero, so every command buffer will be replayed serially on the submitting thread.
+Result Queue::InitReplayWorkers(
+    uint32 workerCount)
+{
+    Result result = Result::Success;
+
+    if (workerCount > 0)
+    {
+        result = m_replayStartSemaphore.Init(workerCount, 0);
+
+        if (result == Result::Success)
+        {
+            result = m_replayDoneSemaphore.Init(workerCount, 0);
+        }
+
+        if (result == Result::Success)
+        {
+            m_pReplayWorkers = static_cast<ReplayWorker*>(PAL_MALLOC(sizeof(ReplayWorker) * workerCount,
+                                                                     m_pDevice->GetPlatform(),
+                                                                     AllocInternal));
+
+            if (m_pReplayWorkers == nullptr)
+            {
+                result = Result::ErrorOutOfMemory;
+            }
+        }
+
+        // Only workers with running threads are counted so that DestroyReplayWorkers() can clean up after a failure.
+        for (uint32 i = 0; ((i < workerCount) && (result == Result::Success)); i++)
+        {
+            ReplayWorker*const pWorker = PAL_PLACEMENT_NEW(&m_pReplayWorkers[i]) ReplayWorker(this);
+
+            result = pWorker->allocator.Init();
+
+            if (result == Result::Success)
+            {
+                result = pWorker->thread.Begin(&ReplayWorkerCallback, pWorker);
+            }
+
+            if (result == Result::Success)
+            {
+                m_replayWorkerCount++;
+            }
+            else
+            {
+                pWorker->~ReplayWorker();
+            }
+        }
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Stops and joins all replay worker threads.
+void Queue::DestroyReplayWorkers()
+{
+    if (m_pReplayWorkers != nullptr)
+    {
+        m_stopReplayWorkers = true;
+        m_replayStartSemaphore.Post(m_replayWorkerCount);
+
+        for (uint32 i = 0; i < m_replayWorkerCount; i++)
+        {
+            m_pReplayWorkers[i].thread.Join();
+            m_pReplayWorkers[i].~ReplayWorker();
+        }
+
+        PAL_SAFE_FREE(m_pReplayWorkers, m_pDevice->GetPlatform());
+        m_replayWorkerCount = 0;
+    }
+}
+
+// =====================================================================================================================
+// Returns true if the command buffers in this submit can be replayed in parallel. Logging appends log items and
+// acquires GPA sessions in submission order, so only unlogged command buffers can be spread across threads.
+bool Queue::CanReplayInParallel(
+    const MultiSubmitInfo& submitInfo
+    ) const
+{
+    bool   canReplay      = (m_replayWorkerCount > 0)                                          &&
+                            (m_pDevice->LoggingEnabled(GpuProfilerGranularityDraw)   == false) &&
+                            (m_pDevice->LoggingEnabled(GpuProfilerGranularityCmdBuf) == false) &&
+                            (m_pDevice->LoggingEnabled(GpuProfilerGranularityFrame)  == false);
+    uint32 cmdBufferCount = 0;
+
+    for (uint32 i = 0; (canReplay && (i < submitInfo.perSubQueueInfoCount)); i++)
+    {
+        const PerSubQueueSubmitInfo& subQueueInfo = submitInfo.pPerSubQueueInfo[i];
+
+        for (uint32 j = 0; (canReplay && (j < subQueueInfo.cmdBufferCount)); j++)
+        {
+            canReplay = static_cast<const CmdBuffer*>(subQueueInfo.ppCmdBuffers[j])->CanReplayInParallel();
+        }
+
+        cmdBufferCount += subQueueInfo.cmdBufferCount;
+    }
+
+    // There's nothing to gain from waking the workers for a single command buffer.
+    return canReplay && (cmdBufferCount > 1);
+}
+
+// =====================================================================================================================
+// Orders replay jobs by their recorded command buffer so that jobs which replay the same command buffer are adjacent.
+static int32 CompareReplayJobs(
+    const void* pLhs,
+    const void* pRhs)
+{
+    const uintptr_t lhs = reinterpret_cast<uintptr_t>(static_cast<const ReplayJob*>(pLhs)->pRecordedCmdBuffer);
+    const uintptr_t rhs = reinterpret_cast<uintptr_t>(static_cast<const ReplayJob*>(pRhs)->pRecordedCmdBuffer);
+
+    return (lhs < rhs) ? -1 : ((lhs > rhs) ? 1 : 0);
+}
+
+// =====================================================================================================================
+// Replays each job's recorded command buffer into its target command buffer using the replay workers and the calling
+// thread, returning once every job is done. Jobs may be replayed in any order because this is only done for unlogged
+// submits.
+Result Queue::ParallelReplay(
+    ReplayJob* pJobs,
+    uint32     jobCount,
+    uint32     frameId)
+{
+    PAL_ASSERT(jobCount > 1);
+
+    qsort(pJobs, jobCount, sizeof(ReplayJob), CompareReplayJobs);
+
+    m_pReplayJobs    = pJobs;
+    m_replayJobCount = jobCount;
+    m_replayFrameId  = frameId;
+    m_nextReplayJob  = 0;
+
+    // The calling thread takes jobs too, so there's no point in waking a worker for every job.
+    const uint32 workerCount = Min(m_replayWorkerCount, jobCount - 1);
+
+    m_replayStartSemaphore.Post(workerCount);
+
+    ReplayJobs(&m_replayAllocator);
+
+    for (uint32 i = 0; i < workerCount; i++)
+    {
+        m_replayDoneSemaphore.Wait(UINT32_MAX);
+    }
+
+    m_pReplayJobs    = nullptr;
+    m_replayJobCount = 0;
+
+    Result result = Result::Success;
+
+    for (uint32 i = 0; ((i < jobCount) && (result == Result::Success)); i++)
+    {
+        result = pJobs[i].result;
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Claims and replays jobs from the current parallel replay until none are left. The replay state of a command buffer
+// lives in the CmdBuffer, so if it was submitted more than once the thread which claims its first job replays all of
+// them in turn and the other threads skip them.
+void Queue::ReplayJobs(
+    VirtualLinearAllocator* pAllocator)
+{
+    uint32 jobIdx = AtomicIncrement(&m_nextReplayJob) - 1;
+
+    while (jobIdx < m_replayJobCount)
+    {
+        CmdBuffer*const pRecordedCmdBuffer = m_pReplayJobs[jobIdx].pRecordedCmdBuffer;
+
+        if ((jobIdx == 0) || (m_pReplayJobs[jobIdx - 1].pRecordedCmdBuffer != pRecordedCmdBuffer))
+        {
+            for (uint32 idx = jobIdx;
+                 ((idx < m_replayJobCount) && (m_pReplayJobs[idx].pRecordedCmdBuffer == pRecordedCmdBuffer));
+                 idx++)
+            {
+                TargetCmdBuffer*const pTargetCmdBuffer = m_pReplayJobs[idx].pTargetCmdBuffer;
+
+                pTargetCmdBuffer->SetReplayAllocator(pAllocator);
+                m_pReplayJobs[idx].result = pRecordedCmdBuffer->Replay(this, pTargetCmdBuffer, m_replayFrameId);
+                pTargetCmdBuffer->SetReplayAllocator(nullptr);
+            }
+        }
+
+        jobIdx = AtomicIncrement(&m_nextReplayJob) - 1;
+    }
+}
+
+// =====================================================================================================================
+// Waits for the submitting thread to start a parallel replay, then helps it replay jobs until the queue is destroyed.
+void Queue::RunReplayWorker(
+    ReplayWorker* pWorker)
+{
+    bool stop = false;
+
+    while (stop == false)
+    {
+        m_replayStartSemaphore.Wait(UINT32_MAX);
+
+        stop = m_stopReplayWorkers;
+
+        if (stop == false)
+        {
+            ReplayJobs(&pWorker->allocator);
+            m_replayDoneSemaphore.Post();
+        }
+    }
+}
+
+// =====================================================================================================================
+void Queue::ReplayWorkerCallback(
+    void* pParameter)
+{
+    ReplayWorker*const pWorker = static_cast<ReplayWorker*>(pParameter);
+
+    pWorker->pQueue->RunReplayWorker(pWorker);
+}
+
 // =====================================================================================================================
 // Log the WaitIdle call and pass it to the next layer.
 Result Queue::WaitIdle()
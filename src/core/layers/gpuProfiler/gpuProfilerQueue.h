@@ -27,10 +27,13 @@
 
 #include "core/layers/decorators.h"
 #include "core/layers/functionIds.h"
+#include "core/layers/gpuProfiler/gpuProfilerTraceWriter.h"
 #include "palDeque.h"
 #include "palFile.h"
 #include "palGpaSession.h"
 #include "palLinearAllocator.h"
+#include "palSemaphore.h"
+#include "palThread.h"
 
 namespace Pal
 {
@@ -166,6 +169,14 @@ struct SubQueueInfo
     Util::Deque<NestedInfo, Platform>* pBusyNestedCmdBufs;
 };
 
+// A recorded command buffer which must be replayed into a queue-owned command buffer before it can be submitted.
+struct ReplayJob
+{
+    CmdBuffer*       pRecordedCmdBuffer;
+    TargetCmdBuffer* pTargetCmdBuffer;
+    Result           result;
+};
+
 typedef Util::Deque<TargetCmdBuffer*, Platform> CmdBufDeque;
 typedef Util::Deque<NestedInfo, Platform> NestedCmdBufDeque;
 
@@ -254,6 +265,9 @@ private:
     void OutputQueueCallToFile(const LogItem& logItem);
     void OutputCmdBufCallToFile(const LogItem& logItem, const char* pNestedCmdBufPrefix);
     void OutputFrameToFile(const LogItem& logItem);
+    void OutputTraceRecord(const LogItem& logItem, bool nested);
+
+    bool IsLogFileOpen() const { return m_binaryTrace ? m_traceWriter.IsOpen() : m_logFile.IsOpen(); }
 
     void OutputTimestampsToFile(const LogItem& logItem);
     void OutputPipelineStatsToFile(const LogItem& logItem);
@@ -262,6 +276,26 @@ private:
 
     void ProfilingClockMode(bool enable);
 
+    // A thread which helps the submitting thread replay command buffers. Replay uses a linear allocator for temporary
+    // memory which can't be shared between threads, so each worker has its own.
+    struct ReplayWorker
+    {
+        explicit ReplayWorker(Queue* pOwner) : pQueue(pOwner), allocator(64 * 1024) { }
+
+        Queue*                       pQueue;
+        Util::Thread                 thread;
+        Util::VirtualLinearAllocator allocator;
+    };
+
+    Result InitReplayWorkers(uint32 workerCount);
+    void   DestroyReplayWorkers();
+    bool   CanReplayInParallel(const MultiSubmitInfo& submitInfo) const;
+    Result ParallelReplay(ReplayJob* pJobs, uint32 jobCount, uint32 frameId);
+    void   ReplayJobs(Util::VirtualLinearAllocator* pAllocator);
+    void   RunReplayWorker(ReplayWorker* pWorker);
+
+    static void ReplayWorkerCallback(void* pParameter);
+
     Device*const     m_pDevice;
 
     uint32           m_queueCount;
@@ -277,6 +311,18 @@ private:
 
     Util::VirtualLinearAllocator m_replayAllocator; // Used to allocate temporary memory during command buffer replay.
 
+    // Command buffers in a submit may be replayed in parallel by these workers and the submitting thread. The jobs for
+    // the current submit are claimed in order by atomically incrementing m_nextReplayJob.
+    ReplayWorker*                m_pReplayWorkers;
+    uint32                       m_replayWorkerCount;
+    Util::Semaphore              m_replayStartSemaphore; // Posted once per worker that should look for jobs.
+    Util::Semaphore              m_replayDoneSemaphore;  // Posted by each worker once it runs out of jobs.
+    ReplayJob*                   m_pReplayJobs;
+    uint32                       m_replayJobCount;
+    volatile uint32              m_nextReplayJob;
+    uint32                       m_replayFrameId;
+    bool                         m_stopReplayWorkers;
+
     // Each replayed nested command buffer needs its own allocator which will be created from this create info.
     CmdAllocatorCreateInfo m_nestedAllocatorCreateInfo;
 
@@ -321,6 +367,9 @@ private:
 
     Util::Deque<LogItem, Platform>    m_logItems;         // List of outstanding calls waiting to be logged.
     Util::File                        m_logFile;          // File logging is currently outputted to (changes per frame).
+    TraceWriter                       m_traceWriter;      // Replaces m_logFile for the whole queue if m_binaryTrace.
+    bool                              m_binaryTrace;
+    bool                              m_traceFailed;      // The binary trace couldn't be opened so nothing is logged.
     uint32                            m_curLogFrame;      // Used to determine when a new frame is started and a new log
                                                           // file should be opened.
     uint32                            m_curLogCmdBufIdx;  // Current command buffer index for the frame being logged.
@@ -96,14 +96,18 @@ void Queue::OutputLogItemsToFile(
 
             // If we have received a command buffer call without having received a queue call for this frame,
             // we are using the dynamic start/stop of GPU profiling.  Open a new log file in this case.
-            if ((m_logFile.IsOpen() == false) || (m_curLogFrame != logItem.frameId))
+            if ((IsLogFileOpen() == false) || (m_curLogFrame != logItem.frameId))
             {
                 OpenLogFile(logItem.frameId);
                 m_curLogFrame = logItem.frameId;
                 m_curLogCmdBufIdx = 0;
             }
 
-            if (writeResults)
+            if (writeResults && m_binaryTrace)
+            {
+                OutputTraceRecord(logItem, (activeCmdBufs == 2));
+            }
+            else if (writeResults)
             {
                 OutputCmdBufCallToFile(logItem, pNestedCmdBufPrefix);
             }
@@ -117,34 +121,98 @@ void Queue::OutputLogItemsToFile(
         else if (logItem.type == QueueCall)
         {
             // If this is the first queue call for a new frame, open a new log file.
-            if ((m_logFile.IsOpen() == false) || (m_curLogFrame != logItem.frameId))
+            if ((IsLogFileOpen() == false) || (m_curLogFrame != logItem.frameId))
             {
                 OpenLogFile(logItem.frameId);
                 m_curLogFrame = logItem.frameId;
                 m_curLogCmdBufIdx = 0;
             }
 
-            OutputQueueCallToFile(logItem);
+            if (m_binaryTrace)
+            {
+                OutputTraceRecord(logItem, false);
+            }
+            else
+            {
+                OutputQueueCallToFile(logItem);
+            }
         }
         else if (logItem.type == Frame)
         {
             m_curLogFrame = logItem.frameId;
-            OutputFrameToFile(logItem);
+
+            if (m_binaryTrace)
+            {
+                if (m_traceWriter.IsOpen() == false)
+                {
+                    OpenLogFile(logItem.frameId);
+                }
+
+                OutputTraceRecord(logItem, false);
+            }
+            else
+            {
+                OutputFrameToFile(logItem);
+            }
         }
     }
 
     // Flush any buffered log writes to disk.  This is helpful for examining log files while an app is running or
-    // dealing with app/driver crashes after the captured frame.
-    m_logFile.Flush();
+    // dealing with app/driver crashes after the captured frame.  The binary trace is instead written by a background
+    // thread as each of its buffers fills, and the rest of it is written when the queue closes it.
+    if (m_binaryTrace == false)
+    {
+        m_logFile.Flush();
+    }
 }
 
 // =====================================================================================================================
-// Opens and initializes a log file for the specified frame.
+// Opens and initializes a log file for the specified frame.  The binary trace is a single file for the whole queue so
+// it is only opened once.
 void Queue::OpenLogFile(
     uint32 frameId)
 {
     const auto& settings = m_pDevice->GetPlatform()->PlatformSettings();
 
+    if (m_binaryTrace)
+    {
+        if ((m_traceWriter.IsOpen() == false) && (m_traceFailed == false))
+        {
+            // The trace has the pattern traceDevBEngCD-EE.gpt, using the same fields as the .csv files below.
+            char filePath[512];
+            Snprintf(&filePath[0],
+                     sizeof(filePath),
+                     "%s/traceDev%uEng%s%u-%02u.gpt",
+                     m_pDevice->GetPlatform()->LogDirPath(),
+                     m_pDevice->Id(),
+                     EngineTypeStrings[static_cast<uint32>(m_pQueueInfos[0].engineType)],
+                     m_pQueueInfos[0].engineIndex,
+                     m_queueId);
+
+            TraceFileHeader header = { };
+            memcpy(&header.magic[0], &TraceFileMagic[0], sizeof(header.magic));
+            header.version       = TraceFileVersion;
+            header.recordSize    = sizeof(TraceRecord);
+            header.deviceId      = m_pDevice->Id();
+            header.engineType    = static_cast<uint32>(m_pQueueInfos[0].engineType);
+            header.engineIndex   = m_pQueueInfos[0].engineIndex;
+            header.queueId       = m_queueId;
+            header.timestampFreq = m_pDevice->TimestampFreq();
+
+            Result result = m_traceWriter.Open(&filePath[0], header);
+
+            // Don't keep trying to open the trace for every log item. The writer drops anything added while it isn't
+            // open, so the rest of this queue's results are discarded rather than held in memory.
+            if (result != Result::Success)
+            {
+                PAL_ALERT_ALWAYS();
+                m_traceFailed = true;
+            }
+        }
+
+        return;
+    }
+
     m_logFile.Close();
 
     // Build a file name for this frame's log file.  It will have the pattern frameAAAAAADevBEngCD-EE.csv, where:
@@ -572,6 +640,115 @@ void Queue::OutputFrameToFile(
     m_logFile.Flush();
 }
 
+//======================================================================================================================
+// Adds a record of a single queue call, command buffer call or frame to the binary trace.  This mirrors the .csv output
+// of OutputQueueCallToFile, OutputCmdBufCallToFile and OutputFrameToFile.
+void Queue::OutputTraceRecord(
+    const LogItem& logItem,
+    bool           nested)
+{
+    // There's no point gathering the record's data if the trace couldn't be opened.
+    if (m_traceFailed)
+    {
+        return;
+    }
+
+    PAL_ASSERT(m_traceWriter.IsOpen());
+
+    constexpr ShaderType ShaderTypes[] =
+    {
+        ShaderType::Vertex,
+        ShaderType::Hull,
+        ShaderType::Domain,
+        ShaderType::Geometry,
+        ShaderType::Pixel,
+    };
+
+    const auto& settings = m_pDevice->GetPlatform()->PlatformSettings();
+
+    TraceRecord record = { };
+    record.frameId     = logItem.frameId;
+    record.type        = logItem.type;
+    record.commentId   = InvalidTraceString;
+    record.cmdBufIdx   = m_curLogCmdBufIdx;
+    record.flags       = nested ? static_cast<uint32>(TraceRecordNested) : 0;
+
+    if (HasValidGpaSample(&logItem, GpuUtil::GpaSampleType::Timing))
+    {
+        uint64 clocks[2] = {};
+        Result result    = logItem.pGpaSession->GetResults(logItem.gpaSampleIdTs, nullptr, clocks);
+        PAL_ASSERT(result == Result::Success);
+
+        record.startClock = clocks[0];
+        record.endClock   = clocks[1];
+        record.flags     |= TraceRecordTimestamps;
+
+        if ((settings.gpuProfilerConfig.granularity == GpuProfilerGranularityDraw) &&
+            (logItem.type == LogItemType::CmdBufferCall)                          &&
+            (logItem.cmdBufCall.callId == CmdBufCallId::Begin))
+        {
+            record.flags |= TraceRecordHideTime;
+        }
+    }
+
+    if (logItem.type == QueueCall)
+    {
+        record.nameId = TraceWriter::CallNameId(logItem.queueCall.callId);
+    }
+    else if (logItem.type == CmdBufferCall)
+    {
+        const auto& cmdBufItem = logItem.cmdBufCall;
+
+        record.nameId      = TraceWriter::CallNameId(cmdBufItem.callId);
+        record.subQueueIdx = cmdBufItem.subQueueIdx;
+
+        if (cmdBufItem.flags.draw || cmdBufItem.flags.dispatch)
+        {
+            const PipelineInfo& pipelineInfo = cmdBufItem.draw.pipelineInfo;
+
+            record.apiPsoHash         = cmdBufItem.draw.apiPsoHash;
+            record.pipelineHash       = pipelineInfo.internalPipelineHash.stable;
+            record.uniquePipelineHash = pipelineInfo.internalPipelineHash.unique;
+
+            if (settings.gpuProfilerConfig.useFullPipelineHash)
+            {
+                record.flags |= TraceRecordFullPipelineHash;
+            }
+
+            if (cmdBufItem.flags.draw)
+            {
+                record.flags        |= TraceRecordDraw;
+                record.count         = cmdBufItem.draw.vertexCount;
+                record.instanceCount = cmdBufItem.draw.instanceCount;
+
+                for (uint32 i = 0; i < ArrayLen(ShaderTypes); i++)
+                {
+                    record.shaderHashes[i] = pipelineInfo.shader[static_cast<uint32>(ShaderTypes[i])].hash;
+                }
+            }
+            else
+            {
+                record.flags          |= TraceRecordDispatch;
+                record.count           = cmdBufItem.dispatch.threadGroupCount;
+                record.shaderHashes[0] = pipelineInfo.shader[static_cast<uint32>(ShaderType::Compute)].hash;
+            }
+        }
+        else if (cmdBufItem.flags.barrier)
+        {
+            if (cmdBufItem.barrier.pComment != nullptr)
+            {
+                record.commentId = m_traceWriter.AddString(cmdBufItem.barrier.pComment);
+            }
+        }
+        else if (cmdBufItem.flags.comment)
+        {
+            record.commentId = m_traceWriter.AddString(cmdBufItem.comment.string);
+        }
+    }
+
+    m_traceWriter.AddRecord(record);
+}
+
 // =====================================================================================================================
 // Output the portion of a .csv with the start/end clock values and time elapsed.  Shared code by all profile
 // granularities.
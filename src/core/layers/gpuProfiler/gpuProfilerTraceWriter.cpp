@@ -0,0 +1,223 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2020 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+
+#include "core/layers/gpuProfiler/gpuProfilerPlatform.h"
+#include "core/layers/gpuProfiler/gpuProfilerTraceWriter.h"
+#include "palHashMapImpl.h"
+
+using namespace Util;
+
+namespace Pal
+{
+namespace GpuProfiler
+{
+
+// =====================================================================================================================
+TraceWriter::TraceWriter(
+    Platform* pPlatform)
+    :
+    m_pPlatform(pPlatform),
+    m_writer(pPlatform, BufferSize, MaxBuffers),
+    m_nextStringId(0),
+    m_stringIds(MaxSharedStrings / 4, pPlatform),
+    m_pBlockHeader(nullptr),
+    m_block()
+{
+}
+
+// =====================================================================================================================
+// Opens the trace file, starts the write thread, and adds the file header and the call name strings. If this fails the
+// trace is left closed and nothing added to it is kept.
+Result TraceWriter::Open(
+    const char*            pFilePath,
+    const TraceFileHeader& header)
+{
+    PAL_ASSERT(IsOpen() == false);
+
+    Result result = m_writer.Open(pFilePath, FileAccessWrite | FileAccessBinary, true);
+
+    if (result == Result::Success)
+    {
+        result = m_writer.Write(&header, sizeof(header));
+
+        if (result == Result::Success)
+        {
+            AddCallNames();
+        }
+        else
+        {
+            m_writer.Close();
+        }
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Writes everything added so far, stops the write thread and closes the file.
+Result TraceWriter::Close()
+{
+    m_nextStringId = 0;
+    m_pBlockHeader = nullptr;
+
+    FreeStrings();
+
+    return m_writer.Close();
+}
+
+// =====================================================================================================================
+// Forgets every string that has been written so far.
+void TraceWriter::FreeStrings()
+{
+    for (auto iter = m_stringIds.Begin(); iter.Get() != nullptr; iter.Next())
+    {
+        PAL_FREE(iter.Get()->key, m_pPlatform);
+    }
+
+    m_stringIds.Reset();
+}
+
+// =====================================================================================================================
+// The first strings in every file name each call in order of their IDs, see CallNameId().
+void TraceWriter::AddCallNames()
+{
+    for (uint32 i = 0; i < static_cast<uint32>(CmdBufCallId::Count); i++)
+    {
+        AddString(CmdBufCallIdStrings[i]);
+    }
+
+    for (uint32 i = 0; i < static_cast<uint32>(QueueCallId::Count); i++)
+    {
+        AddString(QueueCallIdStrings[i]);
+    }
+}
+
+// =====================================================================================================================
+// Adds a string to the trace, unless one with the same text was already added, and returns its ID.
+uint32 TraceWriter::AddString(
+    const char* pString)
+{
+    uint32 id = InvalidTraceString;
+
+    if (IsOpen())
+    {
+        const uint32* pExistingId = m_stringIds.FindKey(pString);
+
+        if (pExistingId != nullptr)
+        {
+            id = *pExistingId;
+        }
+        else
+        {
+            const size_t fullLength = strlen(pString);
+            const uint32 length     = static_cast<uint32>(
+                Min(fullLength, size_t(BufferSize - sizeof(TraceBlockHeader) - sizeof(TraceStringHeader))));
+
+            void* pEntry = AddEntry(TraceBlockType::Strings, sizeof(TraceStringHeader) + length);
+
+            // IDs are handed out even if we run out of memory so that later strings keep the IDs the reader expects.
+            id = m_nextStringId++;
+
+            if (pEntry != nullptr)
+            {
+                const TraceStringHeader stringHeader = { id, length };
+
+                memcpy(pEntry, &stringHeader, sizeof(stringHeader));
+                memcpy(VoidPtrInc(pEntry, sizeof(stringHeader)), pString, length);
+
+                // Only strings that made it into the trace can be referred to again.
+                if (m_stringIds.GetNumEntries() < MaxSharedStrings)
+                {
+                    char*const pKey = static_cast<char*>(PAL_MALLOC(fullLength + 1, m_pPlatform, AllocInternal));
+
+                    if (pKey != nullptr)
+                    {
+                        memcpy(pKey, pString, fullLength + 1);
+
+                        if (m_stringIds.Insert(pKey, id) != Result::Success)
+                        {
+                            PAL_FREE(pKey, m_pPlatform);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return id;
+}
+
+// =====================================================================================================================
+void TraceWriter::AddRecord(
+    const TraceRecord& record)
+{
+    void* pEntry = IsOpen() ? AddEntry(TraceBlockType::Records, sizeof(record)) : nullptr;
+
+    if (pEntry != nullptr)
+    {
+        memcpy(pEntry, &record, sizeof(record));
+    }
+}
+
+// =====================================================================================================================
+// Returns space for an entry of the given size at the end of a block of the given type, starting a new block if the
+// current one has a different type or its buffer is full. Nothing in the buffer is aligned so entries and block
+// headers must be copied in.
+void* TraceWriter::AddEntry(
+    TraceBlockType type,
+    uint32         size)
+{
+    PAL_ASSERT(size <= (BufferSize - sizeof(TraceBlockHeader)));
+
+    void* pEntry = nullptr;
+
+    if ((m_pBlockHeader == nullptr) || (m_block.type != type) || (m_writer.RemainingSpace() < size))
+    {
+        m_pBlockHeader = m_writer.Reserve(sizeof(TraceBlockHeader) + size);
+        m_block.type   = type;
+        m_block.count  = 0;
+
+        if (m_pBlockHeader != nullptr)
+        {
+            pEntry = VoidPtrInc(m_pBlockHeader, sizeof(TraceBlockHeader));
+        }
+    }
+    else
+    {
+        // The entry fits in the current buffer so this can't fail.
+        pEntry = m_writer.Reserve(size);
+    }
+
+    if (pEntry != nullptr)
+    {
+        m_block.count++;
+        memcpy(m_pBlockHeader, &m_block, sizeof(m_block));
+    }
+
+    return pEntry;
+}
+
+} // GpuProfiler
+} // Pal
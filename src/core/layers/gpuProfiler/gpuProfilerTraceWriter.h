@@ -0,0 +1,173 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2020 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+
+#pragma once
+
+#include "core/layers/functionIds.h"
+#include "pal.h"
+#include "palBufferedFileWriter.h"
+#include "palHashMap.h"
+
+namespace Pal
+{
+namespace GpuProfiler
+{
+
+class Platform;
+
+// The binary trace written in place of the per-frame .csv files when the BinaryTraceOutput setting is enabled. Each
+// queue writes a single file made of a TraceFileHeader followed by any number of blocks. Each block is a
+// TraceBlockHeader followed by its entries:
+//     - Strings: Each entry is a TraceStringHeader followed by that many characters, without a null terminator.
+//                Strings are numbered from zero in the order they are written.  The first block holds the names of
+//                every command buffer call followed by the names of every queue call, so a call's name can be found
+//                directly from its ID.  A string is always written before any record which refers to it.  Records
+//                with the same barrier or comment text usually share a single string.
+//     - Records: Each entry is a TraceRecord for one logged queue call, command buffer call, or frame.
+// All values are little-endian. tools/gpuProfilerTools/timingReport.py reads these files and must be kept in sync.
+constexpr char   TraceFileMagic[8]  = { 'P', 'A', 'L', 'G', 'P', 'T', 'R', 'C' };
+constexpr uint32 TraceFileVersion   = 1;
+constexpr uint32 InvalidTraceString = UINT32_MAX;
+
+struct TraceFileHeader
+{
+    char   magic[8];      // Always TraceFileMagic.
+    uint32 version;       // Always TraceFileVersion.
+    uint32 recordSize;    // The size of a TraceRecord, newer versions may only add fields to the end.
+    uint32 deviceId;
+    uint32 engineType;
+    uint32 engineIndex;
+    uint32 queueId;
+    uint64 timestampFreq; // Frequency of the record clocks in ticks per second.
+};
+
+enum class TraceBlockType : uint32
+{
+    Strings = 0,
+    Records = 1,
+};
+
+struct TraceBlockHeader
+{
+    TraceBlockType type;
+    uint32         count; // The number of entries in this block.
+};
+
+struct TraceStringHeader
+{
+    uint32 id;
+    uint32 length;
+};
+
+enum TraceRecordFlags : uint32
+{
+    TraceRecordTimestamps       = 0x01, // The start and end clocks are valid.
+    TraceRecordHideTime         = 0x02, // The clocks are valid but the elapsed time between them isn't meaningful.
+    TraceRecordNested           = 0x04, // The call was made in a nested command buffer.
+    TraceRecordDraw             = 0x08, // The pipeline, shader, vertex and instance fields are valid.
+    TraceRecordDispatch         = 0x10, // The pipeline, compute shader and thread group fields are valid.
+    TraceRecordFullPipelineHash = 0x20, // The unique pipeline hash should be reported alongside the stable hash.
+};
+
+struct TraceRecord
+{
+    uint32     frameId;
+    uint32     type;                // A LogItemType.
+    uint32     nameId;              // String ID of the call's name, unused for frames.
+    uint32     commentId;           // String ID of the barrier or comment text, or InvalidTraceString.
+    uint32     cmdBufIdx;           // Index of the root command buffer within the frame.
+    uint32     subQueueIdx;
+    uint32     flags;               // TraceRecordFlags.
+    uint32     count;               // Vertex count for draws or thread group count for dispatches.
+    uint32     instanceCount;
+    uint32     reserved;
+    uint64     startClock;
+    uint64     endClock;
+    uint64     apiPsoHash;
+    uint64     pipelineHash;        // The stable internal pipeline hash.
+    uint64     uniquePipelineHash;
+    ShaderHash shaderHashes[5];     // VS or CS, HS, DS, GS and PS hashes.
+};
+
+static_assert(sizeof(TraceRecord) == 160, "The TraceRecord layout is part of the trace file format.");
+
+// =====================================================================================================================
+// Writes a binary trace file. Blocks are built up in fixed-size buffers which are handed to a background thread as they
+// fill, so the queue that is logging never waits on file I/O unless it gets several buffers ahead of the disk. Nothing
+// is written to disk until a buffer fills or the trace is closed.
+class TraceWriter
+{
+public:
+    explicit TraceWriter(Platform* pPlatform);
+    ~TraceWriter() { FreeStrings(); }
+
+    // Must be called once before the trace is opened.
+    Result Init() { return m_stringIds.Init(); }
+
+    Result Open(const char* pFilePath, const TraceFileHeader& header);
+    Result Close();
+
+    bool IsOpen() const { return m_writer.IsOpen(); }
+
+    // Returns the ID of a string naming the given call.
+    static uint32 CallNameId(CmdBufCallId callId) { return static_cast<uint32>(callId); }
+    static uint32 CallNameId(QueueCallId callId)
+        { return static_cast<uint32>(CmdBufCallId::Count) + static_cast<uint32>(callId); }
+
+    // Returns the ID of a string holding the given text, only writing the text if it hasn't been written before.
+    // Returns InvalidTraceString if the trace isn't open. Records are likewise dropped if the trace isn't open.
+    uint32 AddString(const char* pString);
+    void   AddRecord(const TraceRecord& record);
+
+private:
+    // The size of each buffer in bytes and how many buffers may exist at once. Strings are truncated to fit a buffer.
+    static constexpr uint32 BufferSize = 1024 * 1024;
+    static constexpr uint32 MaxBuffers = 4;
+
+    // Only this many distinct strings are remembered so that their text is written once. Any strings past that are
+    // written each time they are added, which bounds the memory used by traces with lots of unique comments.
+    static constexpr uint32 MaxSharedStrings = 4096;
+
+    typedef Util::HashMap<const char*, uint32, Platform, Util::StringJenkinsHashFunc, Util::StringEqualFunc> StringMap;
+
+    void* AddEntry(TraceBlockType type, uint32 size);
+    void  AddCallNames();
+    void  FreeStrings();
+
+    Platform*const           m_pPlatform;
+    Util::BufferedFileWriter m_writer;
+    uint32                   m_nextStringId;
+    StringMap                m_stringIds;    // Maps our own copies of the text of written strings to their IDs.
+
+    // A block can't span buffers, so its header stays in the writer's current buffer while entries are added to it.
+    void*                    m_pBlockHeader; // Where the header of the block that entries are being added to lives.
+    TraceBlockHeader         m_block;        // That block's header, which is copied to m_pBlockHeader as it changes.
+
+    PAL_DISALLOW_DEFAULT_CTOR(TraceWriter);
+    PAL_DISALLOW_COPY_AND_ASSIGN(TraceWriter);
+};
+
+} // GpuProfiler
+} // Pal
@@ -49,6 +49,7 @@
 #include "core/layers/interfaceLogger/interfaceLoggerScreen.h"
 #include "core/layers/interfaceLogger/interfaceLoggerShaderLibrary.h"
 #include "core/layers/interfaceLogger/interfaceLoggerSwapChain.h"
+#include "core/g_palPlatformSettings.h"
 
 using namespace Util;
 
@@ -344,30 +345,22 @@ LogStream::LogStream(
     Platform* pPlatform)
     :
     m_pPlatform(pPlatform),
-    m_pBuffer(nullptr),
-    m_bufferSize(0),
-    m_bufferUsed(0)
+    m_writer(pPlatform, BufferSize, MaxBuffers),
+    m_streaming(false)
 {
 }
 
 // =====================================================================================================================
-LogStream::~LogStream()
+Result LogStream::OpenFile(
+    const char* pFilePath,
+    bool        binary)
 {
-    if (m_file.IsOpen())
-    {
-        // Write out anything left in the buffer. If the file was never opened nothing gets written.
-        const Result result = WriteFile();
-        PAL_ASSERT(result == Result::Success);
-    }
+    const uint32 accessFlags = binary ? (Util::FileAccessWrite | Util::FileAccessBinary) : Util::FileAccessWrite;
+    const auto&  settings    = m_pPlatform->PlatformSettings().interfaceLoggerConfig;
 
-    PAL_SAFE_FREE(m_pBuffer, m_pPlatform);
-}
+    m_streaming = settings.streamOutput;
 
-// =====================================================================================================================
-Result LogStream::OpenFile(
-    const char* pFilePath)
-{
-    Result result = m_file.Open(pFilePath, Util::FileAccessWrite);
+    Result result = m_writer.Open(pFilePath, accessFlags, (m_streaming && settings.backgroundWrite));
 
     if (result == Result::Success)
     {
@@ -379,27 +372,11 @@ Result LogStream::OpenFile(
 }
 
 // =====================================================================================================================
+// Writes all buffered text to the log file and flushes it to disk to make the logs more useful if the application
+// crashes.
 Result LogStream::WriteFile()
 {
-    Result result = Result::Success;
-
-    if (m_file.IsOpen() == false)
-    {
-        result = Result::ErrorUnavailable;
-    }
-    else if (m_bufferUsed > 0)
-    {
-        result       = m_file.Write(m_pBuffer, m_bufferUsed * sizeof(char));
-        m_bufferUsed = 0;
-
-        if (result == Result::Success)
-        {
-            // Flush to disk to make the logs more useful if the application crashes.
-            result = m_file.Flush();
-        }
-    }
-
-    return result;
+    return m_writer.Flush();
 }
 
 // =====================================================================================================================
@@ -407,37 +384,15 @@ void LogStream::WriteString(
     const char* pString,
     uint32      length)
 {
-    VerifyUnusedSpace(length);
-    memcpy(m_pBuffer + m_bufferUsed, pString, length * sizeof(char));
-    m_bufferUsed += length;
+    // If we run out of memory the rest of the text is lost.
+    m_writer.Write(pString, length * sizeof(char));
 }
 
 // =====================================================================================================================
 void LogStream::WriteCharacter(
     char character)
 {
-    VerifyUnusedSpace(1);
-    m_pBuffer[m_bufferUsed++] = character;
-}
-
-// =====================================================================================================================
-// Verifies that the buffer has enough space for an additional "size" characters, reallocating if necessary.
-void LogStream::VerifyUnusedSpace(
-    uint32 size)
-{
-    if (m_bufferSize - m_bufferUsed < size)
-    {
-        const char* pOldBuffer = m_pBuffer;
-
-        // Bump up the size of the buffer to the next multiple of 4K that fits the current contents plus "size".
-        m_bufferSize = Pow2Align(m_bufferSize + size, 4096);
-        m_pBuffer     = static_cast<char*>(PAL_MALLOC(m_bufferSize * sizeof(char), m_pPlatform, AllocInternal));
-
-        PAL_ASSERT(m_pBuffer != nullptr);
-
-        memcpy(m_pBuffer, pOldBuffer, m_bufferUsed);
-        PAL_SAFE_FREE(pOldBuffer, m_pPlatform);
-    }
+    m_writer.Write(&character, sizeof(char));
 }
 
 // =====================================================================================================================
@@ -445,7 +400,13 @@ LogContext::LogContext(
     Platform* pPlatform)
     :
     JsonWriter(&m_stream),
-    m_stream(pPlatform)
+    m_pPlatform(pPlatform),
+    m_format(LogFormat::Pending),
+    m_stream(pPlatform),
+    m_pPackBuffer(nullptr),
+    m_packSize(0),
+    m_packCapacity(0),
+    m_packDepth(0)
 {
 #if PAL_ENABLE_PRINTS_ASSERTS
     for (uint32 idx = 0; idx < static_cast<uint32>(InterfaceFunc::Count); ++idx)
@@ -453,16 +414,53 @@ LogContext::LogContext(
         PAL_ASSERT(static_cast<uint32>(FuncFormattingTable[idx].function) == idx);
     }
 #endif
-
-    // All top-level entries in the log will be contained in a list. If we don't do this, we can only write one entry!
-    BeginList(false);
 }
 
 // =====================================================================================================================
 LogContext::~LogContext()
 {
-    // End the list we started in the constructor.
-    EndList();
+    if (m_format == LogFormat::Json)
+    {
+        // End the list we started in OpenFile.
+        EndList();
+    }
+
+    PAL_SAFE_FREE(m_pPackBuffer, m_pPlatform);
+}
+
+// =====================================================================================================================
+Result LogContext::OpenFile(
+    const char* pFilePath,
+    bool        binary)
+{
+    PAL_ASSERT(m_format == LogFormat::Pending);
+    PAL_ASSERT(m_packDepth == 0);
+
+    if (binary)
+    {
+        // Entries packed so far are already in the right format.
+        m_format = LogFormat::MsgPack;
+        m_stream.WriteString(reinterpret_cast<const char*>(m_pPackBuffer), m_packSize);
+    }
+    else
+    {
+        m_format = LogFormat::Json;
+
+        // All top-level entries in the log will be contained in a list. If we don't do this, we can only write one
+        // entry! Any entries logged before now are converted to JSON within that list.
+        BeginList(false);
+
+        uint8* pItem = m_pPackBuffer;
+
+        while (pItem != m_pPackBuffer + m_packSize)
+        {
+            pItem = WritePackedAsJson(pItem, false);
+        }
+    }
+
+    m_packSize = 0;
+
+    return m_stream.OpenFile(pFilePath, binary);
 }
 
 // =====================================================================================================================
@@ -486,15 +484,673 @@ void LogContext::BeginFunc(
 void LogContext::EndFunc()
 {
     EndMap();
+    Flush();
+}
 
-    // Flush our buffered JSON text to our log file if it's already been opened.
-    if (m_stream.IsFileOpen())
+// =====================================================================================================================
+void LogContext::Flush()
+{
+    if (m_stream.IsFileOpen() && (m_stream.IsStreaming() == false))
     {
         const Result result = m_stream.WriteFile();
         PAL_ASSERT(result == Result::Success);
     }
 }
 
+// =====================================================================================================================
+void LogContext::WritePackedEntry(
+    uint8* pEntry,
+    uint32 size)
+{
+    PAL_ASSERT(m_packDepth == 0);
+
+    if (m_format == LogFormat::Json)
+    {
+        const uint8*const pEnd = WritePackedAsJson(pEntry, false);
+        PAL_ASSERT(pEnd == pEntry + size);
+    }
+    else if (m_format == LogFormat::MsgPack)
+    {
+        m_stream.WriteString(reinterpret_cast<const char*>(pEntry), size);
+    }
+    else
+    {
+        memcpy(PackReserve(size), pEntry, size);
+    }
+}
+
+// =====================================================================================================================
+void LogContext::BeginList(
+    bool isInline)
+{
+    if (m_format == LogFormat::Json)
+    {
+        JsonWriter::BeginList(isInline);
+    }
+    else
+    {
+        PackBeginContainer(false, isInline);
+    }
+}
+
+// =====================================================================================================================
+void LogContext::EndList()
+{
+    if (m_format == LogFormat::Json)
+    {
+        JsonWriter::EndList();
+    }
+    else
+    {
+        PackEndContainer();
+    }
+}
+
+// =====================================================================================================================
+void LogContext::BeginMap(
+    bool isInline)
+{
+    if (m_format == LogFormat::Json)
+    {
+        JsonWriter::BeginMap(isInline);
+    }
+    else
+    {
+        PackBeginContainer(true, isInline);
+    }
+}
+
+// =====================================================================================================================
+void LogContext::EndMap()
+{
+    if (m_format == LogFormat::Json)
+    {
+        JsonWriter::EndMap();
+    }
+    else
+    {
+        PackEndContainer();
+    }
+}
+
+// =====================================================================================================================
+void LogContext::Key(
+    const char* pKey)
+{
+    if (m_format == LogFormat::Json)
+    {
+        JsonWriter::Key(pKey);
+    }
+    else
+    {
+        PackKey(pKey);
+    }
+}
+
+// =====================================================================================================================
+void LogContext::Value(
+    const char* pValue)
+{
+    if (m_format == LogFormat::Json)
+    {
+        JsonWriter::Value(pValue);
+    }
+    else
+    {
+        PackValue(pValue);
+    }
+}
+
+// =====================================================================================================================
+void LogContext::Value(
+    uint64 value)
+{
+    if (m_format == LogFormat::Json)
+    {
+        JsonWriter::Value(value);
+    }
+    else
+    {
+        PackUnsigned(value);
+    }
+}
+
+// =====================================================================================================================
+void LogContext::Value(
+    uint32 value)
+{
+    if (m_format == LogFormat::Json)
+    {
+        JsonWriter::Value(value);
+    }
+    else
+    {
+        PackUnsigned(value);
+    }
+}
+
+// =====================================================================================================================
+void LogContext::Value(
+    uint16 value)
+{
+    if (m_format == LogFormat::Json)
+    {
+        JsonWriter::Value(value);
+    }
+    else
+    {
+        PackUnsigned(value);
+    }
+}
+
+// =====================================================================================================================
+void LogContext::Value(
+    uint8 value)
+{
+    if (m_format == LogFormat::Json)
+    {
+        JsonWriter::Value(value);
+    }
+    else
+    {
+        PackUnsigned(value);
+    }
+}
+
+// =====================================================================================================================
+void LogContext::Value(
+    int64 value)
+{
+    if (m_format == LogFormat::Json)
+    {
+        JsonWriter::Value(value);
+    }
+    else
+    {
+        PackSigned(value);
+    }
+}
+
+// =====================================================================================================================
+void LogContext::Value(
+    int32 value)
+{
+    if (m_format == LogFormat::Json)
+    {
+        JsonWriter::Value(value);
+    }
+    else
+    {
+        PackSigned(value);
+    }
+}
+
+// =====================================================================================================================
+void LogContext::Value(
+    int16 value)
+{
+    if (m_format == LogFormat::Json)
+    {
+        JsonWriter::Value(value);
+    }
+    else
+    {
+        PackSigned(value);
+    }
+}
+
+// =====================================================================================================================
+void LogContext::Value(
+    int8 value)
+{
+    if (m_format == LogFormat::Json)
+    {
+        JsonWriter::Value(value);
+    }
+    else
+    {
+        PackSigned(value);
+    }
+}
+
+// =====================================================================================================================
+void LogContext::Value(
+    float value)
+{
+    if (m_format == LogFormat::Json)
+    {
+        JsonWriter::Value(value);
+    }
+    else
+    {
+        PackFloat(value);
+    }
+}
+
+// =====================================================================================================================
+void LogContext::Value(
+    bool value)
+{
+    if (m_format == LogFormat::Json)
+    {
+        JsonWriter::Value(value);
+    }
+    else
+    {
+        PackBool(value);
+    }
+}
+
+// =====================================================================================================================
+void LogContext::NullValue()
+{
+    if (m_format == LogFormat::Json)
+    {
+        JsonWriter::NullValue();
+    }
+    else
+    {
+        PackNull();
+    }
+}
+
+// =====================================================================================================================
+// Returns a pointer to "size" bytes at the end of the pack buffer, growing the buffer if necessary. One byte past the
+// data is always kept available so WritePackedAsJson can temporarily null-terminate strings in place.
+uint8* LogContext::PackReserve(
+    uint32 size)
+{
+    if (m_packCapacity - m_packSize <= size)
+    {
+        const uint8* pOldBuffer = m_pPackBuffer;
+
+        m_packCapacity = Max(m_packCapacity * 2, Pow2Align(m_packSize + size + 1, 4096));
+        m_pPackBuffer  = static_cast<uint8*>(PAL_MALLOC(m_packCapacity, m_pPlatform, AllocInternal));
+
+        PAL_ASSERT(m_pPackBuffer != nullptr);
+
+        if (pOldBuffer != nullptr)
+        {
+            memcpy(m_pPackBuffer, pOldBuffer, m_packSize);
+            PAL_FREE(pOldBuffer, m_pPlatform);
+        }
+    }
+
+    uint8* const pData = m_pPackBuffer + m_packSize;
+    m_packSize += size;
+
+    return pData;
+}
+
+// =====================================================================================================================
+// Must be called before packing a key or value, counts it towards the current container.
+void LogContext::PackBeginItem(
+    bool isKey)
+{
+    if (m_packDepth > 0)
+    {
+        PackScope*const pScope = &m_packScopes[m_packDepth - 1];
+
+        // Maps are sized in key-value pairs so only their keys are counted.
+        PAL_ASSERT(pScope->isMap || (isKey == false));
+
+        if (pScope->isMap == isKey)
+        {
+            pScope->numItems++;
+        }
+    }
+    else
+    {
+        PAL_ASSERT(isKey == false);
+    }
+}
+
+// =====================================================================================================================
+// Must be called after packing a value or ending a container. Once a top-level entry is complete it's written to the
+// log stream, unless we're still waiting to find out which format the log uses.
+void LogContext::PackEndItem()
+{
+    if ((m_packDepth == 0) && (m_format == LogFormat::MsgPack))
+    {
+        m_stream.WriteString(reinterpret_cast<const char*>(m_pPackBuffer), m_packSize);
+        m_packSize = 0;
+    }
+}
+
+// =====================================================================================================================
+void LogContext::PackBeginContainer(
+    bool isMap,
+    bool isInline)
+{
+    PackBeginItem(false);
+
+    PAL_ASSERT(m_packDepth < PackScopeStackSize);
+
+    PackScope*const pScope = &m_packScopes[m_packDepth++];
+
+    pScope->headerOffset = m_packSize;
+    pScope->numItems     = 0;
+    pScope->isMap        = isMap;
+    pScope->isInline     = isInline;
+
+    // map16 or array16 if inline, otherwise map32 or array32. The count is filled in by PackEndContainer.
+    if (isInline)
+    {
+        *PackReserve(3) = isMap ? 0xde : 0xdc;
+    }
+    else
+    {
+        *PackReserve(5) = isMap ? 0xdf : 0xdd;
+    }
+}
+
+// =====================================================================================================================
+void LogContext::PackEndContainer()
+{
+    PAL_ASSERT(m_packDepth > 0);
+
+    const PackScope& scope = m_packScopes[--m_packDepth];
+
+    if (scope.isInline && (scope.numItems > UINT16_MAX))
+    {
+        // Too big for a 16-bit count. Widen the header and let this container be written expanded instead.
+        const uint32 bodyOffset = scope.headerOffset + 3;
+
+        PackReserve(2);
+        memmove(m_pPackBuffer + bodyOffset + 2, m_pPackBuffer + bodyOffset, m_packSize - 2 - bodyOffset);
+
+        m_pPackBuffer[scope.headerOffset] = scope.isMap ? 0xdf : 0xdd;
+    }
+
+    uint8*const pHeader = m_pPackBuffer + scope.headerOffset;
+
+    if ((pHeader[0] == 0xdc) || (pHeader[0] == 0xde))
+    {
+        pHeader[1] = static_cast<uint8>(scope.numItems >> 8);
+        pHeader[2] = static_cast<uint8>(scope.numItems);
+    }
+    else
+    {
+        pHeader[1] = static_cast<uint8>(scope.numItems >> 24);
+        pHeader[2] = static_cast<uint8>(scope.numItems >> 16);
+        pHeader[3] = static_cast<uint8>(scope.numItems >> 8);
+        pHeader[4] = static_cast<uint8>(scope.numItems);
+    }
+
+    PackEndItem();
+}
+
+// =====================================================================================================================
+void LogContext::PackString(
+    const char* pString,
+    uint32      length)
+{
+    uint8* pData = nullptr;
+
+    if (length < 32)
+    {
+        pData    = PackReserve(1 + length);
+        *pData++ = static_cast<uint8>(0xa0 | length);
+    }
+    else if (length <= UINT8_MAX)
+    {
+        pData    = PackReserve(2 + length);
+        *pData++ = 0xd9;
+        *pData++ = static_cast<uint8>(length);
+    }
+    else if (length <= UINT16_MAX)
+    {
+        pData    = PackReserve(3 + length);
+        *pData++ = 0xda;
+        *pData++ = static_cast<uint8>(length >> 8);
+        *pData++ = static_cast<uint8>(length);
+    }
+    else
+    {
+        pData    = PackReserve(5 + length);
+        *pData++ = 0xdb;
+        *pData++ = static_cast<uint8>(length >> 24);
+        *pData++ = static_cast<uint8>(length >> 16);
+        *pData++ = static_cast<uint8>(length >> 8);
+        *pData++ = static_cast<uint8>(length);
+    }
+
+    memcpy(pData, pString, length);
+}
+
+// =====================================================================================================================
+void LogContext::PackKey(
+    const char* pKey)
+{
+    PackBeginItem(true);
+    PackString(pKey, static_cast<uint32>(strlen(pKey)));
+}
+
+// =====================================================================================================================
+void LogContext::PackValue(
+    const char* pValue)
+{
+    PackBeginItem(false);
+    PackString(pValue, static_cast<uint32>(strlen(pValue)));
+    PackEndItem();
+}
+
+// =====================================================================================================================
+void LogContext::PackUnsigned(
+    uint64 value)
+{
+    PackBeginItem(false);
+
+    if (value < 128)
+    {
+        *PackReserve(1) = static_cast<uint8>(value);
+    }
+    else
+    {
+        // Use the smallest of uint8, uint16, uint32 or uint64.
+        const uint32 numBytes = (value <= UINT8_MAX) ? 1 : (value <= UINT16_MAX) ? 2 : (value <= UINT32_MAX) ? 4 : 8;
+        uint8*const  pData    = PackReserve(1 + numBytes);
+
+        pData[0] = (numBytes == 1) ? 0xcc : (numBytes == 2) ? 0xcd : (numBytes == 4) ? 0xce : 0xcf;
+
+        for (uint32 idx = 0; idx < numBytes; ++idx)
+        {
+            pData[numBytes - idx] = static_cast<uint8>(value >> (8 * idx));
+        }
+    }
+
+    PackEndItem();
+}
+
+// =====================================================================================================================
+void LogContext::PackSigned(
+    int64 value)
+{
+    if (value >= 0)
+    {
+        PackUnsigned(static_cast<uint64>(value));
+    }
+    else
+    {
+        PackBeginItem(false);
+
+        if (value >= -32)
+        {
+            *PackReserve(1) = static_cast<uint8>(value);
+        }
+        else
+        {
+            // Use the smallest of int8, int16, int32 or int64.
+            const uint32 numBytes = (value >= INT8_MIN) ? 1 : (value >= INT16_MIN) ? 2 : (value >= INT32_MIN) ? 4 : 8;
+            uint8*const  pData    = PackReserve(1 + numBytes);
+
+            pData[0] = (numBytes == 1) ? 0xd0 : (numBytes == 2) ? 0xd1 : (numBytes == 4) ? 0xd2 : 0xd3;
+
+            for (uint32 idx = 0; idx < numBytes; ++idx)
+            {
+                pData[numBytes - idx] = static_cast<uint8>(static_cast<uint64>(value) >> (8 * idx));
+            }
+        }
+
+        PackEndItem();
+    }
+}
+
+// =====================================================================================================================
+void LogContext::PackFloat(
+    float value)
+{
+    PackBeginItem(false);
+
+    uint32 bits = 0;
+    memcpy(&bits, &value, sizeof(bits));
+
+    uint8*const pData = PackReserve(5);
+
+    pData[0] = 0xca;
+    pData[1] = static_cast<uint8>(bits >> 24);
+    pData[2] = static_cast<uint8>(bits >> 16);
+    pData[3] = static_cast<uint8>(bits >> 8);
+    pData[4] = static_cast<uint8>(bits);
+
+    PackEndItem();
+}
+
+// =====================================================================================================================
+void LogContext::PackBool(
+    bool value)
+{
+    PackBeginItem(false);
+    *PackReserve(1) = value ? 0xc3 : 0xc2;
+    PackEndItem();
+}
+
+// =====================================================================================================================
+void LogContext::PackNull()
+{
+    PackBeginItem(false);
+    *PackReserve(1) = 0xc0;
+    PackEndItem();
+}
+
+// =====================================================================================================================
+// Writes one item from the pack buffer as JSON and returns a pointer to the next item. This only needs to understand
+// what the Pack functions produce. Containers with 16-bit counts were packed inline and are written inline again.
+uint8* LogContext::WritePackedAsJson(
+    uint8* pItem,
+    bool   isKey)
+{
+    const uint8 type = *pItem++;
+
+    // The number of bytes in the big-endian length or value that follows the type byte, if any.
+    uint32 numBytes = 0;
+
+    switch (type)
+    {
+    case 0xcc: case 0xd0: case 0xd9: numBytes = 1; break;
+    case 0xcd: case 0xd1: case 0xda: case 0xdc: case 0xde: numBytes = 2; break;
+    case 0xce: case 0xd2: case 0xdb: case 0xca: case 0xdd: case 0xdf: numBytes = 4; break;
+    case 0xcf: case 0xd3: numBytes = 8; break;
+    default: break;
+    }
+
+    uint64 payload = 0;
+
+    for (uint32 idx = 0; idx < numBytes; ++idx)
+    {
+        payload = (payload << 8) | *pItem++;
+    }
+
+    if ((type < 0x80) || ((type >= 0xcc) && (type <= 0xcf)))
+    {
+        JsonWriter::Value((type < 0x80) ? static_cast<uint64>(type) : payload);
+    }
+    else if (type >= 0xe0)
+    {
+        JsonWriter::Value(static_cast<int64>(static_cast<int8>(type)));
+    }
+    else if ((type >= 0xd0) && (type <= 0xd3))
+    {
+        // Sign extend from the packed size.
+        const uint32 shift = 64 - (8 * numBytes);
+        JsonWriter::Value(static_cast<int64>(payload << shift) >> shift);
+    }
+    else if (((type & 0xe0) == 0xa0) || ((type >= 0xd9) && (type <= 0xdb)))
+    {
+        const uint32 length = ((type & 0xe0) == 0xa0) ? (type & 0x1f) : static_cast<uint32>(payload);
+        char*const   pText  = reinterpret_cast<char*>(pItem);
+
+        // Strings aren't null-terminated in the pack buffer. The byte following the string belongs to the next item
+        // (or is spare space at the end of the buffer), so terminate the string in place and restore it afterwards.
+        const char next = pText[length];
+        pText[length] = '\0';
+
+        if (isKey)
+        {
+            JsonWriter::Key(pText);
+        }
+        else
+        {
+            JsonWriter::Value(pText);
+        }
+
+        pText[length] = next;
+        pItem        += length;
+    }
+    else if (type == 0xca)
+    {
+        const uint32 bits  = static_cast<uint32>(payload);
+        float        value = 0.0f;
+        memcpy(&value, &bits, sizeof(value));
+
+        JsonWriter::Value(value);
+    }
+    else if ((type == 0xc2) || (type == 0xc3))
+    {
+        JsonWriter::Value(type == 0xc3);
+    }
+    else if (type == 0xc0)
+    {
+        JsonWriter::NullValue();
+    }
+    else
+    {
+        PAL_ASSERT((type >= 0xdc) && (type <= 0xdf));
+    }
+
+    if ((type >= 0xdc) && (type <= 0xdf))
+    {
+        const bool   isMap    = (type >= 0xde);
+        const bool   isInline = (type == 0xdc) || (type == 0xde);
+        const uint32 numItems = static_cast<uint32>(payload) * (isMap ? 2 : 1);
+
+        if (isMap)
+        {
+            JsonWriter::BeginMap(isInline);
+        }
+        else
+        {
+            JsonWriter::BeginList(isInline);
+        }
+
+        for (uint32 idx = 0; idx < numItems; ++idx)
+        {
+            pItem = WritePackedAsJson(pItem, isMap && ((idx & 1) == 0));
+        }
+
+        if (isMap)
+        {
+            JsonWriter::EndMap();
+        }
+        else
+        {
+            JsonWriter::EndList();
+        }
+    }
+
+    return pItem;
+}
+
 // =====================================================================================================================
 void LogContext::Object(
     const IBorderColorPalette* pDecorator)
@@ -28,7 +28,7 @@
 #if PAL_BUILD_INTERFACE_LOGGER
 
 #include "core/layers/decorators.h"
-#include "palFile.h"
+#include "palBufferedFileWriter.h"
 #include "palJsonWriter.h"
 
 namespace Pal
@@ -321,31 +321,40 @@ struct BeginFuncInfo
 };
 
 // =====================================================================================================================
-// JSON stream that records the text stream using a staging buffer and a log file. WriteFile must be called explicitly
+// JSON stream that records the text stream using staging buffers and a log file. WriteFile must be called explicitly
 // to flush all buffered text. Note that this makes it possible to generate JSON text before OpenFile has been called.
+//
+// Text is staged in a chain of fixed-size buffers so it never has to be copied to grow the staging area. Once the file
+// is open each buffer is written out as soon as it fills and only a small fixed set of buffers is kept. If the
+// StreamOutput setting is enabled when the file is opened, WriteFile need not be called after each logged call and
+// full buffers may be written by a background thread, so long captures run in constant memory.
 class LogStream : public Util::JsonStream
 {
 public:
     explicit LogStream(Platform* pPlatform);
-    virtual ~LogStream();
+    virtual ~LogStream() { }
 
-    Result OpenFile(const char* pFilePath);
+    Result OpenFile(const char* pFilePath, bool binary);
     Result WriteFile();
 
     // Returns true if the log file has already been opened.
-    bool IsFileOpen() const { return m_file.IsOpen(); }
+    bool IsFileOpen() const { return m_writer.IsOpen(); }
+
+    // Returns true if full buffers are written as they fill, in which case WriteFile need not be called after each
+    // logged call.
+    bool IsStreaming() const { return m_streaming; }
 
     virtual void WriteString(const char* pString, uint32 length) override;
     virtual void WriteCharacter(char character) override;
 
 private:
-    void VerifyUnusedSpace(uint32 size);
+    // The size of each staging buffer in characters and how many buffers are kept once text is being written out.
+    static constexpr uint32 BufferSize = 1024 * 1024;
+    static constexpr uint32 MaxBuffers = 4;
 
-    Platform*const m_pPlatform;
-    Util::File     m_file;       // The text stream is being written here.
-    char*          m_pBuffer;    // Buffered text data that needs to be written to the file.
-    uint32         m_bufferSize; // The size of the buffer in characters.
-    uint32         m_bufferUsed; // How many characters of the buffer are in use.
+    Platform*const           m_pPlatform;
+    Util::BufferedFileWriter m_writer;    // The text stream is being written here.
+    bool                     m_streaming; // If WriteFile need not be called after each logged call.
 
     PAL_DISALLOW_DEFAULT_CTOR(LogStream);
     PAL_DISALLOW_COPY_AND_ASSIGN(LogStream);
@@ -396,8 +405,55 @@ public:
     explicit LogContext(Platform* pPlatform);
     virtual ~LogContext();
 
-    // Must be called once to associate a context with a log file. Logging can occur before the log is opened.
-    Result OpenFile(const char* pFilePath) { return m_stream.OpenFile(pFilePath); }
+    // Must be called once to associate a context with a log file. Logging can occur before the log is opened. If binary
+    // is true the log is written as a sequence of MessagePack objects, one per top-level entry, instead of JSON text.
+    Result OpenFile(const char* pFilePath, bool binary);
+
+    // A context that is never opened keeps its entries packed in memory. These let the platform move each completed
+    // entry out of such a context and into the log of another context.
+    uint8* PackedData() const { return m_pPackBuffer; }
+    uint32 PackedSize() const { return m_packSize; }
+    void   ClearPacked()      { PAL_ASSERT(m_packDepth == 0); m_packSize = 0; }
+
+    // Writes a complete top-level entry packed by another context. The byte after the entry must be writable.
+    void WritePackedEntry(uint8* pEntry, uint32 size);
+
+    // Writes any buffered log text to the log file if it's open. Streamed logs write buffers as they fill instead.
+    void Flush();
+
+    // These hide the JsonWriter functions of the same names so that every token goes through the log's output format.
+    void BeginList(bool isInline);
+    void EndList();
+    void BeginMap(bool isInline);
+    void EndMap();
+    void Key(const char* pKey);
+    void Value(const char* pValue);
+    void Value(uint64 value);
+    void Value(uint32 value);
+    void Value(uint16 value);
+    void Value(uint8 value);
+    void Value(int64 value);
+    void Value(int32 value);
+    void Value(int16 value);
+    void Value(int8 value);
+    void Value(float value);
+    void Value(bool value);
+    void NullValue();
+
+    void KeyAndBeginList(const char* pKey, bool isInline)  { Key(pKey); BeginList(isInline); }
+    void KeyAndBeginMap(const char* pKey, bool isInline)   { Key(pKey); BeginMap(isInline); }
+    void KeyAndValue(const char* pKey, const char* pValue) { Key(pKey); Value(pValue); }
+    void KeyAndValue(const char* pKey, uint64 value)       { Key(pKey); Value(value); }
+    void KeyAndValue(const char* pKey, uint32 value)       { Key(pKey); Value(value); }
+    void KeyAndValue(const char* pKey, uint16 value)       { Key(pKey); Value(value); }
+    void KeyAndValue(const char* pKey, uint8 value)        { Key(pKey); Value(value); }
+    void KeyAndValue(const char* pKey, int64 value)        { Key(pKey); Value(value); }
+    void KeyAndValue(const char* pKey, int32 value)        { Key(pKey); Value(value); }
+    void KeyAndValue(const char* pKey, int16 value)        { Key(pKey); Value(value); }
+    void KeyAndValue(const char* pKey, int8 value)         { Key(pKey); Value(value); }
+    void KeyAndValue(const char* pKey, float value)        { Key(pKey); Value(value); }
+    void KeyAndValue(const char* pKey, bool value)         { Key(pKey); Value(value); }
+    void KeyAndNullValue(const char* pKey)                 { Key(pKey); NullValue(); }
 
     // These functions begin and end a specially formatted map which represents a PAL interface function.
     void BeginFunc(const BeginFuncInfo& info, uint32 threadId);
@@ -691,9 +747,54 @@ public:
     static const char* GetEngineName(EngineType value);
 
 private:
+    // Until the log file is opened we don't know which format to write, so entries are packed as MessagePack and held
+    // by the context. They are converted to JSON text when a JSON log is opened.
+    enum class LogFormat : uint32
+    {
+        Pending,
+        Json,
+        MsgPack
+    };
+
+    // A MessagePack map or array that is still being written. Its item count is filled in once the container ends.
+    // Inline containers get a 16-bit count and all others a 32-bit count, so packed entries remember how they should
+    // be formatted if they're converted to JSON later.
+    struct PackScope
+    {
+        uint32 headerOffset; // Offset of the container's header in the pack buffer.
+        uint32 numItems;     // Number of values written to an array or keys written to a map.
+        bool   isMap;
+        bool   isInline;
+    };
+
+    static constexpr uint32 PackScopeStackSize = 32;
+
     void Object(InterfaceObject objectType, uint32 objectId);
 
-    LogStream m_stream;
+    void   PackBeginContainer(bool isMap, bool isInline);
+    void   PackEndContainer();
+    void   PackKey(const char* pKey);
+    void   PackValue(const char* pValue);
+    void   PackUnsigned(uint64 value);
+    void   PackSigned(int64 value);
+    void   PackFloat(float value);
+    void   PackBool(bool value);
+    void   PackNull();
+    void   PackString(const char* pString, uint32 length);
+    uint8* PackReserve(uint32 size);
+    void   PackBeginItem(bool isKey);
+    void   PackEndItem();
+
+    uint8* WritePackedAsJson(uint8* pItem, bool isKey);
+
+    Platform*const m_pPlatform;
+    LogFormat      m_format;
+    LogStream      m_stream;
+    uint8*         m_pPackBuffer;   // MessagePack data for the current top-level entry, or all entries while pending.
+    uint32         m_packSize;      // How many bytes of the pack buffer are in use.
+    uint32         m_packCapacity;  // The size of the pack buffer in bytes.
+    uint32         m_packDepth;     // How many containers are currently open.
+    PackScope      m_packScopes[PackScopeStackSize];
 
     PAL_DISALLOW_DEFAULT_CTOR(LogContext);
     PAL_DISALLOW_COPY_AND_ASSIGN(LogContext);
@@ -298,6 +298,126 @@ static constexpr FuncLoggingTableEntry FuncLoggingTable[] =
 static_assert(ArrayLen(FuncLoggingTable) == static_cast<size_t>(InterfaceFunc::Count),
               "The FuncLoggingTable must be updated.");
 
+// =====================================================================================================================
+LogEntryRing::LogEntryRing(
+    Platform* pPlatform)
+    :
+    m_pPlatform(pPlatform),
+    m_pBuffer(nullptr),
+    m_capacity(0),
+    m_writeOffset(0),
+    m_readOffset(0)
+{
+}
+
+// =====================================================================================================================
+LogEntryRing::~LogEntryRing()
+{
+    // Every entry should have been merged before the ring is destroyed.
+    PAL_ASSERT(m_writeOffset == m_readOffset);
+
+    PAL_SAFE_FREE(m_pBuffer, m_pPlatform);
+}
+
+// =====================================================================================================================
+Result LogEntryRing::Init(
+    uint32 capacity)
+{
+    PAL_ASSERT(IsPow2Aligned(capacity, sizeof(RecordHeader)));
+
+    Result result = Result::ErrorOutOfMemory;
+    m_pBuffer     = static_cast<uint8*>(PAL_MALLOC(capacity, m_pPlatform, AllocInternal));
+
+    if (m_pBuffer != nullptr)
+    {
+        m_capacity = capacity;
+        result     = Result::Success;
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+bool LogEntryRing::Push(
+    uint64      sequence,
+    const void* pEntry,
+    uint32      size)
+{
+    PAL_ASSERT(CanHold(size));
+
+    // Records can't wrap around the end of the ring so we may need to skip the space left at the end.
+    const uint32 recordSize  = RecordSize(size);
+    const uint64 writeOffset = AtomicReadRelaxed64(&m_writeOffset);
+    const uint32 tailSize    = m_capacity - static_cast<uint32>(writeOffset % m_capacity);
+    const uint32 skipSize    = (tailSize < recordSize) ? tailSize : 0;
+
+    // Adding zero reads the merging thread's offset behind a full barrier so we never overwrite a record it's reading.
+    const uint64 readOffset = AtomicAdd64(&m_readOffset, 0);
+    const bool   fits       = (writeOffset + skipSize + recordSize - readOffset) <= m_capacity;
+
+    if (fits)
+    {
+        if (skipSize > 0)
+        {
+            RecordHeader*const pSkip = HeaderAt(writeOffset);
+
+            pSkip->sequence   = 0;
+            pSkip->size       = WrapMarker;
+            pSkip->recordSize = skipSize;
+        }
+
+        RecordHeader*const pHeader = HeaderAt(writeOffset + skipSize);
+
+        pHeader->sequence   = sequence;
+        pHeader->size       = size;
+        pHeader->recordSize = recordSize;
+
+        memcpy(pHeader + 1, pEntry, size);
+
+        // Publish the new record behind a full barrier so the merging thread never sees a partially written record.
+        AtomicAdd64(&m_writeOffset, skipSize + recordSize);
+    }
+
+    return fits;
+}
+
+// =====================================================================================================================
+bool LogEntryRing::Front(
+    uint64* pSequence,
+    uint8** ppEntry,
+    uint32* pSize)
+{
+    // Adding zero reads the owning thread's offset behind a full barrier so we never read a partially written record.
+    const uint64  writeOffset = AtomicAdd64(&m_writeOffset, 0);
+    const uint64  readOffset  = AtomicReadRelaxed64(&m_readOffset);
+    RecordHeader* pHeader     = nullptr;
+
+    if (readOffset != writeOffset)
+    {
+        pHeader = HeaderAt(readOffset);
+
+        if (pHeader->size == WrapMarker)
+        {
+            // Skipped space is always published along with the record that follows it.
+            pHeader = HeaderAt(AtomicAdd64(&m_readOffset, pHeader->recordSize));
+        }
+
+        *pSequence = pHeader->sequence;
+        *ppEntry   = reinterpret_cast<uint8*>(pHeader + 1);
+        *pSize     = pHeader->size;
+    }
+
+    return (pHeader != nullptr);
+}
+
+// =====================================================================================================================
+void LogEntryRing::Pop()
+{
+    const uint64 readOffset = AtomicReadRelaxed64(&m_readOffset);
+
+    AtomicAdd64(&m_readOffset, HeaderAt(readOffset)->recordSize);
+}
+
 // =====================================================================================================================
 Platform::Platform(
     const PlatformCreateInfo    createInfo,
@@ -311,7 +431,9 @@ Platform::Platform(
     m_nextThreadId(0),
     m_objectId(0),
     m_activePreset(0),
-    m_threadDataVec(this)
+    m_threadDataVec(this),
+    m_nextSequence(0),
+    m_nextMergeSequence(0)
 {
 #if PAL_ENABLE_PRINTS_ASSERTS
     for (uint32 idx = 0; idx < static_cast<uint32>(InterfaceFunc::Count); ++idx)
@@ -350,11 +472,19 @@ Platform::~Platform()
         PAL_ASSERT(result == Result::Success);
     }
 
+    // Merge any calls the threads logged since the last present.
+    if (m_flags.mergeThreadLogs == 1)
+    {
+        MutexAuto lock(&m_platformMutex);
+        MergeThreadLogs();
+    }
+
     for (uint32 idx = 0; idx < m_threadDataVec.NumElements(); ++idx)
     {
         auto* pThreadData = m_threadDataVec.At(idx);
 
         PAL_SAFE_DELETE(pThreadData->pContext, this);
+        PAL_SAFE_DELETE(pThreadData->pRing, this);
         PAL_SAFE_DELETE(pThreadData, this);
     }
 
@@ -365,6 +495,7 @@ Platform::~Platform()
     // If someone manages to call a logging function after destruction this might protect us a bit.
     m_flags.threadKeyCreated  = 0;
     m_flags.multithreaded     = 0;
+    m_flags.mergeThreadLogs   = 0;
     m_flags.settingsCommitted = 0;
 }
 
@@ -485,10 +616,12 @@ Result Platform::CommitLoggingSettings()
         if (result == Result::Success)
         {
             // We can finally open the main log's file; this will flush out any data it already buffered.
+            const bool binary = settings.interfaceLoggerConfig.binaryOutput;
+
             char logFilePath[512];
-            Snprintf(logFilePath, sizeof(logFilePath), "%s/pal_calls.json", LogDirPath());
+            Snprintf(logFilePath, sizeof(logFilePath), "%s/pal_calls.%s", LogDirPath(), binary ? "msgpack" : "json");
 
-            result = m_pMainLog->OpenFile(logFilePath);
+            result = m_pMainLog->OpenFile(logFilePath, binary);
         }
 
         // If multithreaded logging is enabled, we need to go back over our previously allocated ThreadData and give
@@ -513,6 +646,17 @@ Result Platform::CommitLoggingSettings()
                 }
             }
         }
+        else if ((result == Result::Success) && settings.interfaceLoggerConfig.mergeThreadLogs)
+        {
+            // Give every previously allocated ThreadData its own context and ring before any thread can see the flag.
+            for (uint32 idx = 0; (idx < m_threadDataVec.NumElements()) && (result == Result::Success); ++idx)
+            {
+                result = CreateThreadMergeState(m_threadDataVec.At(idx));
+            }
+
+            // If this failed we return an error and fall back to single-threaded logging.
+            m_flags.mergeThreadLogs = (result == Result::Success);
+        }
 
         // If no errors have occured then the log directory is ready for logging.
         m_flags.settingsCommitted = (result == Result::Success);
@@ -531,6 +675,13 @@ void Platform::NotifyPresent()
     const uint32 nextPreset = IsKeyPressed(KeyCode::Shift_F11);
     const uint32 prevPreset = AtomicExchange(&m_activePreset, nextPreset);
 
+    if (m_flags.mergeThreadLogs == 1)
+    {
+        // Merge the calls logged since the last present into the main log.
+        MutexAuto lock(&m_platformMutex);
+        MergeThreadLogs();
+    }
+
     // If we've changed presets, we need to take the platform lock and write a notice to the main log file.
     if (prevPreset != nextPreset)
     {
@@ -615,6 +766,13 @@ bool Platform::LogBeginFunc(
             {
                 *ppContext = pThreadData->pContext;
             }
+            else if (m_flags.mergeThreadLogs == 1)
+            {
+                *ppContext = pThreadData->pContext;
+
+                // Claim this call's place in the merged log. AtomicIncrement64 returns the incremented value.
+                pThreadData->sequence = AtomicIncrement64(&m_nextSequence) - 1;
+            }
             else
             {
                 *ppContext = m_pMainLog;
@@ -636,11 +794,110 @@ void Platform::LogEndFunc(
 {
     pContext->EndFunc();
 
-    if (m_flags.multithreaded == 0)
+    if (pContext == m_pMainLog)
     {
         // In single-threaded mode, we hold the platform mutex while logging each function.
         m_platformMutex.Unlock();
     }
+    else if (m_flags.mergeThreadLogs == 1)
+    {
+        MergeThreadEntry(static_cast<ThreadData*>(GetThreadLocalValue(m_threadKey)));
+    }
+}
+
+// =====================================================================================================================
+// Moves the call that the current thread just finished logging from its context into its ring.
+void Platform::MergeThreadEntry(
+    ThreadData* pThreadData)
+{
+    LogContext*const   pContext = pThreadData->pContext;
+    LogEntryRing*const pRing    = pThreadData->pRing;
+    const uint32       size     = pContext->PackedSize();
+
+    if (pRing->CanHold(size))
+    {
+        bool pushed = pRing->Push(pThreadData->sequence, pContext->PackedData(), size);
+
+        // If our ring is full, merge what we can to make room. Every call older than the oldest call still being logged
+        // can be merged, so the thread logging that call can always make progress.
+        while (pushed == false)
+        {
+            {
+                MutexAuto lock(&m_platformMutex);
+                MergeThreadLogs();
+            }
+
+            pushed = pRing->Push(pThreadData->sequence, pContext->PackedData(), size);
+
+            if (pushed == false)
+            {
+                YieldThread();
+            }
+        }
+    }
+    else
+    {
+        // This call is too big for our ring so we wait for its turn and write it directly into the main log.
+        bool written = false;
+
+        while (written == false)
+        {
+            {
+                MutexAuto lock(&m_platformMutex);
+                MergeThreadLogs();
+
+                if (m_nextMergeSequence == pThreadData->sequence)
+                {
+                    m_pMainLog->WritePackedEntry(pContext->PackedData(), size);
+                    m_nextMergeSequence++;
+                    written = true;
+
+                    // Newer calls may have been waiting on this one.
+                    MergeThreadLogs();
+                }
+            }
+
+            if (written == false)
+            {
+                YieldThread();
+            }
+        }
+    }
+
+    pContext->ClearPacked();
+}
+
+// =====================================================================================================================
+// Writes every call that is next in sequence from the thread rings into the main log. Stops at the first call that is
+// still being logged. The platform mutex must be locked when this is called.
+void Platform::MergeThreadLogs()
+{
+    bool merged = true;
+
+    while (merged)
+    {
+        merged = false;
+
+        for (uint32 idx = 0; idx < m_threadDataVec.NumElements(); ++idx)
+        {
+            LogEntryRing*const pRing = m_threadDataVec.At(idx)->pRing;
+
+            uint64 sequence = 0;
+            uint8* pEntry   = nullptr;
+            uint32 size     = 0;
+
+            while (pRing->Front(&sequence, &pEntry, &size) && (sequence == m_nextMergeSequence))
+            {
+                m_pMainLog->WritePackedEntry(pEntry, size);
+                pRing->Pop();
+
+                m_nextMergeSequence++;
+                merged = true;
+            }
+        }
+    }
+
+    m_pMainLog->Flush();
 }
 
 // =====================================================================================================================
@@ -878,6 +1135,8 @@ Platform::ThreadData* Platform::CreateThreadData()
     {
         pThreadData->threadId = m_nextThreadId++;
         pThreadData->pContext = nullptr;
+        pThreadData->pRing    = nullptr;
+        pThreadData->sequence = 0;
 
         Result result = Result::Success;
 
@@ -891,6 +1150,10 @@ Platform::ThreadData* Platform::CreateThreadData()
                 result = Result::ErrorOutOfMemory;
             }
         }
+        else if (m_flags.mergeThreadLogs == 1)
+        {
+            result = CreateThreadMergeState(pThreadData);
+        }
 
         if (result == Result::Success)
         {
@@ -914,6 +1177,7 @@ Platform::ThreadData* Platform::CreateThreadData()
         if (result != Result::Success)
         {
             PAL_SAFE_DELETE(pThreadData->pContext, this);
+            PAL_SAFE_DELETE(pThreadData->pRing, this);
             PAL_SAFE_DELETE(pThreadData, this);
         }
     }
@@ -931,13 +1195,15 @@ LogContext* Platform::CreateThreadLogContext(
     if (pContext != nullptr)
     {
         // Create a file name and path for this log.
+        const bool binary = PlatformSettings().interfaceLoggerConfig.binaryOutput;
+
         char logFileName[64];
-        Snprintf(logFileName, sizeof(logFileName), "pal_calls_thread_%u.json", threadId);
+        Snprintf(logFileName, sizeof(logFileName), "pal_calls_thread_%u.%s", threadId, binary ? "msgpack" : "json");
 
         char logFilePath[512];
         Snprintf(logFilePath, sizeof(logFilePath), "%s/%s", LogDirPath(), logFileName);
 
-        const Result result = pContext->OpenFile(logFilePath);
+        const Result result = pContext->OpenFile(logFilePath, binary);
 
         if (result == Result::Success)
         {
@@ -956,6 +1222,34 @@ LogContext* Platform::CreateThreadLogContext(
     return pContext;
 }
 
+// =====================================================================================================================
+// Creates the context and ring a thread uses when merging thread logs. The platform mutex must be locked when this is
+// called.
+Result Platform::CreateThreadMergeState(
+    ThreadData* pThreadData)
+{
+    PAL_ASSERT((pThreadData->pContext == nullptr) && (pThreadData->pRing == nullptr));
+
+    // This context is never opened so it holds each call packed in memory until LogEndFunc moves it into the ring.
+    pThreadData->pContext = PAL_NEW(LogContext, this, AllocInternal)(this);
+    pThreadData->pRing    = PAL_NEW(LogEntryRing, this, AllocInternal)(this);
+
+    Result result = Result::ErrorOutOfMemory;
+
+    if ((pThreadData->pContext != nullptr) && (pThreadData->pRing != nullptr))
+    {
+        result = pThreadData->pRing->Init(ThreadRingSize);
+    }
+
+    if (result != Result::Success)
+    {
+        PAL_SAFE_DELETE(pThreadData->pContext, this);
+        PAL_SAFE_DELETE(pThreadData->pRing, this);
+    }
+
+    return result;
+}
+
 // =====================================================================================================================
 // Send turboSync control
 Result Platform::TurboSyncControl(
@@ -59,14 +59,68 @@ enum InterfaceLogFlags : uint32
 
 };
 
+// =====================================================================================================================
+// A single-producer, single-consumer ring of packed log entries, each tagged with its global sequence number. The
+// thread that owns the ring pushes its completed entries without taking any locks while the platform pops them under
+// its mutex to merge every thread's entries into the main log in sequence order.
+class LogEntryRing
+{
+public:
+    explicit LogEntryRing(Platform* pPlatform);
+    ~LogEntryRing();
+
+    Result Init(uint32 capacity);
+
+    // Returns true if an entry of the given size will fit in the ring once it's empty. A record may need to skip the
+    // space at the end of the ring, so records must fit in half of it.
+    bool CanHold(uint32 size) const { return RecordSize(size) <= (m_capacity / 2); }
+
+    // Called by the owning thread. Returns false if the ring doesn't have enough free space right now.
+    bool Push(uint64 sequence, const void* pEntry, uint32 size);
+
+    // Called by the merging thread. Returns false if the ring is empty, otherwise returns the oldest entry which stays
+    // in the ring until Pop is called. The byte after the entry is writable.
+    bool Front(uint64* pSequence, uint8** ppEntry, uint32* pSize);
+    void Pop();
+
+private:
+    // Each record is a header followed by the entry and at least one byte of padding. A record never wraps around the
+    // end of the ring; if it doesn't fit, the remaining space is skipped using a header with a size of WrapMarker.
+    struct RecordHeader
+    {
+        uint64 sequence;
+        uint32 size;       // Size of the entry in bytes.
+        uint32 recordSize; // Size of the whole record in bytes.
+    };
+
+    static constexpr uint32 WrapMarker = UINT32_MAX;
+
+    static uint32 RecordSize(uint32 size)
+        { return static_cast<uint32>(Util::Pow2Align(sizeof(RecordHeader) + size + 1, sizeof(RecordHeader))); }
+
+    RecordHeader* HeaderAt(uint64 offset) const
+        { return reinterpret_cast<RecordHeader*>(m_pBuffer + (offset % m_capacity)); }
+
+    Platform*const  m_pPlatform;
+    uint8*          m_pBuffer;
+    uint32          m_capacity;    // Size of the buffer in bytes, a multiple of the record header size.
+    volatile uint64 m_writeOffset; // Total bytes ever pushed, only modified by the owning thread.
+    volatile uint64 m_readOffset;  // Total bytes ever popped, only modified by the merging thread.
+
+    PAL_DISALLOW_DEFAULT_CTOR(LogEntryRing);
+    PAL_DISALLOW_COPY_AND_ASSIGN(LogEntryRing);
+};
+
 // =====================================================================================================================
 class Platform : public PlatformDecorator
 {
     // Some basic data we will track for each thread.
     struct ThreadData
     {
-        uint32      threadId;
-        LogContext* pContext;
+        uint32        threadId;
+        LogContext*   pContext;
+        LogEntryRing* pRing;    // Only used when merging thread logs.
+        uint64        sequence; // The sequence number of the call this thread is logging when merging thread logs.
     };
 
     // All ThreadData instances will be stored in a vector so we can delete them later.
@@ -137,6 +191,12 @@ protected:
 private:
     ThreadData* CreateThreadData();
     LogContext* CreateThreadLogContext(uint32 threadId);
+    Result      CreateThreadMergeState(ThreadData* pThreadData);
+    void        MergeThreadLogs();
+    void        MergeThreadEntry(ThreadData* pThreadData);
+
+    // Each thread's ring of unmerged entries is this large.
+    static constexpr uint32 ThreadRingSize = 1024 * 1024;
 
     union
     {
@@ -145,7 +205,8 @@ private:
             uint32 threadKeyCreated  :  1; // If m_threadKey was successfully created.
             uint32 multithreaded     :  1; // If multithreaded logging is enabled.
             uint32 settingsCommitted :  1; // If the platform has all of the settings needed to log to a file.
-            uint32 reserved          : 29;
+            uint32 mergeThreadLogs   :  1; // If each thread logs into its own ring which is merged into the main log.
+            uint32 reserved          : 28;
         };
         uint32     u32All;
     } m_flags;
@@ -162,6 +223,8 @@ private:
     uint32                   m_loggingPresets[2]; // Masks of logging levels that the user can select for logging.
     Util::ThreadLocalKey     m_threadKey;         // Used to look up thread specific data (e.g., thread logs).
     ThreadDataVector         m_threadDataVec;     // A list of all thread-local data so they can be deleted on exit.
+    volatile uint64          m_nextSequence;      // The sequence number of the next call logged when merging threads.
+    uint64                   m_nextMergeSequence; // The sequence number of the next call to merge into the main log.
 
     // Tracks the next ID to be issued for all objects.
     volatile uint32          m_nextObjectIds[static_cast<uint32>(InterfaceObject::Count)];
@@ -0,0 +1,275 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2014-2020 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+
+#include "core/pipelineBinaryStore.h"
+#include "core/platform.h"
+#include "palHashMapImpl.h"
+#include "palSysMemory.h"
+
+using namespace Util;
+
+namespace Pal
+{
+
+// Number of buckets in the hash map of stored binaries
+constexpr uint32 PipelineBinaryMapElements = 1024;
+
+// =====================================================================================================================
+ParsedPipelineBinary::ParsedPipelineBinary(
+    Platform*   pPlatform,
+    const void* pBinary)
+    :
+    m_abiReader(pPlatform, pBinary),
+    m_metadataReader()
+{
+    memset(&m_metadata, 0, sizeof(m_metadata));
+}
+
+// =====================================================================================================================
+// Builds the symbol index and decodes the metadata.  Nothing may change after this returns.
+Result ParsedPipelineBinary::Init()
+{
+    Result result = m_abiReader.Init();
+
+    if (result == Result::Success)
+    {
+        result = m_abiReader.GetMetadata(&m_metadataReader, &m_metadata);
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+PipelineBinaryStore::Entry::Entry(
+    Platform*   pPlatform,
+    const void* pData)
+    :
+    size(0),
+    refCount(1),
+    isShared(false),
+    parsed(pPlatform, pData)
+{
+}
+
+// =====================================================================================================================
+PipelineBinaryStore::PipelineBinaryStore(
+    Platform* pPlatform)
+    :
+    m_pPlatform(pPlatform),
+    m_lock(),
+    m_entries(PipelineBinaryMapElements, pPlatform)
+{
+}
+
+// =====================================================================================================================
+PipelineBinaryStore::~PipelineBinaryStore()
+{
+    // Every pipeline and shader library should have released its binary by now.
+    PAL_ALERT(m_entries.GetNumEntries() != 0);
+
+    for (auto iter = m_entries.Begin(); iter.Get() != nullptr; iter.Next())
+    {
+        DestroyEntry(iter.Get()->value);
+    }
+}
+
+// =====================================================================================================================
+Result PipelineBinaryStore::Init()
+{
+    Result result = m_lock.Init();
+
+    if (result == Result::Success)
+    {
+        result = m_entries.Init();
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Allocates a new, unshared entry holding a parsed copy of the given binary with a refcount of one.
+Result PipelineBinaryStore::CreateEntry(
+    const MetroHash::Hash& hash,
+    const void*            pBinary,
+    size_t                 binarySize,
+    Entry**                ppEntry)
+{
+    Result result = Result::ErrorOutOfMemory;
+    void*  pMem   = PAL_MALLOC(DataOffset + binarySize, m_pPlatform, AllocInternal);
+    Entry* pEntry = nullptr;
+
+    if (pMem != nullptr)
+    {
+        void*const pData = VoidPtrInc(pMem, DataOffset);
+        memcpy(pData, pBinary, binarySize);
+
+        pEntry       = PAL_PLACEMENT_NEW(pMem) Entry(m_pPlatform, pData);
+        pEntry->hash = hash;
+        pEntry->size = binarySize;
+
+        result = pEntry->parsed.Init();
+
+        if (result != Result::Success)
+        {
+            DestroyEntry(pEntry);
+            pEntry = nullptr;
+        }
+    }
+
+    *ppEntry = pEntry;
+
+    return result;
+}
+
+// =====================================================================================================================
+void PipelineBinaryStore::DestroyEntry(
+    Entry* pEntry)
+{
+    pEntry->~Entry();
+    PAL_FREE(pEntry, m_pPlatform);
+}
+
+// =====================================================================================================================
+// Looks for a stored copy of the given binary and takes a reference on it.  pFound reports whether any entry has this
+// hash, even if its contents turned out to differ.  The caller must hold m_lock.
+PipelineBinaryStore::Entry* PipelineBinaryStore::FindAndReference(
+    const MetroHash::Hash& hash,
+    const void*            pBinary,
+    size_t                 binarySize,
+    bool*                  pFound)
+{
+    Entry*        pEntry     = nullptr;
+    Entry**const  ppExisting = m_entries.FindKey(hash);
+
+    *pFound = (ppExisting != nullptr);
+
+    // A 128-bit hash collision is practically impossible, but sharing the wrong binary would be a silent miscompile,
+    // so confirm the contents before handing out the existing copy.
+    if ((ppExisting != nullptr) &&
+        ((*ppExisting)->size == binarySize) &&
+        (memcmp(GetData(*ppExisting), pBinary, binarySize) == 0))
+    {
+        pEntry = *ppExisting;
+        pEntry->refCount++;
+    }
+
+    return pEntry;
+}
+
+// =====================================================================================================================
+Result PipelineBinaryStore::Acquire(
+    const void*  pBinary,
+    size_t       binarySize,
+    const void** ppStoredBinary)
+{
+    PAL_ASSERT((pBinary != nullptr) && (binarySize != 0) && (ppStoredBinary != nullptr));
+
+    // Hash outside of the lock; this is the expensive part for large binaries.
+    MetroHash::Hash hash = {};
+    MetroHash128::Hash(static_cast<const uint8*>(pBinary), binarySize, hash.bytes);
+
+    Result result = Result::Success;
+    Entry* pEntry = nullptr;
+    bool   found  = false;
+
+    {
+        MutexAuto lock(&m_lock);
+        pEntry = FindAndReference(hash, pBinary, binarySize, &found);
+    }
+
+    if (pEntry == nullptr)
+    {
+        // Copy and parse the binary without holding the lock so other pipelines can be created in the meantime.
+        Entry* pNewEntry = nullptr;
+        result = CreateEntry(hash, pBinary, binarySize, &pNewEntry);
+
+        if (result == Result::Success)
+        {
+            MutexAuto lock(&m_lock);
+
+            // Another thread may have stored the same binary while we were parsing ours.
+            pEntry = FindAndReference(hash, pBinary, binarySize, &found);
+
+            if ((pEntry == nullptr) && (found == false))
+            {
+                result = m_entries.Insert(hash, pNewEntry);
+
+                if (result == Result::Success)
+                {
+                    pNewEntry->isShared = true;
+                    pEntry              = pNewEntry;
+                    pNewEntry           = nullptr;
+                }
+            }
+            else if (pEntry == nullptr)
+            {
+                // Hash collision with different contents; keep our copy private.
+                pEntry    = pNewEntry;
+                pNewEntry = nullptr;
+            }
+        }
+
+        // Our copy lost the race or could not be tracked.
+        if (pNewEntry != nullptr)
+        {
+            DestroyEntry(pNewEntry);
+        }
+    }
+
+    *ppStoredBinary = (result == Result::Success) ? GetData(pEntry) : nullptr;
+
+    return result;
+}
+
+// =====================================================================================================================
+// Drops one reference to a binary returned by Acquire(), freeing it once the last holder releases it.
+void PipelineBinaryStore::Release(
+    const void* pStoredBinary)
+{
+    if (pStoredBinary != nullptr)
+    {
+        Entry*const pEntry = GetEntry(pStoredBinary);
+        bool        isLast = false;
+
+        {
+            MutexAuto lock(&m_lock);
+
+            PAL_ASSERT(pEntry->refCount > 0);
+            isLast = (--pEntry->refCount == 0);
+
+            if (isLast && pEntry->isShared)
+            {
+                m_entries.Erase(pEntry->hash);
+            }
+        }
+
+        if (isLast)
+        {
+            DestroyEntry(pEntry);
+        }
+    }
+}
+
+} // Pal
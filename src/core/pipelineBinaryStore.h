@@ -0,0 +1,128 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2014-2020 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+
+#pragma once
+
+#include "pal.h"
+#include "palHashMap.h"
+#include "palInlineFuncs.h"
+#include "palMetroHash.h"
+#include "palMsgPack.h"
+#include "palMutex.h"
+#include "palPipelineAbiReader.h"
+
+namespace Pal
+{
+
+class Platform;
+
+// =====================================================================================================================
+// Parsed form of a stored binary: its symbol index and decoded metadata.  It is built once, when the binary first
+// enters the store, and is immutable afterwards, so every holder of the binary can read it concurrently.
+class ParsedPipelineBinary
+{
+public:
+    ParsedPipelineBinary(Platform* pPlatform, const void* pBinary);
+
+    Result Init();
+
+    const Util::Abi::PipelineAbiReader&     GetAbiReader() const { return m_abiReader; }
+    const Util::Abi::PalCodeObjectMetadata& GetMetadata() const { return m_metadata; }
+
+    // Returns a reader over the raw metadata blob.  Callers Seek() to the offsets recorded in GetMetadata() before
+    // reading from it.
+    Util::MsgPackReader GetMetadataReader() const { return m_metadataReader; }
+
+private:
+    Util::Abi::PipelineAbiReader     m_abiReader;
+    Util::Abi::PalCodeObjectMetadata m_metadata;
+    Util::MsgPackReader              m_metadataReader;
+
+    PAL_DISALLOW_DEFAULT_CTOR(ParsedPipelineBinary);
+    PAL_DISALLOW_COPY_AND_ASSIGN(ParsedPipelineBinary);
+};
+
+// =====================================================================================================================
+// Device-wide store of the ELF binaries that pipelines and shader libraries keep around for their lifetime.  Binaries
+// are keyed by a 128-bit hash of their contents, so objects created from identical binaries share one refcounted copy,
+// and one ParsedPipelineBinary, instead of each holding and re-parsing a private one.
+class PipelineBinaryStore
+{
+public:
+    explicit PipelineBinaryStore(Platform* pPlatform);
+    ~PipelineBinaryStore();
+
+    Result Init();
+
+    // Returns a store-owned copy of the given binary, shared with any other holder of identical data.  Every successful
+    // call must be balanced by a call to Release().  Fails if the binary is not a valid pipeline ELF.
+    Result Acquire(
+        const void*  pBinary,
+        size_t       binarySize,
+        const void** ppStoredBinary);
+
+    void Release(const void* pStoredBinary);
+
+    // Returns the parsed form of a binary returned by Acquire().
+    static const ParsedPipelineBinary& GetParsedBinary(const void* pStoredBinary)
+        { return GetEntry(pStoredBinary)->parsed; }
+
+private:
+    // Header placed in front of each stored binary
+    struct Entry
+    {
+        Entry(Platform* pPlatform, const void* pData);
+
+        Util::MetroHash::Hash hash;
+        size_t                size;
+        uint32                refCount;
+        bool                  isShared;   // False if a hash collision forced a private copy not tracked by m_entries
+        ParsedPipelineBinary  parsed;
+    };
+
+    // Offset of the binary data from the start of its entry
+    static constexpr size_t DataOffset = (sizeof(Entry) + 15) & ~size_t(15);
+
+    static Entry* GetEntry(const void* pStoredBinary)
+        { return static_cast<Entry*>(const_cast<void*>(Util::VoidPtrDec(pStoredBinary, DataOffset))); }
+
+    static void* GetData(Entry* pEntry) { return Util::VoidPtrInc(pEntry, DataOffset); }
+
+    Result CreateEntry(const Util::MetroHash::Hash& hash, const void* pBinary, size_t binarySize, Entry** ppEntry);
+    void   DestroyEntry(Entry* pEntry);
+
+    Entry* FindAndReference(const Util::MetroHash::Hash& hash, const void* pBinary, size_t binarySize, bool* pFound);
+
+    typedef Util::HashMap<Util::MetroHash::Hash, Entry*, Platform, Util::JenkinsHashFunc> EntryMap;
+
+    Platform*const m_pPlatform;
+    Util::Mutex    m_lock;      // Serializes all access to m_entries and the entries' refcounts
+    EntryMap       m_entries;
+
+    PAL_DISALLOW_DEFAULT_CTOR(PipelineBinaryStore);
+    PAL_DISALLOW_COPY_AND_ASSIGN(PipelineBinaryStore);
+};
+
+} // Pal
@@ -0,0 +1,451 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2020 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+
+#include "palBufferedFileWriter.h"
+#include "palInlineFuncs.h"
+
+namespace Util
+{
+
+// =====================================================================================================================
+BufferedFileWriter::BufferedFileWriter(
+    const IndirectAllocator& allocator,
+    uint32                   bufferSize,
+    uint32                   maxBuffers)
+    :
+    m_allocator(allocator),
+    m_bufferSize(bufferSize),
+    m_maxBuffers(maxBuffers),
+    m_pCurBuffer(nullptr),
+    m_pQueueHead(nullptr),
+    m_pQueueTail(nullptr),
+    m_pFreeBuffers(nullptr),
+    m_numBuffers(0),
+    m_writeResult(Result::Success),
+    m_writing(false),
+    m_stopWriteThread(false)
+{
+    PAL_ASSERT((bufferSize > 0) && (maxBuffers > 0));
+}
+
+// =====================================================================================================================
+BufferedFileWriter::~BufferedFileWriter()
+{
+    if (IsOpen())
+    {
+        const Result result = Close();
+        PAL_ASSERT(result == Result::Success);
+    }
+
+    // Anything still queued was added before the file was opened, or failed to write.
+    PAL_SAFE_FREE(m_pCurBuffer, &m_allocator);
+    FreeBufferList(m_pQueueHead);
+    FreeBufferList(m_pFreeBuffers);
+}
+
+// =====================================================================================================================
+Result BufferedFileWriter::Open(
+    const char* pFilename,
+    uint32      accessFlags,
+    bool        backgroundWrite)
+{
+    PAL_ASSERT(IsOpen() == false);
+
+    Result result = m_file.Open(pFilename, accessFlags);
+
+    if (result == Result::Success)
+    {
+        m_writeResult     = Result::Success;
+        m_stopWriteThread = false;
+
+        if (backgroundWrite)
+        {
+            result = m_bufferMutex.Init();
+
+            if (result == Result::Success)
+            {
+                result = m_bufferCondition.Init();
+            }
+
+            if (result == Result::Success)
+            {
+                // The write thread starts on anything that was queued before now.
+                result = m_writeThread.Begin(&WriteThreadCallback, this);
+            }
+        }
+        else
+        {
+            WriteQueuedBuffers();
+
+            result = m_writeResult;
+        }
+
+        if (result != Result::Success)
+        {
+            m_file.Close();
+        }
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+Result BufferedFileWriter::Close()
+{
+    Result result = Flush();
+
+    StopWriteThread();
+
+    m_file.Close();
+
+    // Anything still queued failed to write.
+    FreeBufferList(m_pQueueHead);
+    m_pQueueHead = nullptr;
+    m_pQueueTail = nullptr;
+
+    return result;
+}
+
+// =====================================================================================================================
+Result BufferedFileWriter::Write(
+    const void* pData,
+    size_t      size)
+{
+    Result result = Result::Success;
+
+    while (size > 0)
+    {
+        if (RemainingSpace() == 0)
+        {
+            NextBuffer();
+
+            if (m_pCurBuffer == nullptr)
+            {
+                // We're out of memory, the rest of the data is lost.
+                result = Result::ErrorOutOfMemory;
+                break;
+            }
+        }
+
+        const uint32 copySize = static_cast<uint32>(Min(size, size_t(RemainingSpace())));
+
+        memcpy(m_pCurBuffer->Data() + m_pCurBuffer->used, pData, copySize);
+        m_pCurBuffer->used += copySize;
+        pData               = VoidPtrInc(pData, copySize);
+        size               -= copySize;
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+void* BufferedFileWriter::Reserve(
+    uint32 size)
+{
+    PAL_ASSERT(size <= m_bufferSize);
+
+    if (RemainingSpace() < size)
+    {
+        NextBuffer();
+    }
+
+    void* pSpace = nullptr;
+
+    if (m_pCurBuffer != nullptr)
+    {
+        pSpace = m_pCurBuffer->Data() + m_pCurBuffer->used;
+
+        m_pCurBuffer->used += size;
+    }
+
+    return pSpace;
+}
+
+// =====================================================================================================================
+Result BufferedFileWriter::Flush()
+{
+    Result result = Result::Success;
+
+    if (IsOpen() == false)
+    {
+        result = Result::ErrorUnavailable;
+    }
+    else
+    {
+        if ((m_pCurBuffer != nullptr) && (m_pCurBuffer->used > 0))
+        {
+            QueueBuffer(m_pCurBuffer);
+            m_pCurBuffer = nullptr;
+        }
+
+        if (m_writeThread.IsCreated())
+        {
+            MutexAuto lock(&m_bufferMutex);
+
+            while ((m_pQueueHead != nullptr) || m_writing)
+            {
+                m_bufferCondition.Wait(&m_bufferMutex, UINT32_MAX);
+            }
+
+            result = m_writeResult;
+        }
+        else
+        {
+            WriteQueuedBuffers();
+
+            result = m_writeResult;
+        }
+
+        if (result == Result::Success)
+        {
+            result = m_file.Flush();
+        }
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Retires the current buffer, if any, and replaces it with an empty one. Once the file is open, retired buffers are
+// written out right away or handed off to the write thread.
+void BufferedFileWriter::NextBuffer()
+{
+    if (m_pCurBuffer != nullptr)
+    {
+        QueueBuffer(m_pCurBuffer);
+        m_pCurBuffer = nullptr;
+
+        if (IsOpen() && (m_writeThread.IsCreated() == false))
+        {
+            WriteQueuedBuffers();
+        }
+    }
+
+    m_pCurBuffer = AcquireBuffer();
+}
+
+// =====================================================================================================================
+// Returns an empty buffer, either reused or newly allocated. While the write thread is running, this waits for it to
+// finish with a buffer instead of allocating more than m_maxBuffers.
+BufferedFileWriter::Buffer* BufferedFileWriter::AcquireBuffer()
+{
+    const bool threaded = m_writeThread.IsCreated();
+
+    if (threaded)
+    {
+        m_bufferMutex.Lock();
+
+        while ((m_pFreeBuffers == nullptr) && (m_numBuffers >= m_maxBuffers))
+        {
+            m_bufferCondition.Wait(&m_bufferMutex, UINT32_MAX);
+        }
+    }
+
+    Buffer* pBuffer = m_pFreeBuffers;
+
+    if (pBuffer != nullptr)
+    {
+        m_pFreeBuffers = pBuffer->pNext;
+    }
+    else
+    {
+        pBuffer = static_cast<Buffer*>(PAL_MALLOC(sizeof(Buffer) + m_bufferSize, &m_allocator, AllocInternal));
+        PAL_ASSERT(pBuffer != nullptr);
+
+        if (pBuffer != nullptr)
+        {
+            ++m_numBuffers;
+        }
+    }
+
+    if (threaded)
+    {
+        m_bufferMutex.Unlock();
+    }
+
+    if (pBuffer != nullptr)
+    {
+        pBuffer->pNext = nullptr;
+        pBuffer->used  = 0;
+    }
+
+    return pBuffer;
+}
+
+// =====================================================================================================================
+// Returns a written buffer to the free list, or frees it if we already have enough buffers. The buffer mutex must be
+// held if the write thread is running.
+void BufferedFileWriter::ReleaseBuffer(
+    Buffer* pBuffer)
+{
+    if (m_numBuffers > m_maxBuffers)
+    {
+        // Data added before the file was opened can take any number of buffers, give back the extras.
+        PAL_FREE(pBuffer, &m_allocator);
+        --m_numBuffers;
+    }
+    else
+    {
+        pBuffer->pNext = m_pFreeBuffers;
+        m_pFreeBuffers = pBuffer;
+    }
+}
+
+// =====================================================================================================================
+// Adds a buffer to the end of the write queue.
+void BufferedFileWriter::QueueBuffer(
+    Buffer* pBuffer)
+{
+    pBuffer->pNext = nullptr;
+
+    if (m_writeThread.IsCreated())
+    {
+        m_bufferMutex.Lock();
+    }
+
+    if (m_pQueueTail != nullptr)
+    {
+        m_pQueueTail->pNext = pBuffer;
+    }
+    else
+    {
+        m_pQueueHead = pBuffer;
+    }
+
+    m_pQueueTail = pBuffer;
+
+    if (m_writeThread.IsCreated())
+    {
+        m_bufferCondition.WakeAll();
+        m_bufferMutex.Unlock();
+    }
+}
+
+// =====================================================================================================================
+// Writes every queued buffer to the file on the calling thread. Must not be called while the write thread runs.
+void BufferedFileWriter::WriteQueuedBuffers()
+{
+    while (m_pQueueHead != nullptr)
+    {
+        Buffer* const pBuffer = m_pQueueHead;
+
+        m_pQueueHead = pBuffer->pNext;
+
+        if (m_writeResult == Result::Success)
+        {
+            m_writeResult = m_file.Write(pBuffer->Data(), pBuffer->used);
+        }
+
+        ReleaseBuffer(pBuffer);
+    }
+
+    m_pQueueTail = nullptr;
+}
+
+// =====================================================================================================================
+void BufferedFileWriter::FreeBufferList(
+    Buffer* pList)
+{
+    while (pList != nullptr)
+    {
+        Buffer* const pNext = pList->pNext;
+        PAL_FREE(pList, &m_allocator);
+        pList = pNext;
+        --m_numBuffers;
+    }
+}
+
+// =====================================================================================================================
+void BufferedFileWriter::WriteThreadCallback(
+    void* pParameter)
+{
+    static_cast<BufferedFileWriter*>(pParameter)->RunWriteThread();
+}
+
+// =====================================================================================================================
+// Writes queued buffers in order until asked to stop. Only stops once the queue is empty.
+void BufferedFileWriter::RunWriteThread()
+{
+    m_bufferMutex.Lock();
+
+    while (true)
+    {
+        while ((m_pQueueHead == nullptr) && (m_stopWriteThread == false))
+        {
+            m_bufferCondition.Wait(&m_bufferMutex, UINT32_MAX);
+        }
+
+        if (m_pQueueHead == nullptr)
+        {
+            break;
+        }
+
+        Buffer* const pBuffer = m_pQueueHead;
+
+        m_pQueueHead = pBuffer->pNext;
+
+        if (m_pQueueHead == nullptr)
+        {
+            m_pQueueTail = nullptr;
+        }
+
+        m_writing = true;
+        m_bufferMutex.Unlock();
+
+        const Result result = m_file.Write(pBuffer->Data(), pBuffer->used);
+
+        m_bufferMutex.Lock();
+        m_writing = false;
+
+        if ((result != Result::Success) && (m_writeResult == Result::Success))
+        {
+            m_writeResult = result;
+        }
+
+        ReleaseBuffer(pBuffer);
+        m_bufferCondition.WakeAll();
+    }
+
+    m_bufferMutex.Unlock();
+}
+
+// =====================================================================================================================
+// Has the write thread write everything queued and exit.
+void BufferedFileWriter::StopWriteThread()
+{
+    if (m_writeThread.IsCreated())
+    {
+        {
+            MutexAuto lock(&m_bufferMutex);
+
+            m_stopWriteThread = true;
+            m_bufferCondition.WakeAll();
+        }
+
+        m_writeThread.Join();
+    }
+}
+
+} // Util
@@ -0,0 +1,783 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2014-2020 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+/**
+***********************************************************************************************************************
+* @file  builtinHashProvider.cpp
+* @brief PAL utility implementation of the built-in SHA-1 and SHA-256 hash contexts.
+***********************************************************************************************************************
+*/
+
+#include "util/builtinHashProvider.h"
+
+#include "palAssert.h"
+#include "palInlineFuncs.h"
+#include "palSysMemory.h"
+#include "palSysUtil.h"
+
+#include <string.h>
+
+// The SHA extensions are used through intrinsics, so they are only available when the compiler lets us build
+// individual functions for them.
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && defined(__unix__)
+#define PAL_BUILTIN_HASH_SHA_NI 1
+#include <immintrin.h>
+#else
+#define PAL_BUILTIN_HASH_SHA_NI 0
+#endif
+
+namespace Util
+{
+
+static constexpr uint32 Sha1InitialState[] =
+{
+    0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0
+};
+
+static constexpr uint32 Sha256InitialState[] =
+{
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+alignas(16) static constexpr uint32 Sha256K[] =
+{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+// =====================================================================================================================
+static PAL_FORCE_INLINE uint32 RotateLeft(
+    uint32 value,
+    uint32 shift)
+{
+    return (value << shift) | (value >> (32 - shift));
+}
+
+// =====================================================================================================================
+static PAL_FORCE_INLINE uint32 RotateRight(
+    uint32 value,
+    uint32 shift)
+{
+    return (value >> shift) | (value << (32 - shift));
+}
+
+// =====================================================================================================================
+static PAL_FORCE_INLINE uint32 LoadBigEndian32(
+    const uint8* pData)
+{
+    return (uint32(pData[0]) << 24) | (uint32(pData[1]) << 16) | (uint32(pData[2]) << 8) | uint32(pData[3]);
+}
+
+// =====================================================================================================================
+static PAL_FORCE_INLINE void StoreBigEndian32(
+    uint32 value,
+    uint8* pData)
+{
+    pData[0] = uint8(value >> 24);
+    pData[1] = uint8(value >> 16);
+    pData[2] = uint8(value >> 8);
+    pData[3] = uint8(value);
+}
+
+// =====================================================================================================================
+// Portable SHA-1 compression function (FIPS 180-4, section 6.1.2)
+static void Sha1ProcessBlocks(
+    uint32*      pState,
+    const uint8* pData,
+    size_t       numBlocks)
+{
+    for (; numBlocks > 0; numBlocks--, pData += BuiltinHashContext::BlockSize)
+    {
+        uint32 w[80];
+
+        for (uint32 i = 0; i < 16; i++)
+        {
+            w[i] = LoadBigEndian32(pData + (i * 4));
+        }
+
+        for (uint32 i = 16; i < 80; i++)
+        {
+            w[i] = RotateLeft(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+        }
+
+        uint32 a = pState[0];
+        uint32 b = pState[1];
+        uint32 c = pState[2];
+        uint32 d = pState[3];
+        uint32 e = pState[4];
+
+        for (uint32 i = 0; i < 80; i++)
+        {
+            uint32 f;
+            uint32 k;
+
+            if (i < 20)
+            {
+                f = d ^ (b & (c ^ d));
+                k = 0x5a827999;
+            }
+            else if (i < 40)
+            {
+                f = b ^ c ^ d;
+                k = 0x6ed9eba1;
+            }
+            else if (i < 60)
+            {
+                f = (b & c) | (d & (b | c));
+                k = 0x8f1bbcdc;
+            }
+            else
+            {
+                f = b ^ c ^ d;
+                k = 0xca62c1d6;
+            }
+
+            const uint32 temp = RotateLeft(a, 5) + f + e + k + w[i];
+
+            e = d;
+            d = c;
+            c = RotateLeft(b, 30);
+            b = a;
+            a = temp;
+        }
+
+        pState[0] += a;
+        pState[1] += b;
+        pState[2] += c;
+        pState[3] += d;
+        pState[4] += e;
+    }
+}
+
+// =====================================================================================================================
+// Portable SHA-256 compression function (FIPS 180-4, section 6.2.2)
+static void Sha256ProcessBlocks(
+    uint32*      pState,
+    const uint8* pData,
+    size_t       numBlocks)
+{
+    for (; numBlocks > 0; numBlocks--, pData += BuiltinHashContext::BlockSize)
+    {
+        uint32 w[64];
+
+        for (uint32 i = 0; i < 16; i++)
+        {
+            w[i] = LoadBigEndian32(pData + (i * 4));
+        }
+
+        for (uint32 i = 16; i < 64; i++)
+        {
+            const uint32 s0 = RotateRight(w[i - 15], 7) ^ RotateRight(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            const uint32 s1 = RotateRight(w[i - 2], 17) ^ RotateRight(w[i - 2], 19) ^ (w[i - 2] >> 10);
+
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        uint32 a = pState[0];
+        uint32 b = pState[1];
+        uint32 c = pState[2];
+        uint32 d = pState[3];
+        uint32 e = pState[4];
+        uint32 f = pState[5];
+        uint32 g = pState[6];
+        uint32 h = pState[7];
+
+        for (uint32 i = 0; i < 64; i++)
+        {
+            const uint32 s1    = RotateRight(e, 6) ^ RotateRight(e, 11) ^ RotateRight(e, 25);
+            const uint32 ch    = g ^ (e & (f ^ g));
+            const uint32 temp1 = h + s1 + ch + Sha256K[i] + w[i];
+            const uint32 s0    = RotateRight(a, 2) ^ RotateRight(a, 13) ^ RotateRight(a, 22);
+            const uint32 maj   = (a & b) | (c & (a | b));
+            const uint32 temp2 = s0 + maj;
+
+            h = g;
+            g = f;
+            f = e;
+            e = d + temp1;
+            d = c;
+            c = b;
+            b = a;
+            a = temp1 + temp2;
+        }
+
+        pState[0] += a;
+        pState[1] += b;
+        pState[2] += c;
+        pState[3] += d;
+        pState[4] += e;
+        pState[5] += f;
+        pState[6] += g;
+        pState[7] += h;
+    }
+}
+
+#if PAL_BUILTIN_HASH_SHA_NI
+#define PAL_SHA_NI_TARGET __attribute__((target("sha,sse4.1,ssse3")))
+
+// Four SHA-1 rounds: eCur supplies E for these rounds and eNext captures the E for the next four.
+#define SHA1_ROUNDS4(eCur, eNext, msg, func)  \
+    eCur = _mm_sha1nexte_epu32(eCur, msg);    \
+    eNext = abcd;                             \
+    abcd = _mm_sha1rnds4_epu32(abcd, eCur, func)
+
+// =====================================================================================================================
+// SHA-1 compression function using the x86 SHA extensions
+static PAL_SHA_NI_TARGET void Sha1ProcessBlocksShaNi(
+    uint32*      pState,
+    const uint8* pData,
+    size_t       numBlocks)
+{
+    const __m128i byteSwapMask = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+
+    __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pState)), 0x1b);
+    __m128i e0   = _mm_set_epi32(static_cast<int>(pState[4]), 0, 0, 0);
+    __m128i e1;
+
+    for (; numBlocks > 0; numBlocks--, pData += BuiltinHashContext::BlockSize)
+    {
+        const __m128i abcdSave = abcd;
+        const __m128i e0Save   = e0;
+
+        const __m128i* pMsg = reinterpret_cast<const __m128i*>(pData);
+        __m128i msg0 = _mm_shuffle_epi8(_mm_loadu_si128(pMsg + 0), byteSwapMask);
+        __m128i msg1 = _mm_shuffle_epi8(_mm_loadu_si128(pMsg + 1), byteSwapMask);
+        __m128i msg2 = _mm_shuffle_epi8(_mm_loadu_si128(pMsg + 2), byteSwapMask);
+        __m128i msg3 = _mm_shuffle_epi8(_mm_loadu_si128(pMsg + 3), byteSwapMask);
+
+        // Rounds 0-3
+        e0   = _mm_add_epi32(e0, msg0);
+        e1   = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+
+        // Rounds 4-7
+        SHA1_ROUNDS4(e1, e0, msg1, 0);
+        msg0 = _mm_sha1msg1_epu32(msg0, msg1);
+
+        // Rounds 8-11
+        SHA1_ROUNDS4(e0, e1, msg2, 0);
+        msg1 = _mm_sha1msg1_epu32(msg1, msg2);
+        msg0 = _mm_xor_si128(msg0, msg2);
+
+        // Rounds 12-15
+        SHA1_ROUNDS4(e1, e0, msg3, 0);
+        msg0 = _mm_sha1msg2_epu32(msg0, msg3);
+        msg2 = _mm_sha1msg1_epu32(msg2, msg3);
+        msg1 = _mm_xor_si128(msg1, msg3);
+
+        // Rounds 16-19
+        SHA1_ROUNDS4(e0, e1, msg0, 0);
+        msg1 = _mm_sha1msg2_epu32(msg1, msg0);
+        msg3 = _mm_sha1msg1_epu32(msg3, msg0);
+        msg2 = _mm_xor_si128(msg2, msg0);
+
+        // Rounds 20-23
+        SHA1_ROUNDS4(e1, e0, msg1, 1);
+        msg2 = _mm_sha1msg2_epu32(msg2, msg1);
+        msg0 = _mm_sha1msg1_epu32(msg0, msg1);
+        msg3 = _mm_xor_si128(msg3, msg1);
+
+        // Rounds 24-27
+        SHA1_ROUNDS4(e0, e1, msg2, 1);
+        msg3 = _mm_sha1msg2_epu32(msg3, msg2);
+        msg1 = _mm_sha1msg1_epu32(msg1, msg2);
+        msg0 = _mm_xor_si128(msg0, msg2);
+
+        // Rounds 28-31
+        SHA1_ROUNDS4(e1, e0, msg3, 1);
+        msg0 = _mm_sha1msg2_epu32(msg0, msg3);
+        msg2 = _mm_sha1msg1_epu32(msg2, msg3);
+        msg1 = _mm_xor_si128(msg1, msg3);
+
+        // Rounds 32-35
+        SHA1_ROUNDS4(e0, e1, msg0, 1);
+        msg1 = _mm_sha1msg2_epu32(msg1, msg0);
+        msg3 = _mm_sha1msg1_epu32(msg3, msg0);
+        msg2 = _mm_xor_si128(msg2, msg0);
+
+        // Rounds 36-39
+        SHA1_ROUNDS4(e1, e0, msg1, 1);
+        msg2 = _mm_sha1msg2_epu32(msg2, msg1);
+        msg0 = _mm_sha1msg1_epu32(msg0, msg1);
+        msg3 = _mm_xor_si128(msg3, msg1);
+
+        // Rounds 40-43
+        SHA1_ROUNDS4(e0, e1, msg2, 2);
+        msg3 = _mm_sha1msg2_epu32(msg3, msg2);
+        msg1 = _mm_sha1msg1_epu32(msg1, msg2);
+        msg0 = _mm_xor_si128(msg0, msg2);
+
+        // Rounds 44-47
+        SHA1_ROUNDS4(e1, e0, msg3, 2);
+        msg0 = _mm_sha1msg2_epu32(msg0, msg3);
+        msg2 = _mm_sha1msg1_epu32(msg2, msg3);
+        msg1 = _mm_xor_si128(msg1, msg3);
+
+        // Rounds 48-51
+        SHA1_ROUNDS4(e0, e1, msg0, 2);
+        msg1 = _mm_sha1msg2_epu32(msg1, msg0);
+        msg3 = _mm_sha1msg1_epu32(msg3, msg0);
+        msg2 = _mm_xor_si128(msg2, msg0);
+
+        // Rounds 52-55
+        SHA1_ROUNDS4(e1, e0, msg1, 2);
+        msg2 = _mm_sha1msg2_epu32(msg2, msg1);
+        msg0 = _mm_sha1msg1_epu32(msg0, msg1);
+        msg3 = _mm_xor_si128(msg3, msg1);
+
+        // Rounds 56-59
+        SHA1_ROUNDS4(e0, e1, msg2, 2);
+        msg3 = _mm_sha1msg2_epu32(msg3, msg2);
+        msg1 = _mm_sha1msg1_epu32(msg1, msg2);
+        msg0 = _mm_xor_si128(msg0, msg2);
+
+        // Rounds 60-63
+        SHA1_ROUNDS4(e1, e0, msg3, 3);
+        msg0 = _mm_sha1msg2_epu32(msg0, msg3);
+        msg2 = _mm_sha1msg1_epu32(msg2, msg3);
+        msg1 = _mm_xor_si128(msg1, msg3);
+
+        // Rounds 64-67
+        SHA1_ROUNDS4(e0, e1, msg0, 3);
+        msg1 = _mm_sha1msg2_epu32(msg1, msg0);
+        msg3 = _mm_sha1msg1_epu32(msg3, msg0);
+        msg2 = _mm_xor_si128(msg2, msg0);
+
+        // Rounds 68-71
+        SHA1_ROUNDS4(e1, e0, msg1, 3);
+        msg2 = _mm_sha1msg2_epu32(msg2, msg1);
+        msg3 = _mm_xor_si128(msg3, msg1);
+
+        // Rounds 72-75
+        SHA1_ROUNDS4(e0, e1, msg2, 3);
+        msg3 = _mm_sha1msg2_epu32(msg3, msg2);
+
+        // Rounds 76-79
+        SHA1_ROUNDS4(e1, e0, msg3, 3);
+
+        e0   = _mm_sha1nexte_epu32(e0, e0Save);
+        abcd = _mm_add_epi32(abcd, abcdSave);
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(pState), _mm_shuffle_epi32(abcd, 0x1b));
+    pState[4] = static_cast<uint32>(_mm_extract_epi32(e0, 3));
+}
+
+// Four SHA-256 rounds using message words msg and round constants Sha256K[4 * group] onwards
+#define SHA256_ROUNDS4(msg, group)                                                                             \
+    temp   = _mm_add_epi32(msg, _mm_load_si128(reinterpret_cast<const __m128i*>(&Sha256K[4 * (group)])));      \
+    state1 = _mm_sha256rnds2_epu32(state1, state0, temp);                                                     \
+    state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(temp, 0x0e))
+
+// =====================================================================================================================
+// SHA-256 compression function using the x86 SHA extensions
+static PAL_SHA_NI_TARGET void Sha256ProcessBlocksShaNi(
+    uint32*      pState,
+    const uint8* pData,
+    size_t       numBlocks)
+{
+    const __m128i byteSwapMask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    // The round instructions want the state as ABEF and CDGH
+    __m128i temp   = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&pState[0])), 0xb1);
+    __m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&pState[4])), 0x1b);
+    __m128i state0 = _mm_alignr_epi8(temp, state1, 8);
+    state1         = _mm_blend_epi16(state1, temp, 0xf0);
+
+    for (; numBlocks > 0; numBlocks--, pData += BuiltinHashContext::BlockSize)
+    {
+        const __m128i abefSave = state0;
+        const __m128i cdghSave = state1;
+
+        const __m128i* pMsg = reinterpret_cast<const __m128i*>(pData);
+        __m128i msg0 = _mm_shuffle_epi8(_mm_loadu_si128(pMsg + 0), byteSwapMask);
+        __m128i msg1 = _mm_shuffle_epi8(_mm_loadu_si128(pMsg + 1), byteSwapMask);
+        __m128i msg2 = _mm_shuffle_epi8(_mm_loadu_si128(pMsg + 2), byteSwapMask);
+        __m128i msg3 = _mm_shuffle_epi8(_mm_loadu_si128(pMsg + 3), byteSwapMask);
+
+        // Rounds 0-3
+        SHA256_ROUNDS4(msg0, 0);
+
+        // Rounds 4-7
+        SHA256_ROUNDS4(msg1, 1);
+        msg0 = _mm_sha256msg1_epu32(msg0, msg1);
+
+        // Rounds 8-11
+        SHA256_ROUNDS4(msg2, 2);
+        msg1 = _mm_sha256msg1_epu32(msg1, msg2);
+
+        // Rounds 12-15
+        SHA256_ROUNDS4(msg3, 3);
+        msg0 = _mm_sha256msg2_epu32(_mm_add_epi32(msg0, _mm_alignr_epi8(msg3, msg2, 4)), msg3);
+        msg2 = _mm_sha256msg1_epu32(msg2, msg3);
+
+        // Rounds 16-19
+        SHA256_ROUNDS4(msg0, 4);
+        msg1 = _mm_sha256msg2_epu32(_mm_add_epi32(msg1, _mm_alignr_epi8(msg0, msg3, 4)), msg0);
+        msg3 = _mm_sha256msg1_epu32(msg3, msg0);
+
+        // Rounds 20-23
+        SHA256_ROUNDS4(msg1, 5);
+        msg2 = _mm_sha256msg2_epu32(_mm_add_epi32(msg2, _mm_alignr_epi8(msg1, msg0, 4)), msg1);
+        msg0 = _mm_sha256msg1_epu32(msg0, msg1);
+
+        // Rounds 24-27
+        SHA256_ROUNDS4(msg2, 6);
+        msg3 = _mm_sha256msg2_epu32(_mm_add_epi32(msg3, _mm_alignr_epi8(msg2, msg1, 4)), msg2);
+        msg1 = _mm_sha256msg1_epu32(msg1, msg2);
+
+        // Rounds 28-31
+        SHA256_ROUNDS4(msg3, 7);
+        msg0 = _mm_sha256msg2_epu32(_mm_add_epi32(msg0, _mm_alignr_epi8(msg3, msg2, 4)), msg3);
+        msg2 = _mm_sha256msg1_epu32(msg2, msg3);
+
+        // Rounds 32-35
+        SHA256_ROUNDS4(msg0, 8);
+        msg1 = _mm_sha256msg2_epu32(_mm_add_epi32(msg1, _mm_alignr_epi8(msg0, msg3, 4)), msg0);
+        msg3 = _mm_sha256msg1_epu32(msg3, msg0);
+
+        // Rounds 36-39
+        SHA256_ROUNDS4(msg1, 9);
+        msg2 = _mm_sha256msg2_epu32(_mm_add_epi32(msg2, _mm_alignr_epi8(msg1, msg0, 4)), msg1);
+        msg0 = _mm_sha256msg1_epu32(msg0, msg1);
+
+        // Rounds 40-43
+        SHA256_ROUNDS4(msg2, 10);
+        msg3 = _mm_sha256msg2_epu32(_mm_add_epi32(msg3, _mm_alignr_epi8(msg2, msg1, 4)), msg2);
+        msg1 = _mm_sha256msg1_epu32(msg1, msg2);
+
+        // Rounds 44-47
+        SHA256_ROUNDS4(msg3, 11);
+        msg0 = _mm_sha256msg2_epu32(_mm_add_epi32(msg0, _mm_alignr_epi8(msg3, msg2, 4)), msg3);
+        msg2 = _mm_sha256msg1_epu32(msg2, msg3);
+
+        // Rounds 48-51
+        SHA256_ROUNDS4(msg0, 12);
+        msg1 = _mm_sha256msg2_epu32(_mm_add_epi32(msg1, _mm_alignr_epi8(msg0, msg3, 4)), msg0);
+        msg3 = _mm_sha256msg1_epu32(msg3, msg0);
+
+        // Rounds 52-55
+        SHA256_ROUNDS4(msg1, 13);
+        msg2 = _mm_sha256msg2_epu32(_mm_add_epi32(msg2, _mm_alignr_epi8(msg1, msg0, 4)), msg1);
+
+        // Rounds 56-59
+        SHA256_ROUNDS4(msg2, 14);
+        msg3 = _mm_sha256msg2_epu32(_mm_add_epi32(msg3, _mm_alignr_epi8(msg2, msg1, 4)), msg2);
+
+        // Rounds 60-63
+        SHA256_ROUNDS4(msg3, 15);
+
+        state0 = _mm_add_epi32(state0, abefSave);
+        state1 = _mm_add_epi32(state1, cdghSave);
+    }
+
+    // Convert ABEF and CDGH back into ABCD and EFGH
+    temp   = _mm_shuffle_epi32(state0, 0x1b);
+    state1 = _mm_shuffle_epi32(state1, 0xb1);
+    state0 = _mm_blend_epi16(temp, state1, 0xf0);
+    state1 = _mm_alignr_epi8(state1, temp, 8);
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&pState[0]), state0);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&pState[4]), state1);
+}
+
+#undef SHA1_ROUNDS4
+#undef SHA256_ROUNDS4
+#undef PAL_SHA_NI_TARGET
+
+// =====================================================================================================================
+// Returns true if the CPU supports the SHA extensions and the SSE levels the SHA paths use alongside them
+static bool CpuSupportsShaNi()
+{
+    uint32 regValues[4] = {};
+    CpuId(regValues, 0);
+
+    bool supported = false;
+
+    if (regValues[0] >= 7)
+    {
+        uint32 features[4] = {};
+        CpuId(features, 1);
+
+        const bool hasSsse3  = TestAnyFlagSet(features[2], 1u << 9);
+        const bool hasSse41  = TestAnyFlagSet(features[2], 1u << 19);
+
+        CpuId(regValues, 7, 0);
+
+        supported = hasSsse3 && hasSse41 && TestAnyFlagSet(regValues[1], 1u << 29);
+    }
+
+    return supported;
+}
+#endif
+
+// =====================================================================================================================
+// Picks the fastest block processing function the CPU supports for an algorithm
+BuiltinHashContext::ProcessBlocksFunc BuiltinHashContext::SelectProcessBlocksFunc(
+    HashAlgorithm algorithm)
+{
+    const bool        isSha1           = (algorithm == HashAlgorithm::BuiltinSha1);
+    ProcessBlocksFunc pfnProcessBlocks = isSha1 ? &Sha1ProcessBlocks : &Sha256ProcessBlocks;
+
+#if PAL_BUILTIN_HASH_SHA_NI
+    static const bool UseShaNi = CpuSupportsShaNi();
+
+    if (UseShaNi)
+    {
+        pfnProcessBlocks = isSha1 ? &Sha1ProcessBlocksShaNi : &Sha256ProcessBlocksShaNi;
+    }
+#endif
+
+    return pfnProcessBlocks;
+}
+
+// =====================================================================================================================
+BuiltinHashContext::BuiltinHashContext(
+    HashAlgorithm algorithm)
+    :
+    m_algorithm        { algorithm },
+    m_pfnProcessBlocks { SelectProcessBlocksFunc(algorithm) },
+    m_totalSize        { 0 },
+    m_bufferedSize     { 0 }
+{
+    PAL_ASSERT(IsSupported(algorithm));
+
+    Reset();
+}
+
+// =====================================================================================================================
+// Append data to the end of the hash state
+Result BuiltinHashContext::AddData(
+    const void* pData,
+    size_t      dataSize)
+{
+    Result result = Result::Success;
+
+    if ((pData == nullptr) && (dataSize > 0))
+    {
+        result = Result::ErrorInvalidPointer;
+    }
+    else
+    {
+        const uint8* pBytes = static_cast<const uint8*>(pData);
+
+        m_totalSize += dataSize;
+
+        // Top up a partially filled block first
+        if (m_bufferedSize > 0)
+        {
+            const size_t copySize = Min(dataSize, BlockSize - m_bufferedSize);
+
+            memcpy(&m_buffer[m_bufferedSize], pBytes, copySize);
+            m_bufferedSize += static_cast<uint32>(copySize);
+            pBytes         += copySize;
+            dataSize       -= copySize;
+
+            if (m_bufferedSize == BlockSize)
+            {
+                m_pfnProcessBlocks(m_state, m_buffer, 1);
+                m_bufferedSize = 0;
+            }
+        }
+
+        // Hash whole blocks straight out of the caller's memory
+        const size_t numBlocks = dataSize / BlockSize;
+
+        if (numBlocks > 0)
+        {
+            m_pfnProcessBlocks(m_state, pBytes, numBlocks);
+            pBytes   += numBlocks * BlockSize;
+            dataSize -= numBlocks * BlockSize;
+        }
+
+        if (dataSize > 0)
+        {
+            memcpy(m_buffer, pBytes, dataSize);
+            m_bufferedSize = static_cast<uint32>(dataSize);
+        }
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Pad the message and copy the resulting digest to the buffer provided
+Result BuiltinHashContext::Finish(
+    void* pOutput)
+{
+    Result result = Result::Success;
+
+    if (pOutput == nullptr)
+    {
+        result = Result::ErrorInvalidPointer;
+    }
+    else
+    {
+        constexpr size_t LengthOffset = BlockSize - sizeof(uint64);
+
+        const uint64 totalBits = m_totalSize * 8;
+
+        m_buffer[m_bufferedSize++] = 0x80;
+
+        if (m_bufferedSize > LengthOffset)
+        {
+            memset(&m_buffer[m_bufferedSize], 0, BlockSize - m_bufferedSize);
+            m_pfnProcessBlocks(m_state, m_buffer, 1);
+            m_bufferedSize = 0;
+        }
+
+        memset(&m_buffer[m_bufferedSize], 0, LengthOffset - m_bufferedSize);
+        StoreBigEndian32(static_cast<uint32>(totalBits >> 32), &m_buffer[LengthOffset]);
+        StoreBigEndian32(static_cast<uint32>(totalBits), &m_buffer[LengthOffset + 4]);
+        m_pfnProcessBlocks(m_state, m_buffer, 1);
+
+        const uint32 outputSize = static_cast<uint32>(GetOutputBufferSize());
+        uint8*       pDigest    = static_cast<uint8*>(pOutput);
+
+        for (uint32 i = 0; i < (outputSize / sizeof(uint32)); i++)
+        {
+            StoreBigEndian32(m_state[i], pDigest + (i * sizeof(uint32)));
+        }
+
+        // Leave the context ready for a new message rather than in a half-finished state
+        Reset();
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Re-initialize context state for reuse
+Result BuiltinHashContext::Reset()
+{
+    if (m_algorithm == HashAlgorithm::BuiltinSha1)
+    {
+        memcpy(m_state, Sha1InitialState, sizeof(Sha1InitialState));
+    }
+    else
+    {
+        memcpy(m_state, Sha256InitialState, sizeof(Sha256InitialState));
+    }
+
+    m_totalSize    = 0;
+    m_bufferedSize = 0;
+
+    return Result::Success;
+}
+
+// =====================================================================================================================
+// Clone the current hashing state to a new object
+Result BuiltinHashContext::Duplicate(
+    void*           pPlacementAddr,
+    IHashContext**  ppDuplicatedObject
+    ) const
+{
+    Result result = Result::Success;
+
+    if ((pPlacementAddr != nullptr) &&
+        (ppDuplicatedObject != nullptr))
+    {
+        BuiltinHashContext* pDuplicate = PAL_PLACEMENT_NEW(pPlacementAddr) BuiltinHashContext(m_algorithm);
+
+        pDuplicate->m_totalSize    = m_totalSize;
+        pDuplicate->m_bufferedSize = m_bufferedSize;
+        memcpy(pDuplicate->m_state, m_state, sizeof(m_state));
+        memcpy(pDuplicate->m_buffer, m_buffer, m_bufferedSize);
+
+        *ppDuplicatedObject = pDuplicate;
+    }
+    else
+    {
+        PAL_ALERT(pPlacementAddr == nullptr);
+        PAL_ALERT(ppDuplicatedObject == nullptr);
+
+        result = Result::ErrorInvalidPointer;
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Return information about the hash context memory sizes
+Result GetBuiltinHashContextInfo(
+    HashAlgorithm    algorithm,
+    HashContextInfo* pInfo)
+{
+    Result result = Result::Success;
+
+    if (pInfo == nullptr)
+    {
+        result = Result::ErrorInvalidPointer;
+    }
+    else if (BuiltinHashContext::IsSupported(algorithm) == false)
+    {
+        result = Result::ErrorInvalidValue;
+    }
+    else
+    {
+        pInfo->contextObjectSize      = sizeof(BuiltinHashContext);
+        pInfo->contextObjectAlignment = alignof(BuiltinHashContext);
+        pInfo->outputBufferSize       = BuiltinHashContext::GetOutputSize(algorithm);
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Create a built-in hashing context
+Result CreateBuiltinHashContext(
+    HashAlgorithm   algorithm,
+    void*           pPlacementAddr,
+    IHashContext**  ppHashContext)
+{
+    PAL_ASSERT(pPlacementAddr != nullptr);
+    PAL_ASSERT(ppHashContext != nullptr);
+
+    Result result = Result::Success;
+
+    if ((pPlacementAddr == nullptr) ||
+        (ppHashContext == nullptr))
+    {
+        result = Result::ErrorInvalidPointer;
+    }
+    else if (BuiltinHashContext::IsSupported(algorithm) == false)
+    {
+        result         = Result::ErrorInvalidValue;
+        *ppHashContext = nullptr;
+    }
+    else
+    {
+        *ppHashContext = PAL_PLACEMENT_NEW(pPlacementAddr) BuiltinHashContext(algorithm);
+    }
+
+    return result;
+}
+
+} // namespace Util
@@ -0,0 +1,104 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2014-2020 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+/**
+***********************************************************************************************************************
+* @file  builtinHashProvider.h
+* @brief PAL utility header for the built-in SHA hash context implementation
+***********************************************************************************************************************
+*/
+
+#pragma once
+
+#include "palHashProvider.h"
+
+namespace Util
+{
+
+// =====================================================================================================================
+// Hash context for the HashAlgorithm::Builtin* algorithms.  The whole hash state lives inside the object so these
+// contexts do not depend on any OS library and can be duplicated with a plain copy.
+class BuiltinHashContext : public IHashContext
+{
+public:
+    static constexpr size_t BlockSize     = 64;
+    static constexpr size_t MaxOutputSize = 32;
+
+    explicit BuiltinHashContext(HashAlgorithm algorithm);
+    virtual ~BuiltinHashContext() { }
+
+    virtual Result AddData(
+        const void* pData,
+        size_t      dataSize);
+
+    virtual size_t GetOutputBufferSize() const { return GetOutputSize(m_algorithm); }
+
+    virtual Result Finish(
+        void*   pOutput);
+
+    virtual Result Reset();
+
+    virtual size_t GetDuplicateObjectSize() const { return sizeof(BuiltinHashContext); }
+
+    virtual Result Duplicate(
+        void*           pPlacementAddr,
+        IHashContext**  ppDuplicatedObject) const;
+
+    virtual void Destroy() { this->~BuiltinHashContext(); }
+
+    static bool IsSupported(HashAlgorithm algorithm)
+        { return (algorithm == HashAlgorithm::BuiltinSha1) || (algorithm == HashAlgorithm::BuiltinSha256); }
+
+    static size_t GetOutputSize(HashAlgorithm algorithm)
+        { return (algorithm == HashAlgorithm::BuiltinSha1) ? 20 : 32; }
+
+private:
+    PAL_DISALLOW_DEFAULT_CTOR(BuiltinHashContext);
+    PAL_DISALLOW_COPY_AND_ASSIGN(BuiltinHashContext);
+
+    // Processes numBlocks consecutive BlockSize blocks of message data
+    typedef void (*ProcessBlocksFunc)(uint32* pState, const uint8* pData, size_t numBlocks);
+
+    static ProcessBlocksFunc SelectProcessBlocksFunc(HashAlgorithm algorithm);
+
+    const HashAlgorithm     m_algorithm;
+    const ProcessBlocksFunc m_pfnProcessBlocks; // Chosen once per process based on the CPU's SHA extension support
+    uint64                  m_totalSize;        // Bytes of message data added so far
+    uint32                  m_bufferedSize;     // Bytes waiting in m_buffer for a full block
+    uint32                  m_state[8];
+    uint8                   m_buffer[BlockSize];
+};
+
+// Returns the memory sizes for a built-in hash algorithm
+extern Result GetBuiltinHashContextInfo(
+    HashAlgorithm    algorithm,
+    HashContextInfo* pInfo);
+
+// Constructs a built-in hash context at pPlacementAddr
+extern Result CreateBuiltinHashContext(
+    HashAlgorithm   algorithm,
+    void*           pPlacementAddr,
+    IHashContext**  ppHashContext);
+
+} //namespace Util
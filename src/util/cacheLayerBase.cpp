@@ -25,6 +25,8 @@
 #include "cacheLayerBase.h"
 #include "palVectorImpl.h"
 
+#include "lz4.h"
+
 namespace Util
 {
 
@@ -262,4 +264,67 @@ Result CacheLayerBase::SetStorePolicy(
     return result;
 }
 
+// =====================================================================================================================
+// Compress data into the provided buffer
+size_t CacheLayerBase::CompressData(
+    const void* pData,
+    size_t      dataSize,
+    void*       pBuffer,
+    size_t      bufferSize)
+{
+    PAL_ASSERT(pData != nullptr);
+    PAL_ASSERT(pBuffer != nullptr);
+
+    size_t compressedSize = 0;
+
+    if (dataSize <= LZ4_MAX_INPUT_SIZE)
+    {
+        // Don't let LZ4 write more than it would save
+        const int capacity = static_cast<int>(Min(bufferSize, dataSize - 1));
+
+        if (capacity > 0)
+        {
+            compressedSize = static_cast<size_t>(LZ4_compress_default(static_cast<const char*>(pData),
+                                                                      static_cast<char*>(pBuffer),
+                                                                      static_cast<int>(dataSize),
+                                                                      capacity));
+        }
+    }
+
+    return compressedSize;
+}
+
+// =====================================================================================================================
+// Decompress data which must expand to exactly bufferSize bytes
+Result CacheLayerBase::DecompressData(
+    const void* pData,
+    size_t      dataSize,
+    void*       pBuffer,
+    size_t      bufferSize)
+{
+    PAL_ASSERT(pData != nullptr);
+    PAL_ASSERT(pBuffer != nullptr);
+
+    Result result = Result::ErrorInvalidValue;
+
+    if ((dataSize <= LZ4_MAX_INPUT_SIZE) &&
+        (bufferSize <= LZ4_MAX_INPUT_SIZE))
+    {
+        const int decompressedSize = LZ4_decompress_safe(static_cast<const char*>(pData),
+                                                         static_cast<char*>(pBuffer),
+                                                         static_cast<int>(dataSize),
+                                                         static_cast<int>(bufferSize));
+
+        if ((decompressedSize >= 0) &&
+            (static_cast<size_t>(decompressedSize) == bufferSize))
+        {
+            result = Result::Success;
+        }
+    }
+
+    PAL_ALERT(result != Result::Success);
+
+    return result;
+}
+
 } //namespace Util
@@ -83,6 +83,12 @@ protected:
     // Access to a generic allocator suitable for long-term storage
     ForwardAllocator* Allocator() { return &m_allocator; }
 
+    // LZ4 helpers for layers that store their entries compressed. CompressData() returns the compressed size, or 0 if
+    // compressing would not make the data any smaller, in which case the data should be stored as is. A buffer of
+    // dataSize bytes is always large enough.
+    static size_t CompressData(const void* pData, size_t dataSize, void* pBuffer, size_t bufferSize);
+    static Result DecompressData(const void* pData, size_t dataSize, void* pBuffer, size_t bufferSize);
+
     // Internal, single layer operation functions
     virtual Result QueryInternal(
         const Hash128*  pHashId,
@@ -29,6 +29,7 @@
 #include "palPlatformKey.h"
 #include "palHashMapImpl.h"
 #include "palAutoBuffer.h"
+#include "palHashSetImpl.h"
 #include "palVectorImpl.h"
 #include "core/platform.h"
 
@@ -41,16 +42,30 @@ FileArchiveCacheLayer::FileArchiveCacheLayer(
     const AllocCallbacks& callbacks,
     IArchiveFile*         pArchiveFile,
     IHashContext*         pBaseContext,
-    void*                 pTempContextMem)
+    bool                  compressData,
+    bool                  writeBehind)
     :
     CacheLayerBase     { callbacks },
     m_pArchivefile     { pArchiveFile },
     m_pBaseContext     { pBaseContext },
-    m_pTempContextMem  { pTempContextMem },
+    m_hashContextSize  { pBaseContext->GetDuplicateObjectSize() },
+    m_useArchiveLookup { pArchiveFile->SupportsKeyLookup() },
+    m_compressData     { compressData },
+    m_writeBehind      { writeBehind },
     m_archiveFileMutex {},
-    m_hashContextMutex {},
     m_entryMapLock     {},
-    m_entries          { HashTableBucketCount, Allocator() }
+    m_entries          { HashTableBucketCount, Allocator() },
+    m_writeThread      {},
+    m_pendingMutex     {},
+    m_pendingCondition {},
+    m_pendingListA     { Allocator() },
+    m_pendingListB     { Allocator() },
+    m_pQueuedStores    { &m_pendingListA },
+    m_queuedDataSize   { 0 },
+    m_pendingKeys      { MaxPendingStores, Allocator() },
+    m_pendingKeyCount  { 0 },
+    m_writeBehindResult{ Result::Success },
+    m_stopWriteThread  { false }
 {
     PAL_ASSERT(m_pArchivefile != nullptr);
     PAL_ASSERT(m_pBaseContext != nullptr);
@@ -60,6 +75,9 @@ FileArchiveCacheLayer::FileArchiveCacheLayer(
 // =====================================================================================================================
 FileArchiveCacheLayer::~FileArchiveCacheLayer()
 {
+    // Everything still queued is written before the write thread exits
+    StopWriteThread();
+
     m_pBaseContext->Destroy();
 }
 
@@ -69,14 +87,16 @@ Result FileArchiveCacheLayer::Init()
 {
     Result result = CacheLayerBase::Init();
 
-    if (result == Result::Success)
+    // Keys are converted with a duplicate of the base context on the stack
+    if ((result == Result::Success) &&
+        (m_hashContextSize > MaxHashContextSize))
     {
-        result = m_archiveFileMutex.Init();
+        result = Result::ErrorInitializationFailed;
     }
 
     if (result == Result::Success)
     {
-        result = m_hashContextMutex.Init();
+        result = m_archiveFileMutex.Init();
     }
 
     if (result == Result::Success)
@@ -89,6 +109,26 @@ Result FileArchiveCacheLayer::Init()
         result = m_entries.Init();
     }
 
+    if ((result == Result::Success) && m_writeBehind)
+    {
+        result = m_pendingMutex.Init();
+
+        if (result == Result::Success)
+        {
+            result = m_pendingCondition.Init();
+        }
+
+        if (result == Result::Success)
+        {
+            result = m_pendingKeys.Init();
+        }
+
+        if (result == Result::Success)
+        {
+            result = m_writeThread.Begin(&WriteThreadCallback, this);
+        }
+    }
+
     // Collapse all results other than success
     if (result != Result::Success)
     {
@@ -108,7 +148,8 @@ Result FileArchiveCacheLayer::QueryInternal(
     PAL_ASSERT(pHashId != nullptr);
     PAL_ASSERT(pQuery != nullptr);
 
-    Result result = Result::ErrorUnknown;
+    Result   result = Result::ErrorUnknown;
+    EntryKey key;
 
     if ((pHashId == nullptr) ||
         (pQuery == nullptr))
@@ -117,18 +158,52 @@ Result FileArchiveCacheLayer::QueryInternal(
     }
     else
     {
-        EntryKey     key;
-        const Entry* pEntry;
+        result = ConvertToEntryKey(pHashId, &key);
+    }
+
+    if (result == Result::Success)
+    {
+        const Entry* pEntry = nullptr;
+        Entry        archiveEntry;
+
+        // A store still waiting to be written can't be loaded yet
+        if (m_writeBehind)
+        {
+            WaitForPendingStore(key);
+        }
+
+        if (m_useArchiveLookup)
+        {
+            // The archive keeps its own key index, so there is no need to mirror every header in m_entries. Lookups
+            // into it don't need the archive file lock, only a miss checks the file for entries written elsewhere.
+            ArchiveEntryHeader header;
+            Result             findResult = m_pArchivefile->FindEntryByKey(key.value, &header);
 
-        ConvertToEntryKey(pHashId, &key);
+            if (findResult == Result::NotFound)
+            {
+                MutexAuto archiveFileLock { &m_archiveFileMutex };
+
+                Result refreshResult = m_pArchivefile->Refresh();
+                PAL_ALERT(IsErrorResult(refreshResult));
+
+                findResult = m_pArchivefile->FindEntryByKey(key.value, &header);
+            }
 
+            if (findResult == Result::Success)
+            {
+                archiveEntry = { header.ordinalId, header.metaValue };
+                pEntry       = &archiveEntry;
+            }
+        }
+        else
         {
             RWLockAuto<RWLock::ReadOnly> entryMapLock { &m_entryMapLock };
 
             pEntry = m_entries.FindKey(key);
         }
 
-        if (pEntry == nullptr)
+        if ((pEntry == nullptr) &&
+            (m_useArchiveLookup == false))
         {
             MutexAuto                     archiveFileLock { &m_archiveFileMutex };
             RWLockAuto<RWLock::ReadWrite> entryMapLock { &m_entryMapLock };
@@ -184,8 +259,23 @@ Result FileArchiveCacheLayer::StoreInternal(
     }
     else
     {
-        ConvertToEntryKey(pHashId, &key);
+        result = ConvertToEntryKey(pHashId, &key);
+    }
+
+    if (result == Result::Success)
+    {
+        result = Result::NotFound;
+
+        if (m_useArchiveLookup)
+        {
+            ArchiveEntryHeader header;
 
+            if (m_pArchivefile->FindEntryByKey(key.value, &header) == Result::Success)
+            {
+                result = Result::AlreadyExists;
+            }
+        }
+        else
         {
             RWLockAuto<RWLock::ReadOnly> entryMapLock { &m_entryMapLock };
 
@@ -196,49 +286,51 @@ Result FileArchiveCacheLayer::StoreInternal(
         }
     }
 
-    if (result == Result::NotFound)
+    if ((result == Result::NotFound) && m_writeBehind)
+    {
+        result = QueueStore(key, pData, dataSize);
+    }
+    else if (result == Result::NotFound)
     {
         ArchiveEntryHeader header         = {};
-        const size_t       writeDataSize  = dataSize;
-        void* const        pMem           = PAL_MALLOC(writeDataSize, Allocator(), AllocInternalTemp);
+        void* const        pCompressed    = m_compressData ? PAL_MALLOC(dataSize, Allocator(), AllocInternalTemp)
+                                                           : nullptr;
+        size_t             compressedSize = 0;
 
-        PAL_ALERT(pMem == nullptr);
+        PAL_ALERT(m_compressData && (pCompressed == nullptr));
 
-        if (pMem != nullptr)
+        // Compressed entries are flagged by their dataType and keep the uncompressed size in metaValue. Data that
+        // doesn't shrink, or that we had no memory to compress, is stored as is.
+        if (pCompressed != nullptr)
         {
-            result = Result::Success;
-        }
-        else
-        {
-            result = Result::ErrorOutOfMemory;
+            compressedSize = CompressData(pData, dataSize, pCompressed, dataSize);
         }
 
-        // Write the scratch buffer to the file
-        if (result == Result::Success)
+        // Write the data to the file
         {
             MutexAuto archiveFileLock { &m_archiveFileMutex };
 
-            void* const pDataMem = pMem;
-            header.dataSize      = static_cast<uint32>(writeDataSize);
-            header.metaValue     = static_cast<uint32>(dataSize);
+            header.dataSize  = static_cast<uint32>((compressedSize > 0) ? compressedSize : dataSize);
+            header.dataType  = (compressedSize > 0) ? ArchiveCompressedDataType : 0;
+            header.metaValue = static_cast<uint32>(dataSize);
 
-            memcpy(pDataMem, pData, dataSize);
             memcpy(header.entryKey, key.value, sizeof(EntryKey));
 
-            result = m_pArchivefile->Write(&header, pMem);
+            result = m_pArchivefile->Write(&header, (compressedSize > 0) ? pCompressed : pData);
         }
 
         // Only insert this entry into our lookup table if everything succeeded
-        if (result == Result::Success)
+        if ((result == Result::Success) &&
+            (m_useArchiveLookup == false))
         {
             RWLockAuto<RWLock::ReadWrite> entryMapLock { &m_entryMapLock };
 
             result = AddHeaderToTable(header);
         }
 
-        if (pMem != nullptr)
+        if (pCompressed != nullptr)
         {
-            PAL_FREE(pMem, Allocator());
+            PAL_FREE(pCompressed, Allocator());
         }
     }
 
@@ -272,19 +364,22 @@ Result FileArchiveCacheLayer::LoadInternal(
     }
 
 #if DEBUG
-    if (result == Result::Success)
+    if ((result == Result::Success) &&
+        (m_useArchiveLookup == false))
     {
         RWLockAuto<RWLock::ReadOnly> entryMapLock { &m_entryMapLock };
 
         EntryKey key;
-        ConvertToEntryKey(&pQuery->hashId, &key);
 
-        const Entry* pEntry = m_entries.FindKey(key);
+        if (ConvertToEntryKey(&pQuery->hashId, &key) == Result::Success)
+        {
+            const Entry* pEntry = m_entries.FindKey(key);
 
-        // Should be safe to have these in order, if alerts are enabled then the first will be hit,
-        // if they are disabled then neither will be.
-        PAL_ALERT(pEntry == nullptr);
-        PAL_ALERT(pEntry->ordinalId != pQuery->context.entryId);
+            // Should be safe to have these in order, if alerts are enabled then the first will be hit,
+            // if they are disabled then neither will be.
+            PAL_ALERT(pEntry == nullptr);
+            PAL_ALERT(pEntry->ordinalId != pQuery->context.entryId);
+        }
     }
 #endif
 
@@ -305,21 +400,38 @@ Result FileArchiveCacheLayer::LoadInternal(
 
         const size_t readSize      = header.dataSize;
         const size_t dataSize      = header.metaValue;
+        const bool   compressed    = (header.dataType == ArchiveCompressedDataType);
 
-        void* const pReadMem = PAL_MALLOC(readSize, Allocator(), AllocInternalTemp);
-        void* const pDataMem = pReadMem;
+        // Uncompressed entries are read straight into the caller's buffer
+        void* const pReadMem = compressed ? PAL_MALLOC(readSize, Allocator(), AllocInternalTemp) : pBuffer;
 
-        if (pReadMem == nullptr)
+        // Only compressed entries may hold a different amount of data than the size we handed out
+        if ((compressed == false) && (readSize != dataSize))
+        {
+            result = Result::ErrorInvalidValue;
+        }
+        else if (pReadMem == nullptr)
         {
             result = Result::ErrorOutOfMemory;
         }
 
         if (result == Result::Success)
         {
-            MutexAuto archiveFileLock { &m_archiveFileMutex };
+            // Archives that support concurrent reads let loads from multiple threads proceed in parallel
+            const bool lockArchiveFile = (m_pArchivefile->SupportsConcurrentReads() == false);
+
+            if (lockArchiveFile)
+            {
+                m_archiveFileMutex.Lock();
+            }
 
             result = m_pArchivefile->Read(&header, pReadMem);
 
+            if (lockArchiveFile)
+            {
+                m_archiveFileMutex.Unlock();
+            }
+
             // In the case that AsyncIO is not ready, signal Result::NotFound
             if (result == Result::NotReady)
             {
@@ -329,12 +441,12 @@ Result FileArchiveCacheLayer::LoadInternal(
             PAL_ALERT(IsErrorResult(result));
         }
 
-        if (result == Result::Success)
+        if ((result == Result::Success) && compressed)
         {
-            memcpy(pBuffer, pDataMem, dataSize);
+            result = DecompressData(pReadMem, readSize, pBuffer, dataSize);
         }
 
-        if (pReadMem != nullptr)
+        if (compressed && (pReadMem != nullptr))
         {
             PAL_FREE(pReadMem, Allocator());
         }
@@ -359,9 +471,14 @@ static size_t GetBaseContextSizeFromCreateInfo(
     else
     {
         HashContextInfo info   = {};
-        Result          result = GetHashContextInfo(HashAlgorithm::Sha1, &info);
+        Result          result = GetHashContextInfo(HashAlgorithm::BuiltinSha1, &info);
 
         PAL_ALERT(IsErrorResult(result));
+
+        if (result == Result::Success)
+        {
+            contextSize = info.contextObjectSize;
+        }
     }
 
     return contextSize;
@@ -372,7 +489,7 @@ static size_t GetBaseContextSizeFromCreateInfo(
 size_t GetArchiveFileCacheLayerSize(
     const ArchiveFileCacheCreateInfo* pCreateInfo)
 {
-    return sizeof(FileArchiveCacheLayer) + (GetBaseContextSizeFromCreateInfo(pCreateInfo) * 2);
+    return sizeof(FileArchiveCacheLayer) + GetBaseContextSizeFromCreateInfo(pCreateInfo);
 }
 
 // =====================================================================================================================
@@ -389,8 +506,6 @@ Result CreateArchiveFileCacheLayer(
     Result                 result          = Result::Success;
     FileArchiveCacheLayer* pLayer          = nullptr;
     IHashContext*          pBaseContext    = nullptr;
-    void*                  pTempContextMem = nullptr;
-    const size_t           hashContextSize = GetBaseContextSizeFromCreateInfo(pCreateInfo);
     ArchiveFileOpenInfo    openInfo        = {};
 
     if ((pCreateInfo == nullptr) ||
@@ -403,7 +518,6 @@ Result CreateArchiveFileCacheLayer(
     if (result == Result::Success)
     {
         void* pBaseContextMem = VoidPtrInc(pPlacementAddr, sizeof(FileArchiveCacheLayer));
-        pTempContextMem       = VoidPtrInc(pBaseContextMem, hashContextSize);
 
         if (pCreateInfo->pPlatformKey != nullptr)
         {
@@ -411,7 +525,7 @@ Result CreateArchiveFileCacheLayer(
         }
         else
         {
-            result = CreateHashContext(HashAlgorithm::Sha1, pBaseContextMem, &pBaseContext);
+            result = CreateHashContext(HashAlgorithm::BuiltinSha1, pBaseContextMem, &pBaseContext);
         }
     }
 
@@ -428,7 +542,8 @@ Result CreateArchiveFileCacheLayer(
             (pCreateInfo->baseInfo.pCallbacks == nullptr) ? callbacks : *pCreateInfo->baseInfo.pCallbacks,
             pCreateInfo->pFile,
             pBaseContext,
-            pTempContextMem);
+            pCreateInfo->baseInfo.compressData,
+            pCreateInfo->writeBehind);
 
         result = pLayer->Init();
 
@@ -500,27 +615,331 @@ Result FileArchiveCacheLayer::RefreshHeaders()
 }
 
 // =====================================================================================================================
-// Convert a 128-bit hash to a SHA1 entry id
-void FileArchiveCacheLayer::ConvertToEntryKey(
+// Copy data into the write queue, waiting for the write thread to make room if the queue is full
+Result FileArchiveCacheLayer::QueueStore(
+    const EntryKey& key,
+    const void*     pData,
+    size_t          dataSize)
+{
+    PendingStore store = {};
+    store.key      = key;
+    store.pData    = PAL_MALLOC(dataSize, Allocator(), AllocInternal);
+    store.dataSize = dataSize;
+
+    Result result = (store.pData != nullptr) ? Result::Success : Result::ErrorOutOfMemory;
+
+    if (result == Result::Success)
+    {
+        memcpy(store.pData, pData, dataSize);
+
+        MutexAuto pendingLock { &m_pendingMutex };
+
+        // An earlier store that failed to write has to be reported to someone, so this store is refused in its place.
+        // The caller learns the archive isn't taking data instead of the error going unnoticed.
+        result = TakeWriteBehindResult();
+
+        if (result == Result::Success)
+        {
+            // A store larger than the whole budget is still queued once the queue is empty
+            while ((m_pendingKeys.Contains(key) == false) &&
+                   (m_pQueuedStores->IsEmpty() == false) &&
+                   ((m_pQueuedStores->NumElements() >= MaxPendingStores) ||
+                    ((m_queuedDataSize + dataSize) > MaxPendingDataSize)))
+            {
+                m_pendingCondition.Wait(&m_pendingMutex, UINT32_MAX);
+            }
+
+            ArchiveEntryHeader header;
+
+            // The key may have been written out and dropped from m_pendingKeys since StoreInternal() looked it up.
+            // Entries are added to the archive's index before their keys leave m_pendingKeys, so checking again here
+            // is enough.
+            if (m_pendingKeys.Contains(key) ||
+                (m_useArchiveLookup && (m_pArchivefile->FindEntryByKey(key.value, &header) == Result::Success)))
+            {
+                result = Result::AlreadyExists;
+            }
+            else
+            {
+                result = m_pendingKeys.Insert(key);
+
+                if (result == Result::Success)
+                {
+                    result = m_pQueuedStores->PushBack(store);
+
+                    if (result != Result::Success)
+                    {
+                        m_pendingKeys.Erase(key);
+                    }
+                }
+
+                if (result == Result::Success)
+                {
+                    m_queuedDataSize += dataSize;
+                    AtomicWriteRelaxed64(&m_pendingKeyCount, m_pendingKeys.GetNumEntries());
+                    m_pendingCondition.WakeAll();
+                }
+            }
+        }
+    }
+
+    if ((result != Result::Success) && (store.pData != nullptr))
+    {
+        PAL_FREE(store.pData, Allocator());
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Block until a queued store for the key, if any, has been written to the archive
+void FileArchiveCacheLayer::WaitForPendingStore(
+    const EntryKey& key)
+{
+    // Queries far outnumber stores, so don't touch the lock the write thread and Store() use unless something is
+    // actually queued. A store queued before this query began is always counted.
+    if (AtomicReadRelaxed64(&m_pendingKeyCount) > 0)
+    {
+        MutexAuto pendingLock { &m_pendingMutex };
+
+        while (m_pendingKeys.Contains(key))
+        {
+            m_pendingCondition.Wait(&m_pendingMutex, UINT32_MAX);
+        }
+    }
+}
+
+// =====================================================================================================================
+// Returns the first write-behind error that hasn't been reported yet and clears it. The caller must hold
+// m_pendingMutex.
+Result FileArchiveCacheLayer::TakeWriteBehindResult()
+{
+    const Result result = m_writeBehindResult;
+
+    m_writeBehindResult = Result::Success;
+
+    return result;
+}
+
+// =====================================================================================================================
+// Wait for an entry that may still be queued for the write thread
+Result FileArchiveCacheLayer::WaitForEntry(
+    const Hash128* pHashId)
+{
+    QueryResult query  = {};
+    Result      result = QueryInternal(pHashId, &query);
+
+    // A queued store that failed to write never reaches the archive, so it misses here
+    if ((result == Result::NotFound) && m_writeBehind)
+    {
+        MutexAuto pendingLock { &m_pendingMutex };
+
+        const Result writeResult = TakeWriteBehindResult();
+
+        if (writeResult != Result::Success)
+        {
+            result = writeResult;
+        }
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Write a batch of queued stores to the archive with a single append. Entries that fail to write are dropped, and the
+// error is returned so it can be reported by a later Store() or WaitForEntry().
+Result FileArchiveCacheLayer::WritePendingStores(
+    PendingList* pStores)
+{
+    const uint32 count  = pStores->NumElements();
+    void* const  pMem   = PAL_MALLOC(count * (sizeof(void*) + sizeof(ArchiveEntryHeader)),
+                                     Allocator(),
+                                     AllocInternalTemp);
+    Result       result = (pMem != nullptr) ? Result::Success : Result::ErrorOutOfMemory;
+
+    if (result == Result::Success)
+    {
+        const void** const        ppData   = static_cast<const void**>(pMem);
+        ArchiveEntryHeader* const pHeaders = static_cast<ArchiveEntryHeader*>(VoidPtrInc(pMem, count * sizeof(void*)));
+
+        for (uint32 i = 0; i < count; ++i)
+        {
+            PendingStore* const pStore        = &pStores->At(i);
+            size_t              writeDataSize = pStore->dataSize;
+
+            // Compressing here rather than in Store() keeps it off the calling thread as well
+            if (m_compressData)
+            {
+                void* const pCompressed    = PAL_MALLOC(pStore->dataSize, Allocator(), AllocInternal);
+                size_t      compressedSize = 0;
+
+                if (pCompressed != nullptr)
+                {
+                    compressedSize = CompressData(pStore->pData, pStore->dataSize, pCompressed, pStore->dataSize);
+                }
+
+                if (compressedSize > 0)
+                {
+                    PAL_FREE(pStore->pData, Allocator());
+                    pStore->pData = pCompressed;
+                    writeDataSize = compressedSize;
+                }
+                else if (pCompressed != nullptr)
+                {
+                    PAL_FREE(pCompressed, Allocator());
+                }
+            }
+
+            pHeaders[i]           = {};
+            pHeaders[i].dataSize  = static_cast<uint32>(writeDataSize);
+            pHeaders[i].dataType  = (writeDataSize < pStore->dataSize) ? ArchiveCompressedDataType : 0;
+            pHeaders[i].metaValue = static_cast<uint32>(pStore->dataSize);
+            memcpy(pHeaders[i].entryKey, pStore->key.value, sizeof(EntryKey));
+
+            ppData[i] = pStore->pData;
+        }
+
+        {
+            MutexAuto archiveFileLock { &m_archiveFileMutex };
+
+            result = m_pArchivefile->WriteBatch(pHeaders, ppData, count);
+        }
+
+        if ((result == Result::Success) &&
+            (m_useArchiveLookup == false))
+        {
+            RWLockAuto<RWLock::ReadWrite> entryMapLock { &m_entryMapLock };
+
+            for (uint32 i = 0; (i < count) && (result == Result::Success); ++i)
+            {
+                result = AddHeaderToTable(pHeaders[i]);
+            }
+        }
+
+        PAL_FREE(pMem, Allocator());
+    }
+
+    PAL_ALERT(IsErrorResult(result));
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        PAL_FREE(pStores->At(i).pData, Allocator());
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Write thread entry point
+void FileArchiveCacheLayer::WriteThreadCallback(
+    void* pParameter)
+{
+    static_cast<FileArchiveCacheLayer*>(pParameter)->RunWriteThread();
+}
+
+// =====================================================================================================================
+// Write queued stores until asked to stop. Each pass takes the whole queue so stores can keep being queued while a
+// batch is written.
+void FileArchiveCacheLayer::RunWriteThread()
+{
+    m_pendingMutex.Lock();
+
+    while (true)
+    {
+        while (m_pQueuedStores->IsEmpty() && (m_stopWriteThread == false))
+        {
+            m_pendingCondition.Wait(&m_pendingMutex, UINT32_MAX);
+        }
+
+        // Only stop once everything queued has been written
+        if (m_pQueuedStores->IsEmpty())
+        {
+            break;
+        }
+
+        PendingList* const pBatch = m_pQueuedStores;
+
+        m_pQueuedStores  = (pBatch == &m_pendingListA) ? &m_pendingListB : &m_pendingListA;
+        m_queuedDataSize = 0;
+        m_pendingCondition.WakeAll();
+
+        m_pendingMutex.Unlock();
+        const Result writeResult = WritePendingStores(pBatch);
+        m_pendingMutex.Lock();
+
+        // Keep the first error until a caller takes it, later ones are most likely caused by the same problem
+        if ((writeResult != Result::Success) &&
+            (m_writeBehindResult == Result::Success))
+        {
+            m_writeBehindResult = writeResult;
+        }
+
+        // Failed keys leave the pending set as well. Nothing was added to the lookup tables for them, so they are
+        // reported as not found from now on rather than as entries that can't be loaded.
+        for (uint32 i = 0; i < pBatch->NumElements(); ++i)
+        {
+            m_pendingKeys.Erase(pBatch->At(i).key);
+        }
+
+        AtomicWriteRelaxed64(&m_pendingKeyCount, m_pendingKeys.GetNumEntries());
+
+        pBatch->Clear();
+        m_pendingCondition.WakeAll();
+    }
+
+    m_pendingMutex.Unlock();
+}
+
+// =====================================================================================================================
+// Have the write thread finish everything queued and exit
+void FileArchiveCacheLayer::StopWriteThread()
+{
+    if (m_writeThread.IsCreated())
+    {
+        {
+            MutexAuto pendingLock { &m_pendingMutex };
+
+            m_stopWriteThread = true;
+            m_pendingCondition.WakeAll();
+        }
+
+        m_writeThread.Join();
+    }
+}
+
+// =====================================================================================================================
+// Convert a 128-bit hash to a SHA1 entry id. This runs for every Query, Store and Load, from any number of compile
+// threads at once, so it must not take a lock.
+Result FileArchiveCacheLayer::ConvertToEntryKey(
     const Hash128* pHashId,
     EntryKey*      pKey)
 {
     PAL_ASSERT(pHashId != nullptr);
     PAL_ASSERT(pKey != nullptr);
 
-    MutexAuto hashContextLock { &m_hashContextMutex };
+    // Every call hashes with its own duplicate of the base context on the stack, so concurrent lookups don't have to
+    // wait for each other. Init() made sure a duplicate fits.
+    uint64 contextMem[MaxHashContextSize / sizeof(uint64)];
 
     IHashContext* pContext = nullptr;
-    Result result          = m_pBaseContext->Duplicate(m_pTempContextMem, &pContext);
+    Result result          = m_pBaseContext->Duplicate(contextMem, &pContext);
     PAL_ALERT(IsErrorResult(result));
 
-    result = pContext->AddData(pHashId, sizeof(Hash128));
-    PAL_ALERT(IsErrorResult(result));
+    if (result == Result::Success)
+    {
+        result = pContext->AddData(pHashId, sizeof(Hash128));
+        PAL_ALERT(IsErrorResult(result));
 
-    result = pContext->Finish(pKey->value);
-    PAL_ALERT(IsErrorResult(result));
+        if (result == Result::Success)
+        {
+            result = pContext->Finish(pKey->value);
+            PAL_ALERT(IsErrorResult(result));
+        }
 
-    pContext->Destroy();
+        pContext->Destroy();
+    }
+
+    return result;
 }
 
 } //namespace Util
@@ -28,9 +28,12 @@
 
 #include "palArchiveFileFmt.h"
 #include "palArchiveFile.h"
+#include "palConditionVariable.h"
 #include "palLinearAllocator.h"
 #include "palHashProvider.h"
 #include "palHashMap.h"
+#include "palHashSet.h"
+#include "palThread.h"
 #include "palVector.h"
 
 namespace Util
@@ -45,11 +48,16 @@ public:
         const AllocCallbacks& callbacks,
         IArchiveFile*         pArchiveFile,
         IHashContext*         pBaseContext,
-        void*                 pTemContextMem);
+        bool                  compressData,
+        bool                  writeBehind);
     virtual ~FileArchiveCacheLayer();
 
     virtual Result Init() override;
 
+    // With write-behind, waits for a queued store of the entry to be written. A store that failed to write reports
+    // its error here or from a later Store(), see m_writeBehindResult.
+    virtual Result WaitForEntry(const Hash128* pHashId) override;
+
 protected:
 
     virtual Result QueryInternal(
@@ -73,6 +81,14 @@ private:
     static constexpr size_t        MinExpectedHeaders   = 256;
     static constexpr size_t        HashTableBucketCount = 2048;
 
+    // Bounds on the stores queued for the write thread, Store() blocks until there is room
+    static constexpr uint32        MaxPendingStores     = 256;
+    static constexpr size_t        MaxPendingDataSize   = 64 * 1024 * 1024;
+
+    // Largest hash context supported for key conversion. Contexts are duplicated on the stack, so this has to stay
+    // small, but it fits every algorithm the hash providers support.
+    static constexpr size_t        MaxHashContextSize   = 512;
+
     // Helper type for ArchiveEntryHeader::entryKey
     struct EntryKey
     {
@@ -87,24 +103,61 @@ private:
     };
     using EntryMap = HashMap<EntryKey, Entry, ForwardAllocator, JenkinsHashFunc>;
 
-    // Hashing Utility functions
-    void ConvertToEntryKey(const Hash128* pHashId, EntryKey* pKey);
+    // A store waiting for the write thread, which owns pData
+    struct PendingStore
+    {
+        EntryKey key;
+        void*    pData;
+        size_t   dataSize;
+    };
+    using PendingList = Vector<PendingStore, 16, ForwardAllocator>;
+    using PendingSet  = HashSet<EntryKey, ForwardAllocator, JenkinsHashFunc>;
+
+    // Hashing Utility functions. This doesn't take any locks, so keys can be converted by any number of threads at
+    // once. pKey is only valid if this returns Success.
+    Result ConvertToEntryKey(const Hash128* pHashId, EntryKey* pKey);
 
     // Header refresh
     Result AddHeaderToTable(const ArchiveEntryHeader& header);
     Result RefreshHeaders();
 
+    // Write-behind
+    Result QueueStore(const EntryKey& key, const void* pData, size_t dataSize);
+    void   WaitForPendingStore(const EntryKey& key);
+    Result WritePendingStores(PendingList* pStores);
+    Result TakeWriteBehindResult();
+    void   StopWriteThread();
+    void   RunWriteThread();
+
+    static void WriteThreadCallback(void* pParameter);
+
     // Invariants that must be passed in by ctor
     IArchiveFile* const  m_pArchivefile;
-    IHashContext* const  m_pBaseContext;
-    void* const          m_pTempContextMem;
+    IHashContext* const  m_pBaseContext;      // Only ever duplicated after construction, which is thread-safe
+    const size_t         m_hashContextSize;   // Size of a duplicate of m_pBaseContext
+    const bool           m_useArchiveLookup;  // Look entries up through the archive's key index instead of m_entries
+    const bool           m_compressData;
+    const bool           m_writeBehind;
 
     Mutex                m_archiveFileMutex;
-    Mutex                m_hashContextMutex;
     RWLock               m_entryMapLock;
 
     // Data Members
     EntryMap m_entries;
+
+    // Write-behind state, protected by m_pendingMutex. Stores are queued on one list while the write thread works
+    // through the other.
+    Thread               m_writeThread;
+    Mutex                m_pendingMutex;
+    ConditionVariable    m_pendingCondition;  // Signaled when stores are queued or written, or the thread should stop
+    PendingList          m_pendingListA;
+    PendingList          m_pendingListB;
+    PendingList*         m_pQueuedStores;
+    size_t               m_queuedDataSize;
+    PendingSet           m_pendingKeys;       // Keys of every store not yet written, queued or in the current batch
+    volatile uint64      m_pendingKeyCount;   // Copy of m_pendingKeys.GetNumEntries() that can be read without the lock
+    Result               m_writeBehindResult; // First write error not yet returned to a caller
+    bool                 m_stopWriteThread;
 };
 
 } //namespace Util
@@ -26,6 +26,8 @@
 #include "util/lnx/lnxArchiveFile.h"
 
 #include "palAssert.h"
+#include "palHashMapImpl.h"
+#include "palHashSetImpl.h"
 #include "palInlineFuncs.h"
 #include "palIntrusiveListImpl.h"
 #include "palMetroHash.h"
@@ -33,14 +35,17 @@
 #include "palSysUtil.h"
 #include "palVectorImpl.h"
 
+#include <errno.h>
 #include <fcntl.h>
 #include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/file.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <time.h>
 
@@ -120,48 +125,52 @@ static uint64 Crc64(
 }
 
 // =====================================================================================================================
-// Helper function to read directly from a file using Linux API
+// Helper function to read directly from a file using Linux API. Positional reads are used so the file offset is never
+// shared state between callers. If pBytesRead is provided the read may stop early at the end of the file, otherwise
+// the full readSize must be available.
 static Result ReadDirect(
     int32   fd,
     size_t  fileOffset,
     void*   pBuffer,
-    size_t  readSize)
+    size_t  readSize,
+    size_t* pBytesRead = nullptr)
 {
     PAL_ASSERT(fd   > 0);
     PAL_ASSERT(pBuffer != nullptr);
 
-    struct stat statBuf;
-    Result result    = Result::ErrorUnknown;
+    Result result          = Result::Success;
+    size_t alreadyReadSize = 0;
 
-    if (fstat(fd, &statBuf) == 0)
+    while (alreadyReadSize < readSize)
     {
-        result = Result::Success;
-    }
+        const ssize_t curReadSize = pread(fd,
+                                          VoidPtrInc(pBuffer, alreadyReadSize),
+                                          readSize - alreadyReadSize,
+                                          static_cast<off_t>(fileOffset + alreadyReadSize));
 
-    if (result == Result::Success)
-    {
-        if (lseek(fd, fileOffset, SEEK_SET) == InvalidSysCall)
+        if (curReadSize > 0)
         {
-            result = Result::ErrorUnknown;
+            alreadyReadSize += static_cast<size_t>(curReadSize);
+        }
+        else if ((curReadSize == InvalidSysCall) && (errno == EINTR))
+        {
+            continue;
+        }
+        else
+        {
+            // Either we hit the end of the file or the read failed outright
+            if ((curReadSize != 0) || (pBytesRead == nullptr))
+            {
+                result = Result::ErrorUnknown;
+                PAL_ALERT_ALWAYS();
+            }
+            break;
         }
-
     }
 
-    size_t alreadyReadSize = 0;
-    size_t exactSize = Min(readSize, static_cast<size_t>(statBuf.st_size));
-
-    if (result == Result::Success)
-    {
-        alreadyReadSize = read(fd, pBuffer, exactSize);
-    }
-    if (alreadyReadSize == exactSize)
+    if (pBytesRead != nullptr)
     {
-        result = Result::Success;
-    }
-    else
-    {
-        result = Result::ErrorUnknown;
-        PAL_ALERT_ALWAYS();
+        *pBytesRead = alreadyReadSize;
     }
 
     return result;
@@ -178,25 +187,30 @@ static Result WriteDirect(
     PAL_ASSERT(fd > 0);
     PAL_ASSERT(pData != nullptr);
 
-    Result result       = Result::ErrorUnknown;
+    Result result           = Result::Success;
+    size_t alreadyWriteSize = 0;
 
-    if (lseek(fd, fileOffset, SEEK_SET) == InvalidSysCall)
+    while (alreadyWriteSize < writeSize)
     {
-        result = Result::ErrorUnknown;
-        PAL_ALERT_ALWAYS();
-        return result;
-    }
-
-    size_t alreadyWriteSize = write(fd, pData, writeSize);
+        const ssize_t curWriteSize = pwrite(fd,
+                                            VoidPtrInc(pData, alreadyWriteSize),
+                                            writeSize - alreadyWriteSize,
+                                            static_cast<off_t>(fileOffset + alreadyWriteSize));
 
-    if (alreadyWriteSize == writeSize)
-    {
-        result = Result::Success;
-    }
-    else
-    {
-        result = Result::ErrorUnknown;
-        PAL_ALERT_ALWAYS();
+        if (curWriteSize > 0)
+        {
+            alreadyWriteSize += static_cast<size_t>(curWriteSize);
+        }
+        else if ((curWriteSize == InvalidSysCall) && (errno == EINTR))
+        {
+            continue;
+        }
+        else
+        {
+            result = Result::ErrorUnknown;
+            PAL_ALERT_ALWAYS();
+            break;
+        }
     }
 
     return result;
@@ -437,6 +451,61 @@ static bool ValidateFooter(
     return valid;
 }
 
+// =====================================================================================================================
+// Order index keys by entry key, then by ordinal id so the first entry written with a key is found first
+static int32 CompareIndexKeys(
+    const void* pLhs,
+    const void* pRhs)
+{
+    const ArchiveIndexKey* const pLhsKey = static_cast<const ArchiveIndexKey*>(pLhs);
+    const ArchiveIndexKey* const pRhsKey = static_cast<const ArchiveIndexKey*>(pRhs);
+
+    int32 result = memcmp(pLhsKey->entryKey, pRhsKey->entryKey, sizeof(pLhsKey->entryKey));
+
+    if (result == 0)
+    {
+        result = (pLhsKey->ordinalId < pRhsKey->ordinalId) ? -1 : ((pLhsKey->ordinalId > pRhsKey->ordinalId) ? 1 : 0);
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Binary search a sorted index key table for the first entry written with a key
+static bool FindIndexKey(
+    const ArchiveIndexKey* pKeys,
+    uint32                 keyCount,
+    const uint8*           pEntryKey,
+    uint32*                pOrdinalId)
+{
+    uint32 begin = 0;
+    uint32 end   = keyCount;
+
+    while (begin < end)
+    {
+        const uint32 mid = begin + ((end - begin) / 2);
+
+        if (memcmp(pKeys[mid].entryKey, pEntryKey, sizeof(pKeys[mid].entryKey)) < 0)
+        {
+            begin = mid + 1;
+        }
+        else
+        {
+            end = mid;
+        }
+    }
+
+    const bool found = (begin < keyCount) &&
+                       (memcmp(pKeys[begin].entryKey, pEntryKey, sizeof(pKeys[begin].entryKey)) == 0);
+
+    if (found)
+    {
+        *pOrdinalId = pKeys[begin].ordinalId;
+    }
+
+    return found;
+}
+
 // =====================================================================================================================
 ArchiveFile::ArchiveFile(
     const AllocCallbacks&    callbacks,
@@ -449,25 +518,58 @@ ArchiveFile::ArchiveFile(
     m_allocator         (callbacks),
     m_hFile             (hFile),
     m_archiveHeader     (*pArchiveHeader),
+    m_fullPath          (),
     m_fileSize          (0),
     m_cachedFooter      (),
     m_curFooterOffset   (0),
     m_entries           (Allocator()),
+    m_fileLock          (),
+    m_indexLock         (),
+    m_indexSegments     (Allocator()),
+    m_indexedCount      (0),
+    m_lastIndexBlock    (0),
+    m_unindexedKeys     (MaxHeaderRun / 8, Allocator()),
     // Write Access
     m_haveWriteAccess   (haveWriteAccess),
+    // Access tracking
+    m_accessLock        (),
+    m_accessedEntries   (MaxHeaderRun / 8, Allocator()),
+    m_accessOrder       (Allocator()),
     // Read memory buffering
     m_useBufferedMemory (false),
     m_bufferMemory      (memoryBufferMax),
     m_recentList        (),
+    m_pageLookup        (MaxPageCount * 2, Allocator()),
     m_pages             (),
     m_pageCount         (0),
-    m_pageSize          (MinPageSize)
+    m_pageSize          (MinPageSize),
+    m_lastMissPageIndex (-1),
+    m_readaheadPages    (1),
+    // Memory mapped reads
+    m_pMappedFile       (nullptr),
+    m_mappedSize        (0)
 {
 }
 
 // =====================================================================================================================
 ArchiveFile::~ArchiveFile()
 {
+    // Index anything written since the last index so the next open doesn't have to walk the entry chain. Opening and
+    // closing the archive without storing anything leaves the file untouched.
+    if (m_haveWriteAccess &&
+        (m_unindexedKeys.GetNumEntries() > 0))
+    {
+        Result indexResult = WriteIndex(false);
+        PAL_ALERT(IsErrorResult(indexResult));
+    }
+
+    ResetIndex();
+
+    if (m_pMappedFile != nullptr)
+    {
+        munmap(m_pMappedFile, MaxMappedSize);
+    }
+
     close(m_hFile);
 }
 
@@ -476,11 +578,42 @@ ArchiveFile::~ArchiveFile()
 Result ArchiveFile::Init(
     const ArchiveFileOpenInfo* pInfo)
 {
-    Result result = Result::Success;
+    GenerateFullPath(m_fullPath, sizeof(m_fullPath), pInfo);
+
+    Result result = m_accessLock.Init();
+
+    if (result == Result::Success)
+    {
+        result = m_fileLock.Init();
+    }
+
+    if (result == Result::Success)
+    {
+        result = m_indexLock.Init();
+    }
+
+    if (result == Result::Success)
+    {
+        result = m_accessedEntries.Init();
+    }
+
+    if (result == Result::Success)
+    {
+        result = m_unindexedKeys.Init();
+    }
+
+    // A read-only mapping of the file replaces the internal memory buffers when available
+    if ((result == Result::Success) &&
+        (pInfo->useMemoryMappedReads))
+    {
+        Result mapResult = InitMapping();
+        PAL_ALERT(IsErrorResult(mapResult));
+    }
 
     // Init internal memory buffers
     if ((result == Result::Success) &&
-        (pInfo->useBufferedReadMemory))
+        (pInfo->useBufferedReadMemory) &&
+        (m_pMappedFile == nullptr))
     {
         m_useBufferedMemory = true;
         result              = InitPages();
@@ -513,7 +646,28 @@ Result ArchiveFile::Preload(
 {
     Result result = Result::ErrorUnknown;
 
-    if (m_useBufferedMemory)
+    if (m_pMappedFile != nullptr)
+    {
+        if (startLocation < m_fileSize)
+        {
+            // Ask the kernel to start faulting in the range; the copies in Read() then come straight from page cache
+            const size_t pageSize   = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+            const size_t alignedLoc = Pow2AlignDown(startLocation, pageSize);
+            const size_t readSize   = Min(maxReadSize, static_cast<size_t>(m_fileSize) - startLocation);
+
+            if (madvise(VoidPtrInc(m_pMappedFile, alignedLoc),
+                        (startLocation - alignedLoc) + readSize,
+                        MADV_WILLNEED) == 0)
+            {
+                result = Result::Success;
+            }
+        }
+        else
+        {
+            result = Result::ErrorInvalidValue;
+        }
+    }
+    else if (m_useBufferedMemory)
     {
         if (startLocation < m_fileSize)
         {
@@ -596,10 +750,19 @@ Result ArchiveFile::Read(
     }
     else
     {
-        Result refreshResult = RefreshFile(false);
+        // Entries never move once written, so the file only needs to be refreshed if the entry is past the end of the
+        // archive as we last saw it. Concurrent reads only get headers this object has already returned, which are
+        // always inside the known range, so they never refresh: that would change state other readers are using.
+        if ((SupportsConcurrentReads() == false) &&
+            ((pHeader->dataPosition + pHeader->dataSize) > m_curFooterOffset))
+        {
+            Result refreshResult = RefreshFile(false);
+
+            // We can still attempt to read from the file using our cached header
+            PAL_ALERT(IsErrorResult(refreshResult));
+        }
 
-        // We can still attempt to read from the file using our cached header
-        PAL_ALERT(IsErrorResult(refreshResult));
+        RWLockAuto<RWLock::ReadOnly> fileLock { &m_fileLock };
 
         // Sanity check our arguments before attempting the read
         if ((pHeader->ordinalId <= GetEntryCount()) &&
@@ -627,6 +790,10 @@ Result ArchiveFile::Read(
             // since that does not exist use Result::ErrorUnknown to denote an internal error
             result = Result::ErrorUnknown;
         }
+        else
+        {
+            RecordAccess(pHeader->ordinalId);
+        }
     }
 
     return result;
@@ -641,50 +808,100 @@ Result ArchiveFile::Write(
     PAL_ASSERT(pHeader != nullptr);
     PAL_ASSERT(pData != nullptr);
 
-    Result result = Result::ErrorUnknown;
+    return WriteBatch(pHeader, &pData, 1);
+}
 
-    if ((pHeader == nullptr) ||
-        (pData == nullptr))
+// =====================================================================================================================
+// Write entries to the end of the archive. All of the entries and the updated footer go out in one write.
+Result ArchiveFile::WriteBatch(
+    ArchiveEntryHeader* pHeaders,
+    const void* const*  ppData,
+    uint32              count)
+{
+    PAL_ASSERT(pHeaders != nullptr);
+    PAL_ASSERT(ppData != nullptr);
+
+    Result result    = Result::ErrorUnknown;
+    size_t writeSize = sizeof(ArchiveFileFooter);
+
+    if ((pHeaders == nullptr) ||
+        (ppData == nullptr))
     {
         result = Result::ErrorInvalidPointer;
     }
     else if (m_haveWriteAccess)
     {
-        // cache off the write location
-        uint32 curOffset = m_curFooterOffset;
+        result = Result::Success;
 
-        FastMemCpy(pHeader->entryMarker, MagicEntryMarker, sizeof(MagicEntryMarker));
-        pHeader->ordinalId    = m_cachedFooter.entryCount;
-        pHeader->nextBlock    = curOffset + sizeof(ArchiveEntryHeader) + pHeader->dataSize;
-        pHeader->dataPosition = curOffset + sizeof(ArchiveEntryHeader);
-        pHeader->dataCrc64    = Crc64(pData, pHeader->dataSize);
+        for (uint32 i = 0; i < count; ++i)
+        {
+            if (ppData[i] == nullptr)
+            {
+                result = Result::ErrorInvalidPointer;
+                break;
+            }
 
-        size_t writeSize = sizeof(ArchiveEntryHeader) + pHeader->dataSize + sizeof(ArchiveFileFooter);
+            writeSize += sizeof(ArchiveEntryHeader) + pHeaders[i].dataSize;
+        }
+    }
+    else
+    {
+        result = Result::Unsupported;
+    }
 
-        void* pBuffer = PAL_MALLOC(writeSize, Allocator(), AllocInternalTemp);
+    if ((result == Result::Success) &&
+        (count > 0))
+    {
+        void* const pBuffer = PAL_MALLOC(writeSize, Allocator(), AllocInternalTemp);
 
         if (pBuffer != nullptr)
         {
-            void* pOutData   = VoidPtrInc(pBuffer, sizeof(ArchiveEntryHeader));
-            void* pOutFooter = VoidPtrInc(pOutData, pHeader->dataSize);
+            // cache off the write location
+            const uint32 startOffset = m_curFooterOffset;
+            uint32       curOffset   = startOffset;
+
+            for (uint32 i = 0; i < count; ++i)
+            {
+                ArchiveEntryHeader* const pHeader = &pHeaders[i];
 
-            memcpy(pBuffer, pHeader, sizeof(ArchiveEntryHeader));
-            memcpy(pOutData, pData, pHeader->dataSize);
+                FastMemCpy(pHeader->entryMarker, MagicEntryMarker, sizeof(MagicEntryMarker));
+                pHeader->ordinalId    = m_cachedFooter.entryCount + i;
+                pHeader->nextBlock    = curOffset + sizeof(ArchiveEntryHeader) + pHeader->dataSize;
+                pHeader->dataPosition = curOffset + sizeof(ArchiveEntryHeader);
+                pHeader->dataCrc64    = Crc64(ppData[i], pHeader->dataSize);
+
+                void* const pOutHeader = VoidPtrInc(pBuffer, curOffset - startOffset);
+
+                memcpy(pOutHeader, pHeader, sizeof(ArchiveEntryHeader));
+                memcpy(VoidPtrInc(pOutHeader, sizeof(ArchiveEntryHeader)), ppData[i], pHeader->dataSize);
+
+                curOffset = pHeader->nextBlock;
+            }
+
+            void* const pOutFooter = VoidPtrInc(pBuffer, curOffset - startOffset);
             memcpy(pOutFooter, &m_cachedFooter, sizeof(ArchiveFileFooter));
 
             // Correct the footer we're about to attempt to write
-            static_cast<ArchiveFileFooter*>(pOutFooter)->entryCount += 1;
+            static_cast<ArchiveFileFooter*>(pOutFooter)->entryCount += count;
+
+            result = WriteInternal(startOffset, pBuffer, writeSize);
 
-            result = WriteInternal(curOffset, pBuffer, writeSize);
+            PAL_FREE(pBuffer, Allocator());
 
-            PAL_SAFE_FREE(pBuffer, Allocator());
             if (result == Result::Success)
             {
                 // Update our internal cache to reflect the result of the write
-                m_curFooterOffset = pHeader->nextBlock;
-                m_cachedFooter.entryCount += 1;
+                {
+                    RWLockAuto<RWLock::ReadWrite> fileLock { &m_fileLock };
+
+                    m_curFooterOffset          = curOffset;
+                    m_cachedFooter.entryCount += count;
+                }
 
-                result = m_entries.PushBack(*pHeader);
+                for (uint32 i = 0; (i < count) && (result == Result::Success); ++i)
+                {
+                    result = AddEntry(pHeaders[i]);
+                }
 
                 PAL_ALERT(IsErrorResult(result));
             }
@@ -695,10 +912,112 @@ Result ArchiveFile::Write(
             result = Result::ErrorOutOfMemory;
         }
     }
-    else
+
+    return result;
+}
+
+// =====================================================================================================================
+// Rewrite the archive so only live entries remain, stored back to back
+Result ArchiveFile::Compact(
+    const ArchiveCompactInfo* pCompactInfo)
+{
+    PAL_ASSERT(pCompactInfo != nullptr);
+
+    Result result = Result::Success;
+
+    if (pCompactInfo == nullptr)
+    {
+        result = Result::ErrorInvalidPointer;
+    }
+    else if (m_haveWriteAccess == false)
     {
         result = Result::Unsupported;
     }
+    else
+    {
+        // Make sure we know about everything that has been written to the file
+        result = RefreshFile(true);
+    }
+
+    uint32* pOrder     = nullptr;
+    uint32  orderCount = 0;
+
+    if (result == Result::Success)
+    {
+        const size_t entryCount = Max<size_t>(m_entries.NumElements(), 1);
+
+        pOrder = static_cast<uint32*>(PAL_MALLOC(sizeof(uint32) * entryCount, Allocator(), AllocInternalTemp));
+
+        if (pOrder != nullptr)
+        {
+            result = BuildCompactOrder(pCompactInfo, pOrder, &orderCount);
+        }
+        else
+        {
+            result = Result::ErrorOutOfMemory;
+        }
+    }
+
+    // The compacted archive is written next to the original and only replaces it once it is complete
+    char  tempPath[sizeof(m_fullPath) + 8] = {};
+    int32 hNewFile                         = InvalidFd;
+
+    if (result == Result::Success)
+    {
+        Strncpy(tempPath, m_fullPath, sizeof(tempPath));
+        Strncat(tempPath, sizeof(tempPath), ".compact");
+
+        hNewFile = open(tempPath, O_RDWR | O_CREAT, S_IRWXU);
+
+        if (hNewFile == InvalidFd)
+        {
+            result = Result::ErrorUnavailable;
+        }
+        // Take the same lock we hold on the original so the new file is already ours when it is renamed into place.
+        // Any leftover from an interrupted compaction is only truncated once we hold the lock.
+        else if ((flock(hNewFile, LOCK_EX | LOCK_NB) != 0) ||
+                 (ftruncate(hNewFile, 0) != 0))
+        {
+            close(hNewFile);
+            hNewFile = InvalidFd;
+            result   = Result::ErrorUnavailable;
+        }
+    }
+
+    ArchiveFileHeader newHeader = m_archiveHeader;
+
+    if (result == Result::Success)
+    {
+        result = WriteCompactFile(hNewFile, pOrder, orderCount, &newHeader);
+    }
+
+    // Make sure the new archive is on disc before it replaces the old one
+    if ((result == Result::Success) &&
+        (fsync(hNewFile) != 0))
+    {
+        result = Result::ErrorUnknown;
+    }
+
+    if ((result == Result::Success) &&
+        (rename(tempPath, m_fullPath) != 0))
+    {
+        result = Result::ErrorUnknown;
+    }
+
+    if (result == Result::Success)
+    {
+        result = ReplaceFile(hNewFile, newHeader);
+    }
+    else if (hNewFile != InvalidFd)
+    {
+        close(hNewFile);
+        remove(tempPath);
+    }
+
+    if (pOrder != nullptr)
+    {
+        PAL_FREE(pOrder, Allocator());
+    }
 
     return result;
 }
@@ -722,6 +1041,8 @@ Result ArchiveFile::RefreshFile(
 
     if (fstat(m_hFile, &statBuf) == 0)
     {
+        UpdateMappedSize(static_cast<size_t>(statBuf.st_size));
+
         if (m_fileSize == static_cast<uint64>(statBuf.st_size))
         {
             result = Result::Success;
@@ -752,6 +1073,8 @@ Result ArchiveFile::RefreshFile(
                 {
                     if (ValidateFooter(&tmpFooter))
                     {
+                        RWLockAuto<RWLock::ReadWrite> fileLock { &m_fileLock };
+
                         m_curFooterOffset = static_cast<uint32>(footerOffset);
                         m_cachedFooter    = tmpFooter;
                     }
@@ -774,20 +1097,7 @@ Result ArchiveFile::RefreshFile(
     // Repopulate our headers if we need to
     if (result == Result::Success)
     {
-        while ((m_entries.NumElements() < m_cachedFooter.entryCount) &&
-               (result == Result::Success))
-        {
-            ArchiveEntryHeader* pLast   = m_entries.IsEmpty() ? nullptr : &m_entries.Back();
-            ArchiveEntryHeader  header = {};
-
-            result = ReadNextEntry(pLast, &header);
-
-            if (result == Result::Success)
-            {
-                PAL_ALERT(header.ordinalId != m_entries.NumElements());
-                m_entries.PushBack(header);
-            }
-        }
+        result = ReadEntryHeaders();
 
         PAL_ALERT(IsErrorResult(result));
     }
@@ -834,39 +1144,793 @@ Result ArchiveFile::GetEntryByIndex(
 }
 
 // =====================================================================================================================
-// Attempt to read the next entry in
-Result ArchiveFile::ReadNextEntry(
-    const ArchiveEntryHeader* pCurheader,
-    ArchiveEntryHeader*       pNextHeader)
+// Read in the headers of any entries we don't know about yet. Once a header is found to be immediately followed by the
+// next one, the rest of that run of headers is pulled in with a single read. Compact() writes all headers back to back
+// so opening a compacted archive takes a couple of reads rather than one per entry.
+Result ArchiveFile::ReadEntryHeaders()
 {
-    Result result = Result::Eof;
-
-    size_t headerOffset = pCurheader != nullptr ? pCurheader->nextBlock : m_archiveHeader.firstBlock;
-
-    if (headerOffset < m_curFooterOffset)
+    Result              result       = Result::Success;
+    size_t              runLength    = 1;
+    ArchiveEntryHeader  singleHeader = {};
+    ArchiveEntryHeader* pRunHeaders  = nullptr;
+
+    // An archive that ends in an index can be loaded without touching the entry chain at all
+    if (m_entries.IsEmpty() &&
+        (m_cachedFooter.entryCount > 0))
     {
-        result = ReadInternal(headerOffset, pNextHeader, sizeof(ArchiveEntryHeader), false);
+        Result indexResult = LoadIndex();
+        PAL_ALERT((indexResult != Result::Success) && (indexResult != Result::NotFound));
     }
 
-    return result;
-}
-
-// =====================================================================================================================
-// Select and call the appropriate read method for this file
-Result ArchiveFile::ReadInternal(
-    size_t fileOffset,
-    void*  pBuffer,
-    size_t readSize,
-    bool   forceCacheReload)
-{
-    PAL_ASSERT(pBuffer != nullptr);
-
-    Result result = Result::ErrorUnknown;
-
-    if (m_useBufferedMemory)
+    while ((m_entries.NumElements() < m_cachedFooter.entryCount) &&
+           (result == Result::Success))
     {
-        result = ReadCached(fileOffset, pBuffer, readSize, forceCacheReload);
-    }
+        const size_t headerOffset = m_entries.IsEmpty() ? m_archiveHeader.firstBlock : m_entries.Back().nextBlock;
+        const size_t maxHeaders   = (headerOffset < m_curFooterOffset) ?
+                                    ((m_curFooterOffset - headerOffset) / sizeof(ArchiveEntryHeader)) : 0;
+        const size_t numHeaders   = Min(Min(runLength, maxHeaders),
+                                        static_cast<size_t>(m_cachedFooter.entryCount - m_entries.NumElements()));
+
+        ArchiveEntryHeader* pHeaders = &singleHeader;
+
+        if (numHeaders == 0)
+        {
+            result = Result::Eof;
+        }
+        else if (numHeaders > 1)
+        {
+            if (pRunHeaders == nullptr)
+            {
+                pRunHeaders = static_cast<ArchiveEntryHeader*>(
+                    PAL_MALLOC(sizeof(ArchiveEntryHeader) * MaxHeaderRun, Allocator(), AllocInternalTemp));
+            }
+
+            // Fall back to reading one header at a time if the run buffer isn't available
+            if (pRunHeaders != nullptr)
+            {
+                pHeaders = pRunHeaders;
+            }
+        }
+
+        const size_t readCount = (pHeaders == pRunHeaders) ? numHeaders : 1;
+
+        if (result == Result::Success)
+        {
+            result = ReadInternal(headerOffset, pHeaders, readCount * sizeof(ArchiveEntryHeader), false);
+        }
+
+        runLength = 1;
+
+        for (size_t i = 0; (i < readCount) && (result == Result::Success); ++i)
+        {
+            const ArchiveEntryHeader& header = pHeaders[i];
+
+            PAL_ALERT(header.ordinalId != m_entries.NumElements());
+            result = AddEntry(header);
+
+            // Anything after a header that isn't immediately followed by the next one is not a header
+            if (header.nextBlock != (headerOffset + ((i + 1) * sizeof(ArchiveEntryHeader))))
+            {
+                break;
+            }
+
+            runLength = MaxHeaderRun;
+        }
+    }
+
+    if (pRunHeaders != nullptr)
+    {
+        PAL_FREE(pRunHeaders, Allocator());
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Track an entry that was just read in or written
+Result ArchiveFile::AddEntry(
+    const ArchiveEntryHeader& header)
+{
+    RWLockAuto<RWLock::ReadWrite> indexLock { &m_indexLock };
+
+    Result result = m_entries.PushBack(header);
+
+    if ((result == Result::Success) &&
+        (header.dataType != ArchiveIndexDataType))
+    {
+        EntryKey key;
+        memcpy(key.value, header.entryKey, sizeof(key.value));
+
+        // Insert keeps any existing value, so lookups resolve to the first entry written with a key
+        result = m_unindexedKeys.Insert(key, header.ordinalId);
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Find the first entry written with the given key
+Result ArchiveFile::FindEntryByKey(
+    const uint8*        pEntryKey,
+    ArchiveEntryHeader* pHeader)
+{
+    PAL_ASSERT(pEntryKey != nullptr);
+    PAL_ASSERT(pHeader != nullptr);
+
+    Result result = Result::NotFound;
+
+    if ((pEntryKey == nullptr) ||
+        (pHeader == nullptr))
+    {
+        result = Result::ErrorInvalidPointer;
+    }
+    else
+    {
+        // Only the in-memory index is searched here, so lookups never touch the file. Callers that miss can Refresh()
+        // and search again.
+        RWLockAuto<RWLock::ReadOnly> indexLock { &m_indexLock };
+
+        uint32 ordinalId = 0;
+        bool   found     = false;
+
+        // Older indices hold older entries, so search them first
+        for (uint32 i = 0; (i < m_indexSegments.NumElements()) && (found == false); ++i)
+        {
+            const IndexSegment& segment = m_indexSegments.At(i);
+
+            found = FindIndexKey(segment.pKeys, segment.keyCount, pEntryKey, &ordinalId);
+        }
+
+        if (found == false)
+        {
+            EntryKey key;
+            memcpy(key.value, pEntryKey, sizeof(key.value));
+
+            const uint32* const pOrdinalId = m_unindexedKeys.FindKey(key);
+
+            if (pOrdinalId != nullptr)
+            {
+                ordinalId = *pOrdinalId;
+                found     = true;
+            }
+        }
+
+        if (found && (ordinalId < m_entries.NumElements()))
+        {
+            *pHeader = m_entries.At(ordinalId);
+            result   = Result::Success;
+        }
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Rebuild the entry table from the chain of indices ending at the end of the archive. Returns NotFound if the archive
+// does not end in an index. If any part of the chain can't be validated nothing is kept and the caller falls back to
+// walking the entry chain.
+Result ArchiveFile::LoadIndex()
+{
+    PAL_ASSERT(m_entries.IsEmpty());
+
+    struct LoadedIndex
+    {
+        ArchiveEntryHeader        header;
+        const ArchiveIndexHeader* pIndex;
+        void*                     pMemory;
+    };
+
+    constexpr size_t MinIndexSize = sizeof(ArchiveIndexHeader) + sizeof(ArchiveIndexLocator);
+
+    LoadedIndex         loaded[MaxIndexSegments] = {};
+    uint32              loadedCount              = 0;
+    ArchiveIndexLocator locator                  = {};
+    Result              result                   = Result::NotFound;
+
+    if (m_curFooterOffset >= (m_archiveHeader.firstBlock + sizeof(ArchiveEntryHeader) + MinIndexSize))
+    {
+        result = ReadInternal(m_curFooterOffset - sizeof(locator), &locator, sizeof(locator), false);
+
+        if ((result == Result::Success) &&
+            (memcmp(locator.indexMarker, MagicIndexMarker, sizeof(MagicIndexMarker)) != 0))
+        {
+            result = Result::NotFound;
+        }
+    }
+
+    uint32 indexBlock      = locator.indexBlock;
+    uint32 expectedOrdinal = m_cachedFooter.entryCount - 1;
+
+    while (result == Result::Success)
+    {
+        LoadedIndex* const        pLoaded = &loaded[loadedCount];
+        const ArchiveEntryHeader& header  = pLoaded->header;
+
+        result = ((indexBlock + sizeof(ArchiveEntryHeader)) <= m_curFooterOffset)            ?
+                 ReadInternal(indexBlock, &pLoaded->header, sizeof(ArchiveEntryHeader), false) :
+                 Result::ErrorInvalidValue;
+
+        // The most recent index must be the last entry, older ones are followed by the entries they don't describe
+        if ((result == Result::Success) &&
+            ((memcmp(header.entryMarker, MagicEntryMarker, sizeof(MagicEntryMarker)) != 0) ||
+             (header.dataType != ArchiveIndexDataType)                                      ||
+             (header.ordinalId != expectedOrdinal)                                          ||
+             (header.dataPosition != (indexBlock + sizeof(ArchiveEntryHeader)))             ||
+             (header.dataSize < MinIndexSize)                                               ||
+             ((header.dataPosition + header.dataSize) > m_curFooterOffset)                  ||
+             ((loadedCount == 0) && (header.nextBlock != m_curFooterOffset))))
+        {
+            result = Result::ErrorInvalidValue;
+        }
+
+        if (result == Result::Success)
+        {
+            // The index can be used straight out of the mapping rather than copied
+            if ((m_pMappedFile != nullptr) &&
+                ((header.dataPosition + header.dataSize) <= m_mappedSize))
+            {
+                pLoaded->pIndex = static_cast<const ArchiveIndexHeader*>(
+                    VoidPtrInc(m_pMappedFile, header.dataPosition));
+            }
+            else
+            {
+                pLoaded->pMemory = PAL_MALLOC(header.dataSize, Allocator(), AllocInternal);
+
+                if (pLoaded->pMemory != nullptr)
+                {
+                    result          = ReadInternal(header.dataPosition, pLoaded->pMemory, header.dataSize, false);
+                    pLoaded->pIndex = static_cast<const ArchiveIndexHeader*>(pLoaded->pMemory);
+                }
+                else
+                {
+                    result = Result::ErrorOutOfMemory;
+                }
+            }
+
+            // Count the index as loaded from here on so its memory is released on failure
+            loadedCount += 1;
+        }
+
+        if ((result == Result::Success) &&
+            (Crc64(pLoaded->pIndex, header.dataSize) != header.dataCrc64))
+        {
+            result = Result::ErrorInvalidValue;
+        }
+
+        if (result == Result::Success)
+        {
+            const ArchiveIndexHeader* const pIndex       = pLoaded->pIndex;
+            const size_t                    expectedSize = MinIndexSize                                       +
+                                                           (pIndex->entryCount * sizeof(ArchiveEntryHeader)) +
+                                                           (pIndex->keyCount * sizeof(ArchiveIndexKey));
+
+            if ((memcmp(pIndex->indexMarker, MagicIndexMarker, sizeof(MagicIndexMarker)) != 0) ||
+                ((pIndex->firstOrdinal + pIndex->entryCount) != header.ordinalId)              ||
+                (expectedSize != header.dataSize))
+            {
+                result = Result::ErrorInvalidValue;
+            }
+            // Reached the start of the archive
+            else if (pIndex->firstOrdinal == 0)
+            {
+                break;
+            }
+            else if (loadedCount == MaxIndexSegments)
+            {
+                result = Result::ErrorInvalidValue;
+            }
+            else
+            {
+                indexBlock      = pIndex->prevIndexBlock;
+                expectedOrdinal = pIndex->firstOrdinal - 1;
+            }
+        }
+    }
+
+    RWLockAuto<RWLock::ReadWrite> indexLock { &m_indexLock };
+
+    // Fill the entry table oldest first, each index is followed by its own entry
+    for (uint32 i = loadedCount; (i > 0) && (result == Result::Success); --i)
+    {
+        const LoadedIndex&              index    = loaded[i - 1];
+        const ArchiveIndexHeader* const pIndex   = index.pIndex;
+        const ArchiveEntryHeader* const pHeaders = static_cast<const ArchiveEntryHeader*>(
+            VoidPtrInc(pIndex, sizeof(ArchiveIndexHeader)));
+
+        for (uint32 entry = 0; (entry < pIndex->entryCount) && (result == Result::Success); ++entry)
+        {
+            PAL_ALERT(pHeaders[entry].ordinalId != m_entries.NumElements());
+            result = m_entries.PushBack(pHeaders[entry]);
+        }
+
+        if (result == Result::Success)
+        {
+            result = m_entries.PushBack(index.header);
+        }
+
+        if (result == Result::Success)
+        {
+            IndexSegment segment = {};
+            segment.pKeys        = static_cast<const ArchiveIndexKey*>(
+                VoidPtrInc(pHeaders, pIndex->entryCount * sizeof(ArchiveEntryHeader)));
+            segment.keyCount     = pIndex->keyCount;
+            segment.firstOrdinal = pIndex->firstOrdinal;
+            segment.entryCount   = pIndex->entryCount;
+            segment.indexBlock   = index.header.dataPosition - sizeof(ArchiveEntryHeader);
+            segment.pMemory      = index.pMemory;
+
+            result = m_indexSegments.PushBack(segment);
+        }
+    }
+
+    if (result == Result::Success)
+    {
+        m_indexedCount   = m_entries.NumElements();
+        m_lastIndexBlock = locator.indexBlock;
+    }
+    else
+    {
+        // Memory that made it into m_indexSegments is released by ResetIndex()
+        for (uint32 i = m_indexSegments.NumElements(); i < loadedCount; ++i)
+        {
+            PAL_SAFE_FREE(loaded[loadedCount - 1 - i].pMemory, Allocator());
+        }
+
+        ResetIndex();
+        m_entries.Clear();
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Append an index describing every entry since the last index, or every entry in the archive for a full index.
+//
+// The newest indices are merged into the new one while they describe no more than twice as many entries as it would
+// on its own. Index sizes then grow geometrically towards the start of the archive, so the chain stays short and each
+// entry is only ever copied into a logarithmic number of indices. The space held by merged indices is left for
+// Compact() to reclaim.
+Result ArchiveFile::WriteIndex(
+    bool fullIndex)
+{
+    PAL_ASSERT(m_haveWriteAccess);
+
+    uint32 keepSegments = (fullIndex || (m_indexedCount == 0)) ? 0 : m_indexSegments.NumElements();
+    uint32 firstOrdinal = m_indexedCount;
+
+    while ((keepSegments > 0) &&
+           ((keepSegments >= MaxIndexSegments) ||
+            (m_indexSegments.At(keepSegments - 1).entryCount <= (2 * (m_entries.NumElements() - firstOrdinal)))))
+    {
+        keepSegments--;
+        firstOrdinal = m_indexSegments.At(keepSegments).firstOrdinal;
+    }
+
+    if (keepSegments == 0)
+    {
+        firstOrdinal = 0;
+    }
+
+    const uint32 entryCount = m_entries.NumElements() - firstOrdinal;
+    uint32       keyCount     = 0;
+
+    for (uint32 i = firstOrdinal; i < m_entries.NumElements(); ++i)
+    {
+        keyCount += (m_entries.At(i).dataType != ArchiveIndexDataType) ? 1 : 0;
+    }
+
+    const size_t dataSize = sizeof(ArchiveIndexHeader)                      +
+                            (entryCount * sizeof(ArchiveEntryHeader))       +
+                            (keyCount * sizeof(ArchiveIndexKey))            +
+                            sizeof(ArchiveIndexLocator);
+
+    void* const pData  = PAL_MALLOC(dataSize, Allocator(), AllocInternal);
+    Result      result = (pData != nullptr) ? Result::Success : Result::ErrorOutOfMemory;
+
+    if (result == Result::Success)
+    {
+        ArchiveIndexHeader* const pIndex   = static_cast<ArchiveIndexHeader*>(pData);
+        ArchiveEntryHeader* const pHeaders = static_cast<ArchiveEntryHeader*>(VoidPtrInc(pIndex, sizeof(*pIndex)));
+        ArchiveIndexKey* const    pKeys    = static_cast<ArchiveIndexKey*>(
+            VoidPtrInc(pHeaders, entryCount * sizeof(ArchiveEntryHeader)));
+        ArchiveIndexLocator* const pLocator = static_cast<ArchiveIndexLocator*>(
+            VoidPtrInc(pKeys, keyCount * sizeof(ArchiveIndexKey)));
+
+        memcpy(pIndex->indexMarker, MagicIndexMarker, sizeof(MagicIndexMarker));
+        pIndex->firstOrdinal   = firstOrdinal;
+        pIndex->entryCount     = entryCount;
+        pIndex->keyCount       = keyCount;
+        pIndex->prevIndexBlock = (keepSegments == 0) ? 0 : m_indexSegments.At(keepSegments - 1).indexBlock;
+
+        uint32 keyIndex = 0;
+
+        for (uint32 i = 0; i < entryCount; ++i)
+        {
+            const ArchiveEntryHeader& header = m_entries.At(firstOrdinal + i);
+
+            pHeaders[i] = header;
+
+            if (header.dataType != ArchiveIndexDataType)
+            {
+                memcpy(pKeys[keyIndex].entryKey, header.entryKey, sizeof(header.entryKey));
+                pKeys[keyIndex].ordinalId = header.ordinalId;
+                keyIndex++;
+            }
+        }
+
+        qsort(pKeys, keyCount, sizeof(ArchiveIndexKey), CompareIndexKeys);
+
+        // The index entry is appended where the footer currently is
+        memcpy(pLocator->indexMarker, MagicIndexMarker, sizeof(MagicIndexMarker));
+        pLocator->indexBlock = m_curFooterOffset;
+
+        ArchiveEntryHeader indexHeader = {};
+        indexHeader.dataSize = static_cast<uint32>(dataSize);
+        indexHeader.dataType = ArchiveIndexDataType;
+
+        result = Write(&indexHeader, pData);
+
+        RWLockAuto<RWLock::ReadWrite> indexLock { &m_indexLock };
+
+        if (result == Result::Success)
+        {
+            // Drop the indices the new one replaces
+            while (m_indexSegments.NumElements() > keepSegments)
+            {
+                IndexSegment merged = {};
+                m_indexSegments.PopBack(&merged);
+
+                if (merged.pMemory != nullptr)
+                {
+                    PAL_FREE(merged.pMemory, Allocator());
+                }
+            }
+
+            IndexSegment segment = {};
+            segment.pKeys        = pKeys;
+            segment.keyCount     = keyCount;
+            segment.firstOrdinal = firstOrdinal;
+            segment.entryCount   = entryCount;
+            segment.indexBlock   = pLocator->indexBlock;
+            segment.pMemory      = pData;
+
+            result = m_indexSegments.PushBack(segment);
+        }
+
+        if (result == Result::Success)
+        {
+            m_indexedCount   = m_entries.NumElements();
+            m_lastIndexBlock = pLocator->indexBlock;
+            m_unindexedKeys.Reset();
+        }
+        else
+        {
+            PAL_FREE(pData, Allocator());
+        }
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Forget about every index, all entries are treated as unindexed until the next index is written
+void ArchiveFile::ResetIndex()
+{
+    for (uint32 i = 0; i < m_indexSegments.NumElements(); ++i)
+    {
+        if (m_indexSegments.At(i).pMemory != nullptr)
+        {
+            PAL_FREE(m_indexSegments.At(i).pMemory, Allocator());
+        }
+    }
+
+    m_indexSegments.Clear();
+    m_indexedCount   = 0;
+    m_lastIndexBlock = 0;
+}
+
+// =====================================================================================================================
+// Remember the order entries are first read in so Compact() can place entries that are used together next to each
+// other. Only archives we can write to are ever compacted so there is nothing to track otherwise.
+void ArchiveFile::RecordAccess(
+    uint32 ordinalId)
+{
+    if (m_haveWriteAccess)
+    {
+        MutexAuto accessLock { &m_accessLock };
+
+        if (m_accessedEntries.Contains(ordinalId) == false)
+        {
+            Result result = m_accessedEntries.Insert(ordinalId);
+
+            if (result == Result::Success)
+            {
+                result = m_accessOrder.PushBack(ordinalId);
+            }
+
+            PAL_ALERT(IsErrorResult(result));
+        }
+    }
+}
+
+// =====================================================================================================================
+// Pick the entries that survive compaction and the order they are written in: entries in the order they were first
+// read, followed by the entries that were never read in their original order. pOrder must have room for every entry.
+Result ArchiveFile::BuildCompactOrder(
+    const ArchiveCompactInfo* pCompactInfo,
+    uint32*                   pOrder,
+    uint32*                   pOrderCount)
+{
+    using EntryKeySet = HashSet<EntryKey, ForwardAllocator, JenkinsHashFunc>;
+
+    const uint32 entryCount = m_entries.NumElements();
+    uint32       orderCount = 0;
+    Result       result     = Result::Success;
+
+    // Entries that are already placed or are being dropped
+    bool* const pSkip = static_cast<bool*>(PAL_CALLOC(sizeof(bool) * Max(entryCount, 1u),
+                                                      Allocator(),
+                                                      AllocInternalTemp));
+
+    if (pSkip == nullptr)
+    {
+        result = Result::ErrorOutOfMemory;
+    }
+
+    // Lookups resolve to the first entry written for a key, so that is the one we keep
+    if ((result == Result::Success) &&
+        pCompactInfo->discardDuplicateKeys)
+    {
+        EntryKeySet keys(MaxHeaderRun / 8, Allocator());
+
+        result = keys.Init();
+
+        for (uint32 i = 0; (i < entryCount) && (result == Result::Success); ++i)
+        {
+            EntryKey key;
+            memcpy(key.value, m_entries.At(i).entryKey, sizeof(key.value));
+
+            if (keys.Contains(key))
+            {
+                pSkip[i] = true;
+            }
+            else
+            {
+                result = keys.Insert(key);
+            }
+        }
+    }
+
+    // Any index is rebuilt once the archive has been rewritten
+    for (uint32 i = 0; (i < entryCount) && (result == Result::Success); ++i)
+    {
+        if (m_entries.At(i).dataType == ArchiveIndexDataType)
+        {
+            pSkip[i] = true;
+        }
+    }
+
+    if (result == Result::Success)
+    {
+        MutexAuto accessLock { &m_accessLock };
+
+        for (uint32 i = 0; i < m_accessOrder.NumElements(); ++i)
+        {
+            const uint32 ordinalId = m_accessOrder.At(i);
+
+            if ((ordinalId < entryCount) &&
+                (pSkip[ordinalId] == false))
+            {
+                pSkip[ordinalId]     = true;
+                pOrder[orderCount++] = ordinalId;
+            }
+        }
+    }
+
+    if (result == Result::Success)
+    {
+        for (uint32 i = 0; i < entryCount; ++i)
+        {
+            if (pSkip[i] == false)
+            {
+                pOrder[orderCount++] = i;
+            }
+        }
+
+        *pOrderCount = orderCount;
+    }
+
+    if (pSkip != nullptr)
+    {
+        PAL_FREE(pSkip, Allocator());
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Write the entries listed in pOrder to a new archive file. The layout is the file header, all entry data back to back,
+// then all entry headers back to back followed by the footer. Entries whose data can't be read back or fails its
+// checksum are dropped while copying, which is why the headers are written last.
+Result ArchiveFile::WriteCompactFile(
+    int32              hNewFile,
+    const uint32*      pOrder,
+    uint32             orderCount,
+    ArchiveFileHeader* pNewHeader)
+{
+    size_t maxDataSize = 1;
+
+    for (uint32 i = 0; i < orderCount; ++i)
+    {
+        maxDataSize = Max<size_t>(maxDataSize, m_entries.At(pOrder[i]).dataSize);
+    }
+
+    const size_t headerBlockSize = (sizeof(ArchiveEntryHeader) * orderCount) + sizeof(ArchiveFileFooter);
+
+    void* const               pData    = PAL_MALLOC(maxDataSize, Allocator(), AllocInternalTemp);
+    ArchiveEntryHeader* const pHeaders = static_cast<ArchiveEntryHeader*>(
+        PAL_MALLOC(headerBlockSize, Allocator(), AllocInternalTemp));
+
+    Result result = ((pData != nullptr) && (pHeaders != nullptr)) ? Result::Success : Result::ErrorOutOfMemory;
+
+    size_t writeOffset = sizeof(ArchiveFileHeader);
+    uint32 keptCount   = 0;
+
+    for (uint32 i = 0; (i < orderCount) && (result == Result::Success); ++i)
+    {
+        const ArchiveEntryHeader& header     = m_entries.At(pOrder[i]);
+        Result                    readResult = Result::ErrorInvalidValue;
+
+        if ((header.dataPosition + header.dataSize) <= m_curFooterOffset)
+        {
+            readResult = ReadInternal(header.dataPosition, pData, header.dataSize, false);
+        }
+
+        if ((readResult == Result::Success) &&
+            (Crc64(pData, header.dataSize) == header.dataCrc64))
+        {
+            result = WriteDirect(hNewFile, writeOffset, pData, header.dataSize);
+
+            pHeaders[keptCount]              = header;
+            pHeaders[keptCount].ordinalId    = keptCount;
+            pHeaders[keptCount].dataPosition = static_cast<uint32>(writeOffset);
+
+            writeOffset += header.dataSize;
+            keptCount   += 1;
+        }
+        else
+        {
+            // Bad entries are dropped rather than failing the whole compaction
+            PAL_ALERT_ALWAYS();
+        }
+    }
+
+    if (result == Result::Success)
+    {
+        const size_t headerOffset = writeOffset;
+
+        for (uint32 i = 0; i < keptCount; ++i)
+        {
+            // The last header points at the footer, which is where the next entry will be appended
+            pHeaders[i].nextBlock = static_cast<uint32>(headerOffset + ((i + 1) * sizeof(ArchiveEntryHeader)));
+        }
+
+        ArchiveFileFooter* const pFooter = reinterpret_cast<ArchiveFileFooter*>(&pHeaders[keptCount]);
+
+        *pFooter                    = m_cachedFooter;
+        pFooter->entryCount         = keptCount;
+        pFooter->lastWriteTimestamp = GetCurrentFileTime();
+
+        pNewHeader->firstBlock = static_cast<uint32>(headerOffset);
+
+        result = WriteDirect(hNewFile,
+                             headerOffset,
+                             pHeaders,
+                             (sizeof(ArchiveEntryHeader) * keptCount) + sizeof(ArchiveFileFooter));
+    }
+
+    if (result == Result::Success)
+    {
+        result = WriteDirect(hNewFile, 0, pNewHeader, sizeof(ArchiveFileHeader));
+    }
+
+    if (pData != nullptr)
+    {
+        PAL_FREE(pData, Allocator());
+    }
+
+    if (pHeaders != nullptr)
+    {
+        PAL_FREE(pHeaders, Allocator());
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Switch over to the compacted archive once it has been renamed over the original. Everything known about the old file
+// is thrown away and read back in from the new one.
+Result ArchiveFile::ReplaceFile(
+    int32                    hNewFile,
+    const ArchiveFileHeader& newHeader)
+{
+    const bool wasMapped = (m_pMappedFile != nullptr);
+
+    {
+        // Wait for any reads still copying out of the old file before it is unmapped and closed
+        RWLockAuto<RWLock::ReadWrite> fileLock { &m_fileLock };
+
+        if (wasMapped)
+        {
+            munmap(m_pMappedFile, MaxMappedSize);
+            m_pMappedFile = nullptr;
+            m_mappedSize  = 0;
+        }
+
+        close(m_hFile);
+
+        m_hFile           = hNewFile;
+        m_archiveHeader   = newHeader;
+        m_fileSize        = 0;
+        m_curFooterOffset = 0;
+        m_cachedFooter    = {};
+
+        if (wasMapped)
+        {
+            Result mapResult = InitMapping();
+            PAL_ALERT(IsErrorResult(mapResult));
+        }
+    }
+
+    {
+        RWLockAuto<RWLock::ReadWrite> indexLock { &m_indexLock };
+
+        m_entries.Clear();
+        ResetIndex();
+    }
+
+    {
+        MutexAuto accessLock { &m_accessLock };
+
+        m_accessedEntries.Reset();
+        m_accessOrder.Clear();
+    }
+
+    // Cached pages stay on the LRU list and are recycled as they fall off the back of it
+    m_pageLookup.Reset();
+    m_lastMissPageIndex = -1;
+    m_readaheadPages    = 1;
+
+    Result result = RefreshFile(true);
+
+    if (result == Result::Success)
+    {
+        result = WriteIndex(true);
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Select and call the appropriate read method for this file
+Result ArchiveFile::ReadInternal(
+    size_t fileOffset,
+    void*  pBuffer,
+    size_t readSize,
+    bool   forceCacheReload)
+{
+    PAL_ASSERT(pBuffer != nullptr);
+
+    Result result = Result::ErrorUnknown;
+
+    if (m_pMappedFile != nullptr)
+    {
+        result = ReadMapped(fileOffset, pBuffer, readSize);
+    }
+    else if (m_useBufferedMemory)
+    {
+        result = ReadCached(fileOffset, pBuffer, readSize, forceCacheReload);
+    }
 
     if (result != Result::Success)
     {
@@ -889,6 +1953,13 @@ Result ArchiveFile::WriteInternal(
 
     result = WriteDirect(m_hFile, fileOffset, pData, writeSize);
 
+    // The mapping is shared with the file so new data is visible through it as soon as the write completes
+    if ((m_pMappedFile != nullptr) &&
+        (result == Result::Success))
+    {
+        UpdateMappedSize(fileOffset + writeSize);
+    }
+
     // Update the cached pages if needed
     if ((m_useBufferedMemory) &&
         (result == Result::Success))
@@ -1001,6 +2072,62 @@ Result ArchiveFile::WriteCached(
     return result;
 }
 
+// =====================================================================================================================
+// Map the whole archive address range read-only. Any failure leaves us on the direct read path.
+Result ArchiveFile::InitMapping()
+{
+    Result result = Result::Success;
+
+    void* const pMem = mmap(nullptr, MaxMappedSize, PROT_READ, MAP_SHARED, m_hFile, 0);
+
+    if (pMem != MAP_FAILED)
+    {
+        m_pMappedFile = pMem;
+    }
+    else
+    {
+        result = Result::ErrorOutOfMemory;
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Copy data out of the read-only mapping of the file. Data past the range known to be backed by the file is reported
+// as not found so the caller falls back to a direct read rather than faulting on a page past the end of the file.
+Result ArchiveFile::ReadMapped(
+    size_t fileOffset,
+    void*  pBuffer,
+    size_t readSize
+    ) const
+{
+    PAL_ASSERT(m_pMappedFile != nullptr);
+
+    Result result = Result::NotFound;
+
+    if ((fileOffset + readSize) <= static_cast<size_t>(AtomicReadRelaxed64(&m_mappedSize)))
+    {
+        memcpy(pBuffer, VoidPtrInc(m_pMappedFile, fileOffset), readSize);
+        result = Result::Success;
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Record that the file is known to be at least fileSize bytes long. The mapped size only ever grows since the archive
+// is append only.
+void ArchiveFile::UpdateMappedSize(
+    size_t fileSize)
+{
+    const uint64 newSize = Min(fileSize, MaxMappedSize);
+
+    if (newSize > m_mappedSize)
+    {
+        AtomicExchange64(&m_mappedSize, newSize);
+    }
+}
+
 // =====================================================================================================================
 // Initial cache pages to an empty state
 Result ArchiveFile::InitPages()
@@ -1014,6 +2141,8 @@ Result ArchiveFile::InitPages()
         PAL_ALERT(totalMemorySize < MinPageSize);
 
         m_pageSize = Max(Pow2Pad(totalMemorySize / MaxPageCount), MinPageSize);
+
+        result = m_pageLookup.Init();
     }
 
     return result;
@@ -1026,80 +2155,207 @@ ArchiveFile::PageInfo* ArchiveFile::FindPage(
     bool   loadOnMiss,
     bool   forceReload)
 {
-    PageInfo* pFoundPage = nullptr;
+    const int32 pageIndex  = CalcPageIndex(fileOffset);
+    PageInfo**  ppPage     = m_pageLookup.FindKey(pageIndex);
+    PageInfo*   pFoundPage = (ppPage != nullptr) ? *ppPage : nullptr;
 
-    // Find the existing page first.
-    for (PageInfo::Iter i = m_recentList.Begin(); i.IsValid(); i.Next())
+    if (pFoundPage != nullptr)
     {
-        PageInfo* const pCurPage = i.Get();
-        if (pCurPage->Contains(fileOffset) != nullptr)
+        if (forceReload &&
+            (pFoundPage->IsLoaded()))
+        {
+            Result reloadResult = pFoundPage->Reload(m_hFile);
+            PAL_ALERT(IsErrorResult(reloadResult));
+        }
+    }
+    else if (loadOnMiss)
+    {
+        // Grow the readahead window while misses keep landing on the page after the previous one. Any other access
+        // pattern goes back to loading a single page.
+        if (pageIndex == (m_lastMissPageIndex + 1))
+        {
+            m_readaheadPages = Min(m_readaheadPages * 2, MaxReadaheadPages);
+        }
+        else
+        {
+            m_readaheadPages = 1;
+        }
+
+        m_lastMissPageIndex = pageIndex;
+
+        pFoundPage = LoadPages(pageIndex, m_readaheadPages);
+    }
+
+    // "Touch" the current page to make it recently used
+    if (pFoundPage != nullptr)
+    {
+        PageInfo::Node* pNode = pFoundPage->ListNode();
+        if (pNode->InList())
+        {
+            m_recentList.Erase(pNode);
+        }
+
+        m_recentList.PushFront(pNode);
+    }
+
+    return pFoundPage;
+}
+
+// =====================================================================================================================
+// Get a page to load new data into. All pages are allocated before the least recently used page is recycled.
+ArchiveFile::PageInfo* ArchiveFile::AcquirePage()
+{
+    PageInfo* pPage = nullptr;
+
+    // The linear allocator does not bound allocations to its reservation, so stop at the budget ourselves.
+    if ((m_pageCount < MaxPageCount) && (m_bufferMemory.Remaining() >= m_pageSize))
+    {
+        void* pMem = PAL_MALLOC(m_pageSize, &m_bufferMemory, AllocInternal);
+        PAL_ALERT(pMem == nullptr);
+
+        if (pMem != nullptr)
+        {
+            pPage = &m_pages[m_pageCount];
+            pPage->Init(pMem, m_pageSize);
+            m_pageCount += 1;
+        }
+    }
+
+    if ((pPage == nullptr) && (m_recentList.IsEmpty() == false))
+    {
+        pPage = m_recentList.Back();
+
+        // Pages that failed to load are recycled without ever having been added to the lookup
+        const int32      oldPageIndex = CalcPageIndex(pPage->BeginOffset());
+        PageInfo** const ppMapped     = m_pageLookup.FindKey(oldPageIndex);
+
+        if ((ppMapped != nullptr) && (*ppMapped == pPage))
+        {
+            m_pageLookup.Erase(oldPageIndex);
+        }
+
+        m_recentList.Erase(pPage->ListNode());
+    }
+
+    return pPage;
+}
+
+// =====================================================================================================================
+// Load a run of consecutive pages starting at pageIndex using a single vectored read. Returns the page holding
+// pageIndex, the rest of the run is readahead and is placed in the LRU list behind it.
+ArchiveFile::PageInfo* ArchiveFile::LoadPages(
+    int32  pageIndex,
+    uint32 numPages)
+{
+    PAL_ASSERT((numPages > 0) && (numPages <= MaxReadaheadPages));
+
+    PageInfo*    pages[MaxReadaheadPages] = {};
+    struct iovec ioVecs[MaxReadaheadPages];
+    uint32       pageCount = 0;
+
+    // Stop the run early at the end of the file or at a page that is already cached
+    const size_t firstOffset = static_cast<size_t>(pageIndex) * m_pageSize;
+    if (m_fileSize > 0)
+    {
+        const size_t remaining = (m_fileSize > firstOffset) ? (static_cast<size_t>(m_fileSize) - firstOffset) : 0;
+        numPages = Max(Min(numPages, static_cast<uint32>(Pow2Align(remaining, m_pageSize) / m_pageSize)), 1u);
+    }
+
+    for (uint32 i = 0; i < numPages; ++i)
+    {
+        if ((i > 0) && (m_pageLookup.FindKey(pageIndex + i) != nullptr))
+        {
+            break;
+        }
+
+        PageInfo* const pPage = AcquirePage();
+
+        if (pPage == nullptr)
         {
-            pFoundPage = pCurPage;
-            if (forceReload &&
-                (pFoundPage->IsLoaded()))
-            {
-                Result reloadResult = pFoundPage->Reload(m_hFile, false);
-                PAL_ALERT(IsErrorResult(reloadResult));
-            }
             break;
         }
+
+        pPage->SetBeginOffset(firstOffset + (i * m_pageSize));
+
+        pages[pageCount]           = pPage;
+        ioVecs[pageCount].iov_base = pPage->Memory();
+        ioVecs[pageCount].iov_len  = pPage->MemSize();
+        pageCount++;
     }
 
-    if ((pFoundPage == nullptr) &&
-        loadOnMiss)
+    Result result = (pageCount > 0) ? Result::Success : Result::ErrorOutOfMemory;
+
+    if (result == Result::Success)
     {
-        size_t pageBaseAddress = CalcPageIndex(fileOffset) * m_pageSize;
+        ssize_t bytesRead = InvalidSysCall;
 
-        // Alloc all pages before recycling
-        if (m_pageCount < MaxPageCount)
+        do
         {
-            void* pMem = PAL_MALLOC(m_pageSize, &m_bufferMemory, AllocInternal);
-            PAL_ALERT(pMem == nullptr);
+            bytesRead = preadv(m_hFile, ioVecs, static_cast<int32>(pageCount), static_cast<off_t>(firstOffset));
+        } while ((bytesRead == InvalidSysCall) && (errno == EINTR));
 
-            if (pMem != nullptr)
+        if (bytesRead == InvalidSysCall)
+        {
+            result = Result::ErrorUnknown;
+        }
+        else
+        {
+            // A short read is expected at the end of the file. Otherwise finish off any page the kernel cut short.
+            size_t pageEnd = 0;
+
+            for (uint32 i = 0; (i < pageCount) && (result == Result::Success); ++i)
             {
-                m_pages[m_pageCount].Init(pMem, m_pageSize);
+                const size_t pageBegin = pageEnd;
+                pageEnd += pages[i]->MemSize();
 
-                if (m_pages[m_pageCount].Load(m_hFile, pageBaseAddress, false) == Result::Success)
-                {
-                    pFoundPage   = &m_pages[m_pageCount];
-                    m_pageCount += 1;
-                }
-                else
+                if (static_cast<size_t>(bytesRead) < pageEnd)
                 {
-                    PAL_ALERT_ALWAYS();
-                    m_bufferMemory.Rewind(pMem, false);
+                    const size_t pageBytesRead = (static_cast<size_t>(bytesRead) > pageBegin) ?
+                                                 (static_cast<size_t>(bytesRead) - pageBegin) : 0;
+                    size_t       bytesLeft     = 0;
+
+                    result = ReadDirect(m_hFile,
+                                        pages[i]->BeginOffset() + pageBytesRead,
+                                        VoidPtrInc(pages[i]->Memory(), pageBytesRead),
+                                        pages[i]->MemSize() - pageBytesRead,
+                                        &bytesLeft);
+
+                    // Nothing more to read past the end of the file
+                    if ((result == Result::Success) && (pageBytesRead + bytesLeft < pages[i]->MemSize()))
+                    {
+                        break;
+                    }
                 }
             }
         }
+    }
+
+    PageInfo* pFoundPage = nullptr;
+
+    // Insert the pages in reverse so the page that was asked for ends up the most recently used
+    for (uint32 i = pageCount; i > 0; --i)
+    {
+        PageInfo* const pPage = pages[i - 1];
 
-        // Pull the least recently used page
-        if ((pFoundPage == nullptr) && (m_recentList.IsEmpty() != true))
+        if ((result == Result::Success) &&
+            (m_pageLookup.Insert(pageIndex + static_cast<int32>(i - 1), pPage) == Result::Success))
         {
-            PageInfo* pRecyclePage = m_recentList.Back();
-            if (pRecyclePage->Load(m_hFile, pageBaseAddress, false) == Result::Success)
-            {
-                pFoundPage = pRecyclePage;
-            }
-            else
+            m_recentList.PushFront(pPage->ListNode());
+
+            if (i == 1)
             {
-                PAL_ALERT_ALWAYS();
+                pFoundPage = pPage;
             }
         }
-    }
-
-    // "Touch" the current page to make it recently used
-    if (pFoundPage != nullptr)
-    {
-        PageInfo::Node* pNode = pFoundPage->ListNode();
-        if (pNode->InList())
+        else
         {
-            m_recentList.Erase(pNode);
+            // The page holds nothing valid, make it the first to be recycled
+            m_recentList.PushBack(pPage->ListNode());
         }
-
-        m_recentList.PushFront(pNode);
     }
 
+    PAL_ALERT(pFoundPage == nullptr);
+
     return pFoundPage;
 }
 
@@ -1123,15 +2379,16 @@ void* ArchiveFile::PageInfo::Contains(
 }
 
 // =====================================================================================================================
-// Pull a page in from the disk using the appropriate method
+// Pull a page in from the disk. The page may extend past the end of the file, anything not read is left as-is.
 Result ArchiveFile::PageInfo::Load(
     int32  hFile,
-    size_t fileOffset,
-    bool   useAsyncIo)
+    size_t fileOffset)
 {
     m_beginOffset = fileOffset;
 
-    return ReadDirect(hFile, fileOffset, m_pMem, m_memSize);
+    size_t bytesRead = 0;
+
+    return ReadDirect(hFile, fileOffset, m_pMem, m_memSize, &bytesRead);
 }
 
 // =====================================================================================================================
@@ -1276,4 +2533,61 @@ Result DeleteArchiveFile(
     return result;
 }
 
+// =====================================================================================================================
+// Open an archive file just long enough to compact it
+Result CompactArchiveFile(
+    const ArchiveFileOpenInfo* pOpenInfo,
+    const ArchiveCompactInfo*  pCompactInfo)
+{
+    PAL_ASSERT(pOpenInfo != nullptr);
+    PAL_ASSERT(pCompactInfo != nullptr);
+
+    Result result = Result::Success;
+
+    if ((pOpenInfo == nullptr) ||
+        (pCompactInfo == nullptr))
+    {
+        result = Result::ErrorInvalidPointer;
+    }
+
+    if (result == Result::Success)
+    {
+        ArchiveFileOpenInfo openInfo  = *pOpenInfo;
+        AllocCallbacks      callbacks = {};
+
+        openInfo.allowCreateFile  = false;
+        openInfo.allowWriteAccess = true;
+
+        if (openInfo.pMemoryCallbacks == nullptr)
+        {
+            Pal::GetDefaultAllocCb(&callbacks);
+            openInfo.pMemoryCallbacks = &callbacks;
+        }
+
+        ForwardAllocator allocator(*openInfo.pMemoryCallbacks);
+        void* const      pMem = PAL_MALLOC(GetArchiveFileObjectSize(&openInfo), &allocator, AllocInternalTemp);
+
+        if (pMem != nullptr)
+        {
+            IArchiveFile* pArchiveFile = nullptr;
+
+            result = OpenArchiveFile(&openInfo, pMem, &pArchiveFile);
+
+            if (result == Result::Success)
+            {
+                result = pArchiveFile->Compact(pCompactInfo);
+                pArchiveFile->Destroy();
+            }
+
+            PAL_FREE(pMem, &allocator);
+        }
+        else
+        {
+            result = Result::ErrorOutOfMemory;
+        }
+    }
+
+    return result;
+}
+
 } //namespace Util
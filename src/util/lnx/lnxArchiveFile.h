@@ -24,8 +24,11 @@
  **********************************************************************************************************************/
 #include "palArchiveFile.h"
 #include "palArchiveFileFmt.h"
+#include "palHashMap.h"
+#include "palHashSet.h"
 #include "palIntrusiveList.h"
 #include "palLinearAllocator.h"
+#include "palMutex.h"
 #include "palVector.h"
 
 namespace Util
@@ -71,6 +74,24 @@ public:
         ArchiveEntryHeader* pHeader,
         const void*         pData) override;
 
+    virtual Result WriteBatch(
+        ArchiveEntryHeader* pHeaders,
+        const void* const*  ppData,
+        uint32              count) override;
+
+    virtual Result FindEntryByKey(
+        const uint8*        pEntryKey,
+        ArchiveEntryHeader* pHeader) override;
+
+    virtual Result Refresh() override { return RefreshFile(false); }
+
+    virtual bool   SupportsKeyLookup() const override { return true; }
+
+    virtual bool   SupportsConcurrentReads() const override { return (m_useBufferedMemory == false); }
+
+    virtual Result Compact(
+        const ArchiveCompactInfo* pCompactInfo) override;
+
     virtual void   Destroy() override { this->~ArchiveFile(); }
 
 private:
@@ -95,11 +116,15 @@ private:
         void Init(void* pMem, size_t memSize) { m_pMem = pMem; m_memSize = memSize; }
 
         // Page->Memory interface
-        void* Contains(size_t offset);
+        void*  Contains(size_t offset);
+        void*  Memory() const { return m_pMem; }
+        size_t MemSize() const { return m_memSize; }
+        size_t BeginOffset() const { return m_beginOffset; }
 
         // I/O Control
-        Result Load(int32 fd, size_t fileOffset, bool useAsyncIo);
-        Result Reload(int32 fd, bool useAsyncIo) { return Load(fd, m_beginOffset, useAsyncIo); }
+        Result Load(int32 fd, size_t fileOffset);
+        Result Reload(int32 fd) { return Load(fd, m_beginOffset); }
+        void   SetBeginOffset(size_t fileOffset) { m_beginOffset = fileOffset; }
         bool   IsLoaded() { return true; }
         void   Wait() {}
 
@@ -115,13 +140,47 @@ private:
         Node         m_node;        // Page's position in an LRU chain
     };
 
+    // Helper type for ArchiveEntryHeader::entryKey
+    struct EntryKey
+    {
+        uint8 value[sizeof(ArchiveEntryHeader::entryKey)];
+    };
+
+    // Sorted key table of an index stored in the archive
+    struct IndexSegment
+    {
+        const ArchiveIndexKey* pKeys;
+        uint32                 keyCount;
+        uint32                 firstOrdinal; // First entry described by the index
+        uint32                 entryCount;   // Number of entries described by the index, not counting the index itself
+        uint32                 indexBlock;   // Offset of the index entry's header
+        void*                  pMemory;      // Allocation holding the index data, nullptr if pKeys points into the mapping
+    };
+
     Result RefreshFile(bool forceRefresh);
 
-    Result ReadNextEntry(const ArchiveEntryHeader* pCurheader, ArchiveEntryHeader* pNextHeader);
+    Result ReadEntryHeaders();
+    Result AddEntry(const ArchiveEntryHeader& header);
+
+    // Entry indices
+    Result LoadIndex();
+    Result WriteIndex(bool fullIndex);
+    void   ResetIndex();
+
+    // Compaction
+    void   RecordAccess(uint32 ordinalId);
+    Result BuildCompactOrder(const ArchiveCompactInfo* pCompactInfo, uint32* pOrder, uint32* pOrderCount);
+    Result WriteCompactFile(int32 hNewFile, const uint32* pOrder, uint32 orderCount, ArchiveFileHeader* pNewHeader);
+    Result ReplaceFile(int32 hNewFile, const ArchiveFileHeader& newHeader);
 
     Result ReadInternal(size_t fileOffset, void* pBuffer, size_t readSize, bool forceCacheReload);
     Result WriteInternal(size_t fileOffset, const void* pData, size_t writeSize);
 
+    // Memory mapped I/O API
+    Result InitMapping();
+    Result ReadMapped(size_t fileOffset, void* pBuffer, size_t readSize) const;
+    void   UpdateMappedSize(size_t fileSize);
+
     // "Cached" I/O API
     Result ReadCached(size_t fileOffset, void* pBuffer, size_t readSize, bool forceReload);
     Result WriteCached(size_t fileOffset, const void* pData, size_t writeSize);
@@ -129,6 +188,8 @@ private:
     // Page management
     Result    InitPages();
     PageInfo* FindPage(size_t fileOffset, bool loadOnMiss, bool forceReload);
+    PageInfo* AcquirePage();
+    PageInfo* LoadPages(int32 pageIndex, uint32 numPages);
     int32     CalcPageIndex(size_t fileOffset) const        { return static_cast<int32>(fileOffset / m_pageSize); }
     size_t    CalcNextPageBoundary(size_t fileOffset) const { return (CalcPageIndex(fileOffset) + 1) * m_pageSize; }
 
@@ -137,30 +198,78 @@ private:
     static constexpr size_t MaxPageSize  = 8 * 1024 * 1024;
     static constexpr size_t MinPageSize  = 256 * 1024;
 
+    // Sequential misses grow the readahead window up to this many pages, all filled by a single read
+    static constexpr uint32 MaxReadaheadPages = 8;
+
+    // Largest number of back to back entry headers pulled in by a single read when opening the archive
+    static constexpr size_t MaxHeaderRun = 4096;
+
+    // Longest chain of indices we follow when opening the archive, older indices are merged into a new one rather than
+    // growing the chain past this
+    static constexpr uint32 MaxIndexSegments = 8;
+
+    // All archive offsets are 32-bit so a mapping of this size covers any archive for the lifetime of the object. The
+    // file may grow into the mapping, but only the range known to be backed by the file is ever touched.
+    static constexpr size_t MaxMappedSize = UINT32_MAX;
+
     using EntryVector = Vector<ArchiveEntryHeader, 16, ForwardAllocator>;
+    using PageMap     = HashMap<int32, PageInfo*, ForwardAllocator, JenkinsHashFunc>;
+    using OrdinalSet  = HashSet<uint32, ForwardAllocator, JenkinsHashFunc>;
+    using OrdinalList = Vector<uint32, 16, ForwardAllocator>;
+    using EntryKeyMap = HashMap<EntryKey, uint32, ForwardAllocator, JenkinsHashFunc>;
+    using IndexList   = Vector<IndexSegment, MaxIndexSegments, ForwardAllocator>;
 
     // Allocator
     ForwardAllocator*       Allocator() { return &m_allocator; }
     ForwardAllocator        m_allocator;
 
-    // File information
-    const int32             m_hFile;
-    const ArchiveFileHeader m_archiveHeader;
+    // File information, the file handle and header only change when Compact() replaces the file
+    int32                   m_hFile;
+    ArchiveFileHeader       m_archiveHeader;
+    char                    m_fullPath[MaxPathLength + MaxFilenameLength + 1];
     uint64                  m_fileSize;
     ArchiveFileFooter       m_cachedFooter;
     uint32                  m_curFooterOffset;
     EntryVector             m_entries;
 
+    // Concurrent Read() calls hold m_fileLock shared while they check the footer and copy from the file. Code that
+    // changes the footer, the file handle or the mapping holds it exclusively around the change itself.
+    RWLock                  m_fileLock;
+
+    // Entry lookup by key. Entries below m_indexedCount are found through the sorted key tables of the indices stored
+    // in the archive, anything after that is tracked in a hash map until the next index is written.
+    //
+    // FindEntryByKey() may run alongside the externally synchronized calls, so it reads m_entries and these members
+    // under a shared m_indexLock. Code that changes them is already serialized by the caller and only takes the lock
+    // exclusively around the change itself, never across file I/O.
+    RWLock                  m_indexLock;
+    IndexList               m_indexSegments;   // Oldest first
+    uint32                  m_indexedCount;
+    uint32                  m_lastIndexBlock;  // Offset of the most recent index entry, 0 if there is none
+    EntryKeyMap             m_unindexedKeys;
+
     // Write components: MAY NOT BE INITIALIZED IF WE DON'T HAVE WRITE ACCESS
     const bool              m_haveWriteAccess;
 
+    // Order entries were first read in, used by Compact() to place entries that are used together next to each other
+    Mutex                   m_accessLock;
+    OrdinalSet              m_accessedEntries;
+    OrdinalList             m_accessOrder;
+
     // Internal memory buffer: MAY NOT BE INITIALIZED IF WE AREN'T USING A MEMORY BUFFER
     bool                    m_useBufferedMemory;
     VirtualLinearAllocator  m_bufferMemory;
     PageInfo::List          m_recentList;
+    PageMap                 m_pageLookup;        // Page index to the loaded page holding it
     PageInfo                m_pages[MaxPageCount];
     size_t                  m_pageCount;
     size_t                  m_pageSize;
+    int32                   m_lastMissPageIndex; // Page index of the most recent cache miss, used to detect streaming
+    uint32                  m_readaheadPages;    // Number of pages to read on the next sequential miss
+
+    // Read-only view of the file: MAY BE NULL IF WE AREN'T USING MEMORY MAPPED READS
+    void*                   m_pMappedFile;
+    volatile uint64         m_mappedSize;  // Number of bytes at the start of the mapping known to be backed by the file
 };
 
 } //namespace Util
@@ -29,6 +29,7 @@
 ***********************************************************************************************************************
 */
 
+#include "util/builtinHashProvider.h"
 #include "util/lnx/lnxHashProvider.h"
 #include "util/lnx/lnxOpenssl.h"
 
@@ -138,7 +139,10 @@ Result GetHashContextInfo(
 {
     size_t     size    = 0;
     OpenSslLib* pOpenssl = nullptr;
-    Result     result  = OpenSslLib::OpenLibrary(&pOpenssl);
+
+    // The built-in algorithms never touch OpenSSL, so they keep working when it is not installed
+    Result     result  = BuiltinHashContext::IsSupported(algorithm) ? GetBuiltinHashContextInfo(algorithm, pInfo)
+                                                                     : OpenSslLib::OpenLibrary(&pOpenssl);
 
     if ((result == Result::Success) &&
         (pOpenssl != nullptr))
@@ -177,9 +181,12 @@ Result CreateHashContext(
         result = Result::ErrorInvalidPointer;
     }
 
-    OpenSslLib* pOpenssl = nullptr;
+    const bool  isBuiltin = BuiltinHashContext::IsSupported(algorithm);
+    OpenSslLib* pOpenssl  = nullptr;
 
-    if (result == Result::Success)
+    // The built-in algorithms never touch OpenSSL, so they keep working when it is not installed
+    if ((result == Result::Success) &&
+        (isBuiltin == false))
     {
         result = OpenSslLib::OpenLibrary(&pOpenssl);
     }
@@ -187,7 +194,12 @@ Result CreateHashContext(
     ShaContext hContext = { };
     size_t     objectSize;
 
-    if (result == Result::Success)
+    if ((result == Result::Success) &&
+        isBuiltin)
+    {
+        result = CreateBuiltinHashContext(algorithm, pPlacementAddr, ppHashContext);
+    }
+    else if (result == Result::Success)
     {
         void* pWorkBuffer = VoidPtrInc(pPlacementAddr, sizeof(HashContext));
         result            = OpenSslLib::CreateHash(
@@ -197,13 +209,14 @@ Result CreateHashContext(
             &objectSize);
     }
 
-    if (result == Result::Success)
+    if ((result == Result::Success) &&
+        (isBuiltin == false))
     {
         PAL_ALERT(hContext.pMd5 == nullptr);
 
         *ppHashContext = PAL_PLACEMENT_NEW(pPlacementAddr) HashContext(hContext, algorithm, objectSize);
     }
-    else
+    else if (result != Result::Success)
     {
         if (ppHashContext != nullptr)
         {
@@ -32,39 +32,74 @@
 namespace Util
 {
 
+// Number of hash buckets to allocate for the entry lookup table across all shards
+static constexpr uint32 TotalLookupBuckets    = 2048;
+// Minimum number of hash buckets to allocate for each shard
+static constexpr uint32 MinShardLookupBuckets = 64;
+
 // =====================================================================================================================
 MemoryCacheLayer::MemoryCacheLayer(
     const AllocCallbacks& callbacks,
     size_t                maxMemorySize,
     size_t                maxObjectCount,
     bool                  evictOnFull,
-    bool                  evictDuplicates)
+    bool                  evictDuplicates,
+    uint32                numShards,
+    bool                  compressData)
     :
     CacheLayerBase    { callbacks },
     m_maxSize         { maxMemorySize },
     m_maxCount        { maxObjectCount },
     m_evictOnFull     { evictOnFull },
     m_evictDuplicates { evictDuplicates },
-    m_lock            {},
+    m_numShards       { ClampShardCount(numShards) },
+    m_compressData    { compressData },
     m_curSize         { 0 },
     m_curCount        { 0 },
-    m_recentEntryList {},
-    m_entryLookup     { 2048, Allocator() }
+    m_pShards         { static_cast<Shard*>(VoidPtrInc(this, sizeof(MemoryCacheLayer))) }
 {
+    const uint32 numBuckets = Max(TotalLookupBuckets / m_numShards, MinShardLookupBuckets);
+
+    for (uint32 i = 0; i < m_numShards; ++i)
+    {
+        PAL_PLACEMENT_NEW(&m_pShards[i]) Shard(numBuckets, Allocator());
+    }
 }
 
 // =====================================================================================================================
 MemoryCacheLayer::~MemoryCacheLayer()
 {
-    while (m_recentEntryList.IsEmpty() == false)
+    for (uint32 i = 0; i < m_numShards; ++i)
     {
-        Entry* pEntry = m_recentEntryList.Front();
-        m_entryLookup.Erase(*pEntry->HashId());
-        m_recentEntryList.Erase(pEntry->ListNode());
-        pEntry->Destroy();
+        Shard* const pShard = &m_pShards[i];
+
+        while (pShard->recentEntryList.IsEmpty() == false)
+        {
+            Entry* pEntry = pShard->recentEntryList.Front();
+            pShard->entryLookup.Erase(*pEntry->HashId());
+            pShard->recentEntryList.Erase(pEntry->ListNode());
+            pEntry->Destroy();
+        }
+
+        pShard->~Shard();
     }
 }
 
+// =====================================================================================================================
+// Rounds the requested shard count up to a power of two so a shard can be selected by masking the hash id
+uint32 MemoryCacheLayer::ClampShardCount(
+    uint32 numShards)
+{
+    return Pow2Pad(Min(Max(numShards, 1u), MaxMemoryCacheShards));
+}
+
+// =====================================================================================================================
+size_t MemoryCacheLayer::GetSize(
+    uint32 numShards)
+{
+    return sizeof(MemoryCacheLayer) + (ClampShardCount(numShards) * sizeof(Shard));
+}
+
 // =====================================================================================================================
 // Initialize the cache layer
 Result MemoryCacheLayer::Init()
@@ -81,14 +116,14 @@ Result MemoryCacheLayer::Init()
         result = m_conditionVariable.Init();
     }
 
-    if (result == Result::Success)
+    for (uint32 i = 0; (i < m_numShards) && (result == Result::Success); ++i)
     {
-        result = m_lock.Init();
-    }
+        result = m_pShards[i].lock.Init();
 
-    if (result == Result::Success)
-    {
-        result = m_entryLookup.Init();
+        if (result == Result::Success)
+        {
+            result = m_pShards[i].entryLookup.Init();
+        }
     }
 
     return result;
@@ -103,10 +138,11 @@ Result MemoryCacheLayer::QueryInternal(
     Result result = Result::Success;
 
     Entry** ppFound = nullptr;
+    Shard*  pShard  = GetShard(pHashId);
 
-    RWLockAuto<RWLock::ReadWrite> lock { &m_lock };
+    RWLockAuto<RWLock::ReadWrite> lock { &pShard->lock };
 
-    ppFound = m_entryLookup.FindKey(*pHashId);
+    ppFound = pShard->entryLookup.FindKey(*pHashId);
 
     if (ppFound == nullptr)
     {
@@ -115,8 +151,8 @@ Result MemoryCacheLayer::QueryInternal(
     else if (*ppFound != nullptr)
     {
         Entry::Node* pNode = (*ppFound)->ListNode();
-        m_recentEntryList.Erase(pNode);
-        m_recentEntryList.PushBack(pNode);
+        pShard->recentEntryList.Erase(pNode);
+        pShard->recentEntryList.PushBack(pNode);
 
         pQuery->hashId             = *pHashId;
         pQuery->pLayer             = this;
@@ -155,14 +191,31 @@ Result MemoryCacheLayer::StoreInternal(
         result = Result::ErrorInvalidValue;
     }
 
+    // Compress before taking any lock, entries are sized by their compressed data
+    void*       pCompressed = nullptr;
+    const void* pStoredData = pData;
+    size_t      storedSize  = dataSize;
+
+    if ((result == Result::Success) && m_compressData)
+    {
+        const size_t compressedSize = CompressEntryData(pData, dataSize, &pCompressed);
+
+        if (compressedSize > 0)
+        {
+            pStoredData = pCompressed;
+            storedSize  = compressedSize;
+        }
+    }
+
     bool setData = false;
     if (result == Result::Success)
     {
         Entry** ppFound = nullptr;
+        Shard*  pShard  = GetShard(pHashId);
 
-        RWLockAuto<RWLock::ReadWrite> lock { &m_lock };
+        RWLockAuto<RWLock::ReadWrite> lock { &pShard->lock };
 
-        ppFound = m_entryLookup.FindKey(*pHashId);
+        ppFound = pShard->entryLookup.FindKey(*pHashId);
 
         if (ppFound != nullptr)
         {
@@ -170,7 +223,7 @@ Result MemoryCacheLayer::StoreInternal(
             {
                 if ((*ppFound)->Data() == nullptr)
                 {
-                    result = SetDataToEntry(*ppFound, pData, dataSize);
+                    result = SetDataToEntry(pShard, *ppFound, pStoredData, storedSize, dataSize);
                     if (result == Result::Success)
                     {
                         setData = true;
@@ -179,7 +232,7 @@ Result MemoryCacheLayer::StoreInternal(
                 }
                 else if (m_evictDuplicates)
                 {
-                    result = EvictEntryFromCache(*ppFound);
+                    result = EvictEntryFromCache(pShard, *ppFound);
                 }
                 else
                 {
@@ -195,20 +248,20 @@ Result MemoryCacheLayer::StoreInternal(
 
     if ((result == Result::Success) && (setData == false))
     {
-        RWLockAuto<RWLock::ReadWrite> lock { &m_lock };
-
-        result = EnsureAvailableSpace(dataSize, 1);
+        result = EnsureAvailableSpace(GetShard(pHashId), storedSize, 1);
     }
 
     if ((result == Result::Success) && (setData == false))
     {
-        Entry* pEntry = Entry::Create(Allocator(), pHashId, pData, dataSize);
+        Entry* pEntry = Entry::Create(Allocator(), pHashId, pStoredData, storedSize, dataSize);
 
         if (pEntry != nullptr)
         {
-            RWLockAuto<RWLock::ReadWrite> lock { &m_lock };
+            Shard* pShard = GetShard(pHashId);
 
-            result = AddEntryToCache(pEntry);
+            RWLockAuto<RWLock::ReadWrite> lock { &pShard->lock };
+
+            result = AddEntryToCache(pShard, pEntry);
 
             if (result != Result::Success)
             {
@@ -222,6 +275,11 @@ Result MemoryCacheLayer::StoreInternal(
         }
     }
 
+    if (pCompressed != nullptr)
+    {
+        PAL_FREE(pCompressed, Allocator());
+    }
+
     return result;
 }
 
@@ -241,19 +299,26 @@ Result MemoryCacheLayer::LoadInternal(
     else
     {
         Entry** ppFound = nullptr;
+        Shard*  pShard  = GetShard(&pQuery->hashId);
 
-        RWLockAuto<RWLock::ReadOnly> lock { &m_lock };
+        RWLockAuto<RWLock::ReadOnly> lock { &pShard->lock };
 
-        ppFound = m_entryLookup.FindKey(pQuery->hashId);
+        ppFound = pShard->entryLookup.FindKey(pQuery->hashId);
         if (ppFound != nullptr)
         {
-            if ((*ppFound)->Data())
+            const Entry* const pEntry = *ppFound;
+
+            if (pEntry->Data() == nullptr)
+            {
+                result = Result::NotReady;
+            }
+            else if (pEntry->IsCompressed())
             {
-                memcpy(pBuffer, (*ppFound)->Data(), (*ppFound)->DataSize());
+                result = DecompressData(pEntry->Data(), pEntry->StoredSize(), pBuffer, pEntry->DataSize());
             }
             else
             {
-                result = Result::NotReady;
+                memcpy(pBuffer, pEntry->Data(), pEntry->DataSize());
             }
         }
         else
@@ -279,10 +344,11 @@ Result MemoryCacheLayer::AcquireCacheRef(
     else
     {
         Entry** ppFound = nullptr;
+        Shard*  pShard  = GetShard(&pQuery->hashId);
 
-        RWLockAuto<RWLock::ReadOnly> lock { &m_lock };
+        RWLockAuto<RWLock::ReadOnly> lock { &pShard->lock };
 
-        ppFound = m_entryLookup.FindKey(pQuery->hashId);
+        ppFound = pShard->entryLookup.FindKey(pQuery->hashId);
         if (ppFound != nullptr)
         {
             (*ppFound)->IncreaseRef();
@@ -309,23 +375,30 @@ Result MemoryCacheLayer::ReleaseCacheRef(
     else
     {
         Entry** ppFound = nullptr;
+        Shard*  pShard  = GetShard(&pQuery->hashId);
+        bool    evict   = false;
 
-        RWLockAuto<RWLock::ReadOnly> lock { &m_lock };
-
-        ppFound = m_entryLookup.FindKey(pQuery->hashId);
-        if (ppFound != nullptr)
         {
-            (*ppFound)->DecreaseRef();
-            if ((*ppFound)->IsBad())
+            RWLockAuto<RWLock::ReadOnly> lock { &pShard->lock };
+
+            ppFound = pShard->entryLookup.FindKey(pQuery->hashId);
+            if (ppFound != nullptr)
             {
-                Evict(&pQuery->hashId);
+                (*ppFound)->DecreaseRef();
+                evict = (*ppFound)->IsBad();
+            }
+            else
+            {
+                PAL_ASSERT_ALWAYS();
+                // This should never happen, ReleaseCacheRef is after AcquireCacheRef.
+                result = Result::NotFound;
             }
         }
-        else
+
+        // Evict takes the shard lock for writing, so it must be called after the read lock above is released.
+        if (evict)
         {
-            PAL_ASSERT_ALWAYS();
-            // This should never happen, ReleaseCacheRef is after AcquireCacheRef.
-            result = Result::NotFound;
+            Evict(&pQuery->hashId);
         }
     }
 
@@ -346,19 +419,26 @@ Result MemoryCacheLayer::GetCacheData(
     else
     {
         Entry** ppFound = nullptr;
+        Shard*  pShard  = GetShard(&pQuery->hashId);
 
-        RWLockAuto<RWLock::ReadOnly> lock { &m_lock };
+        RWLockAuto<RWLock::ReadOnly> lock { &pShard->lock };
 
-        ppFound = m_entryLookup.FindKey(pQuery->hashId);
+        ppFound = pShard->entryLookup.FindKey(pQuery->hashId);
         if (ppFound != nullptr)
         {
-            if ((*ppFound)->Data())
+            if ((*ppFound)->Data() == nullptr)
             {
-                *ppData = (*ppFound)->Data();
+                result = Result::NotReady;
+            }
+            else if ((*ppFound)->IsCompressed())
+            {
+                // Compressed data can't be used in place, it has to go through Load()
+                *ppData = nullptr;
+                result  = Result::Unsupported;
             }
             else
             {
-                result = Result::NotReady;
+                *ppData = (*ppFound)->Data();
             }
         }
         else
@@ -386,13 +466,14 @@ Result MemoryCacheLayer::WaitForEntry(
     else
     {
         Entry** ppFound = nullptr;
+        Shard*  pShard  = GetShard(pHashId);
 
         m_conditionMutex.Lock();
         for (;;)
         {
             {
-                RWLockAuto<RWLock::ReadOnly> lock{ &m_lock };
-                ppFound = m_entryLookup.FindKey(*pHashId);
+                RWLockAuto<RWLock::ReadOnly> lock{ &pShard->lock };
+                ppFound = pShard->entryLookup.FindKey(*pHashId);
                 if (ppFound == nullptr)
                 {
                     result = Result::NotFound;
@@ -431,12 +512,13 @@ Result MemoryCacheLayer::Evict(
     else
     {
         Entry** ppFound = nullptr;
+        Shard*  pShard  = GetShard(pHashId);
 
-        RWLockAuto<RWLock::ReadOnly> lock { &m_lock };
-        ppFound = m_entryLookup.FindKey(*pHashId);
+        RWLockAuto<RWLock::ReadWrite> lock { &pShard->lock };
+        ppFound = pShard->entryLookup.FindKey(*pHashId);
         if (ppFound != nullptr)
         {
-            result = EvictEntryFromCache(*ppFound);
+            result = EvictEntryFromCache(pShard, *ppFound);
         }
         else
         {
@@ -461,9 +543,10 @@ Result MemoryCacheLayer::MarkEntryBad(
     else
     {
         Entry** ppFound = nullptr;
+        Shard*  pShard  = GetShard(pHashId);
 
-        RWLockAuto<RWLock::ReadOnly> lock { &m_lock };
-        ppFound = m_entryLookup.FindKey(*pHashId);
+        RWLockAuto<RWLock::ReadOnly> lock { &pShard->lock };
+        ppFound = pShard->entryLookup.FindKey(*pHashId);
         if (ppFound != nullptr)
         {
             (*ppFound)->SetIsBad(true);
@@ -480,74 +563,44 @@ Result MemoryCacheLayer::MarkEntryBad(
 }
 
 // =====================================================================================================================
-// Evict entries until a specified count is reached
-Result MemoryCacheLayer::EvictEntryByCount(
-    size_t numToEvict)
+// Returns true if an entry of the given size and count fits within the cache limits without evicting anything
+bool MemoryCacheLayer::HasAvailableSpace(
+    size_t entrySize,
+    size_t entryCount
+    ) const
 {
-    Result result = Result::Success;
-
-    size_t numEvicted = 0;
-
-    while ((result == Result::Success) &&
-           (numEvicted < numToEvict))
-    {
-        Entry* const pEntry = m_recentEntryList.Front();
-
-        if (pEntry != nullptr)
-        {
-            result = EvictEntryFromCache(pEntry);
-
-            if (result == Result::Success)
-            {
-                ++numEvicted;
-            }
-        }
-        else
-        {
-            result = Result::ErrorShaderCacheFull;
-        }
-    }
-
-    return result;
+    return ((m_curCount + entryCount) <= m_maxCount) && ((m_curSize + entrySize) <= m_maxSize);
 }
 
 // =====================================================================================================================
-// Evict entries until a specified size is reached
-Result MemoryCacheLayer::EvictEntryBySize(
-    size_t minSizeToEvict)
+// Evict the least recently used entries of a shard until the cache limits are met or the shard has nothing left that
+// can be evicted. The caller must hold the shard lock for writing.
+void MemoryCacheLayer::EvictShardEntries(
+    Shard* pShard,
+    size_t entrySize,
+    size_t entryCount)
 {
-    Result result = Result::Success;
-
-    size_t evictedSize = 0;
+    auto iter = pShard->recentEntryList.Begin();
 
-    while ((result == Result::Success) &&
-           (evictedSize < minSizeToEvict))
+    while (iter.IsValid() && (HasAvailableSpace(entrySize, entryCount) == false))
     {
-        Entry* const pEntry = m_recentEntryList.Front();
-
-        if (pEntry != nullptr)
-        {
-            const size_t dataSize = pEntry->DataSize();
+        Entry* const pEntry = iter.Get();
 
-            result = EvictEntryFromCache(pEntry);
+        // Advance first since evicting the entry removes it from the list
+        iter.Next();
 
-            if (result == Result::Success)
-            {
-                evictedSize += dataSize;
-            }
-        }
-        else
+        // Entries with outstanding references are skipped over rather than ending the search
+        if (pEntry->CanEvict())
         {
-            result = Result::ErrorShaderCacheFull;
+            EvictEntryFromCache(pShard, pEntry);
         }
     }
-
-    return result;
 }
 
 // =====================================================================================================================
-// Remove an entry from the cache table, list, and metrics.
+// Remove an entry from the cache table, list, and metrics. The caller must hold the shard lock for writing.
 Result MemoryCacheLayer::EvictEntryFromCache(
+    Shard* pShard,
     Entry* pEntry)
 {
     PAL_ASSERT(pEntry != nullptr);
@@ -556,13 +609,15 @@ Result MemoryCacheLayer::EvictEntryFromCache(
 
     if (pEntry->CanEvict())
     {
-        if (m_entryLookup.Erase(*pEntry->HashId()))
+        if (pShard->entryLookup.Erase(*pEntry->HashId()))
         {
             result = Result::Success;
 
-            m_recentEntryList.Erase(pEntry->ListNode());
-            m_curSize -= pEntry->DataSize();
-            m_curCount -= 1;
+            pShard->recentEntryList.Erase(pEntry->ListNode());
+            pShard->curSize  -= pEntry->StoredSize();
+            pShard->curCount -= 1;
+            AtomicAdd64(&m_curSize, static_cast<uint64>(0) - pEntry->StoredSize());
+            AtomicAdd64(&m_curCount, static_cast<uint64>(0) - 1);
             pEntry->Destroy();
         }
     }
@@ -571,29 +626,34 @@ Result MemoryCacheLayer::EvictEntryFromCache(
 }
 
 // =====================================================================================================================
-// Insert the entry into our cache lookup table and LRU list
+// Insert the entry into our cache lookup table and LRU list. The caller must hold the shard lock for writing.
 Result MemoryCacheLayer::AddEntryToCache(
+    Shard* pShard,
     Entry* pEntry)
 {
     PAL_ASSERT(pEntry != nullptr);
 
-    Result result = m_entryLookup.Insert(*pEntry->HashId(), pEntry);
+    Result result = pShard->entryLookup.Insert(*pEntry->HashId(), pEntry);
 
     if (result == Result::Success)
     {
-        m_recentEntryList.PushBack(pEntry->ListNode());
-        m_curSize += pEntry->DataSize();
-        m_curCount++;
+        pShard->recentEntryList.PushBack(pEntry->ListNode());
+        pShard->curSize += pEntry->StoredSize();
+        pShard->curCount++;
+        AtomicAdd64(&m_curSize, pEntry->StoredSize());
+        AtomicIncrement64(&m_curCount);
     }
 
     return result;
 }
 
 // =====================================================================================================================
-// Set data to Entry
+// Set data to Entry. The caller must hold the shard lock for writing.
 Result MemoryCacheLayer::SetDataToEntry(
+    Shard*      pShard,
     Entry*      pEntry,
     const void* pData,
+    size_t      storedSize,
     size_t      dataSize)
 {
     PAL_ASSERT(pEntry != nullptr);
@@ -601,11 +661,12 @@ Result MemoryCacheLayer::SetDataToEntry(
 
     if ((pData != nullptr) && (dataSize > 0))
     {
-        result = pEntry->SetData(pData, dataSize);
+        result = pEntry->SetData(pData, storedSize, dataSize);
 
         if (result == Result::Success)
         {
-            m_curSize += pEntry->DataSize();
+            pShard->curSize += pEntry->StoredSize();
+            AtomicAdd64(&m_curSize, pEntry->StoredSize());
         }
     }
 
@@ -613,8 +674,41 @@ Result MemoryCacheLayer::SetDataToEntry(
 }
 
 // =====================================================================================================================
-// Ensure size requested is available within the cache, may evict data
+// Compress data that is about to be stored in an entry. Returns the compressed size, or 0 if the data should be stored
+// uncompressed. On success the caller owns the buffer returned in ppCompressed.
+size_t MemoryCacheLayer::CompressEntryData(
+    const void* pData,
+    size_t      dataSize,
+    void**      ppCompressed)
+{
+    PAL_ASSERT(ppCompressed != nullptr);
+
+    size_t      compressedSize = 0;
+    void* const pCompressed    = PAL_MALLOC(dataSize, Allocator(), AllocInternalTemp);
+
+    if (pCompressed != nullptr)
+    {
+        compressedSize = CompressData(pData, dataSize, pCompressed, dataSize);
+
+        if (compressedSize > 0)
+        {
+            *ppCompressed = pCompressed;
+        }
+        else
+        {
+            PAL_FREE(pCompressed, Allocator());
+        }
+    }
+
+    return compressedSize;
+}
+
+// =====================================================================================================================
+// Ensure size requested is available within the cache, may evict data. Entries are evicted from the shard the new entry
+// belongs to first and then from the other shards in turn, so only one shard lock is held at any time. The caller must
+// not hold any shard lock.
 Result MemoryCacheLayer::EnsureAvailableSpace(
+    Shard* pShard,
     size_t entrySize,
     size_t entryCount)
 {
@@ -623,28 +717,28 @@ Result MemoryCacheLayer::EnsureAvailableSpace(
 
     Result result = Result::Success;
 
-    const size_t availableCount = m_maxCount - m_curCount;
-
-    if (entryCount > availableCount)
+    if (HasAvailableSpace(entrySize, entryCount) == false)
     {
         result = Result::ErrorShaderCacheFull;
 
         if (m_evictOnFull)
         {
-            result = EvictEntryByCount(entryCount - availableCount);
-        }
-    }
+            const uint32 firstShard = static_cast<uint32>(pShard - m_pShards);
 
-    const size_t availableSize = m_maxSize - m_curSize;
+            for (uint32 i = 0; i < m_numShards; ++i)
+            {
+                Shard* const pEvictShard = &m_pShards[(firstShard + i) & (m_numShards - 1)];
 
-    if ((result == Result::Success) &&
-        (entrySize > availableSize))
-    {
-        result = Result::ErrorShaderCacheFull;
+                RWLockAuto<RWLock::ReadWrite> lock { &pEvictShard->lock };
 
-        if (m_evictOnFull)
-        {
-            result = EvictEntryBySize(entrySize - availableSize);
+                EvictShardEntries(pEvictShard, entrySize, entryCount);
+
+                if (HasAvailableSpace(entrySize, entryCount))
+                {
+                    result = Result::Success;
+                    break;
+                }
+            }
         }
     }
 
@@ -674,11 +768,12 @@ Result MemoryCacheLayer::PromoteData(
     }
 
     Entry** ppFound = nullptr;
+    Shard*  pShard  = GetShard(&pQuery->hashId);
 
     {
-        RWLockAuto<RWLock::ReadOnly> lock { &m_lock };
+        RWLockAuto<RWLock::ReadOnly> lock { &pShard->lock };
 
-        ppFound = m_entryLookup.FindKey(pQuery->hashId);
+        ppFound = pShard->entryLookup.FindKey(pQuery->hashId);
     }
 
     if (ppFound != nullptr)
@@ -686,16 +781,45 @@ Result MemoryCacheLayer::PromoteData(
         result = Result::AlreadyExists;
     }
 
-    if (result == Result::Success)
+    if ((result == Result::Success) && m_compressData)
     {
-        RWLockAuto<RWLock::ReadWrite> lock { &m_lock };
+        // The size of a compressed entry isn't known until its data has been loaded, so go through the regular store
+        // path from a temporary copy
+        void* const pData = PAL_MALLOC(pQuery->dataSize, Allocator(), AllocInternalTemp);
+
+        if (pData != nullptr)
+        {
+            result = pNextLayer->Load(pQuery, pData);
+
+            if (result == Result::Success)
+            {
+                result = StoreInternal(&pQuery->hashId, pData, pQuery->dataSize);
+            }
+
+            if (result == Result::Success)
+            {
+                // Update the query to reflect our entry
+                const Hash128 hashId = pQuery->hashId;
+
+                result = QueryInternal(&hashId, pQuery);
+            }
+
+            PAL_FREE(pData, Allocator());
+        }
+        else
+        {
+            result = Result::ErrorOutOfMemory;
+        }
+    }
 
-        result = EnsureAvailableSpace(pQuery->dataSize, 1);
+    if ((result == Result::Success) && (m_compressData == false))
+    {
+        result = EnsureAvailableSpace(pShard, pQuery->dataSize, 1);
     }
 
-    if (result == Result::Success)
+    if ((result == Result::Success) && (m_compressData == false))
     {
-        Entry* pEntry = Entry::Create(Allocator(), &pQuery->hashId, nullptr, pQuery->dataSize);
+        Entry* pEntry = Entry::Create(Allocator(), &pQuery->hashId, nullptr, pQuery->dataSize, pQuery->dataSize);
 
         if (pEntry != nullptr)
         {
@@ -703,10 +827,9 @@ Result MemoryCacheLayer::PromoteData(
 
             if (result == Result::Success)
             {
-                RWLockAuto<RWLock::ReadWrite> lock { &m_lock };
+                RWLockAuto<RWLock::ReadWrite> lock { &pShard->lock };
 
-                result = AddEntryToCache(pEntry);
-                m_entryLookup.Insert(pQuery->hashId, pEntry);
+                result = AddEntryToCache(pShard, pEntry);
             }
 
             if (result == Result::Success)
@@ -746,10 +869,11 @@ Result MemoryCacheLayer::Reserve(
     if (result == Result::Success)
     {
         Entry** ppFound = nullptr;
+        Shard*  pShard  = GetShard(pHashId);
 
-        RWLockAuto<RWLock::ReadWrite> lock { &m_lock };
+        RWLockAuto<RWLock::ReadWrite> lock { &pShard->lock };
 
-        ppFound = m_entryLookup.FindKey(*pHashId);
+        ppFound = pShard->entryLookup.FindKey(*pHashId);
         if (ppFound != nullptr)
         {
             if (*ppFound != nullptr)
@@ -765,11 +889,13 @@ Result MemoryCacheLayer::Reserve(
 
     if (result == Result::Success)
     {
-        Entry* pEntry = Entry::Create(Allocator(), pHashId, nullptr, 0);
+        Entry* pEntry = Entry::Create(Allocator(), pHashId, nullptr, 0, 0);
         if (pEntry != nullptr)
         {
-            RWLockAuto<RWLock::ReadWrite> lock { &m_lock };
-            result = AddEntryToCache(pEntry);
+            Shard* pShard = GetShard(pHashId);
+
+            RWLockAuto<RWLock::ReadWrite> lock { &pShard->lock };
+            result = AddEntryToCache(pShard, pEntry);
             if (result != Result::Success)
             {
                 pEntry->Destroy();
@@ -790,7 +916,9 @@ Result MemoryCacheLayer::Reserve(
 size_t GetMemoryCacheLayerSize(
     const MemoryCacheCreateInfo* pCreateInfo)
 {
-    return sizeof(MemoryCacheLayer);
+    PAL_ASSERT(pCreateInfo != nullptr);
+
+    return MemoryCacheLayer::GetSize(pCreateInfo->numShards);
 }
 
 // =====================================================================================================================
@@ -827,7 +955,9 @@ Result CreateMemoryCacheLayer(
             pCreateInfo->maxMemorySize,
             pCreateInfo->maxObjectCount,
             pCreateInfo->evictOnFull,
-            pCreateInfo->evictDuplicates);
+            pCreateInfo->evictDuplicates,
+            pCreateInfo->numShards,
+            pCreateInfo->baseInfo.compressData);
 
         result = pLayer->Init();
 
@@ -862,17 +992,30 @@ Result MemoryCacheLayer::GetMemoryCacheHashIds(
 {
     Result result = Result::Success;
 
-    RWLockAuto<RWLock::ReadOnly> lock { &m_lock };
     // Iterate through all Entries and copy their hash ID to pHashIds array.
     if (curCount == m_curCount)
     {
-        uint32 i = 0;
+        size_t i = 0;
 
-        for (auto iter = m_recentEntryList.Begin(); iter.IsValid(); iter.Next())
+        for (uint32 shard = 0; (shard < m_numShards) && (result == Result::Success); ++shard)
         {
-            Entry* pEntry = iter.Get();
+            Shard* const pShard = &m_pShards[shard];
+
+            RWLockAuto<RWLock::ReadOnly> lock { &pShard->lock };
 
-            pHashIds[i++] = *pEntry->HashId();
+            for (auto iter = pShard->recentEntryList.Begin(); iter.IsValid(); iter.Next())
+            {
+                // Other threads may have added entries to shards we have not visited yet
+                if (i == curCount)
+                {
+                    result = Result::ErrorInvalidMemorySize;
+                    break;
+                }
+
+                Entry* pEntry = iter.Get();
+
+                pHashIds[i++] = *pEntry->HashId();
+            }
         }
     }
     else
@@ -899,10 +1042,12 @@ MemoryCacheLayer::Entry* MemoryCacheLayer::Entry::Create(
     ForwardAllocator* pAllocator,
     const Hash128*    pHashId,
     const void*       pInitialData,
+    size_t            storedSize,
     size_t            dataSize)
 {
     PAL_ASSERT(pAllocator != nullptr);
     PAL_ASSERT(pHashId != nullptr);
+    PAL_ASSERT(storedSize <= dataSize);
 
     Entry* pEntry = nullptr;
     void*  pMem   = PAL_MALLOC(sizeof(Entry), pAllocator, AllocInternal);
@@ -913,14 +1058,14 @@ MemoryCacheLayer::Entry* MemoryCacheLayer::Entry::Create(
 
         void* pData = nullptr;
 
-        if (dataSize > 0)
+        if (storedSize > 0)
         {
-            pData = PAL_MALLOC(dataSize, pAllocator, AllocInternal);
+            pData = PAL_MALLOC(storedSize, pAllocator, AllocInternal);
             if (pData != nullptr)
             {
                 if (pInitialData != nullptr)
                 {
-                    memcpy(pData, pInitialData, dataSize);
+                    memcpy(pData, pInitialData, storedSize);
                 }
             }
             else
@@ -934,6 +1079,7 @@ MemoryCacheLayer::Entry* MemoryCacheLayer::Entry::Create(
             pEntry->m_hashId   = *pHashId;
             pEntry->m_pData    = pData;
             pEntry->m_dataSize = dataSize;
+            pEntry->m_storedSize = storedSize;
             pEntry->m_zeroCopyCount = 0;
         }
     }
@@ -944,18 +1090,21 @@ MemoryCacheLayer::Entry* MemoryCacheLayer::Entry::Create(
 // =====================================================================================================================
 Result MemoryCacheLayer::Entry::SetData(
     const void* pData,
+    size_t      storedSize,
     size_t      dataSize)
 {
     PAL_ASSERT(m_pData == nullptr);
+    PAL_ASSERT(storedSize <= dataSize);
     Result result = Result::Success;
 
     if (pData)
     {
-        m_pData = PAL_MALLOC(dataSize, m_pAllocator, AllocInternal);
+        m_pData = PAL_MALLOC(storedSize, m_pAllocator, AllocInternal);
         if (m_pData != nullptr)
         {
-            memcpy(m_pData, pData, dataSize);
-            m_dataSize = dataSize;
+            memcpy(m_pData, pData, storedSize);
+            m_dataSize   = dataSize;
+            m_storedSize = storedSize;
         }
         else
         {
@@ -43,15 +43,23 @@ public:
         size_t                maxMemorySize,
         size_t                maxObjectCount,
         bool                  evictOnFull,
-        bool                  evictDuplicates);
+        bool                  evictDuplicates,
+        uint32                numShards,
+        bool                  compressData);
     virtual ~MemoryCacheLayer();
 
     virtual Result Init() override;
 
+    // Returns the number of shards that will be used for the requested shard count
+    static uint32 ClampShardCount(uint32 numShards);
+
+    // Returns the size of the memory needed to construct a layer with the given number of shards
+    static size_t GetSize(uint32 numShards);
+
     Result GetMemoryCacheSize(size_t* pCurCount, size_t* pCurSize) const
     {
-        *pCurCount = m_curCount;
-        *pCurSize  = m_curSize;
+        *pCurCount = static_cast<size_t>(m_curCount);
+        *pCurSize  = static_cast<size_t>(m_curSize);
 
         return Result::Success;
     }
@@ -89,14 +97,20 @@ private:
     PAL_DISALLOW_COPY_AND_ASSIGN(MemoryCacheLayer);
     PAL_DISALLOW_DEFAULT_CTOR(MemoryCacheLayer);
     class Entry;
+    struct Shard;
+
+    Shard* GetShard(const Hash128* pHashId) const
+        { return &m_pShards[pHashId->dwords[0] & (m_numShards - 1)]; }
 
-    Result SetDataToEntry(Entry* pEntry, const void* pData, size_t dataSize);
-    Result AddEntryToCache(Entry* pEntry);
-    Result EvictEntryFromCache(Entry* pEntry);
+    Result SetDataToEntry(Shard* pShard, Entry* pEntry, const void* pData, size_t storedSize, size_t dataSize);
+    Result AddEntryToCache(Shard* pShard, Entry* pEntry);
+    Result EvictEntryFromCache(Shard* pShard, Entry* pEntry);
 
-    Result EnsureAvailableSpace(size_t entrySize, size_t entryCount);
-    Result EvictEntryByCount(size_t numToEvict = 1);
-    Result EvictEntryBySize(size_t minSizeToEvict);
+    bool HasAvailableSpace(size_t entrySize, size_t entryCount) const;
+    Result EnsureAvailableSpace(Shard* pShard, size_t entrySize, size_t entryCount);
+    void EvictShardEntries(Shard* pShard, size_t entrySize, size_t entryCount);
+
+    size_t CompressEntryData(const void* pData, size_t dataSize, void** ppCompressed);
 
     // IntrusiveList capable cache entry data structure
     class Entry
@@ -111,12 +125,15 @@ private:
             ForwardAllocator* pAllocator,
             const Hash128*    pHashId,
             const void*       pInitialData,
+            size_t            storedSize,
             size_t            dataSize);
 
-        Result SetData(const void* pData, size_t dataSize);
+        Result SetData(const void* pData, size_t storedSize, size_t dataSize);
         const Hash128* HashId() const { return &m_hashId; }
         void* Data() const { return m_pData; }
         size_t DataSize() const { return m_dataSize; }
+        size_t StoredSize() const { return m_storedSize; }
+        bool IsCompressed() const { return m_storedSize < m_dataSize; }
         void IncreaseRef() { AtomicIncrement(&m_zeroCopyCount); }
         void DecreaseRef()
         {
@@ -142,6 +159,7 @@ private:
             m_hashId     {},
             m_pData      { nullptr },
             m_dataSize   { 0 },
+            m_storedSize { 0 },
             m_isBad      { false }
         {
             PAL_ASSERT(m_pAllocator != nullptr);
@@ -153,23 +171,45 @@ private:
         Node                    m_node;
         Hash128                 m_hashId;
         void*                   m_pData;
-        size_t                  m_dataSize;
+        size_t                  m_dataSize;     // Size of the data as stored and loaded by clients
+        size_t                  m_storedSize;   // Size of m_pData, smaller than m_dataSize if it is LZ4 compressed
         volatile uint32         m_zeroCopyCount;
         bool                    m_isBad;
     };
 
+    // An independently locked partition of the cache. Entries are assigned to a shard by their hash id.
+    struct Shard
+    {
+        Shard(uint32 numBuckets, ForwardAllocator* pAllocator)
+            :
+            lock            {},
+            curSize         { 0 },
+            curCount        { 0 },
+            recentEntryList {},
+            entryLookup     { numBuckets, pAllocator }
+        {
+        }
+
+        RWLock       lock;
+        size_t       curSize;
+        size_t       curCount;
+        Entry::List  recentEntryList;
+        Entry::Map   entryLookup;
+    };
+
     const size_t m_maxSize;
     const size_t m_maxCount;
     const bool   m_evictOnFull;
     const bool   m_evictDuplicates;
+    const uint32 m_numShards;
+    const bool   m_compressData;
 
-    RWLock       m_lock;
-
-    size_t       m_curSize;
-    size_t       m_curCount;
+    // Totals across all shards, these are updated atomically so each shard only needs to hold its own lock. Sizes are
+    // the sizes entries take up in memory, which for compressed entries is less than the size of their data.
+    volatile uint64    m_curSize;
+    volatile uint64    m_curCount;
 
-    Entry::List  m_recentEntryList;
-    Entry::Map   m_entryLookup;
+    Shard* const       m_pShards;             // Shards are placed in memory immediately after this object
 
     Mutex              m_conditionMutex;      // Mutex that will be used with the condition variable
     ConditionVariable  m_conditionVariable;   // used for waiting on Entry::ready
@@ -26,6 +26,7 @@
 #include "palAssert.h"
 #include "palHashLiteralString.h"
 #include "palMsgPackImpl.h"
+#include "palMutex.h"
 #include "palPipelineAbiReader.h"
 #include "palPipelineAbiUtils.h"
 #include "palHashMapImpl.h"
@@ -55,12 +56,9 @@ Result PipelineAbiReader::Init()
     if (result == Result::Success)
     {
         memset(&m_pipelineSymbols, 0, sizeof(m_pipelineSymbols));
-        result = m_genericSymbolsMap.Init();
-    }
 
-    if (result == Result::Success)
-    {
-        // Cache symbols so we don't have to search them when looking up
+        // Cache the pipeline symbols so we don't have to search them when looking up.  Generic symbols are left for
+        // GetGenericSymbol to index, so this doesn't allocate anything.
         for (ElfReader::SectionId sectionIndex = 0; sectionIndex < m_elfReader.GetNumSections(); sectionIndex++)
         {
             if (m_elfReader.GetSectionType(sectionIndex) != ElfReader::SectionHeaderType::SymTab)
@@ -83,18 +81,6 @@ Result PipelineAbiReader::Init()
                 {
                     m_pipelineSymbols[static_cast<uint32>(pipelineSymbolType)] = {sectionIndex, symbolIndex};
                 }
-                else
-                {
-                    result = m_genericSymbolsMap.Insert(pName, {sectionIndex, symbolIndex});
-                    if (result != Result::Success)
-                    {
-                        break;
-                    }
-                }
-            }
-            if (result != Result::Success)
-            {
-                break;
             }
         }
     }
@@ -208,17 +194,122 @@ const Elf::SymbolTableEntry* PipelineAbiReader::GetGenericSymbol(
 {
     PAL_ASSERT(pName != nullptr);
 
-    const SymbolEntry*const pSymbolEntry = m_genericSymbolsMap.FindKey(pName);
+    SymbolEntry symbolEntry = {};
+    bool        found       = false;
+    uint32      state       = m_genericSymbolsState;
+
+    if (state == NotIndexed)
+    {
+        // Only the thread which wins the swap builds the map.  Everybody else scans until it has been published.
+        state = AtomicCompareAndSwap(&m_genericSymbolsState, NotIndexed, Indexing);
+
+        if (state == NotIndexed)
+        {
+            state = (IndexGenericSymbols() == Result::Success) ? Indexed : IndexFailed;
+            AtomicExchange(&m_genericSymbolsState, state);
+        }
+    }
+
+    if (state == Indexed)
+    {
+        // The map is never modified once indexed, so it can be read without a lock.
+        const SymbolEntry*const pSymbolEntry = m_genericSymbolsMap.FindKey(pName);
+
+        if (pSymbolEntry != nullptr)
+        {
+            symbolEntry = *pSymbolEntry;
+            found       = true;
+        }
+    }
+    else
+    {
+        // Another thread is still indexing, or it ran out of memory.  Either way this only costs us speed.
+        found = FindGenericSymbol(pName, &symbolEntry);
+    }
 
     const Elf::SymbolTableEntry* pSymbol = nullptr;
-    if (pSymbolEntry != nullptr)
+    if (found)
     {
-        ElfReader::Symbols symbolSection(m_elfReader, pSymbolEntry->m_section);
-        pSymbol = &symbolSection.GetSymbol(pSymbolEntry->m_index);
+        ElfReader::Symbols symbolSection(m_elfReader, symbolEntry.m_section);
+        pSymbol = &symbolSection.GetSymbol(symbolEntry.m_index);
     }
 
     return pSymbol;
 }
 
+// =====================================================================================================================
+// Adds every defined symbol which isn't a pipeline symbol to m_genericSymbolsMap.  The caller must have moved
+// m_genericSymbolsState to Indexing.
+Result PipelineAbiReader::IndexGenericSymbols() const
+{
+    Result result = m_genericSymbolsMap.Init();
+
+    for (ElfReader::SectionId sectionIndex = 0;
+         (result == Result::Success) && (sectionIndex < m_elfReader.GetNumSections());
+         sectionIndex++)
+    {
+        if (m_elfReader.GetSectionType(sectionIndex) != ElfReader::SectionHeaderType::SymTab)
+        {
+            continue;
+        }
+
+        ElfReader::Symbols symbols(m_elfReader, sectionIndex);
+        for (uint32 symbolIndex = 0;
+             (result == Result::Success) && (symbolIndex < symbols.GetNumSymbols());
+             symbolIndex++)
+        {
+            if (symbols.GetSymbol(symbolIndex).st_shndx == 0)
+            {
+                continue;
+            }
+
+            const char* pName = symbols.GetSymbolName(symbolIndex);
+
+            if (GetSymbolTypeFromName(pName) == PipelineSymbolType::Unknown)
+            {
+                result = m_genericSymbolsMap.Insert(pName, {sectionIndex, symbolIndex});
+            }
+        }
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Searches the symbol tables for a generic symbol without using m_genericSymbolsMap.
+bool PipelineAbiReader::FindGenericSymbol(
+    const char*  pName,
+    SymbolEntry* pSymbolEntry
+    ) const
+{
+    bool found = false;
+
+    if (GetSymbolTypeFromName(pName) == PipelineSymbolType::Unknown)
+    {
+        for (ElfReader::SectionId sectionIndex = 0;
+             (found == false) && (sectionIndex < m_elfReader.GetNumSections());
+             sectionIndex++)
+        {
+            if (m_elfReader.GetSectionType(sectionIndex) != ElfReader::SectionHeaderType::SymTab)
+            {
+                continue;
+            }
+
+            ElfReader::Symbols symbols(m_elfReader, sectionIndex);
+            for (uint32 symbolIndex = 0; (found == false) && (symbolIndex < symbols.GetNumSymbols()); symbolIndex++)
+            {
+                if ((symbols.GetSymbol(symbolIndex).st_shndx != 0) &&
+                    (strcmp(symbols.GetSymbolName(symbolIndex), pName) == 0))
+                {
+                    *pSymbolEntry = {sectionIndex, symbolIndex};
+                    found         = true;
+                }
+            }
+        }
+    }
+
+    return found;
+}
+
 } // Abi
 } // Util
@@ -0,0 +1,273 @@
+##
+ #######################################################################################################################
+ #
+ #  Copyright (c) 2020 Advanced Micro Devices, Inc. All Rights Reserved.
+ #
+ #  Permission is hereby granted, free of charge, to any person obtaining a copy
+ #  of this software and associated documentation files (the "Software"), to deal
+ #  in the Software without restriction, including without limitation the rights
+ #  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ #  copies of the Software, and to permit persons to whom the Software is
+ #  furnished to do so, subject to the following conditions:
+ #
+ #  The above copyright notice and this permission notice shall be included in all
+ #  copies or substantial portions of the Software.
+ #
+ #  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ #  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ #  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ #  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ #  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ #  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ #  SOFTWARE.
+ #
+ #######################################################################################################################
+
+# Offline compactor for PAL archive files (see inc/util/palArchiveFileFmt.h).
+#
+# Archive files are append only, so replaced and corrupted entries are never reclaimed. This rewrites an archive with
+# only its valid entries, laid out the same way IArchiveFile::Compact() does: all entry data back to back, followed by
+# all entry headers back to back, then a full index of the archive and the footer, so the driver can find any entry
+# without walking the entry chain when it opens the file. Entries keep their relative order since no access information
+# is available offline, and any old indices are dropped.
+#
+# The archive must not be in use. The file lock held by the driver is honored, and the compacted archive is written
+# next to the original and renamed over it once complete.
+
+import argparse
+import fcntl
+import os
+import struct
+import sys
+import time
+
+MagicArchiveMarker = bytes(bytearray([0x23, 0xd8, 0xfa, 0xe7, 0x0f, 0x5f, 0x47, 0xbe,
+                                      0x8b, 0xd1, 0x48, 0xf5, 0xd8, 0xf0, 0xb4, 0xa7]))
+MagicFooterMarker  = b"FOTR"
+MagicEntryMarker   = b"NTRY"
+MagicIndexMarker   = b"INDX"
+ArchiveIndexDataType = 0x58444E49
+CurrentMajorVersion = 1
+
+# Packed layouts matching palArchiveFileFmt.h
+FileHeaderFmt  = "<16sIIII20s" # archiveMarker, majorVersion, minorVersion, firstBlock, archiveType, platformKey
+FileFooterFmt  = "<4sIQ16s"    # footerMarker, entryCount, lastWriteTimestamp, archiveMarker
+EntryHeaderFmt = "<4sIIIIQI20sI" # entryMarker, ordinalId, nextBlock, dataSize, dataPosition, dataCrc64, dataType,
+                                 # entryKey, metaValue
+IndexHeaderFmt  = "<4sIIII"    # indexMarker, firstOrdinal, entryCount, keyCount, prevIndexBlock
+IndexKeyFmt     = "<20sI"      # entryKey, ordinalId
+IndexLocatorFmt = "<4sI"       # indexMarker, indexBlock
+FileHeaderSize  = struct.calcsize(FileHeaderFmt)
+FileFooterSize  = struct.calcsize(FileFooterFmt)
+EntryHeaderSize = struct.calcsize(EntryHeaderFmt)
+IndexHeaderSize = struct.calcsize(IndexHeaderFmt)
+
+# Entry field indices
+EntryOrdinalId    = 1
+EntryNextBlock    = 2
+EntryDataSize     = 3
+EntryDataPosition = 4
+EntryDataCrc64    = 5
+EntryDataType     = 6
+EntryKey          = 7
+
+# FILETIME (100ns since 1601-01-01) of the Unix epoch
+EpochDiff = 116444736000000000
+
+Mask64 = (1 << 64) - 1
+
+def RotateRight(value, count):
+    return ((value >> count) | (value << (64 - count))) & Mask64
+
+def MetroHash64(data, seed = 0):
+    """Port of MetroHash64::Hash(), which the archive uses as its data checksum."""
+    k0 = 0xD6D018F5
+    k1 = 0xA2AA033B
+    k2 = 0x62992FC1
+    k3 = 0x30BC5B29
+
+    def Read(fmt, offset):
+        return struct.unpack_from(fmt, data, offset)[0]
+
+    length = len(data)
+    pos    = 0
+    h      = ((seed + k2) * k0) & Mask64
+
+    if length >= 32:
+        v = [h, h, h, h]
+        while True:
+            v[0] = (RotateRight((v[0] + Read("<Q", pos)      * k0) & Mask64, 29) + v[2]) & Mask64
+            v[1] = (RotateRight((v[1] + Read("<Q", pos + 8)  * k1) & Mask64, 29) + v[3]) & Mask64
+            v[2] = (RotateRight((v[2] + Read("<Q", pos + 16) * k2) & Mask64, 29) + v[0]) & Mask64
+            v[3] = (RotateRight((v[3] + Read("<Q", pos + 24) * k3) & Mask64, 29) + v[1]) & Mask64
+            pos += 32
+            if pos > (length - 32):
+                break
+        v[2] ^= (RotateRight((((v[0] + v[3]) * k0) + v[1]) & Mask64, 37) * k1) & Mask64
+        v[3] ^= (RotateRight((((v[1] + v[2]) * k1) + v[0]) & Mask64, 37) * k0) & Mask64
+        v[0] ^= (RotateRight((((v[0] + v[2]) * k0) + v[3]) & Mask64, 37) * k1) & Mask64
+        v[1] ^= (RotateRight((((v[1] + v[3]) * k1) + v[2]) & Mask64, 37) * k0) & Mask64
+        h = (h + (v[0] ^ v[1])) & Mask64
+
+    if (length - pos) >= 16:
+        v0 = (RotateRight((h + Read("<Q", pos)     * k2) & Mask64, 29) * k3) & Mask64
+        v1 = (RotateRight((h + Read("<Q", pos + 8) * k2) & Mask64, 29) * k3) & Mask64
+        v0 ^= (RotateRight((v0 * k0) & Mask64, 21) + v1) & Mask64
+        v1 ^= (RotateRight((v1 * k3) & Mask64, 21) + v0) & Mask64
+        h = (h + v1) & Mask64
+        pos += 16
+
+    for (size, fmt, rotate) in ((8, "<Q", 55), (4, "<I", 26), (2, "<H", 48), (1, "<B", 37)):
+        if (length - pos) >= size:
+            h = (h + Read(fmt, pos) * k3) & Mask64
+            h ^= (RotateRight(h, rotate) * k1) & Mask64
+            pos += size
+
+    h ^= RotateRight(h, 28)
+    h = (h * k0) & Mask64
+    h ^= RotateRight(h, 29)
+
+    return h
+
+def ReadArchive(archive):
+    """Returns the file header, footer and entry headers of an open archive file."""
+    archive.seek(0, os.SEEK_END)
+    fileSize = archive.tell()
+
+    if fileSize < (FileHeaderSize + FileFooterSize):
+        sys.exit("ERROR: File is too small to be an archive.")
+
+    archive.seek(0)
+    fileHeader = list(struct.unpack(FileHeaderFmt, archive.read(FileHeaderSize)))
+
+    if fileHeader[0] != MagicArchiveMarker:
+        sys.exit("ERROR: File is not a PAL archive.")
+    if fileHeader[1] != CurrentMajorVersion:
+        sys.exit("ERROR: Unsupported archive major version {0}.".format(fileHeader[1]))
+
+    footerOffset = fileSize - FileFooterSize
+    archive.seek(footerOffset)
+    footer = list(struct.unpack(FileFooterFmt, archive.read(FileFooterSize)))
+
+    if (footer[0] != MagicFooterMarker) or (footer[3] != MagicArchiveMarker):
+        sys.exit("ERROR: Archive footer is corrupt.")
+
+    entries    = []
+    nextHeader = fileHeader[3]
+
+    while (len(entries) < footer[1]) and ((nextHeader + EntryHeaderSize) <= footerOffset):
+        archive.seek(nextHeader)
+        entry = list(struct.unpack(EntryHeaderFmt, archive.read(EntryHeaderSize)))
+
+        # The chain can't be followed past a bad header
+        if (entry[0] != MagicEntryMarker) or (entry[EntryNextBlock] <= nextHeader):
+            print("WARNING: Entry chain is broken at offset {0}, dropping the remaining entries.".format(nextHeader))
+            break
+
+        entries.append(entry)
+        nextHeader = entry[EntryNextBlock]
+
+    return (fileHeader, footer, footerOffset, entries)
+
+def CompactArchive(path, discardDuplicateKeys):
+    with open(path, "rb") as archive:
+        # Fail rather than wait if the driver has the archive open
+        try:
+            fcntl.flock(archive.fileno(), fcntl.LOCK_EX | fcntl.LOCK_NB)
+        except IOError:
+            sys.exit("ERROR: <{0}> is in use.".format(path))
+
+        (fileHeader, footer, footerOffset, entries) = ReadArchive(archive)
+
+        tempPath = path + ".compact"
+        seenKeys = set()
+        kept     = []
+
+        with open(tempPath, "wb") as compacted:
+            writeOffset = FileHeaderSize
+            compacted.seek(writeOffset)
+
+            for entry in entries:
+                dataPosition = entry[EntryDataPosition]
+                dataSize     = entry[EntryDataSize]
+
+                # A new index is written for the compacted archive
+                if entry[EntryDataType] == ArchiveIndexDataType:
+                    continue
+
+                if discardDuplicateKeys and (entry[EntryKey] in seenKeys):
+                    continue
+
+                data = b""
+                if (dataPosition + dataSize) <= footerOffset:
+                    archive.seek(dataPosition)
+                    data = archive.read(dataSize)
+
+                if (len(data) != dataSize) or (MetroHash64(data) != entry[EntryDataCrc64]):
+                    print("WARNING: Dropping corrupt entry {0}.".format(entry[EntryOrdinalId]))
+                    continue
+
+                seenKeys.add(entry[EntryKey])
+                compacted.write(data)
+
+                entry[EntryOrdinalId]    = len(kept)
+                entry[EntryDataPosition] = writeOffset
+                kept.append(entry)
+
+                writeOffset += dataSize
+
+            # All entry headers go back to back after the data, the last one points at the footer
+            headerOffset = writeOffset
+
+            for entry in kept:
+                entry[EntryNextBlock] = headerOffset + ((entry[EntryOrdinalId] + 1) * EntryHeaderSize)
+                compacted.write(struct.pack(EntryHeaderFmt, *entry))
+
+            # Followed by a full index, which has to be the last entry for the driver to find it
+            indexBlock = headerOffset + (len(kept) * EntryHeaderSize)
+            keys       = sorted((entry[EntryKey], entry[EntryOrdinalId]) for entry in kept)
+            indexData  = struct.pack(IndexHeaderFmt, MagicIndexMarker, 0, len(kept), len(keys), 0)
+            indexData += b"".join(struct.pack(EntryHeaderFmt, *entry) for entry in kept)
+            indexData += b"".join(struct.pack(IndexKeyFmt, *key) for key in keys)
+            indexData += struct.pack(IndexLocatorFmt, MagicIndexMarker, indexBlock)
+
+            dataPosition = indexBlock + EntryHeaderSize
+            compacted.write(struct.pack(EntryHeaderFmt, MagicEntryMarker, len(kept), dataPosition + len(indexData),
+                                        len(indexData), dataPosition, MetroHash64(indexData), ArchiveIndexDataType,
+                                        bytes(20), 0))
+            compacted.write(indexData)
+
+            footer[1] = len(kept) + 1
+            footer[2] = (int(time.time()) * 10000000) + EpochDiff
+            compacted.write(struct.pack(FileFooterFmt, *footer))
+
+            fileHeader[3] = headerOffset
+            compacted.seek(0)
+            compacted.write(struct.pack(FileHeaderFmt, *fileHeader))
+
+            compacted.flush()
+            os.fsync(compacted.fileno())
+
+        oldSize = footerOffset + FileFooterSize
+        newSize = os.path.getsize(tempPath)
+
+        # Replace the original while we still hold its lock
+        os.rename(tempPath, path)
+
+    print("Kept {0} of {1} entries. {2} -> {3} bytes.".format(len(kept), len(entries), oldSize, newSize))
+
+def main():
+    parser = argparse.ArgumentParser(description="Compact a PAL archive file.")
+    parser.add_argument("archive", help="Path to the archive file")
+    parser.add_argument("--discard-duplicate-keys", action="store_true",
+                        help="Keep only the first entry written for each entry key. Only use this on archives whose "
+                             "entry keys uniquely identify their data, such as pipeline cache archives.")
+    args = parser.parse_args()
+
+    if os.path.isfile(args.archive) == False:
+        sys.exit("ERROR: <{0}> does not exist.".format(args.archive))
+
+    CompactArchive(args.archive, args.discard_duplicate_keys)
+
+if __name__ == "__main__":
+    main()
@@ -28,6 +28,7 @@ import csv
 import glob
 import os
 import re
+import struct
 import sys
 
 try:
@@ -63,6 +64,132 @@ VertsThdGrpsCol  = PsCol + 1
 InstancesCol     = VertsThdGrpsCol + 1
 CommentsCol      = InstancesCol + 1
 
+# Binary trace (.gpt) layout, see gpuProfilerTraceWriter.h.
+TraceFileMagic      = b"PALGPTRC"
+TraceHeaderFormat   = "<8sIIIIIIQ"
+TraceBlockFormat    = "<II"
+TraceStringFormat   = "<II"
+TraceRecordFormat   = "<10I5Q10Q"
+TraceBlockStrings   = 0
+TraceBlockRecords   = 1
+TraceTypeQueueCall  = 0
+TraceTypeCmdBufCall = 1
+InvalidTraceString  = 0xFFFFFFFF
+
+TraceRecordTimestamps       = 0x01
+TraceRecordHideTime         = 0x02
+TraceRecordNested           = 0x04
+TraceRecordDraw             = 0x08
+TraceRecordDispatch         = 0x10
+TraceRecordFullPipelineHash = 0x20
+
+EngineTypeStrings = [ "Gfx", "Ace", "Dma", "Timer" ]
+
+def ReadCsvLogs():
+    # Yields (frameNum, deviceNum, engineType, engineId, queueId, tsFreq, rows) for each frame*.csv file.
+    for file in glob.glob("frame*.csv"):
+        # Decode file name.
+        searchObj  = re.search("frame([0-9]*)Dev([0-9]*)Eng(\D*)([0-9]*)-([0-9]*)\.csv", file)
+        frameNum   = int(searchObj.group(1))
+        deviceNum  = int(searchObj.group(2))
+        engineType = searchObj.group(3)
+        engineId   = int(searchObj.group(4))
+        queueId    = int(searchObj.group(5))
+
+        with open(file) as csvFile:
+            reader  = csv.reader(csvFile, skipinitialspace=True)
+            headers = next(reader)
+
+            tsFreqSearch = re.search(".*Frequency: (\d+).*", headers[TimeCol])
+            yield (frameNum, deviceNum, engineType, engineId, queueId, int(tsFreqSearch.group(1)), reader)
+
+def TraceRecordToRow(record, strings, tsFreq):
+    # Converts a binary trace record to a row with the same columns and formatting as the .csv files.
+    (frameId, recordType, nameId, commentId, cmdBufIdx, subQueueIdx, flags, count, instanceCount, reserved,
+     startClock, endClock, apiPsoHash, pipelineHash, uniquePipelineHash) = record[:15]
+    shaderHashes = record[15:]
+
+    row = [ "" ] * (CommentsCol + 1)
+    if recordType == TraceTypeQueueCall:
+        row[QueueCallCol] = strings[nameId]
+        return row
+
+    row[CmdBufIndexCol] = str(cmdBufIdx)
+    row[CmdBufCallCol]  = ("- " if (flags & TraceRecordNested) else "") + strings[nameId]
+    row[SubQueueIdxCol] = str(subQueueIdx)
+
+    if flags & TraceRecordTimestamps:
+        row[StartClockCol] = str(startClock)
+        row[EndClockCol]   = str(endClock)
+        if not (flags & TraceRecordHideTime):
+            row[TimeCol] = "{0:.2f}".format(1000000 * float(endClock - startClock) / tsFreq)
+
+    if flags & (TraceRecordDraw | TraceRecordDispatch):
+        row[PipelineHashCol] = "0x{0:016x}".format(apiPsoHash)
+        row[CompilerHashCol] = "0x{0:016x}".format(pipelineHash)
+        if flags & TraceRecordFullPipelineHash:
+            row[CompilerHashCol] += "-0x{0:016x}".format(uniquePipelineHash)
+
+        shaderCount = 5 if (flags & TraceRecordDraw) else 1
+        for i in range(shaderCount):
+            row[VsCsCol + i] = "0x{0:016x}{1:016x}".format(shaderHashes[2 * i + 1], shaderHashes[2 * i])
+
+        row[VertsThdGrpsCol] = str(count)
+        if flags & TraceRecordDraw:
+            row[InstancesCol] = str(instanceCount)
+
+    if commentId != InvalidTraceString:
+        row[CommentsCol] = strings[commentId]
+
+    return row
+
+def ReadTraceLogs():
+    # Yields the same tuples as ReadCsvLogs() for each frame in each trace*.gpt file.
+    headerSize = struct.calcsize(TraceHeaderFormat)
+    blockSize  = struct.calcsize(TraceBlockFormat)
+    stringSize = struct.calcsize(TraceStringFormat)
+    recordSize = struct.calcsize(TraceRecordFormat)
+
+    for file in glob.glob("trace*.gpt"):
+        with open(file, "rb") as traceFile:
+            data = traceFile.read()
+
+        (magic, version, fileRecordSize, deviceNum, engineType, engineId, queueId, tsFreq) = \
+            struct.unpack_from(TraceHeaderFormat, data, 0)
+
+        if magic != TraceFileMagic or version != 1 or fileRecordSize < recordSize:
+            sys.exit("ERROR: <{0}> is not a supported GPU profiler trace file.".format(file))
+
+        strings = { }
+        frameRows = collections.OrderedDict() # Frame num -> [ row, ... ]
+        offset = headerSize
+        while offset + blockSize <= len(data):
+            (blockType, entryCount) = struct.unpack_from(TraceBlockFormat, data, offset)
+            offset += blockSize
+            for i in range(entryCount):
+                if blockType == TraceBlockStrings:
+                    (stringId, length) = struct.unpack_from(TraceStringFormat, data, offset)
+                    offset += stringSize
+                    strings[stringId] = data[offset:offset + length].decode("utf-8", "replace")
+                    offset += length
+                elif blockType == TraceBlockRecords:
+                    record = struct.unpack_from(TraceRecordFormat, data, offset)
+                    offset += fileRecordSize
+                    if record[1] == TraceTypeQueueCall or record[1] == TraceTypeCmdBufCall:
+                        frameRows.setdefault(record[0], []).append(TraceRecordToRow(record, strings, tsFreq))
+                else:
+                    sys.exit("ERROR: <{0}> has an unknown block type {1:d}.".format(file, blockType))
+
+        engineName = EngineTypeStrings[engineType] if engineType < len(EngineTypeStrings) else str(engineType)
+        for (frameNum, rows) in iteritems(frameRows):
+            yield (frameNum, deviceNum, engineName, engineId, queueId, tsFreq, rows)
+
+def ReadLogs():
+    for log in ReadCsvLogs():
+        yield log
+    for log in ReadTraceLogs():
+        yield log
+
 def isValidHash(string):
     # A valid hash is a non-empty string that represents a non-zero hex value.
     return string and (int(string, 16) != 0)
@@ -95,10 +222,10 @@ elif len(sys.argv) == 3:
 gpuFrameTime = 0
 
 os.chdir(sys.argv[1])
-files = glob.glob("frame*.csv")
+fileCount = len(glob.glob("frame*.csv")) + len(glob.glob("trace*.gpt"))
 
-if (len(files) == 0):
-    sys.exit("ERROR: Looking at directory <{0}> but cannot find any files that match the \"frame*.csv\" pattern.".format(os.getcwd()))
+if (fileCount == 0):
+    sys.exit("ERROR: Looking at directory <{0}> but cannot find any files that match the \"frame*.csv\" or \"trace*.gpt\" patterns.".format(os.getcwd()))
 
 frames               = { }  # Frame num -> [ tsFreq, cmdBufClockPairs, total barrier time ]
 perCallTable         = { }  # Device -> Engine -> QueueId -> Call -> [ count, totalTime ]
@@ -111,20 +238,12 @@ frameCount           = 0
 submitCount          = 0
 cmdBufCount          = 0
 
-filesProcessedSoFar  = 0 # For printing parsing progress.
+logsProcessedSoFar   = 0 # For printing parsing progress.
 
-for file in files:
+for (frameNum, deviceNum, engineType, engineId, queueId, tsFreq, rows) in ReadLogs():
     if sys.stdout.isatty():
-        sys.stdout.write("Parsing input files.  {0:.0f}% Complete.\r".format((filesProcessedSoFar / float(len(files))) * 100))
-    filesProcessedSoFar += 1
-
-    # Decode file name.
-    searchObj  = re.search("frame([0-9]*)Dev([0-9]*)Eng(\D*)([0-9]*)-([0-9]*)\.csv", file)
-    frameNum   = int(searchObj.group(1))
-    deviceNum  = int(searchObj.group(2))
-    engineType = searchObj.group(3)
-    engineId   = int(searchObj.group(4))
-    queueId    = int(searchObj.group(5))
+        sys.stdout.write("Parsing input files.  {0:d} frame logs complete.\r".format(logsProcessedSoFar))
+    logsProcessedSoFar += 1
 
     # Track the fact we've never seen this frame before:
     # - Zero out the time spend in barriers for it.
@@ -155,63 +274,57 @@ for file in files:
     if not queueKey in perCallTable[deviceKey][engineKey].keys():
         perCallTable[deviceKey][engineKey][queueKey] = { }
 
-    with open(file) as csvFile:
-        reader = csv.reader(csvFile, skipinitialspace=True)
-        headers = next(reader)
-
-        tsFreqSearch        = re.search(".*Frequency: (\d+).*", headers[TimeCol])
-        frames[frameNum][0] = int(tsFreqSearch.group(1))
-
-        for row in reader:
-            if row[QueueCallCol] == "Submit()":
-                submitCount += 1
-            if row[CmdBufCallCol] == "Begin()" and row[StartClockCol]:
-                frames[frameNum][1].append((int(row[StartClockCol]), int(row[EndClockCol])))
-                cmdBufCount += 1
-            if row[TimeCol]:
-                if row[CmdBufCallCol] in perCallTable[deviceKey][engineKey][queueKey].keys():
-                    perCallTable[deviceKey][engineKey][queueKey][row[CmdBufCallCol]][0] += 1
-                    perCallTable[deviceKey][engineKey][queueKey][row[CmdBufCallCol]][1] += float(row[TimeCol])
-                else:
-                    perCallTable[deviceKey][engineKey][queueKey][row[CmdBufCallCol]] = [ 1, float(row[TimeCol]) ]
+    frames[frameNum][0] = tsFreq
+
+    for row in rows:
+        if row[QueueCallCol] == "Submit()":
+            submitCount += 1
+        if row[CmdBufCallCol] == "Begin()" and row[StartClockCol]:
+            frames[frameNum][1].append((int(row[StartClockCol]), int(row[EndClockCol])))
+            cmdBufCount += 1
+        if row[TimeCol]:
+            if row[CmdBufCallCol] in perCallTable[deviceKey][engineKey][queueKey].keys():
+                perCallTable[deviceKey][engineKey][queueKey][row[CmdBufCallCol]][0] += 1
+                perCallTable[deviceKey][engineKey][queueKey][row[CmdBufCallCol]][1] += float(row[TimeCol])
+            else:
+                perCallTable[deviceKey][engineKey][queueKey][row[CmdBufCallCol]] = [ 1, float(row[TimeCol]) ]
 
-                pipelineType = DeterminePipelineType(row)
-                if pipelineType in perPipelineTypeTable:
-                    perPipelineTypeTable[pipelineType][0] += 1
-                    perPipelineTypeTable[pipelineType][1] += float(row[TimeCol])
+            pipelineType = DeterminePipelineType(row)
+            if pipelineType in perPipelineTypeTable:
+                perPipelineTypeTable[pipelineType][0] += 1
+                perPipelineTypeTable[pipelineType][1] += float(row[TimeCol])
+            else:
+                perPipelineTypeTable[pipelineType] = [ 1, float(row[TimeCol]) ]
+
+            if row[CompilerHashCol]:
+                # Update the perPipelineTable totals.
+                # Note that in practice the compiler hash is most useful because it's in all of the pipeline dumps.
+                if row[CompilerHashCol] in perPipelineTable:
+                    perPipelineTable[row[CompilerHashCol]][1] += 1
+                    perPipelineTable[row[CompilerHashCol]][2] += float(row[TimeCol])
                 else:
-                    perPipelineTypeTable[pipelineType] = [ 1, float(row[TimeCol]) ]
-
-                if row[CompilerHashCol]:
-                    # Update the perPipelineTable totals.
-                    # Note that in practice the compiler hash is most useful because it's in all of the pipeline dumps.
-                    if row[CompilerHashCol] in perPipelineTable:
-                        perPipelineTable[row[CompilerHashCol]][1] += 1
-                        perPipelineTable[row[CompilerHashCol]][2] += float(row[TimeCol])
+                    perPipelineTable[row[CompilerHashCol]] = [ pipelineType, 1, float(row[TimeCol]), row[VsCsCol], row[HsCol], row[DsCol], row[GsCol], row[PsCol] ]
+
+                # Record the start and end clocks and the time of this shader work in the pipelineRangeTable.
+                # Note that we may divide by zero later unless we exclude rows with identical start and end clocks.
+                startClock = int(row[StartClockCol])
+                endClock   = int(row[EndClockCol])
+                if endClock - startClock > 0:
+                    if row[CompilerHashCol] in pipelineRangeTable[frameNum][engineType]:
+                        pipelineRangeTable[frameNum][engineType][row[CompilerHashCol]].append((startClock, endClock, float(row[TimeCol])))
                     else:
-                        perPipelineTable[row[CompilerHashCol]] = [ pipelineType, 1, float(row[TimeCol]), row[VsCsCol], row[HsCol], row[DsCol], row[GsCol], row[PsCol] ]
-
-                    # Record the start and end clocks and the time of this shader work in the pipelineRangeTable.
-                    # Note that we may divide by zero later unless we exclude rows with identical start and end clocks.
-                    startClock = int(row[StartClockCol])
-                    endClock   = int(row[EndClockCol])
-                    if endClock - startClock > 0:
-                        if row[CompilerHashCol] in pipelineRangeTable[frameNum][engineType]:
-                            pipelineRangeTable[frameNum][engineType][row[CompilerHashCol]].append((startClock, endClock, float(row[TimeCol])))
-                        else:
-                            pipelineRangeTable[frameNum][engineType][row[CompilerHashCol]] = [(startClock, endClock, float(row[TimeCol]))]
+                        pipelineRangeTable[frameNum][engineType][row[CompilerHashCol]] = [(startClock, endClock, float(row[TimeCol]))]
 
-                if row[PsCol]:
-                    if row[PsCol] in perPsTable:
-                        perPsTable[row[PsCol]][0] += 1
-                        perPsTable[row[PsCol]][1] += float(row[TimeCol])
-                    else:
-                        perPsTable[row[PsCol]] = [ 1, float(row[TimeCol]) ]
+            if row[PsCol]:
+                if row[PsCol] in perPsTable:
+                    perPsTable[row[PsCol]][0] += 1
+                    perPsTable[row[PsCol]][1] += float(row[TimeCol])
+                else:
+                    perPsTable[row[PsCol]] = [ 1, float(row[TimeCol]) ]
 
-                if row[CmdBufCallCol] == "CmdBarrier()":
-                    frames[frameNum][2] += float(row[TimeCol])
+            if row[CmdBufCallCol] == "CmdBarrier()":
+                frames[frameNum][2] += float(row[TimeCol])
 
-        csvFile.close
 
 # Compute the sum of all GPU frame times, where the time of a single frame is the amount of time the GPU spent being busy.
 # We can do this by creating a list of all GPU clock ranges when the GPU was busy from the list of all command buffer clock ranges like so:
@@ -354,43 +467,34 @@ medianBarrierFrame = list(collections.OrderedDict(sorted(list(iteritems(frames))
 
 barrierTime = 0
 barrierReportTable = [ ] # [time, [desc, ...] ]
-for file in files:
-    # Decode file name.
-    searchObj  = re.search("frame([0-9]*)Dev([0-9]*)Eng(\D*)([0-9]*)-([0-9]*)\.csv", file)
-    frameNum   = int(searchObj.group(1))
-    engineType = searchObj.group(3)
-
+for (frameNum, deviceNum, engineType, engineId, queueId, tsFreq, rows) in ReadLogs():
     if not (engineType == "Ace" or engineType == "Dma" or engineType == "Gfx"):
         continue
 
     if frameNum == medianBarrierFrame:
-        with open(file) as csvFile:
-            reader = csv.reader(csvFile, skipinitialspace=True)
-            next(reader)
-            for row in reader:
-                if row[CmdBufCallCol] == "CmdBarrier()":
-                    barrierTime += float(row[TimeCol])
-                    entry = [float(row[TimeCol]), [ ] ]
-
-                    if row[CommentsCol] == "":
-                        entry[1].append(["-", "", 0, 0])
-                    else:
-                        actionList = row[CommentsCol].split("\n")
-                        for action in actionList:
-                            if ('CacheMask' not in action) and ('OldLayout' not in action) and ('NewLayout' not in action):
-                                searchObj = re.search("(.*): ([0-9]*)x([0-9]*) (.*)", action)
-                                if searchObj != None:
-                                    actionType = searchObj.group(1)
-                                    width = int(searchObj.group(2))
-                                    height = int(searchObj.group(3))
-                                    format = searchObj.group(4)
-
-                                    entry[1].append([actionType, format, width, height])
-                                else:
-                                    entry[1].append([action, "", 0, 0])
-
-                    barrierReportTable.append(entry)
-            csvFile.close
+        for row in rows:
+            if row[CmdBufCallCol] == "CmdBarrier()":
+                barrierTime += float(row[TimeCol])
+                entry = [float(row[TimeCol]), [ ] ]
+
+                if row[CommentsCol] == "":
+                    entry[1].append(["-", "", 0, 0])
+                else:
+                    actionList = row[CommentsCol].split("\n")
+                    for action in actionList:
+                        if ('CacheMask' not in action) and ('OldLayout' not in action) and ('NewLayout' not in action):
+                            searchObj = re.search("(.*): ([0-9]*)x([0-9]*) (.*)", action)
+                            if searchObj != None:
+                                actionType = searchObj.group(1)
+                                width = int(searchObj.group(2))
+                                height = int(searchObj.group(3))
+                                format = searchObj.group(4)
+
+                                entry[1].append([actionType, format, width, height])
+                            else:
+                                entry[1].append([action, "", 0, 0])
+
+                barrierReportTable.append(entry)
 
 print("== Median Frame Top CmdBarrier() Calls (>= 10us): ===============================================================================================\n")
 print("Frame #{0:d} total barrier time: {1:,.2f} us\n".format(medianBarrierFrame, barrierTime))
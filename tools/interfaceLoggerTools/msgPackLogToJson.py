@@ -0,0 +1,219 @@
+##
+ #######################################################################################################################
+ #
+ #  Copyright (c) 2020 Advanced Micro Devices, Inc. All Rights Reserved.
+ #
+ #  Permission is hereby granted, free of charge, to any person obtaining a copy
+ #  of this software and associated documentation files (the "Software"), to deal
+ #  in the Software without restriction, including without limitation the rights
+ #  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ #  copies of the Software, and to permit persons to whom the Software is
+ #  furnished to do so, subject to the following conditions:
+ #
+ #  The above copyright notice and this permission notice shall be included in all
+ #  copies or substantial portions of the Software.
+ #
+ #  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ #  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ #  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ #  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ #  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ #  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ #  SOFTWARE.
+ #
+ #######################################################################################################################
+
+# Converts a binary interface logger log (written with the InterfaceLoggerConfig.BinaryOutput setting) to JSON.
+#
+# Binary logs are a sequence of MessagePack objects, one per top-level log entry. The JSON log is a list of those
+# entries, the same as the interface logger would have written with BinaryOutput disabled. Floats are formatted the way
+# the interface logger formats them.
+#
+# Usage: msgPackLogToJson.py pal_calls.msgpack [output.json]
+# If no output path is given the ".msgpack" extension is replaced with ".json".
+
+import argparse
+import os
+import struct
+import sys
+
+class MsgPackError(Exception):
+    pass
+
+# The interface logger packs inline maps and lists with 16-bit counts and all others with 32-bit counts.
+class ListEntries(list):
+    def __init__(self, items, isInline):
+        list.__init__(self, items)
+        self.isInline = isInline
+
+# Map entries are kept as a list of (key, value) pairs so they stay in the order they were logged.
+class MapEntries(ListEntries):
+    pass
+
+class MsgPackDecoder:
+    def __init__(self, data):
+        self.data   = data
+        self.offset = 0
+
+    def AtEnd(self):
+        return self.offset >= len(self.data)
+
+    def Read(self, size):
+        if self.offset + size > len(self.data):
+            raise MsgPackError("Truncated data at offset {0}.".format(self.offset))
+        value = self.data[self.offset:self.offset + size]
+        self.offset += size
+        return value
+
+    def Unpack(self, fmt):
+        return struct.unpack(fmt, self.Read(struct.calcsize(fmt)))[0]
+
+    def ReadItem(self):
+        itemOffset = self.offset
+        type = self.Unpack(">B")
+
+        if type <= 0x7f:
+            return type
+        elif type >= 0xe0:
+            return type - 0x100
+        elif (type & 0xf0) == 0x80:
+            return self.ReadMap(type & 0x0f, False)
+        elif (type & 0xf0) == 0x90:
+            return self.ReadArray(type & 0x0f, False)
+        elif (type & 0xe0) == 0xa0:
+            return self.ReadString(type & 0x1f)
+        elif type == 0xc0:
+            return None
+        elif type == 0xc2:
+            return False
+        elif type == 0xc3:
+            return True
+        elif type == 0xca:
+            return self.Unpack(">f")
+        elif type == 0xcb:
+            return self.Unpack(">d")
+        elif type == 0xcc:
+            return self.Unpack(">B")
+        elif type == 0xcd:
+            return self.Unpack(">H")
+        elif type == 0xce:
+            return self.Unpack(">I")
+        elif type == 0xcf:
+            return self.Unpack(">Q")
+        elif type == 0xd0:
+            return self.Unpack(">b")
+        elif type == 0xd1:
+            return self.Unpack(">h")
+        elif type == 0xd2:
+            return self.Unpack(">i")
+        elif type == 0xd3:
+            return self.Unpack(">q")
+        elif type == 0xd9:
+            return self.ReadString(self.Unpack(">B"))
+        elif type == 0xda:
+            return self.ReadString(self.Unpack(">H"))
+        elif type == 0xdb:
+            return self.ReadString(self.Unpack(">I"))
+        elif type == 0xdc:
+            return self.ReadArray(self.Unpack(">H"), True)
+        elif type == 0xdd:
+            return self.ReadArray(self.Unpack(">I"), False)
+        elif type == 0xde:
+            return self.ReadMap(self.Unpack(">H"), True)
+        elif type == 0xdf:
+            return self.ReadMap(self.Unpack(">I"), False)
+        else:
+            raise MsgPackError("Unsupported type 0x{0:02x} at offset {1}.".format(type, itemOffset))
+
+    def ReadString(self, length):
+        return self.Read(length).decode("utf-8", "replace")
+
+    def ReadArray(self, count, isInline):
+        return ListEntries([self.ReadItem() for i in range(count)], isInline)
+
+    def ReadMap(self, count, isInline):
+        entries = []
+        for i in range(count):
+            key = self.ReadItem()
+            entries.append((key, self.ReadItem()))
+        return MapEntries(entries, isInline)
+
+def EscapeString(value):
+    # The interface logger doesn't escape strings, so neither do we.
+    return "\"" + value + "\""
+
+def WriteJson(out, value, indent):
+    if isinstance(value, ListEntries):
+        isMap = isinstance(value, MapEntries)
+        if len(value) == 0:
+            out.write("{}" if isMap else "[]")
+            return
+        # Like the interface logger, inline containers separate their items with single spaces instead of newlines.
+        childIndent = indent + "  "
+        itemSpace   = " " if value.isInline else "\n" + childIndent
+        endSpace    = " " if value.isInline else "\n" + indent
+        out.write("{" if isMap else "[")
+        for idx, item in enumerate(value):
+            out.write(itemSpace)
+            if isMap:
+                out.write(EscapeString(str(item[0])) + ": ")
+                WriteJson(out, item[1], childIndent)
+            else:
+                WriteJson(out, item, childIndent)
+            if idx + 1 < len(value):
+                out.write(",")
+        out.write(endSpace + ("}" if isMap else "]"))
+    elif value is None:
+        out.write("null")
+    elif value is True:
+        out.write("true")
+    elif value is False:
+        out.write("false")
+    elif isinstance(value, float):
+        out.write("%g" % value)
+    elif isinstance(value, int):
+        out.write(str(value))
+    else:
+        out.write(EscapeString(value))
+
+def ConvertLog(inPath, outPath):
+    with open(inPath, "rb") as inFile:
+        decoder = MsgPackDecoder(inFile.read())
+
+    numEntries = 0
+
+    with open(outPath, "w") as out:
+        out.write("[\n")
+        while decoder.AtEnd() == False:
+            try:
+                entry = decoder.ReadItem()
+            except MsgPackError as error:
+                # The last entry may be incomplete if the application crashed while it was being written.
+                print("WARNING: {0} Stopping after {1} entries.".format(error, numEntries))
+                break
+            if numEntries > 0:
+                out.write(",\n")
+            out.write("  ")
+            WriteJson(out, entry, "  ")
+            numEntries += 1
+        out.write("\n]\n")
+
+    print("Wrote {0} entries to {1}.".format(numEntries, outPath))
+
+def main():
+    parser = argparse.ArgumentParser(description="Convert a binary PAL interface logger log to JSON.")
+    parser.add_argument("log", help="Path to the .msgpack log file")
+    parser.add_argument("output", nargs="?", help="Path to the JSON file to write")
+    args = parser.parse_args()
+
+    if os.path.isfile(args.log) == False:
+        sys.exit("ERROR: <{0}> does not exist.".format(args.log))
+
+    outPath = args.output
+    if outPath is None:
+        outPath = os.path.splitext(args.log)[0] + ".json"
+
+    ConvertLog(args.log, outPath)
+
+if __name__ == "__main__":
+    main()